@@ -0,0 +1,90 @@
+#!/bin/sh
+# End-to-end benchmark of pathalizer on generated multi-megabyte inputs.
+# Builds the current sources and a baseline revision, runs both on the same
+# inputs, checks that they produce the same graph and prints the timings.
+# With --large also times a ~1 GB profile: the baseline, the current parser
+# on one thread and on all cores, and an incremental update of a saved
+# 1 GB state with one more small events file.
+#
+# usage: ./bench.sh [--large] [baseline-revision]
+# The default baseline is the commit that added main.cpp in this directory,
+# i.e. the original sources of this solution.
+
+set -e
+
+LARGE=0
+if [ "$1" = "--large" ]; then
+	LARGE=1
+	shift
+fi
+SRC_DIR=$(cd "$(dirname "$0")" && pwd)
+cd "$SRC_DIR"
+BASELINE=${1:-$(git log --diff-filter=A --format=%H -- main.cpp | tail -n 1)}
+if [ -z "$BASELINE" ] || ! git cat-file -e "$BASELINE:./main.cpp" 2>/dev/null; then
+	echo "baseline revision '$BASELINE' has no sources in this directory, pass one explicitly" >&2
+	exit 1
+fi
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+mkdir "$WORK_DIR/baseline"
+git archive "$BASELINE" . | tar -x -C "$WORK_DIR/baseline"
+g++ -O2 -w "$WORK_DIR"/baseline/*.cpp -o "$WORK_DIR/pathalizer-baseline"
+g++ -O2 -w -pthread ./*.cpp -o "$WORK_DIR/pathalizer"
+
+# small: the bundled access log as is
+# repeated: the bundled access log replayed 30 times with distinct sessions (~55 MB),
+#           few distinct edges taken many times
+# distinct: 100k sessions over 50k pages (~12 MB), hundreds of thousands of distinct edges
+python3 - "$SRC_DIR/inputs" "$WORK_DIR" <<'EOF'
+import sys
+src, out = sys.argv[1], sys.argv[2]
+lines = open(src).read().splitlines()
+with open(out + '/small.txt', 'w') as f:
+    f.write('\n'.join(lines) + '\n')
+with open(out + '/repeated.txt', 'w') as f:
+    for k in range(30):
+        for line in lines:
+            session, timestamp, name = line.split('\t')
+            f.write(f'{session}.{k}\t{timestamp}\t{name}\n')
+with open(out + '/distinct.txt', 'w') as f:
+    for s in range(100000):
+        for k in range(4):
+            f.write(f'10.0.{s // 256}.{s % 256}\t{1000 + k}\t/page/{(s * 7 + k * 13) % 50000:06d}\n')
+EOF
+
+seconds() {
+	start=$(date +%s.%N)
+	"$@" > /dev/null 2>&1
+	end=$(date +%s.%N)
+	awk "BEGIN { printf \"%.2f\", $end - $start }"
+}
+
+for input in repeated distinct; do
+	file="$WORK_DIR/$input.txt"
+	"$WORK_DIR/pathalizer-baseline" "$file" 2>/dev/null | sort > "$WORK_DIR/baseline.dot"
+	"$WORK_DIR/pathalizer" "$file" 2>/dev/null | sort > "$WORK_DIR/current.dot"
+	if ! cmp -s "$WORK_DIR/baseline.dot" "$WORK_DIR/current.dot"; then
+		echo "$input: outputs differ" >&2
+		exit 1
+	fi
+	size=$(du -m "$file" | cut -f1)
+	baseline=$(seconds "$WORK_DIR/pathalizer-baseline" "$file")
+	current=$(seconds "$WORK_DIR/pathalizer" "$file")
+	echo "$input (${size} MB): baseline ${baseline}s, current ${current}s"
+done
+
+[ "$LARGE" = 1 ] || exit 0
+
+# ~1 GB: the repeated input 19 times over
+file="$WORK_DIR/large.txt"
+for i in $(seq 19); do cat "$WORK_DIR/repeated.txt"; done > "$file"
+rm "$WORK_DIR/repeated.txt" "$WORK_DIR/distinct.txt"
+size=$(du -m "$file" | cut -f1)
+echo "large (${size} MB): baseline $(seconds "$WORK_DIR/pathalizer-baseline" "$file")s," \
+	"current -j 1 $(seconds "$WORK_DIR/pathalizer" -j 1 "$file")s," \
+	"current -j $(nproc) $(seconds "$WORK_DIR/pathalizer" "$file")s"
+
+"$WORK_DIR/pathalizer" -s "$WORK_DIR/state" "$file" > /dev/null 2>&1
+echo "incremental: state of large + small $(seconds "$WORK_DIR/pathalizer" -s "$WORK_DIR/state" "$WORK_DIR/small.txt")s," \
+	"large + small from scratch $(seconds "$WORK_DIR/pathalizer" "$file" "$WORK_DIR/small.txt")s"
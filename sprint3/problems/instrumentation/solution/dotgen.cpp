@@ -4,50 +4,32 @@
 #define BUFSIZE 100
 #undef DEBUG
 
-/* a pointer to this struct * is passed on to FindTreshold while walking */
-struct findtreshold_arg
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+/*
+ * Returns the smallest treshold that leaves at most max_edgecount edges
+ * with n_taken above it. Uses one sort of the counts instead of a pass over
+ * all edges per candidate treshold.
+ */
+int FindTreshold(const std::vector<AnnotatedEdge> & edges, int max_edgecount)
 {
-        int n_edges;
-        int current_treshold;
-};
-
-void CountEdges (void * content, void * arg)
-{
-        findtreshold_arg * args = (findtreshold_arg *) arg;
-        // TODO wat als edge->next != null? Juist!
-        AnnotatedEdge * current = (AnnotatedEdge *)content;
-        while (current != NULL)
-        {
-                if (current->n_taken > args->current_treshold)
-                        args->n_edges++;
-                current = current->next;
-        }
-}
+	if (max_edgecount < 0 || edges.size() <= (size_t)max_edgecount)
+		return 0;
 
-int FindTreshold(BinaryTree * tree_root, int max_edgecount)
-{
-	static findtreshold_arg * args = (findtreshold_arg*) malloc (sizeof(findtreshold_arg));
-	args->n_edges=-1;
-	args->current_treshold=0;
+	std::vector<int> counts;
+	counts.reserve(edges.size());
+	for (size_t i = 0; i < edges.size(); i++)
+		counts.push_back(edges[i].n_taken);
+	std::nth_element (counts.begin(), counts.begin() + max_edgecount, counts.end(), std::greater<int>());
 
 #ifdef DEBUG
 	fprintf(stderr, "  Finding treshold. max_edgecount: %d\n", max_edgecount);
 #endif
-	
-	while ((args->n_edges > max_edgecount) || (args->n_edges == -1))
-	{
-		//AnnotatedEdge * current_edge = start_edge;
-		args->n_edges = 0;
-
-		tree_root->walk(CountEdges, args);
-
-#ifdef DEBUG
-		fprintf(stderr, "  With treshold %d, found %d edges.\n", current_treshold, edges);
-#endif
 
-		args->current_treshold++;
-	}
-	return args->current_treshold-1;
+	// edges above the (max_edgecount+1)-th largest count are exactly those that fit
+	return std::max(counts[max_edgecount], 0);
 }
 
 struct printedge_arg
@@ -79,24 +61,17 @@ void PrintNode (void * content, void * arg)
 			node->name,
 			shape);
 }
-void PrintEdge (void * content, void * arg)
+void PrintEdge (FILE * dest, AnnotatedEdge * current, printedge_arg * args)
 {
-        printedge_arg * args = (printedge_arg*) arg;
-        AnnotatedEdge * current = (AnnotatedEdge *)content;
-
-        while (current != NULL)
+        if (current->n_taken > args->min_edgewidth)
         {
-                if (current->n_taken > args->min_edgewidth)
-                {
-                        printf("\"%s\" -> \"%s\"[label=%d,color=\"0,0,%f\"];\n", 
-                                        current->from->name,
-                                        current->to->name,
-                                        current->n_taken, 
-					1.0-current->n_taken/60.0);
-                         current->from->used = true;
-                         current->to->used = true;
-                }
-                current = current->next;
+                fprintf(dest, "\"%s\" -> \"%s\"[label=%d,color=\"0,0,%f\"];\n",
+                                current->from->name,
+                                current->to->name,
+                                current->n_taken,
+                                1.0-current->n_taken/60.0);
+                current->from->used = true;
+                current->to->used = true;
         }
 }
 
@@ -114,15 +89,18 @@ void GenerateDot (FILE * dest, AnnotatedGraph * g, NodeHashTbl * nodehash, Confi
 
 	printedge_arg * args = (printedge_arg*) malloc (sizeof(printedge_arg));
 
+	sortEdges (g);
+
 	if (config->min_edgewidth < 0)
 	{
-		args->min_edgewidth = FindTreshold(g->edgetree, config->max_edgecount);
+		args->min_edgewidth = FindTreshold(g->edges, config->max_edgecount);
 		fprintf(stderr, "  Chose treshold: %d\n", args->min_edgewidth);
 	} else {
 		args->min_edgewidth = config->min_edgewidth;
 	}
 
-	g->edgetree->walk (PrintEdge, args);
+	for (size_t i = 0; i < g->edges.size(); i++)
+		PrintEdge (dest, &g->edges[i], args);
 	nodehash->walk (PrintNode, dest);
 
 	/* TODO walk nodes */
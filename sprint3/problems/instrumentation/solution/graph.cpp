@@ -1,317 +1,228 @@
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <assert.h>
+#include <algorithm>
 #include "graph.h"
 
-void NodeHashTbl::walk (void (*func)(void *, void*), void* arg)
-{
-	for (int x=0; x<size; x++)
-	{
-		if (table[x] != NULL)
-		{
-			table[x]->walk(func, arg);
-		}
-	}
-}
-
-void HashNode::walk (void (*func)(void *, void *), void * arg)
-{
-	func (node, arg);
-	if (next != NULL)
-		next->walk(func, arg);
-}
-
-unsigned int NodeHashTbl::HashString (const char * str)
-{
-        unsigned int retval = 0;
-        int length = strlen(str);
-
-        unsigned int top5bits = 0xf8000000;
-        unsigned int carry = 0;
-
-        const int kleftmove=5;
-        const int krightmove=27;
-
-        for (int i=0; i<length; i++)
-        {
-                carry = retval & top5bits;
-                carry = carry >> krightmove;
-                retval = retval << kleftmove;
-                retval ^= carry;
-                retval ^= str[i];
-        }
-        return retval;
-}
+/* size of a block of the name arena, longer names get a block of their own */
+#define NAME_BLOCK_SIZE 65536
 
 NodeHashTbl::NodeHashTbl(int n_size)
+	: block_used(0), block_size(0)
 {
-        size = n_size;
-        table = (HashNode **) malloc (sizeof(HashNode*)*size); 
-        for (int i=0; i<size; i++)
-        {
-                table[i] = NULL;
-        }
+	size_t capacity = 16;
+	while (capacity < (size_t)n_size * 2)
+		capacity *= 2;
+	table.assign(capacity, Slot{0, NULL});
 }
 
-void NodeHashTbl::add(char * key, Node * content)
+NodeHashTbl::~NodeHashTbl ()
 {
-        //assert (strcmp (key, content->name) == 0);
-
-        int hkey = HashString (key) % size;
-        table[hkey] = new HashNode(key, content, table[hkey]);
+	for (size_t i = 0; i < name_blocks.size(); i++)
+		free (name_blocks[i]);
 }
 
-Node * NodeHashTbl::get(char * key)
+void NodeHashTbl::walk (void (*func)(void *, void*), void* arg)
 {
-        HashNode * current_node = table[HashString (key) % size];
-        while (current_node != NULL)
-        {
-                if (strcmp(current_node->key, key) == 0)
-                {
-                        //assert (strcmp (key, current_node->node->name) == 0);
-
-                        return current_node->node;
-                }
-                current_node=current_node->next;
-        }
-        return NULL;
+	for (size_t i = 0; i < nodes.size(); i++)
+		func (&nodes[i], arg);
 }
 
-Node * newNode (char * name)
+/* FNV-1a */
+unsigned int NodeHashTbl::HashString (const char * str, size_t length)
 {
-	Node * retval = (Node *) malloc (sizeof(Node));
-	retval->name = strdup(name);
-	retval->start = 0;
-	retval->end = 0;
-	retval->used = false;
+	unsigned int retval = 2166136261u;
+	for (size_t i = 0; i < length; i++)
+	{
+		retval ^= (unsigned char)str[i];
+		retval *= 16777619u;
+	}
 	return retval;
 }
 
-/* remove bad characters from names, should move somewhere else probably */
-void FixName (char * name)
+const char * NodeHashTbl::InternName (const char * key, size_t length)
 {
-	// Node names may not end with '\' or '/'
-	while ((name[strlen(name)-1] == '\\')
-		|| (name[strlen(name)-1] == '/'))
+	if (block_used + length + 1 > block_size)
 	{
-		name[strlen(name)-1] = '\0';
+		block_size = std::max((size_t)NAME_BLOCK_SIZE, length + 1);
+		name_blocks.push_back((char *) malloc (block_size));
+		block_used = 0;
 	}
+	char * name = name_blocks.back() + block_used;
+	memcpy (name, key, length);
+	name[length] = '\0';
+	block_used += length + 1;
+	return name;
 }
 
-Node * getNode (char * name, NodeHashTbl * nodehash)
+void NodeHashTbl::Grow ()
 {
-        FixName(name);
-
-        Node * retval = nodehash->get(name);
-
-        if (retval == NULL)
-        {
-                retval = newNode(name);
-                nodehash->add(strdup(name), retval);
-        }
-
-        return retval;
+	std::vector<Slot> old_table;
+	old_table.swap(table);
+	table.assign(old_table.size() * 2, Slot{0, NULL});
+	size_t mask = table.size() - 1;
+	for (size_t i = 0; i < old_table.size(); i++)
+	{
+		if (old_table[i].node == NULL)
+			continue;
+		size_t pos = old_table[i].hash & mask;
+		while (table[pos].node != NULL)
+			pos = (pos + 1) & mask;
+		table[pos] = old_table[i];
+	}
 }
 
-GraphListNode * newGraphListNode (GraphListNode * next, Node * start)
+Node * NodeHashTbl::get (const char * key, size_t length)
 {
-	assert (start != NULL);
+	unsigned int hash = HashString (key, length);
+	size_t mask = table.size() - 1;
+	for (size_t pos = hash & mask; table[pos].node != NULL; pos = (pos + 1) & mask)
+	{
+		const char * name = table[pos].node->name;
+		if (table[pos].hash == hash
+				&& strncmp (name, key, length) == 0
+				&& name[length] == '\0')
+			return table[pos].node;
+	}
+	return NULL;
+}
 
-	Graph * new_graph = (Graph *) malloc (sizeof(Graph));
-	new_graph->name = "";
-	new_graph->start = start;
-	new_graph->edges = NULL;
+Node * NodeHashTbl::add (const char * key, size_t length)
+{
+	// load factor stays at most 1/2
+	if ((nodes.size() + 1) * 2 > table.size())
+		Grow ();
 
-	GraphListNode * retval = (GraphListNode *) malloc (sizeof(GraphListNode));
-	retval->next = next;
-	retval->graph = new_graph;
+	Node node = {InternName (key, length), 0, 0, false, (int)nodes.size()};
+	nodes.push_back(node);
 
-	assert (retval->graph != NULL);
-	
-	return retval;
+	unsigned int hash = HashString (key, length);
+	size_t mask = table.size() - 1;
+	size_t pos = hash & mask;
+	while (table[pos].node != NULL)
+		pos = (pos + 1) & mask;
+	table[pos].hash = hash;
+	table[pos].node = &nodes.back();
+	return &nodes.back();
 }
 
-/* 
- * merges the strings in order to get a unique key identifying
- * this pair, using which the binary tree will be sorted.
- *
- * would be better to alternate characters from str1 and str2
- * instead of just concatenating the strings 
- */
-int MergeStrings (const char * str1, const char * str2)
+/* remove bad characters from names, should move somewhere else probably */
+size_t FixName (const char * name, size_t length)
 {
-        int retval = 0;
-        while (*str1 != '\0')
-                retval += *str1++;
-        while (*str2 != '\0')
-                retval += *str2++;
-        return retval;
+	// Node names may not end with '\' or '/'
+	while ((length > 0)
+		&& ((name[length-1] == '\\') || (name[length-1] == '/')))
+	{
+		length--;
+	}
+	return length;
 }
 
-Edge * newEdge (Node * from, Node * to, Edge * next = NULL)
+Node * getNode (const char * name, size_t length, NodeHashTbl * nodehash)
 {
-	Edge * retval = (Edge *) malloc (sizeof(Edge));
+	length = FixName(name, length);
 
-	assert (from->name != NULL);
-	assert (to->name != NULL);
+	Node * retval = nodehash->get(name, length);
 
-	retval->from = from;
-	retval->to = to;
-	retval->next = next;
-	retval->key = MergeStrings(from->name, to->name);
+	if (retval == NULL)
+	{
+		retval = nodehash->add(name, length);
+	}
 
 	return retval;
 }
 
-void addEdge (Graph * g, Node * from, Node * to)
+static size_t HashEdge (Node * from, Node * to)
 {
-	Edge * current_edge = g->edges;
+	uint64_t key = (uint64_t)(uintptr_t)from * 0x9E3779B97F4A7C15ull
+		^ (uint64_t)(uintptr_t)to;
+	key ^= key >> 29;
+	key *= 0xBF58476D1CE4E5B9ull;
+	key ^= key >> 32;
+	return (size_t)key;
+}
 
-	if (current_edge == NULL)
+AnnotatedEdge * EdgeHashTbl::get (std::vector<AnnotatedEdge> & edges, Node * from, Node * to)
+{
+	size_t mask = table.size() - 1;
+	size_t pos = HashEdge (from, to) & mask;
+	while (table[pos] >= 0)
 	{
-		g->edges = newEdge(from, to);
-		return;
+		AnnotatedEdge * edge = &edges[table[pos]];
+		if (edge->from == from && edge->to == to)
+			return edge;
+		pos = (pos + 1) & mask;
 	}
 
-	while (current_edge->next != NULL)
+	// load factor stays at most 1/2
+	if ((edges.size() + 1) * 2 > table.size())
 	{
-		current_edge = current_edge->next;
+		table.resize(table.size() * 2);
+		rebuild (edges);
+		return get (edges, from, to);
 	}
-
-	current_edge->next = newEdge(from, to);
-}
-
-AnnotatedEdge * newAnnotatedEdge (Edge * e, AnnotatedEdge * next = NULL)
-{
-	AnnotatedEdge * retval = (AnnotatedEdge *) malloc (sizeof(AnnotatedEdge));
-	retval->from = e->from;
-	retval->to = e->to;
-	retval->next = next;
-	retval->n_taken = 1;
-
-	return retval;
+	AnnotatedEdge edge = {from, to, 0};
+	table[pos] = (int)edges.size();
+	edges.push_back(edge);
+	return &edges.back();
 }
 
-// Returns 0 if equal names
-bool CompareNodes (Node * a, Node * b)
+void EdgeHashTbl::rebuild (const std::vector<AnnotatedEdge> & edges)
 {
-	assert (a->name != NULL);
-	assert (b->name != NULL);
-	return strcmp (a->name, b->name);
-}
-
-// Returns 0 if equal
-bool CompareEdges (Edge * a, AnnotatedEdge * b)
-{
-	return (CompareNodes (a->from, b->from) 
-			|| CompareNodes (a->to, b->to));
-}
-
-/* 
- * Looks for the AnnotatedEdge in the tree corresponding
- * to the Edge provided 
- */
-AnnotatedEdge * GetEdgeFromTree(BinaryTree * root, Edge * edge)
-{
-        AnnotatedEdge * temp;
-        if (! (temp = (AnnotatedEdge*)(root->get ((void*)&(edge->key)))))
-        {
-                return NULL;
-        }
-        while (temp != NULL)
-        {
-                if (CompareEdges(edge, temp) == 0)
-                        return temp;
-                temp = temp->next;
-        }
-        return NULL;
+	while (edges.size() * 2 > table.size())
+		table.resize(table.size() * 2);
+	table.assign(table.size(), -1);
+	size_t mask = table.size() - 1;
+	for (size_t i = 0; i < edges.size(); i++)
+	{
+		size_t pos = HashEdge (edges[i].from, edges[i].to) & mask;
+		while (table[pos] >= 0)
+			pos = (pos + 1) & mask;
+		table[pos] = (int)i;
+	}
 }
 
-/*
- * convert an Edge to an AnnotatedEdge and
- * insert it in the tree
- */     
-void InsertEdgeInTree(BinaryTree * tree, Edge * edge)
+void addAnnotatedEdge (AnnotatedGraph * g, Node * from, Node * to, int n_taken)
 {
-#ifdef DEBUG
-        assert (GetEdgeFromTree(tree, edge) == NULL);
-#endif  
-        void * key = &(edge->key);
-        AnnotatedEdge * list;
-
-        if (list = (AnnotatedEdge*)tree->get(key))
-        {
-                list->next = newAnnotatedEdge(edge, list->next);
-        }
-        else
-        {
-                tree->put(key, (void *)newAnnotatedEdge(edge));
-        }
+	g->edgehash.get(g->edges, from, to)->n_taken += n_taken;
 }
 
-void addAnnotatedEdge(AnnotatedGraph * g, Edge * edge)
+std::vector<Node *> mergeGraph (AnnotatedGraph * g, NodeHashTbl * nodehash,
+		AnnotatedGraph * other, NodeHashTbl * other_nodes)
 {
-	AnnotatedEdge * this_edge = NULL;
-	AnnotatedEdge * last_edge = NULL;
-	BinaryTree * tree = g->edgetree;
-
-        if (this_edge = GetEdgeFromTree(tree, edge))
-        {
-                this_edge->n_taken++;
-        }
-        else
-        {
-                InsertEdgeInTree(tree, edge);
-        }
+	std::vector<Node *> nodes (other_nodes->count());
+	for (int i = 0; i < other_nodes->count(); i++)
+	{
+		Node * other_node = other_nodes->at(i);
+		Node * node = nodehash->get(other_node->name, strlen(other_node->name));
+		if (node == NULL)
+			node = nodehash->add(other_node->name, strlen(other_node->name));
+		node->start += other_node->start;
+		node->end += other_node->end;
+		nodes[i] = node;
+	}
 
+	for (size_t i = 0; i < other->edges.size(); i++)
+	{
+		AnnotatedEdge & edge = other->edges[i];
+		addAnnotatedEdge (g, nodes[edge.from->index], nodes[edge.to->index], edge.n_taken);
+	}
+	return nodes;
 }
 
-int CompareKey(const void * leftp, const void * rightp)
+// Orders edges by the names of their nodes
+bool CompareEdges (const AnnotatedEdge & a, const AnnotatedEdge & b)
 {
-        int left  = *(int*)leftp;
-        int right = *(int*)rightp;
-
-        if (left < right)
-                return -1;
-        else if (left > right)
-                return 1;
-        else
-                return 0;
+	if (a.from != b.from)
+		return strcmp (a.from->name, b.from->name) < 0;
+	if (a.to != b.to)
+		return strcmp (a.to->name, b.to->name) < 0;
+	return false;
 }
 
-AnnotatedGraph * summarize (GraphList g, Config * config)
+void sortEdges (AnnotatedGraph * g)
 {
-	AnnotatedGraph * retval = (AnnotatedGraph *) malloc (sizeof(AnnotatedGraph));
-	int count = 1;
-
-	retval->edgetree = new BinaryTree(CompareKey);
-
-	GraphListNode * current_graphlistnode = g;
-
-	while (current_graphlistnode != NULL)
-	{
-		assert (current_graphlistnode->graph != NULL);
-
-		current_graphlistnode->graph->start->start++;
-
-		Edge * current_edge = current_graphlistnode->graph->edges;
-		Node * last_node = NULL;
-
-		if (current_edge == NULL)
-		{
-			last_node = current_graphlistnode->graph->start;
-		}
-
-		while (current_edge != NULL)
-		{
-			last_node = current_edge->to;
-			addAnnotatedEdge(retval, current_edge);
-			current_edge = current_edge->next;
-		}
-
-		last_node->end++;
-
-		current_graphlistnode = current_graphlistnode->next;
-	}
-	return retval;
+	std::sort (g->edges.begin(), g->edges.end(), CompareEdges);
+	g->edgehash.rebuild (g->edges);
 }
@@ -2,119 +2,121 @@
 #define GRAPH_H
 
 #include <stdio.h>
+#include <stddef.h>
+#include <deque>
+#include <vector>
 #include "config.h"
-#include "binarytree.h"
-
-#define N_PAGES 50
 
 struct Node
 {
-	char * name;
+	const char * name;
 	int start;
 	int end;
 	int used;
+	/* position in the order of insertion into the NodeHashTbl */
+	int index;
 };
 
-struct NodeListNode
-{
-	Node * node;
-	NodeListNode * next;
-};
-
-class HashNode
-{
-public:
-        HashNode (char* n_key, Node* n_node, HashNode* n_next)
-        {
-                key = n_key;
-                node = n_node;
-                next = n_next;
-        }
-	void walk (void (*func)(void *, void *), void *);
-
-        char * key;
-        Node * node;
-        HashNode * next;
-};
-
+/*
+ * Open addressing hash table (linear probing) of nodes by name.
+ * Every name is stored once, in an arena owned by the table, so nodes
+ * can be compared by pointer. Nodes are walked in order of insertion.
+ */
 class NodeHashTbl
 {
 public:
-        NodeHashTbl (int n_size);
-        ~NodeHashTbl ()
-        {
-                free (table);
-        }
-
-        void add (char * key, Node * content);
-        Node * get (char * key);
-        int size;
-        HashNode ** table;
+	NodeHashTbl (int n_size);
+	~NodeHashTbl ();
+
+	Node * get (const char * key, size_t length);
+	/* the key must not be in the table yet */
+	Node * add (const char * key, size_t length);
+	int count () const
+	{
+		return (int)nodes.size();
+	}
+	Node * at (int index)
+	{
+		return &nodes[index];
+	}
 	void walk (void (*func)(void *, void *), void *);
 private:
-        unsigned int HashString (const char * str);
-        NodeHashTbl();
-        NodeHashTbl(const NodeHashTbl &);
+	struct Slot
+	{
+		unsigned int hash;
+		Node * node;
+	};
+
+	static unsigned int HashString (const char * str, size_t length);
+	const char * InternName (const char * key, size_t length);
+	void Grow ();
+
+	std::vector<Slot> table;
+	std::deque<Node> nodes;
+	std::vector<char *> name_blocks;
+	size_t block_used;
+	size_t block_size;
+
+	NodeHashTbl (const NodeHashTbl &);
+	NodeHashTbl & operator= (const NodeHashTbl &);
 };
 
-struct Edge
+struct AnnotatedEdge
 {
 	Node * from;
 	Node * to;
-	Edge * next;
-
-	int key;
-};
-
-struct AnnotatedEdge 
-{
-	Node * from;
-	Node * to;
-	AnnotatedEdge * next;
 	int n_taken;
 };
 
-struct Graph
+/*
+ * Open addressing table from a pair of nodes to the index
+ * of the corresponding edge in a flat array of edges
+ */
+class EdgeHashTbl
 {
-	char * name;
-	Node * start;
-	Edge * edges;
-};
+public:
+	EdgeHashTbl ()
+		: table(1024, -1)
+	{
+	}
 
-struct AnnotatedGraph 
-{
-	BinaryTree * edgetree;
+	/* returns the edge, adding it to edges with n_taken = 0 if needed */
+	AnnotatedEdge * get (std::vector<AnnotatedEdge> & edges, Node * from, Node * to);
+	/* must be called after the edges are reordered */
+	void rebuild (const std::vector<AnnotatedEdge> & edges);
+
+private:
+	std::vector<int> table;
 };
 
-struct GraphListNode
+/* every distinct edge once with the number of times it was taken */
+struct AnnotatedGraph
 {
-	Graph * graph;
-	GraphListNode * next;
+	std::vector<AnnotatedEdge> edges;
+	EdgeHashTbl edgehash;
 };
 
-typedef struct GraphListNode * GraphList;
-typedef struct NodeListNode * NodeList;
-
 /*
  * Takes the name of a node and returns the node with that name, or, if that node doesn't
  * exist, adds a node with that name to the global nodelist.
  */
-Node * getNode (char * name, NodeHashTbl * nodehash);
+Node * getNode (const char * name, size_t length, NodeHashTbl * nodehash);
 
 /*
- * Creates a GraphListNode with an empty graph
+ * Adds n_taken to the count of the edge, adding the edge if needed
  */
-GraphListNode * newGraphListNode (GraphListNode * next, Node * start);
-
-void addEdge (Graph * graph, Node * from, Node * to);
+void addAnnotatedEdge (AnnotatedGraph * g, Node * from, Node * to, int n_taken);
 
 /*
- * adds an edge to an annotated graph, at the same time
- * converting it to an annotated edge and counting the number
- * of times it occurs.
+ * Adds all nodes and edges of another graph, whose nodes belong to another table.
+ * Returns the nodes of nodehash corresponding to the nodes of other_nodes, by index.
  */
-void addAnnotatedEdge(AnnotatedGraph * g, Edge * edge);
+std::vector<Node *> mergeGraph (AnnotatedGraph * g, NodeHashTbl * nodehash,
+		AnnotatedGraph * other, NodeHashTbl * other_nodes);
 
-AnnotatedGraph * summarize (GraphList g, Config * config);
+/*
+ * Sorts the edges by the names of their nodes
+ */
+void sortEdges (AnnotatedGraph * g);
 
 #endif
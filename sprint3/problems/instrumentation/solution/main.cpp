@@ -2,26 +2,47 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <thread>
 #include "graph.h"
 #include "readfile.h"
 #include "dotgen.h"
 #include "config.h"
+#include "state.h"
 
 void printUsage()
 {
-	fprintf(stderr, "events2dot <eventsfile>\n");
+	fprintf(stderr, "events2dot [-j <threads>] [-s <statefile>] <eventsfile>...\n");
+	fprintf(stderr, "  -j  number of threads parsing each events file, all cores by default\n");
+	fprintf(stderr, "  -s  add the events files to the graph saved in statefile and save it back,\n");
+	fprintf(stderr, "      so later runs only need the new events files\n");
 }
 
 int main (int argc, char ** argv)
 {
 	NodeHashTbl * nodehash = new NodeHashTbl (255);
-	GraphList g;
+	AnnotatedGraph * ag = new AnnotatedGraph;
+	unsigned threads = std::thread::hardware_concurrency();
+	const char * state_file = NULL;
 
-	if ((argc != 2) 
-		|| (strcmp(argv[1], "--help") == 0)
-		|| (strcmp(argv[1], "-help") == 0)
-		|| (strcmp(argv[1], "-?") == 0)
-		|| (strcmp(argv[1], "-h") == 0))
+	int arg = 1;
+	for (; arg < argc && argv[arg][0] == '-'; arg++)
+	{
+		if ((strcmp(argv[arg], "-j") == 0) && (arg + 1 < argc))
+		{
+			threads = atoi(argv[++arg]);
+		}
+		else if ((strcmp(argv[arg], "-s") == 0) && (arg + 1 < argc))
+		{
+			state_file = argv[++arg];
+		}
+		else
+		{
+			printUsage();
+			exit(0);
+		}
+	}
+
+	if ((arg == argc) && (state_file == NULL))
 	{
 		printUsage();
 		exit(0);
@@ -30,9 +51,14 @@ int main (int argc, char ** argv)
 	Config * config;
 	config = ReadConfig ("pathalizer.conf");
 
-	g = getGraphFromFile(argv[1], nodehash, config);
+	if (state_file != NULL)
+		loadState(state_file, ag, nodehash);
+
+	for (; arg < argc; arg++)
+		getGraphFromFile(argv[arg], threads, ag, nodehash, config);
 
-	AnnotatedGraph * ag = summarize(g, config);
+	if (state_file != NULL)
+		saveState(state_file, ag, nodehash);
 
 	GenerateDot (stdout, ag, nodehash, config);
 
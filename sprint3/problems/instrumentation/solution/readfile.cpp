@@ -1,65 +1,215 @@
 #include "readfile.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <thread>
+#include <vector>
+
 #undef DEBUG
 
-GraphList getGraphFromFile (char * file, NodeHashTbl * nodehash, Config * config)
+/* a chunk smaller than this is not worth a thread */
+#define MIN_CHUNK_SIZE (1 << 20)
+
+/* everything one thread learns from its part of the file */
+struct Chunk
 {
-	FILE * in;
-	GraphListNode * current_graphlistnode = NULL;
+	Chunk ()
+		: nodehash(255), first_session(NULL), first_session_length(0),
+		  last_session(NULL), last_session_length(0), first_node(NULL), last_node(NULL)
+	{
+	}
+
+	NodeHashTbl nodehash;
+	AnnotatedGraph graph;
+
+	/* the sessions at both ends of the chunk, which may continue in the neighbours */
+	const char * first_session;
+	size_t first_session_length;
+	const char * last_session;
+	size_t last_session_length;
+	Node * first_node;
+	Node * last_node;
+};
+
+static bool IsSpace (char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+/*
+ * Splits the next whitespace separated field off the line.
+ * Returns false if the line has no more fields.
+ */
+static bool NextField (const char ** pos, const char * line_end, const char ** field, size_t * length)
+{
+	const char * p = *pos;
+	while (p < line_end && IsSpace(*p))
+		p++;
+	if (p == line_end)
+		return false;
+	*field = p;
+	while (p < line_end && !IsSpace(*p))
+		p++;
+	*length = p - *field;
+	*pos = p;
+	return true;
+}
+
+static void ParseChunk (const char * begin, const char * end, Chunk * chunk, Config * config)
+{
+	Node * last_node = NULL;
+	const char * session = NULL;
+	size_t session_length = 0;
+
+	const char * line = begin;
+	while (line < end)
+	{
+		const char * line_end = (const char *) memchr (line, '\n', end - line);
+		if (line_end == NULL)
+			line_end = end;
+
+		const char * pos = line;
+		const char * line_session;
+		size_t line_session_length;
+		const char * timestamp;
+		size_t timestamp_length;
+		const char * name;
+		size_t name_length;
+		line = line_end + 1;
+
+		// lines without all three fields are skipped
+		if (!NextField(&pos, line_end, &line_session, &line_session_length)
+				|| !NextField(&pos, line_end, &timestamp, &timestamp_length)
+				|| !NextField(&pos, line_end, &name, &name_length))
+			continue;
+
+		Node * current_node = getNode(name, name_length, &chunk->nodehash);
+
+		if (session == NULL
+				|| line_session_length != session_length
+				|| memcmp(line_session, session, session_length) != 0)
+		{
+			if (session == NULL)
+			{
+				chunk->first_session = line_session;
+				chunk->first_session_length = line_session_length;
+				chunk->first_node = current_node;
+			}
+			else
+			{
+				last_node->end++;
+			}
+			session = line_session;
+			session_length = line_session_length;
+			current_node->start++;
+		}
+		else if ((!config->ignore_refresh) // if false, just add the edge
+				|| (last_node != current_node))
+		{
+			addAnnotatedEdge(&chunk->graph, last_node, current_node, 1);
+		}
+		last_node = current_node;
+	}
 
-	in = fopen (file, "r");
+	if (last_node != NULL)
+	{
+		last_node->end++;
+		chunk->last_session = session;
+		chunk->last_session_length = session_length;
+		chunk->last_node = last_node;
+	}
+}
+
+void getGraphFromFile (const char * file, unsigned threads, AnnotatedGraph * graph,
+		NodeHashTbl * nodehash, Config * config)
+{
+	int fd = open (file, O_RDONLY);
+	struct stat st;
 
-	if (in == NULL)
+	if (fd < 0 || fstat (fd, &st) < 0)
 	{
-		char * error = "Error opening file with events ('";
+		const char * error = "Error opening file with events ('";
 		char * errmsg = (char *) malloc (strlen(error) + strlen(file) + 2 + 1);
 		sprintf(errmsg, "%s%s')", error, file);
 		perror(errmsg);
 		exit(0);
 	};
 
-	char buffer[BUFSIZE];
-	char session[BUFSIZE];
-	int timestamp;
-	char name[BUFSIZE];
-
-	char * current_session = (char *) malloc (1); // so we can free it
-	Node * last_node = NULL;
-	Node * current_node = NULL;
+	size_t size = st.st_size;
+	if (size == 0)
+	{
+		close (fd);
+		return;
+	}
 
-#ifdef DEBUG
-	fprintf(stderr, "Ignoring refreshes: %d", config->ignore_refresh);
-#endif
+	const char * data = (const char *) mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close (fd);
+	if (data == MAP_FAILED)
+	{
+		perror("mmap");
+		exit(0);
+	}
+	madvise ((void *)data, size, MADV_SEQUENTIAL);
 
-	// while (fscanf(in, "%s\t%d\t%s\n", &session, &timestamp, &name) > 0)
-	while (fgets (buffer, BUFSIZE, in))
+	// one chunk per thread, every chunk ends after a newline
+	if (threads < 1)
+		threads = 1;
+	size_t n_chunks = size / MIN_CHUNK_SIZE + 1;
+	if (n_chunks > threads)
+		n_chunks = threads;
+	std::vector<const char *> bounds;
+	bounds.push_back(data);
+	for (size_t i = 1; i < n_chunks; i++)
 	{
-		if (!sscanf(buffer, "%s\t%d\t%s\n", &session, &timestamp, &name))
-			break;
+		const char * bound = data + size / n_chunks * i;
+		if (bound < bounds.back())
+			bound = bounds.back();
+		const char * newline = (const char *) memchr (bound, '\n', data + size - bound);
+		bounds.push_back(newline == NULL ? data + size : newline + 1);
+	}
+	bounds.push_back(data + size);
 
-		last_node = current_node;
+	std::vector<Chunk *> chunks;
+	for (size_t i = 0; i < n_chunks; i++)
+		chunks.push_back(new Chunk);
 
-#ifdef DEBUG
-		fprintf(stderr, "Session %s, node %s\n", session, name);
-#endif
-		current_node = getNode(name, nodehash);
+	std::vector<std::thread> workers;
+	for (size_t i = 1; i < n_chunks; i++)
+		workers.push_back(std::thread(ParseChunk, bounds[i], bounds[i + 1], chunks[i], config));
+	ParseChunk (bounds[0], bounds[1], chunks[0], config);
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
 
-		if (strcmp(session, current_session) != 0)
-		{
-			free (current_session);
-			current_session = strdup(session);
-			// TODO maybe check for graphs without edges?
-			current_graphlistnode = newGraphListNode(current_graphlistnode, current_node);
-		}
-		else
+	// merged in file order, so that sessions cut by a boundary can be joined
+	Node * last_node = NULL;
+	const char * last_session = NULL;
+	size_t last_session_length = 0;
+	for (size_t i = 0; i < n_chunks; i++)
+	{
+		Chunk * chunk = chunks[i];
+		std::vector<Node *> nodes = mergeGraph (graph, nodehash, &chunk->graph, &chunk->nodehash);
+
+		if (chunk->first_node != NULL)
 		{
-			if ((!config->ignore_refresh) // if false, just add the edge
-					|| (strcmp(last_node->name, current_node->name) != 0))
+			Node * first_node = nodes[chunk->first_node->index];
+			if (last_session != NULL
+					&& chunk->first_session_length == last_session_length
+					&& memcmp(chunk->first_session, last_session, last_session_length) == 0)
 			{
-				addEdge(current_graphlistnode->graph, last_node, current_node);
+				// the session goes on: neither an end nor a start at the boundary
+				last_node->end--;
+				first_node->start--;
+				if ((!config->ignore_refresh) || (last_node != first_node))
+					addAnnotatedEdge(graph, last_node, first_node, 1);
 			}
+			last_node = nodes[chunk->last_node->index];
+			last_session = chunk->last_session;
+			last_session_length = chunk->last_session_length;
 		}
+		delete chunk;
 	}
 
-	return current_graphlistnode;
+	munmap ((void *)data, size);
 }
@@ -5,6 +5,15 @@
 #include "graph.h"
 #include "config.h"
 
-#define BUFSIZE 255
-
-GraphList getGraphFromFile (char * file, NodeHashTbl * nodelist, Config * config);
+/*
+ * Reads the events file, one "session<TAB>timestamp<TAB>name" line per event,
+ * and adds its sessions to the annotated graph. Consecutive lines of the same
+ * session form one path: the first node is a start, the last one an end.
+ *
+ * The file is mapped into memory and split at line boundaries into one chunk
+ * per thread. Every chunk is parsed into its own node table and edge counts,
+ * which are merged in order; a session cut by a chunk boundary is stitched
+ * back during the merge.
+ */
+void getGraphFromFile (const char * file, unsigned threads, AnnotatedGraph * graph,
+		NodeHashTbl * nodehash, Config * config);
@@ -0,0 +1,103 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "state.h"
+
+#define STATE_HEADER "pathalizer-state 1\n"
+
+static void BadState (const char * file)
+{
+	fprintf(stderr, "Malformed state file ('%s')\n", file);
+	exit(1);
+}
+
+bool loadState (const char * file, AnnotatedGraph * graph, NodeHashTbl * nodehash)
+{
+	FILE * in = fopen (file, "r");
+	if (in == NULL)
+	{
+		if (errno == ENOENT)
+			return false;
+		perror(file);
+		exit(1);
+	}
+
+	char * line = NULL;
+	size_t capacity = 0;
+	ssize_t length;
+	long count;
+
+	if (getline(&line, &capacity, in) < 0 || strcmp(line, STATE_HEADER) != 0)
+		BadState(file);
+
+	if (getline(&line, &capacity, in) < 0 || sscanf(line, "nodes %ld", &count) != 1 || count < 0)
+		BadState(file);
+	std::vector<Node *> nodes;
+	nodes.reserve(count);
+	for (long i = 0; i < count; i++)
+	{
+		int start, end, name_offset;
+		if ((length = getline(&line, &capacity, in)) < 0)
+			BadState(file);
+		if (line[length - 1] == '\n')
+			line[--length] = '\0';
+		if (sscanf(line, "%d %d %n", &start, &end, &name_offset) != 2)
+			BadState(file);
+		Node * node = getNode(line + name_offset, length - name_offset, nodehash);
+		node->start += start;
+		node->end += end;
+		nodes.push_back(node);
+	}
+
+	if (getline(&line, &capacity, in) < 0 || sscanf(line, "edges %ld", &count) != 1 || count < 0)
+		BadState(file);
+	for (long i = 0; i < count; i++)
+	{
+		long from, to;
+		int n_taken;
+		if (getline(&line, &capacity, in) < 0
+				|| sscanf(line, "%ld %ld %d", &from, &to, &n_taken) != 3
+				|| from < 0 || from >= (long)nodes.size()
+				|| to < 0 || to >= (long)nodes.size())
+			BadState(file);
+		addAnnotatedEdge(graph, nodes[from], nodes[to], n_taken);
+	}
+
+	free (line);
+	fclose (in);
+	return true;
+}
+
+void saveState (const char * file, AnnotatedGraph * graph, NodeHashTbl * nodehash)
+{
+	std::string tmp_file = std::string(file) + ".tmp";
+	FILE * out = fopen (tmp_file.c_str(), "w");
+	if (out == NULL)
+	{
+		perror(tmp_file.c_str());
+		exit(1);
+	}
+
+	fputs(STATE_HEADER, out);
+	fprintf(out, "nodes %d\n", nodehash->count());
+	for (int i = 0; i < nodehash->count(); i++)
+	{
+		Node * node = nodehash->at(i);
+		fprintf(out, "%d %d %s\n", node->start, node->end, node->name);
+	}
+	fprintf(out, "edges %zu\n", graph->edges.size());
+	for (size_t i = 0; i < graph->edges.size(); i++)
+	{
+		AnnotatedEdge & edge = graph->edges[i];
+		fprintf(out, "%d %d %d\n", edge.from->index, edge.to->index, edge.n_taken);
+	}
+
+	if (fclose (out) != 0 || rename (tmp_file.c_str(), file) != 0)
+	{
+		perror(file);
+		exit(1);
+	}
+}
@@ -0,0 +1,31 @@
+#ifndef STATE_H
+#define STATE_H
+
+#include "graph.h"
+
+/*
+ * The annotated graph can be saved between runs, so that new events files
+ * are added to it without parsing the old ones again. Sessions never
+ * continue from one events file into the next.
+ *
+ * The state is a text file:
+ *   pathalizer-state 1
+ *   nodes <count>
+ *   <start> <end> <name>        one line per node
+ *   edges <count>
+ *   <from> <to> <n_taken>       one line per edge, nodes by their line number from 0
+ */
+
+/*
+ * Adds the saved graph to an empty graph and node table.
+ * Returns false if the file doesn't exist, exits on a malformed file.
+ */
+bool loadState (const char * file, AnnotatedGraph * graph, NodeHashTbl * nodehash);
+
+/*
+ * Writes the graph to a temporary file and renames it over the state file,
+ * so an interrupted run leaves the previous state intact
+ */
+void saveState (const char * file, AnnotatedGraph * graph, NodeHashTbl * nodehash);
+
+#endif
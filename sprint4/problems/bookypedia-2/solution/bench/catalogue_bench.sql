@@ -0,0 +1,151 @@
+-- Замер запросов списка книг на каталоге из миллиона книг.
+-- Запуск: psql "$BOOKYPEDIA_DB_URL" -f bench/catalogue_bench.sql
+-- Всё создаётся в отдельной схеме bench и удаляется в конце.
+-- Для раздела поиска нужно расширение pg_trgm.
+
+\timing on
+SET client_min_messages = warning;
+
+DROP SCHEMA IF EXISTS bench CASCADE;
+CREATE SCHEMA bench;
+SET search_path = bench, public;
+
+CREATE TABLE authors (
+    id UUID PRIMARY KEY,
+    name varchar(100) NOT NULL UNIQUE
+);
+
+CREATE TABLE books (
+    id UUID PRIMARY KEY,
+    author_id UUID REFERENCES authors(id),
+    title VARCHAR(100) NOT NULL,
+    publication_year INT
+);
+
+CREATE TABLE book_tags (
+    book_id UUID REFERENCES books(id),
+    tag varchar(30) NOT NULL
+);
+
+-- 10 тысяч авторов, миллион книг, у книги от нуля до трёх тегов
+INSERT INTO authors (id, name)
+SELECT md5('author' || i)::uuid, 'Author ' || i FROM generate_series(1, 10000) AS i;
+
+INSERT INTO books (id, author_id, title, publication_year)
+SELECT md5('book' || i)::uuid, a.id, 'Book ' || (i % 200000), 1900 + i % 120
+FROM generate_series(1, 1000000) AS i
+JOIN (SELECT id, row_number() OVER () AS n FROM authors) AS a ON a.n = 1 + i % 10000;
+
+INSERT INTO book_tags (book_id, tag)
+SELECT books.id, 'tag ' || t
+FROM books, generate_series(1, 3) AS t
+WHERE t <= abs(hashtext(books.id::text)) % 4;
+
+ANALYZE;
+
+\echo '=== Without indexes ==='
+
+\echo 'Books by title, tags queried per book (one of N queries)'
+EXPLAIN (ANALYZE, COSTS OFF)
+SELECT books.id, books.title, authors.name, books.publication_year
+FROM books JOIN authors ON books.author_id = authors.id
+WHERE books.title = 'Book 4242';
+
+EXPLAIN (ANALYZE, COSTS OFF)
+SELECT tag FROM book_tags WHERE book_id = (SELECT id FROM books WHERE title = 'Book 4242' LIMIT 1);
+
+\echo 'Books by author'
+EXPLAIN (ANALYZE, COSTS OFF)
+SELECT id, title FROM books WHERE author_id = (SELECT id FROM authors WHERE name = 'Author 77');
+
+CREATE INDEX books_title_idx ON books (title);
+CREATE INDEX books_author_id_idx ON books (author_id);
+CREATE INDEX book_tags_book_id_idx ON book_tags (book_id);
+ANALYZE;
+
+\echo '=== With indexes ==='
+
+\echo 'Books by title with tags in one query'
+EXPLAIN (ANALYZE, COSTS OFF)
+SELECT books.id, books.title, authors.name, books.publication_year,
+       string_agg(book_tags.tag, ', ' ORDER BY book_tags.tag)
+FROM books
+JOIN authors ON books.author_id = authors.id
+LEFT JOIN book_tags ON book_tags.book_id = books.id
+WHERE books.title = 'Book 4242'
+GROUP BY books.id, authors.name
+ORDER BY books.title ASC, authors.name ASC, books.publication_year ASC;
+
+\echo 'Tags of one book'
+EXPLAIN (ANALYZE, COSTS OFF)
+SELECT string_agg(tag, ', ' ORDER BY tag) FROM book_tags
+WHERE book_id = (SELECT id FROM books WHERE title = 'Book 4242' LIMIT 1);
+
+\echo 'Books by author'
+EXPLAIN (ANALYZE, COSTS OFF)
+SELECT id, title FROM books WHERE author_id = (SELECT id FROM authors WHERE name = 'Author 77');
+
+\echo 'All books with tags in one query'
+EXPLAIN (ANALYZE, COSTS OFF)
+SELECT books.id, books.title, authors.name, books.publication_year,
+       string_agg(book_tags.tag, ', ' ORDER BY book_tags.tag)
+FROM books
+JOIN authors ON books.author_id = authors.id
+LEFT JOIN book_tags ON book_tags.book_id = books.id
+GROUP BY books.id, authors.name
+ORDER BY books.title ASC, authors.name ASC, books.publication_year ASC;
+
+\echo 'Page of 100 books after a given book (keyset)'
+EXPLAIN (ANALYZE, COSTS OFF)
+SELECT page.id, page.title, page.name, page.publication_year,
+       (SELECT string_agg(tag, ', ' ORDER BY tag) FROM book_tags WHERE book_id = page.id)
+FROM (
+    SELECT books.id, books.title, authors.name, books.publication_year
+    FROM books
+    JOIN authors ON books.author_id = authors.id
+    WHERE books.title >= 'Book 4242'
+      AND (books.title, authors.name, books.publication_year, books.id)
+          > ('Book 4242', 'Author 77', 1950, '00000000-0000-0000-0000-000000000000'::uuid)
+    ORDER BY books.title ASC, authors.name ASC, books.publication_year ASC, books.id ASC
+    LIMIT 100
+) AS page
+ORDER BY page.title ASC, page.name ASC, page.publication_year ASC, page.id ASC;
+
+\echo 'Page of 100 authors'
+EXPLAIN (ANALYZE, COSTS OFF)
+SELECT id, name FROM authors WHERE name > 'Author 5000' ORDER BY name ASC LIMIT 100;
+
+\echo '=== Search ==='
+
+CREATE EXTENSION IF NOT EXISTS pg_trgm SCHEMA bench;
+\echo 'Trigram indexes build time'
+CREATE INDEX books_title_trgm_idx ON books USING GIN (title gin_trgm_ops);
+CREATE INDEX authors_name_trgm_idx ON authors USING GIN (name gin_trgm_ops);
+ANALYZE;
+
+\echo 'Search by part of title or author name, 20 best matches'
+EXPLAIN (ANALYZE, COSTS OFF)
+WITH matched AS (
+    SELECT books.id FROM books
+    WHERE books.title ILIKE '%ok 4242%' OR books.title % 'ok 4242'
+    UNION
+    SELECT books.id FROM authors JOIN books ON books.author_id = authors.id
+    WHERE authors.name ILIKE '%ok 4242%' OR authors.name % 'ok 4242'
+)
+SELECT books.id, books.title, authors.name, books.publication_year,
+       (SELECT string_agg(tag, ', ' ORDER BY tag) FROM book_tags WHERE book_id = books.id)
+FROM matched
+JOIN books ON books.id = matched.id
+JOIN authors ON books.author_id = authors.id
+ORDER BY GREATEST(word_similarity('ok 4242', books.title), word_similarity('ok 4242', authors.name)) DESC,
+         books.title ASC, authors.name ASC, books.publication_year ASC, books.id ASC
+LIMIT 20;
+
+\echo 'Same search without the trigram indexes'
+DROP INDEX books_title_trgm_idx;
+DROP INDEX authors_name_trgm_idx;
+EXPLAIN (ANALYZE, COSTS OFF)
+SELECT books.id FROM books WHERE books.title ILIKE '%ok 4242%' OR books.title % 'ok 4242';
+
+RESET search_path;
+DROP SCHEMA bench CASCADE;
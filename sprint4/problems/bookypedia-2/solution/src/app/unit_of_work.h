@@ -0,0 +1,30 @@
+#pragma once
+#include <memory>
+
+#include "../domain/author.h"
+#include "../domain/book.h"
+#include "../domain/tag.h"
+
+namespace app {
+
+// Все репозитории работают внутри одной транзакции.
+// Изменения сохраняются только после Commit, иначе откатываются при уничтожении
+class UnitOfWork {
+public:
+    virtual void Commit() = 0;
+    virtual domain::AuthorRepository& Authors() = 0;
+    virtual domain::BookRepository& Books() = 0;
+    virtual domain::TagRepository& Tags() = 0;
+
+    virtual ~UnitOfWork() = default;
+};
+
+class UnitOfWorkFactory {
+public:
+    virtual std::unique_ptr<UnitOfWork> CreateUnitOfWork() = 0;
+
+protected:
+    ~UnitOfWorkFactory() = default;
+};
+
+}  // namespace app
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <iosfwd>
 #include <string>
 #include <vector>
 #include <optional>
@@ -16,18 +17,33 @@ public:
     virtual void DeleteAuthor(const std::string& id) = 0;
     virtual void EditAuthor(const std::string& id, const std::string& new_name) = 0;
     virtual std::vector<ui::detail::AuthorInfo> GetAllAuthors() = 0;
-    virtual ui::detail::BookInfo AddBook(const std::string& author_id, const std::string& title, int year) = 0;
+    virtual std::optional<std::string> GetAuthorIdByName(const std::string& name) = 0;
+    // Не больше limit авторов, следующих за after по имени. Без after — первая страница
+    virtual std::vector<ui::detail::AuthorInfo> GetAuthorsPage(const std::optional<ui::detail::AuthorInfo>& after,
+                                                               size_t limit) = 0;
+    virtual ui::detail::BookInfo AddBook(const std::string& author_id, const std::string& title, int year,
+                                         const std::set<std::string>& tags) = 0;
     virtual void DeleteBook(const std::string& id) = 0;
     virtual std::vector<ui::detail::BookInfo> GetBooksBy(const std::string& author_id) = 0;
     virtual std::vector<ui::detail::BookInfo> GetAllbooks() = 0;
-    virtual std::vector<ui::detail::BookInfoAllBooks> GetAllBooksForShow() = 0;
+    // Страница списка книг по названию, автору и году, начиная сразу после книги after.
+    // Весь каталог одним вектором не читается
+    virtual std::vector<ui::detail::BookInfoAllBooks> GetBooksPageForShow(
+        const std::optional<ui::detail::BookInfoAllBooks>& after, size_t limit) = 0;
     virtual std::vector<ui::detail::BookInfoAllBooks> GetBooksByTitle(const std::string title) = 0;
+    // Неточный поиск книг по части названия или имени автора без учёта регистра.
+    // Сначала идут лучшие совпадения, не больше limit книг
+    virtual std::vector<ui::detail::BookInfoAllBooks> SearchBooks(const std::string& query, size_t limit) = 0;
     virtual ui::detail::BookInfoAllBooks GetBookByBookId(const std::string &id) = 0;
-    virtual void AddTagsBooks(std::set<std::string>, const std::string& book_id) = 0;
     virtual std::optional<std::string> GetTagsByBookId(const std::string& title) = 0;
+    // Заменяет название, год и все теги книги
     virtual void UpdateBook(const std::string &id,
-                    const std::string& new_title, int new_year) = 0;
-    virtual void DeleteTagsByBookId(const std::string book_id) = 0 ;
+                    const std::string& new_title, int new_year, const std::set<std::string>& tags) = 0;
+    // Каталог в CSV: title,author,publication_year,tags. Неизвестные авторы добавляются.
+    // Импорт выполняется одной транзакцией
+    virtual ui::detail::CatalogStats ImportCatalog(std::istream& input) = 0;
+    // Возвращает число выгруженных книг
+    virtual size_t ExportCatalog(std::ostream& output) = 0;
 
 protected:
     ~UseCases() = default;
@@ -2,93 +2,271 @@
 #include "../domain/author.h"
 #include "../domain/book.h"
 #include "../domain/tag.h"
+#include "../util/csv.h"
 
 #include <boost/uuid/uuid_io.hpp>
 #include <string>
 #include <sstream>
 #include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
 
 
 namespace app {
 using namespace domain;
 
+namespace {
+
+std::vector<Tag> MakeTags(const BookId& book_id, const std::set<std::string>& tags_set) {
+    std::vector<Tag> tags;
+    tags.reserve(tags_set.size());
+    for (const auto& tag : tags_set) {
+        tags.emplace_back(book_id, tag);
+    }
+    return tags;
+}
+
+// Сколько книг каталога держать в памяти перед отправкой в базу
+constexpr size_t IMPORT_CHUNK_SIZE = 10'000;
+
+const std::vector<std::string> CATALOG_HEADER{"title", "author", "publication_year", "tags"};
+
+// Теги в каталоге записаны через запятую, как их выводит string_agg
+std::set<std::string> ParseCatalogTags(const std::string& tags_str) {
+    std::set<std::string> tags;
+    std::istringstream input(tags_str);
+    std::string tag;
+    while (std::getline(input, tag, ',')) {
+        const auto begin = tag.find_first_not_of(' ');
+        if (begin == std::string::npos) {
+            continue;
+        }
+        const auto end = tag.find_last_not_of(' ');
+        tags.insert(tag.substr(begin, end - begin + 1));
+    }
+    return tags;
+}
+
+int ParseCatalogYear(const std::string& year_str) {
+    size_t pos = 0;
+    int year = std::stoi(year_str, &pos);
+    if (pos != year_str.size()) {
+        throw std::invalid_argument("Invalid publication year: " + year_str);
+    }
+    return year;
+}
+
+}  // namespace
+
 void UseCasesImpl::AddAuthor(const std::string& name) {
-    authors_.Save({AuthorId::New(), name});
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
+    unit_of_work->Authors().Save({AuthorId::New(), name});
+    unit_of_work->Commit();
 }
 
 void UseCasesImpl::DeleteAuthor(const std::string &id) {
-    authors_.Delete(id);
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
+    unit_of_work->Authors().Delete(id);
+    unit_of_work->Commit();
 }
 
 void UseCasesImpl::EditAuthor(const std::string &id, const std::string &new_name) {
-    authors_.UpdateName(id, new_name);
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
+    unit_of_work->Authors().UpdateName(id, new_name);
+    unit_of_work->Commit();
 }
 
 std::vector<ui::detail::AuthorInfo> UseCasesImpl::GetAllAuthors(){
-
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
     std::vector<ui::detail::AuthorInfo> authors_info;
-    for (auto& author : authors_.GetAllAuthors()) {
+    for (auto& author : unit_of_work->Authors().GetAllAuthors()) {
         std::string id = boost::uuids::to_string(*author.GetId());
         authors_info.emplace_back(id, author.GetName());
     }
     return authors_info;
 }
 
-ui::detail::BookInfo UseCasesImpl::AddBook(const std::string& author_id, const std::string& title, int year) {
+std::optional<std::string> UseCasesImpl::GetAuthorIdByName(const std::string& name) {
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
+    if (auto id = unit_of_work->Authors().FindIdByName(name)) {
+        return id->ToString();
+    }
+    return std::nullopt;
+}
+
+std::vector<ui::detail::AuthorInfo> UseCasesImpl::GetAuthorsPage(
+        const std::optional<ui::detail::AuthorInfo>& after, size_t limit) {
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
+    std::optional<std::string> after_name;
+    if (after) {
+        after_name = after->name;
+    }
+    std::vector<ui::detail::AuthorInfo> authors_info;
+    for (auto& author : unit_of_work->Authors().GetAuthorsPage(after_name, limit)) {
+        authors_info.emplace_back(author.GetId().ToString(), author.GetName());
+    }
+    return authors_info;
+}
+
+ui::detail::BookInfo UseCasesImpl::AddBook(const std::string& author_id, const std::string& title, int year,
+                                           const std::set<std::string>& tags) {
     BookId id = BookId::New();
     ui::detail::BookInfo book{id.ToString(), title, year};
-    books_.Save({id, AuthorId::FromString(author_id), title, year});
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
+    unit_of_work->Books().Save({id, AuthorId::FromString(author_id), title, year});
+    unit_of_work->Tags().SaveAll(MakeTags(id, tags));
+    unit_of_work->Commit();
     return book;
 }
 
 void UseCasesImpl::DeleteBook(const std::string &id){
-    books_.Delete(id);
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
+    unit_of_work->Books().Delete(id);
+    unit_of_work->Commit();
 }
 
 std::vector<ui::detail::BookInfo> UseCasesImpl::GetBooksBy(const std::string& author_id) {
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
     std::vector<ui::detail::BookInfo> list_books;
-    for (const auto& book : books_.GetBooksBy(author_id)) {
+    for (const auto& book : unit_of_work->Books().GetBooksBy(author_id)) {
         list_books.emplace_back(book.GetId().ToString(), book.GetTitle(), book.GetPublicationYear());
     }
     return list_books;
 }
 
 ui::detail::BookInfoAllBooks UseCasesImpl::GetBookByBookId(const std::string &id){
-    return books_.GetBook(id);
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
+    return unit_of_work->Books().GetBook(id);
 }
 
 std::vector<ui::detail::BookInfo> UseCasesImpl::GetAllbooks() {
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
     std::vector<ui::detail::BookInfo> list_books;
-    for (const auto& book : books_.GetAllBooks()) {
+    for (const auto& book : unit_of_work->Books().GetAllBooks()) {
         list_books.emplace_back(book.GetId().ToString(), book.GetTitle(), book.GetPublicationYear());
     }
     return list_books;
 }
 
-std::vector<ui::detail::BookInfoAllBooks> UseCasesImpl::GetAllBooksForShow() {
-    return books_.GetAllBooksForShow();
+std::vector<ui::detail::BookInfoAllBooks> UseCasesImpl::GetBooksPageForShow(
+        const std::optional<ui::detail::BookInfoAllBooks>& after, size_t limit) {
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
+    return unit_of_work->Books().GetBooksPageForShow(after, limit);
 }
 
 std::vector<ui::detail::BookInfoAllBooks> UseCasesImpl::GetBooksByTitle(const std::string title){
-    return books_.GetBooksBytitle(title);
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
+    return unit_of_work->Books().GetBooksBytitle(title);
 }
 
-void UseCasesImpl::AddTagsBooks(std::set<std::string> tags_set, const std::string& book_id) {
-    for (auto& tag : tags_set) {
-        tags_.Save({BookId::FromString(book_id), tag});
+std::vector<ui::detail::BookInfoAllBooks> UseCasesImpl::SearchBooks(const std::string& query, size_t limit) {
+    // Пробелы по краям и повторные пробелы не влияют на поиск
+    std::string normalized_query;
+    std::istringstream words(query);
+    std::string word;
+    while (words >> word) {
+        if (!normalized_query.empty()) {
+            normalized_query += ' ';
+        }
+        normalized_query += word;
     }
+    if (normalized_query.empty() || limit == 0) {
+        return {};
+    }
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
+    return unit_of_work->Books().SearchBooks(normalized_query, limit);
 }
 
 std::optional<std::string> UseCasesImpl::GetTagsByBookId(const std::string &book_id){
-    return tags_.GetTagsByBookId(book_id);
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
+    return unit_of_work->Tags().GetTagsByBookId(book_id);
+}
+
+void UseCasesImpl::UpdateBook(const std::string &id, const std::string& new_title, int new_year,
+                              const std::set<std::string>& tags){
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
+    unit_of_work->Books().UpdateBook(id, new_title, new_year);
+    unit_of_work->Tags().DeleteTagsByBookId(id);
+    unit_of_work->Tags().SaveAll(MakeTags(BookId::FromString(id), tags));
+    unit_of_work->Commit();
 }
 
-void UseCasesImpl::UpdateBook(const std::string &id, const std::string& new_title, int new_year){
-    books_.UpdateBook(id, new_title, new_year);
+ui::detail::CatalogStats UseCasesImpl::ImportCatalog(std::istream& input) {
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
+    std::unordered_map<std::string, AuthorId> author_ids;
+    for (auto& author : unit_of_work->Authors().GetAllAuthors()) {
+        author_ids.emplace(author.GetName(), author.GetId());
+    }
+
+    ui::detail::CatalogStats stats;
+    std::vector<Author> authors;
+    std::vector<Book> books;
+    std::vector<Tag> tags;
+    books.reserve(IMPORT_CHUNK_SIZE);
+    auto flush = [&]() {
+        // Авторы сохраняются первыми: на них ссылаются книги
+        unit_of_work->Authors().SaveAll(authors);
+        unit_of_work->Books().SaveAll(books);
+        unit_of_work->Tags().SaveAll(tags);
+        stats.authors += authors.size();
+        stats.books += books.size();
+        stats.tags += tags.size();
+        authors.clear();
+        books.clear();
+        tags.clear();
+    };
+
+    bool first_record = true;
+    while (auto record = util::ReadCsvRecord(input)) {
+        if (std::exchange(first_record, false) && *record == CATALOG_HEADER) {
+            continue;
+        }
+        if (record->size() == 1 && record->front().empty()) {
+            continue;
+        }
+        if (record->size() != 3 && record->size() != 4) {
+            throw std::invalid_argument("Invalid catalog record: expected title,author,publication_year[,tags]");
+        }
+
+        const std::string& author_name = (*record)[1];
+        auto [author, inserted] = author_ids.try_emplace(author_name, AuthorId{});
+        if (inserted) {
+            author->second = AuthorId::New();
+            authors.emplace_back(author->second, author_name);
+        }
+
+        BookId book_id = BookId::New();
+        books.emplace_back(book_id, author->second, std::move((*record)[0]), ParseCatalogYear((*record)[2]));
+        if (record->size() == 4) {
+            for (auto& tag : ParseCatalogTags((*record)[3])) {
+                tags.emplace_back(book_id, std::move(tag));
+            }
+        }
+
+        if (books.size() >= IMPORT_CHUNK_SIZE) {
+            flush();
+        }
+    }
+    flush();
+    unit_of_work->Commit();
+    return stats;
 }
 
-void UseCasesImpl::DeleteTagsByBookId(const std::string book_id){
-    tags_.DeleteTagsByBookId(book_id);
+size_t UseCasesImpl::ExportCatalog(std::ostream& output) {
+    auto unit_of_work = unit_of_work_factory_.CreateUnitOfWork();
+    util::WriteCsvRecord(output, CATALOG_HEADER);
+    size_t count = 0;
+    std::vector<std::string> record(CATALOG_HEADER.size());
+    unit_of_work->Books().ForEachBookForShow([&](const ui::detail::BookInfoAllBooks& book) {
+        record[0] = book.title;
+        record[1] = book.author_name;
+        record[2] = std::to_string(book.publication_year);
+        record[3] = book.tags.value_or(std::string{});
+        util::WriteCsvRecord(output, record);
+        ++count;
+    });
+    return count;
 }
 
 }  // namespace app
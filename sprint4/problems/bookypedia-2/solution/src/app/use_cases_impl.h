@@ -2,6 +2,7 @@
 #include "../domain/author_fwd.h"
 #include "../domain/book_fwd.h"
 #include "../domain/tag_fwd.h"
+#include "unit_of_work.h"
 #include "use_cases.h"
 
 
@@ -9,34 +10,36 @@ namespace app {
 
 class UseCasesImpl : public UseCases {
 public:
-    explicit UseCasesImpl(domain::AuthorRepository& authors,
-                          domain::BookRepository& books, domain::TagRepository& tags)
-        : authors_{authors}
-        , books_{books}
-        , tags_{tags} {
-    }    
+    // Каждая команда выполняется в своей единице работы и фиксируется одной транзакцией
+    explicit UseCasesImpl(UnitOfWorkFactory& unit_of_work_factory)
+        : unit_of_work_factory_{unit_of_work_factory} {
+    }
 
     void AddAuthor(const std::string& name) override;
     void DeleteAuthor(const std::string& id) override;
     void EditAuthor(const std::string& id, const std::string& new_name) override;
     std::vector<ui::detail::AuthorInfo> GetAllAuthors() override;
-    ui::detail::BookInfo AddBook(const std::string& author_id, const std::string& title, int year) override;
+    std::optional<std::string> GetAuthorIdByName(const std::string& name) override;
+    std::vector<ui::detail::AuthorInfo> GetAuthorsPage(const std::optional<ui::detail::AuthorInfo>& after,
+                                                       size_t limit) override;
+    ui::detail::BookInfo AddBook(const std::string& author_id, const std::string& title, int year,
+                                 const std::set<std::string>& tags) override;
     void DeleteBook(const std::string& id) override;
     std::vector<ui::detail::BookInfo> GetBooksBy(const std::string& author_id) override;
     ui::detail::BookInfoAllBooks GetBookByBookId(const std::string &id) override;
     std::vector<ui::detail::BookInfo> GetAllbooks() override;
-    std::vector<ui::detail::BookInfoAllBooks> GetAllBooksForShow() override;
+    std::vector<ui::detail::BookInfoAllBooks> GetBooksPageForShow(
+        const std::optional<ui::detail::BookInfoAllBooks>& after, size_t limit) override;
     std::vector<ui::detail::BookInfoAllBooks> GetBooksByTitle(const std::string title) override;
-    void AddTagsBooks(std::set<std::string>, const std::string& book_id) override;
+    std::vector<ui::detail::BookInfoAllBooks> SearchBooks(const std::string& query, size_t limit) override;
     std::optional<std::string> GetTagsByBookId(const std::string &book_id) override;
     void UpdateBook(const std::string &id,
-                const std::string& new_title, int new_year) override;
-    void DeleteTagsByBookId(const std::string book_id) override;
+                const std::string& new_title, int new_year, const std::set<std::string>& tags) override;
+    ui::detail::CatalogStats ImportCatalog(std::istream& input) override;
+    size_t ExportCatalog(std::ostream& output) override;
 
 private:
-    domain::AuthorRepository& authors_;
-    domain::BookRepository& books_;
-    domain::TagRepository& tags_;
+    UnitOfWorkFactory& unit_of_work_factory_;
 };
 
 }  // namespace app
@@ -18,7 +18,7 @@ public:
 
 private:
     postgres::Database db_;
-    app::UseCasesImpl use_cases_{db_.GetAuthors(), db_.GetBooks(),  db_.GetTags()};
+    app::UseCasesImpl use_cases_{db_};
 };
 
 }  // namespace bookypedia
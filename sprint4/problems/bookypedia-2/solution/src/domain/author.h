@@ -31,9 +31,14 @@ private:
 class AuthorRepository {
 public:
     virtual void Save(const Author& author) = 0;
+    // Новые авторы сохраняются одной командой COPY
+    virtual void SaveAll(const std::vector<Author>& authors) = 0;
     virtual void Delete(const std::string& id) = 0;
     virtual void UpdateName(const std::string& id, const std::string& new_name) = 0;
     virtual std::vector<Author> GetAllAuthors() = 0;
+    virtual std::optional<AuthorId> FindIdByName(const std::string& name) = 0;
+    // Постраничное чтение по имени: авторы с именем больше after_name
+    virtual std::vector<Author> GetAuthorsPage(const std::optional<std::string>& after_name, size_t limit) = 0;
 
 protected:
     ~AuthorRepository() = default;
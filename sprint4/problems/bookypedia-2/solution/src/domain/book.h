@@ -1,4 +1,5 @@
 #pragma once
+#include <functional>
 #include <string>
 #include <vector>
 #include <optional>
@@ -39,11 +40,20 @@ private:
 class BookRepository {
 public:
     virtual void Save(const Book& book) = 0;
+    // Новые книги сохраняются одной командой COPY
+    virtual void SaveAll(const std::vector<Book>& books) = 0;
     virtual void Delete(const std::string& id) = 0;
     virtual std::vector<Book> GetBooksBy(const std::string& author_id) = 0;
     virtual std::vector<Book> GetAllBooks() = 0;
-    virtual std::vector<ui::detail::BookInfoAllBooks> GetAllBooksForShow() = 0;
+    // Постраничное чтение по ключу (название, автор, год, id) вместо OFFSET:
+    // страница начинается сразу за книгой after и не зависит от числа пропущенных книг
+    virtual std::vector<ui::detail::BookInfoAllBooks> GetBooksPageForShow(
+        const std::optional<ui::detail::BookInfoAllBooks>& after, size_t limit) = 0;
+    // Все книги в том же порядке, что и страницы. Книги читаются потоком и не собираются в вектор
+    virtual void ForEachBookForShow(const std::function<void(const ui::detail::BookInfoAllBooks&)>& fn) = 0;
     virtual std::vector<ui::detail::BookInfoAllBooks> GetBooksBytitle(const std::string& title) = 0;
+    // Книги, у которых название или имя автора содержит query или похоже на него, лучшие совпадения первыми
+    virtual std::vector<ui::detail::BookInfoAllBooks> SearchBooks(const std::string& query, size_t limit) = 0;
     virtual ui::detail::BookInfoAllBooks GetBook(const std::string& id) = 0;
     virtual void UpdateBook(const std::string& book_id,
                             const std::string& new_title, int new_year) = 0;
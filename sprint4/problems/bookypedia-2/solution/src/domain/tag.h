@@ -31,7 +31,8 @@ private:
 
 class TagRepository {
 public:
-    virtual void Save(const Tag& tag) = 0;
+    // Все теги сохраняются одним запросом
+    virtual void SaveAll(const std::vector<Tag>& tags) = 0;
     virtual std::optional<std::string> GetTagsByBookId(const std::string book_id) = 0;
     virtual void DeleteTagsByBookId(const std::string book_id) = 0;
 
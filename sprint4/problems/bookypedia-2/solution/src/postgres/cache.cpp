@@ -0,0 +1,121 @@
+#include "cache.h"
+
+#include <algorithm>
+
+namespace postgres {
+
+bool AuthorsCache::IsFilled() const noexcept {
+    return filled_;
+}
+
+bool AuthorsCache::HasSortedList() const noexcept {
+    return filled_ && sorted_valid_;
+}
+
+void AuthorsCache::Fill(const std::vector<domain::Author>& sorted_authors) {
+    sorted_ = sorted_authors;
+    id_by_name_.clear();
+    name_by_id_.clear();
+    for (const auto& author : sorted_) {
+        id_by_name_.emplace(author.GetName(), author.GetId());
+        name_by_id_.emplace(author.GetId().ToString(), author.GetName());
+    }
+    filled_ = true;
+    sorted_valid_ = true;
+}
+
+const std::vector<domain::Author>& AuthorsCache::GetAll() const noexcept {
+    return sorted_;
+}
+
+std::optional<domain::AuthorId> AuthorsCache::FindIdByName(const std::string& name) const {
+    if (auto it = id_by_name_.find(name); it != id_by_name_.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+void AuthorsCache::Put(const domain::Author& author) {
+    if (!filled_) {
+        return;
+    }
+    const std::string id = author.GetId().ToString();
+    if (auto it = name_by_id_.find(id); it != name_by_id_.end()) {
+        id_by_name_.erase(it->second);
+        it->second = author.GetName();
+    } else {
+        name_by_id_.emplace(id, author.GetName());
+    }
+    id_by_name_.insert_or_assign(author.GetName(), author.GetId());
+    sorted_valid_ = false;
+}
+
+void AuthorsCache::Remove(const std::string& id) {
+    if (!filled_) {
+        return;
+    }
+    auto it = name_by_id_.find(id);
+    if (it == name_by_id_.end()) {
+        return;
+    }
+    id_by_name_.erase(it->second);
+    name_by_id_.erase(it);
+    // Удаление не меняет порядок остальных авторов
+    std::erase_if(sorted_, [&id](const domain::Author& author) {
+        return author.GetId().ToString() == id;
+    });
+}
+
+void AuthorsCache::Rename(const std::string& id, const std::string& new_name) {
+    if (!filled_) {
+        return;
+    }
+    auto it = name_by_id_.find(id);
+    if (it == name_by_id_.end()) {
+        return;
+    }
+    Put({domain::AuthorId::FromString(id), new_name});
+}
+
+std::optional<ui::detail::BookInfoAllBooks> BooksCache::Get(const std::string& id) {
+    auto it = index_.find(id);
+    if (it == index_.end()) {
+        return std::nullopt;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->book;
+}
+
+void BooksCache::Put(const std::string& id, const std::string& author_id,
+                     const ui::detail::BookInfoAllBooks& book) {
+    if (capacity_ == 0) {
+        return;
+    }
+    Remove(id);
+    if (index_.size() == capacity_) {
+        index_.erase(entries_.back().id);
+        entries_.pop_back();
+    }
+    entries_.push_front({id, author_id, book});
+    index_.emplace(id, entries_.begin());
+}
+
+void BooksCache::Remove(const std::string& id) {
+    if (auto it = index_.find(id); it != index_.end()) {
+        entries_.erase(it->second);
+        index_.erase(it);
+    }
+}
+
+void BooksCache::RemoveByAuthor(const std::string& author_id) {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->author_id == author_id) {
+            index_.erase(it->id);
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}  // namespace postgres
@@ -0,0 +1,100 @@
+#pragma once
+#include <functional>
+#include <list>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../domain/author.h"
+#include "../ui/view.h"
+
+namespace postgres {
+
+// Изменения кешей, сделанные внутри транзакции.
+// Применяются после фиксации, при откате просто отбрасываются
+class PendingCacheUpdates {
+public:
+    void Add(std::function<void()> update) {
+        updates_.push_back(std::move(update));
+        has_writes_ = true;
+    }
+
+    // Запись, которая не меняет закешированные данные
+    void MarkWrite() noexcept {
+        has_writes_ = true;
+    }
+
+    // После первой записи в транзакции репозитории читают базу мимо кешей
+    bool HasWrites() const noexcept {
+        return has_writes_;
+    }
+
+    void Apply() {
+        for (auto& update : updates_) {
+            update();
+        }
+        updates_.clear();
+    }
+
+private:
+    std::vector<std::function<void()>> updates_;
+    bool has_writes_ = false;
+};
+
+// Все авторы: имя -> id, id -> имя и список в порядке ORDER BY name.
+// Заполняется первым чтением всех авторов и дальше обновляется записями репозитория.
+// Порядок имён задаёт collation базы, поэтому после добавления или переименования автора
+// список перечитывается из базы, а поиск по имени и id продолжает работать из кеша.
+// Bookypedia однопоточная, кеш не синхронизирован
+class AuthorsCache {
+public:
+    bool IsFilled() const noexcept;
+    bool HasSortedList() const noexcept;
+    void Fill(const std::vector<domain::Author>& sorted_authors);
+
+    const std::vector<domain::Author>& GetAll() const noexcept;
+    std::optional<domain::AuthorId> FindIdByName(const std::string& name) const;
+
+    void Put(const domain::Author& author);
+    void Remove(const std::string& id);
+    void Rename(const std::string& id, const std::string& new_name);
+
+private:
+    bool filled_ = false;
+    bool sorted_valid_ = false;
+    std::vector<domain::Author> sorted_;
+    std::unordered_map<std::string, domain::AuthorId> id_by_name_;
+    std::unordered_map<std::string, std::string> name_by_id_;
+};
+
+// Недавно прочитанные по id книги, при переполнении вытесняется давно не читавшаяся
+class BooksCache {
+public:
+    explicit BooksCache(size_t capacity)
+        : capacity_{capacity} {
+    }
+
+    std::optional<ui::detail::BookInfoAllBooks> Get(const std::string& id);
+    void Put(const std::string& id, const std::string& author_id, const ui::detail::BookInfoAllBooks& book);
+    void Remove(const std::string& id);
+    void RemoveByAuthor(const std::string& author_id);
+
+    size_t GetSize() const noexcept {
+        return index_.size();
+    }
+
+private:
+    struct Entry {
+        std::string id;
+        std::string author_id;
+        ui::detail::BookInfoAllBooks book;
+    };
+
+    size_t capacity_;
+    // Последние прочитанные книги в начале списка
+    std::list<Entry> entries_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+}  // namespace postgres
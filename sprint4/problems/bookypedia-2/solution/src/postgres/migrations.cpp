@@ -0,0 +1,109 @@
+#include "migrations.h"
+
+#include <pqxx/pqxx>
+#include <array>
+#include <stdexcept>
+#include <string>
+
+namespace postgres {
+
+using namespace std::literals;
+using pqxx::operator"" _zv;
+
+namespace {
+
+// Миграции применяются по порядку, миграция i переводит схему в версию i + 1.
+// Уже выпущенные миграции не меняются, изменения схемы добавляются новыми.
+// Первые три миграции повторяют прежнюю схему с IF NOT EXISTS:
+// у баз, созданных до появления версий, таблицы и индексы уже есть
+const std::array MIGRATIONS{
+    // 1: таблицы
+    R"(
+CREATE TABLE IF NOT EXISTS authors (
+    id UUID CONSTRAINT firstindex PRIMARY KEY,
+    name varchar(100) NOT NULL UNIQUE
+);
+CREATE TABLE IF NOT EXISTS books (
+    id UUID PRIMARY KEY,
+    author_id UUID,
+    title VARCHAR(100) NOT NULL,
+    publication_year INT,
+    CONSTRAINT fk_authors
+        FOREIGN KEY(author_id)
+        REFERENCES authors(id)
+);
+CREATE TABLE IF NOT EXISTS book_tags (
+    book_id UUID,
+    tag varchar(30) NOT NULL,
+    CONSTRAINT fk_books
+        FOREIGN KEY(book_id)
+        REFERENCES books(id)
+);
+)"_zv,
+    // 2: индексы для поиска книг по названию и автору и тегов по книге
+    R"(
+CREATE INDEX IF NOT EXISTS books_title_idx ON books (title);
+CREATE INDEX IF NOT EXISTS books_author_id_idx ON books (author_id);
+CREATE INDEX IF NOT EXISTS book_tags_book_id_idx ON book_tags (book_id);
+)"_zv,
+    // 3: триграммные индексы для поиска по части названия и имени автора
+    R"(
+CREATE EXTENSION IF NOT EXISTS pg_trgm;
+CREATE INDEX IF NOT EXISTS books_title_trgm_idx ON books USING GIN (title gin_trgm_ops);
+CREATE INDEX IF NOT EXISTS authors_name_trgm_idx ON authors USING GIN (name gin_trgm_ops);
+)"_zv,
+    // 4: книги удаляются вместе с автором, теги — вместе с книгой
+    R"(
+ALTER TABLE books
+    DROP CONSTRAINT IF EXISTS fk_authors,
+    ADD CONSTRAINT fk_authors FOREIGN KEY(author_id) REFERENCES authors(id) ON DELETE CASCADE;
+ALTER TABLE book_tags
+    DROP CONSTRAINT IF EXISTS fk_books,
+    ADD CONSTRAINT fk_books FOREIGN KEY(book_id) REFERENCES books(id) ON DELETE CASCADE;
+)"_zv,
+};
+
+}  // namespace
+
+int GetLatestSchemaVersion() noexcept {
+    return static_cast<int>(MIGRATIONS.size());
+}
+
+int MigrateSchema(pqxx::connection& connection) {
+    pqxx::work work{connection};
+
+    work.exec(R"(
+CREATE TABLE IF NOT EXISTS schema_version (
+    version INT NOT NULL
+);
+)"_zv);
+    // Вторая программа, запущенная одновременно, дождётся окончания миграции и увидит новую версию
+    work.exec("LOCK TABLE schema_version IN EXCLUSIVE MODE;"_zv);
+
+    auto result = work.exec("SELECT version FROM schema_version;"_zv);
+    if (result.size() > 1) {
+        throw std::runtime_error("schema_version must contain one row");
+    }
+    const int version = result.empty() ? 0 : result[0][0].as<int>();
+    const int latest_version = GetLatestSchemaVersion();
+    if (version > latest_version) {
+        throw std::runtime_error("Database schema version "s + std::to_string(version)
+                                 + " is newer than supported version "s + std::to_string(latest_version));
+    }
+    if (version == latest_version) {
+        return version;
+    }
+
+    for (int i = version; i < latest_version; ++i) {
+        work.exec(MIGRATIONS[i]);
+    }
+    if (result.empty()) {
+        work.exec_params("INSERT INTO schema_version (version) VALUES ($1);"_zv, latest_version);
+    } else {
+        work.exec_params("UPDATE schema_version SET version = $1;"_zv, latest_version);
+    }
+    work.commit();
+    return latest_version;
+}
+
+}  // namespace postgres
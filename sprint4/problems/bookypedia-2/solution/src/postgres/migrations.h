@@ -0,0 +1,14 @@
+#pragma once
+#include <pqxx/connection>
+
+namespace postgres {
+
+// Номер последней миграции схемы, которую знает программа
+int GetLatestSchemaVersion() noexcept;
+
+// Применяет ещё не применённые миграции одной транзакцией и записывает номер версии в schema_version.
+// Параллельно запущенные программы ждут друг друга на блокировке таблицы версий.
+// Возвращает версию схемы после миграции
+int MigrateSchema(pqxx::connection& connection);
+
+}  // namespace postgres
@@ -1,4 +1,5 @@
 #include "postgres.h"
+#include "migrations.h"
 
 #include <pqxx/zview.hxx>
 #include <pqxx/pqxx>
@@ -9,107 +10,87 @@ namespace postgres {
 using namespace std::literals;
 using pqxx::operator"" _zv;
 
+namespace {
+
+// С этого числа строк COPY быстрее одного INSERT с массивами
+constexpr size_t COPY_THRESHOLD = 1000;
+
+// Шаблон ILIKE для поиска подстроки: служебные символы LIKE в запросе экранируются
+std::string MakeContainsPattern(const std::string& query) {
+    std::string pattern = "%";
+    for (char c : query) {
+        if (c == '%' || c == '_' || c == '\\') {
+            pattern += '\\';
+        }
+        pattern += c;
+    }
+    pattern += '%';
+    return pattern;
+}
+
+}  // namespace
+
 void AuthorRepositoryImpl::Save(const domain::Author& author) {
-    // Пока каждое обращение к репозиторию выполняется внутри отдельной транзакции
-    // В будущих уроках вы узнаете про паттерн Unit of Work, при помощи которого сможете несколько
-    // запросов выполнить в рамках одной транзакции.
-    // Вы также может самостоятельно почитать информацию про этот паттерн и применить его здесь.
-    pqxx::work work{connection_};
-    work.exec_params(
+    work_.exec_params(
         R"(
             INSERT INTO authors (id, name) VALUES ($1, $2)
             ON CONFLICT (id) DO UPDATE SET name=$2;
         )"_zv,
         author.GetId().ToString(), author.GetName());
-    work.commit();
+    cache_updates_.Add([&cache = authors_cache_, author]() {
+        cache.Put(author);
+    });
 }
 
-void AuthorRepositoryImpl::Delete(const std::string &id) {
-    pqxx::work work{connection_};
-
-    bool book_tags_exists = false;
-    bool books_exists = false;
-    bool authors_exists = false;
-
-    pqxx::result result;
-
-    result = work.exec(R"(
-        SELECT EXISTS (
-            SELECT 1
-            FROM information_schema.tables
-            WHERE table_schema = 'public'
-            AND table_name = 'book_tags'
-        );
-    )");
-    if (result[0][0].as<bool>()) {
-        book_tags_exists = true;
+void AuthorRepositoryImpl::SaveAll(const std::vector<domain::Author>& authors) {
+    if (authors.empty()) {
+        return;
     }
-
-    result = work.exec(R"(
-        SELECT EXISTS (
-            SELECT 1
-            FROM information_schema.tables
-            WHERE table_schema = 'public'
-            AND table_name = 'books'
-        );
-    )");
-    if (result[0][0].as<bool>()) {
-        books_exists = true;
-    }
-
-    result = work.exec(R"(
-        SELECT EXISTS (
-            SELECT 1
-            FROM information_schema.tables
-            WHERE table_schema = 'public'
-            AND table_name = 'authors'
-        );
-    )");
-    if (result[0][0].as<bool>()) {
-        authors_exists = true;
-    }
-
-    if (book_tags_exists) {
-        work.exec_params(R"(
-            DELETE FROM book_tags
-            WHERE book_id IN (SELECT id FROM books WHERE author_id = $1);
-        )"_zv, id);
-    }
-
-    if (books_exists) {
-        work.exec_params(R"(
-            DELETE FROM books
-            WHERE author_id = $1;
-        )"_zv, id);
+    auto stream = pqxx::stream_to::table(work_, {"authors"sv}, {"id"sv, "name"sv});
+    for (const auto& author : authors) {
+        stream.write_values(author.GetId().ToString(), author.GetName());
     }
+    stream.complete();
+    cache_updates_.Add([&cache = authors_cache_, authors]() {
+        for (const auto& author : authors) {
+            cache.Put(author);
+        }
+    });
+}
 
-    if (authors_exists) {
-        work.exec_params(R"(
-            DELETE FROM authors
-            WHERE id = $1;
-        )"_zv, id);
-    }
+void AuthorRepositoryImpl::Delete(const std::string &id) {
+    // Книги автора и их теги удаляются каскадом по внешним ключам
+    work_.exec_params(R"(
+        DELETE FROM authors WHERE id = $1;
+    )"_zv, id);
 
-    work.commit();
+    cache_updates_.Add([&authors_cache = authors_cache_, &books_cache = books_cache_, id]() {
+        authors_cache.Remove(id);
+        books_cache.RemoveByAuthor(id);
+    });
 }
 
 void AuthorRepositoryImpl::UpdateName(const std::string &id, const std::string &new_name) {
-    pqxx::work work{connection_};
-    work.exec_params(R"(
+    work_.exec_params(R"(
         UPDATE authors
         SET name = $1
         WHERE id = $2;
     )"_zv, new_name, id);
-
-    work.commit();
+    cache_updates_.Add([&cache = authors_cache_, id, new_name]() {
+        cache.Rename(id, new_name);
+    });
 }
 
 std::vector<domain::Author> AuthorRepositoryImpl::GetAllAuthors() {
-    std::vector<domain::Author> authors;
+    // Пока в транзакции нет записей, её данные совпадают с зафиксированными и кеш можно использовать
+    const bool use_cache = !cache_updates_.HasWrites();
+    if (use_cache && authors_cache_.HasSortedList()) {
+        return authors_cache_.GetAll();
+    }
 
-    pqxx::read_transaction read_transaction_{connection_};
+    std::vector<domain::Author> authors;
 
-    auto result = read_transaction_.exec("SELECT id, name FROM authors ORDER BY name ASC");
+    auto result = work_.exec("SELECT id, name FROM authors ORDER BY name ASC");
 
     for (const auto& row : result) {
         std::string id = row[0].as<std::string>();
@@ -117,12 +98,48 @@ std::vector<domain::Author> AuthorRepositoryImpl::GetAllAuthors() {
         authors.emplace_back(domain::AuthorId::FromString(id), name);
     }
 
+    if (use_cache) {
+        authors_cache_.Fill(authors);
+    }
+    return authors;
+}
+
+std::optional<domain::AuthorId> AuthorRepositoryImpl::FindIdByName(const std::string& name) {
+    if (!cache_updates_.HasWrites() && authors_cache_.IsFilled()) {
+        return authors_cache_.FindIdByName(name);
+    }
+    auto result = work_.exec_params("SELECT id FROM authors WHERE name = $1"_zv, name);
+    if (result.empty()) {
+        return std::nullopt;
+    }
+    return domain::AuthorId::FromString(result[0][0].as<std::string>());
+}
+
+std::vector<domain::Author> AuthorRepositoryImpl::GetAuthorsPage(const std::optional<std::string>& after_name,
+                                                                  size_t limit) {
+    // Имена авторов уникальны, поэтому имени достаточно как ключа страницы.
+    // Страница читается по индексу UNIQUE (name) с нужного места
+    pqxx::result result;
+    if (after_name) {
+        result = work_.exec_params(R"(
+            SELECT id, name FROM authors WHERE name > $1 ORDER BY name ASC LIMIT $2
+        )"_zv, *after_name, limit);
+    } else {
+        result = work_.exec_params(R"(
+            SELECT id, name FROM authors ORDER BY name ASC LIMIT $1
+        )"_zv, limit);
+    }
+
+    std::vector<domain::Author> authors;
+    authors.reserve(result.size());
+    for (const auto& row : result) {
+        authors.emplace_back(domain::AuthorId::FromString(row[0].as<std::string>()), row[1].as<std::string>());
+    }
     return authors;
 }
 
 void BookRepositoryImpl::Save(const domain::Book& book) {
-    pqxx::work work{connection_};
-    work.exec_params(R"(
+    work_.exec_params(R"(
     INSERT INTO books (id, author_id, title, publication_year) VALUES ($1, $2, $3, $4)
         ON CONFLICT (id) DO UPDATE SET author_id=$2, title=$3, publication_year=$4;
         )"_zv,
@@ -131,30 +148,42 @@ void BookRepositoryImpl::Save(const domain::Book& book) {
         book.GetTitle(),
         book.GetPublicationYear())
     ;
-    work.commit();
+    cache_updates_.Add([&cache = books_cache_, id = book.GetId().ToString()]() {
+        cache.Remove(id);
+    });
 }
 
-void BookRepositoryImpl::Delete(const std::string &id) {
-    pqxx::work work{connection_};
-
-    work.exec_params(R"(
-        DELETE FROM book_tags WHERE book_id = $1;
-    )"_zv, id);
+void BookRepositoryImpl::SaveAll(const std::vector<domain::Book>& books) {
+    if (books.empty()) {
+        return;
+    }
+    auto stream = pqxx::stream_to::table(work_, {"books"sv},
+                                         {"id"sv, "author_id"sv, "title"sv, "publication_year"sv});
+    for (const auto& book : books) {
+        stream.write_values(book.GetId().ToString(), book.GetAuthorId().ToString(),
+                            book.GetTitle(), book.GetPublicationYear());
+    }
+    stream.complete();
+    // Новых книг в кеше нет, но до конца транзакции кеш читать нельзя
+    cache_updates_.MarkWrite();
+}
 
-    work.exec_params(R"(
+void BookRepositoryImpl::Delete(const std::string &id) {
+    // Теги книги удаляются каскадом
+    work_.exec_params(R"(
         DELETE FROM books WHERE id = $1;
     )"_zv, id);
-
-    work.commit();
+    cache_updates_.Add([&cache = books_cache_, id]() {
+        cache.Remove(id);
+    });
 }
 
 std::vector<domain::Book> BookRepositoryImpl::GetBooksBy(const std::string& author_id_str) {
     std::vector<domain::Book> books;
-    pqxx::read_transaction read_transaction_{connection_};
     auto query_text = "SELECT id, author_id, title, publication_year FROM books WHERE author_id = "
-            + read_transaction_.quote(author_id_str)
+            + work_.quote(author_id_str)
             + " ORDER BY publication_year ASC, title ASC";
-    for (auto [id, author_id, title, year] : read_transaction_.query<std::string, std::string, std::string, int>(query_text)) {
+    for (auto [id, author_id, title, year] : work_.query<std::string, std::string, std::string, int>(query_text)) {
         books.emplace_back(
             domain::BookId::FromString(id),
             domain::AuthorId::FromString(author_id),
@@ -167,9 +196,8 @@ std::vector<domain::Book> BookRepositoryImpl::GetBooksBy(const std::string& auth
 
 std::vector<domain::Book> BookRepositoryImpl::GetAllBooks() {
     std::vector<domain::Book> books;
-    pqxx::read_transaction read_transaction_{connection_};
     auto query_text = "SELECT id, author_id, title, publication_year FROM books ORDER BY title ASC"_zv;
-    for (auto [id, author_id, title, year] : read_transaction_.query<std::string, std::string, std::string, int>(query_text)) {
+    for (auto [id, author_id, title, year] : work_.query<std::string, std::string, std::string, int>(query_text)) {
         books.emplace_back(
             domain::BookId::FromString(id),
             domain::AuthorId::FromString(author_id),
@@ -180,62 +208,159 @@ std::vector<domain::Book> BookRepositoryImpl::GetAllBooks() {
     return books;
 }
 
-std::vector<ui::detail::BookInfoAllBooks> BookRepositoryImpl::GetAllBooksForShow() {
+std::vector<ui::detail::BookInfoAllBooks> BookRepositoryImpl::GetBooksPageForShow(
+        const std::optional<ui::detail::BookInfoAllBooks>& after, size_t limit) {
+    // Сначала выбирается страница книг по индексу названий, теги собираются только для неё.
+    // Условие books.title >= $1 дублирует сравнение строк, чтобы планировщик начал поиск по индексу с нужного места
+    pqxx::result result;
+    if (after) {
+        result = work_.exec_params(R"(
+            SELECT page.id, page.title, page.name, page.publication_year,
+                   (SELECT string_agg(tag, ', ' ORDER BY tag) FROM book_tags WHERE book_id = page.id)
+            FROM (
+                SELECT books.id, books.title, authors.name, books.publication_year
+                FROM books
+                JOIN authors ON books.author_id = authors.id
+                WHERE books.title >= $1
+                  AND (books.title, authors.name, books.publication_year, books.id) > ($1, $2, $3, $4::uuid)
+                ORDER BY books.title ASC, authors.name ASC, books.publication_year ASC, books.id ASC
+                LIMIT $5
+            ) AS page
+            ORDER BY page.title ASC, page.name ASC, page.publication_year ASC, page.id ASC
+        )"_zv, after->title, after->author_name, after->publication_year, after->id, limit);
+    } else {
+        result = work_.exec_params(R"(
+            SELECT page.id, page.title, page.name, page.publication_year,
+                   (SELECT string_agg(tag, ', ' ORDER BY tag) FROM book_tags WHERE book_id = page.id)
+            FROM (
+                SELECT books.id, books.title, authors.name, books.publication_year
+                FROM books
+                JOIN authors ON books.author_id = authors.id
+                ORDER BY books.title ASC, authors.name ASC, books.publication_year ASC, books.id ASC
+                LIMIT $1
+            ) AS page
+            ORDER BY page.title ASC, page.name ASC, page.publication_year ASC, page.id ASC
+        )"_zv, limit);
+    }
 
     std::vector<ui::detail::BookInfoAllBooks> books;
-    pqxx::read_transaction read_transaction_{connection_};
+    books.reserve(result.size());
+    for (const auto& row : result) {
+        books.emplace_back(ui::detail::BookInfoAllBooks{
+            row[0].as<std::string>(),
+            row[1].as<std::string>(),
+            row[2].as<std::string>(),
+            row[3].as<int>(),
+            row[4].as<std::optional<std::string>>()
+        });
+    }
+    return books;
+}
 
-    // Объединяем книги и авторов, сортируем по названию книги, имени автора и году публикации
+void BookRepositoryImpl::ForEachBookForShow(
+        const std::function<void(const ui::detail::BookInfoAllBooks&)>& fn) {
+    // Книги объединяются с авторами, теги собираются в строку тем же запросом, у книги без тегов
+    // строка NULL. Строки приходят через COPY TO STDOUT и обрабатываются по одной,
+    // не занимая память под весь каталог
     auto query_text = R"(
-        SELECT books.id, books.title, authors.name, books.publication_year
+        SELECT books.id, books.title, authors.name, books.publication_year,
+               string_agg(book_tags.tag, ', ' ORDER BY book_tags.tag)
         FROM books
         JOIN authors ON books.author_id = authors.id
-        ORDER BY books.title ASC, authors.name ASC, books.publication_year ASC
+        LEFT JOIN book_tags ON book_tags.book_id = books.id
+        GROUP BY books.id, authors.name
+        ORDER BY books.title ASC, authors.name ASC, books.publication_year ASC, books.id ASC
     )"_zv;
 
-    for (auto [id, title, author_name, year] :
-         read_transaction_.query<std::string, std::string, std::string, int>(query_text)) {
-        books.emplace_back(ui::detail::BookInfoAllBooks{
-            id,
-            title,
-            author_name,
-            year
+    for (auto [id, title, author_name, year, tags] :
+         work_.stream<std::string, std::string, std::string, int, std::optional<std::string>>(query_text)) {
+        fn(ui::detail::BookInfoAllBooks{
+            std::move(id),
+            std::move(title),
+            std::move(author_name),
+            year,
+            std::move(tags)
         });
     }
-    return books;
 }
 
 std::vector<ui::detail::BookInfoAllBooks> BookRepositoryImpl::GetBooksBytitle(const std::string &title){
     std::vector<ui::detail::BookInfoAllBooks> books;
-    pqxx::read_transaction read_transaction_{connection_};
-
     auto query_text = R"(
-        SELECT books.id, books.title, authors.name, books.publication_year
+        SELECT books.id, books.title, authors.name, books.publication_year,
+               string_agg(book_tags.tag, ', ' ORDER BY book_tags.tag)
         FROM books
         JOIN authors ON books.author_id = authors.id
+        LEFT JOIN book_tags ON book_tags.book_id = books.id
         WHERE books.title = $1
+        GROUP BY books.id, authors.name
         ORDER BY books.title ASC, authors.name ASC, books.publication_year ASC
     )"_zv;
 
-    for (auto row : read_transaction_.exec_params(query_text, title)) {
+    for (auto row : work_.exec_params(query_text, title)) {
         std::string id = row[0].as<std::string>();
         std::string book_title = row[1].as<std::string>();
         std::string author_name = row[2].as<std::string>();
         int year = row[3].as<int>();
+        auto tags = row[4].as<std::optional<std::string>>();
 
         books.emplace_back(ui::detail::BookInfoAllBooks{
             id,
             book_title,
             author_name,
-            year
+            year,
+            std::move(tags)
         });
     }
 
     return books;
 }
 
+std::vector<ui::detail::BookInfoAllBooks> BookRepositoryImpl::SearchBooks(const std::string& query, size_t limit) {
+    // ILIKE и оператор похожести % используют триграммные GIN-индексы по названиям и именам.
+    // Поиск по книгам и по авторам разнесён в UNION, чтобы каждая часть шла по своему индексу.
+    // Ранг — наибольшая похожесть запроса на слово из названия или имени автора
+    auto query_text = R"(
+        WITH matched AS (
+            SELECT books.id
+            FROM books
+            WHERE books.title ILIKE $2 OR books.title % $1
+            UNION
+            SELECT books.id
+            FROM authors
+            JOIN books ON books.author_id = authors.id
+            WHERE authors.name ILIKE $2 OR authors.name % $1
+        )
+        SELECT books.id, books.title, authors.name, books.publication_year,
+               (SELECT string_agg(tag, ', ' ORDER BY tag) FROM book_tags WHERE book_id = books.id)
+        FROM matched
+        JOIN books ON books.id = matched.id
+        JOIN authors ON books.author_id = authors.id
+        ORDER BY GREATEST(word_similarity($1, books.title), word_similarity($1, authors.name)) DESC,
+                 books.title ASC, authors.name ASC, books.publication_year ASC, books.id ASC
+        LIMIT $3
+    )"_zv;
+
+    std::vector<ui::detail::BookInfoAllBooks> books;
+    for (const auto& row : work_.exec_params(query_text, query, MakeContainsPattern(query), limit)) {
+        books.emplace_back(ui::detail::BookInfoAllBooks{
+            row[0].as<std::string>(),
+            row[1].as<std::string>(),
+            row[2].as<std::string>(),
+            row[3].as<int>(),
+            row[4].as<std::optional<std::string>>()
+        });
+    }
+    return books;
+}
+
 ui::detail::BookInfoAllBooks BookRepositoryImpl::GetBook(const std::string &id) {
-    pqxx::read_transaction read_transaction{connection_};
+    const bool use_cache = !cache_updates_.HasWrites();
+    if (use_cache) {
+        if (auto book = books_cache_.Get(id)) {
+            return *book;
+        }
+    }
 
     auto query_text = R"(
         SELECT id, author_id, title, publication_year
@@ -243,7 +368,7 @@ ui::detail::BookInfoAllBooks BookRepositoryImpl::GetBook(const std::string &id)
         WHERE id = $1
     )"_zv;
 
-    pqxx::result result = read_transaction.exec_params(query_text, id);
+    pqxx::result result = work_.exec_params(query_text, id);
 
     if (result.empty()) {
         throw std::runtime_error("Book not found with id: " + id);
@@ -255,109 +380,85 @@ ui::detail::BookInfoAllBooks BookRepositoryImpl::GetBook(const std::string &id)
     std::string title = row[2].as<std::string>();
     int publication_year = row[3].as<int>();
 
-    return ui::detail::BookInfoAllBooks{
+    ui::detail::BookInfoAllBooks book{
         book_id,
         title,
         author_id,
         publication_year
     };
+    if (use_cache) {
+        books_cache_.Put(id, author_id, book);
+    }
+    return book;
 }
 
 void BookRepositoryImpl::UpdateBook(const std::string& book_id,
                                      const std::string& new_title, int new_year){
-    pqxx::work work{connection_};
-    work.exec_params(R"(
+    work_.exec_params(R"(
         UPDATE books
         SET title = $1,
         publication_year = $2
         WHERE id = $3;
     )"_zv, new_title, new_year, book_id);
-
-    work.commit();
+    cache_updates_.Add([&cache = books_cache_, book_id]() {
+        cache.Remove(book_id);
+    });
 }
 
-void TagRepositoryImpl::Save(const domain::Tag& tag_input) {
-    pqxx::work work{connection_};
+void TagRepositoryImpl::SaveAll(const std::vector<domain::Tag>& tags) {
+    if (tags.empty()) {
+        return;
+    }
+    if (tags.size() >= COPY_THRESHOLD) {
+        auto stream = pqxx::stream_to::table(work_, {"book_tags"sv}, {"book_id"sv, "tag"sv});
+        for (const auto& tag : tags) {
+            stream.write_values(tag.GetBookId().ToString(), tag.GetTag());
+        }
+        stream.complete();
+        return;
+    }
+    // Один запрос на все теги: массивы книг и тегов разворачиваются в строки на стороне сервера
+    std::vector<std::string> book_ids;
+    std::vector<std::string> tag_names;
+    book_ids.reserve(tags.size());
+    tag_names.reserve(tags.size());
+    for (const auto& tag : tags) {
+        book_ids.push_back(tag.GetBookId().ToString());
+        tag_names.push_back(tag.GetTag());
+    }
 
-    work.exec_params(R"(
-    INSERT INTO book_tags (book_id, tag) VALUES ($1, $2)
+    work_.exec_params(R"(
+    INSERT INTO book_tags (book_id, tag)
+    SELECT * FROM unnest($1::uuid[], $2::varchar[])
         )"_zv,
-        tag_input.GetBookId().ToString(),
-        tag_input.GetTag())
-    ;
-
-    work.commit();
+        book_ids,
+        tag_names);
 }
 
 std::optional<std::string> TagRepositoryImpl::GetTagsByBookId(const std::string book_id){
-    pqxx::read_transaction read_transaction_{connection_};
-
+    // Для книги без тегов string_agg возвращает NULL
     auto query_text = R"(
-        SELECT book_tags.tag
+        SELECT string_agg(book_tags.tag, ', ' ORDER BY book_tags.tag)
         FROM book_tags
         WHERE book_tags.book_id = $1
     )"_zv;
 
-    pqxx::result result = read_transaction_.exec_params(query_text, book_id);
-    if (result.empty()) {
-        return std::nullopt;
-    }
-
-    std::string tags;
-    for (const auto& row : result) {
-        if (!tags.empty()) {
-            tags += ", ";
-        }
-        tags += row["tag"].as<std::string>();
-    }
-
-    return tags;
+    return work_.exec_params1(query_text, book_id)[0].as<std::optional<std::string>>();
 }
 
 void TagRepositoryImpl::DeleteTagsByBookId(const std::string book_id){
-    pqxx::work work{connection_};
-    work.exec_params(R"(
+    work_.exec_params(R"(
         DELETE FROM book_tags WHERE book_id = $1;
     )"_zv, book_id);
-
-    work.commit();
 }
 
 Database::Database(pqxx::connection connection)
     : connection_{std::move(connection)} {
-    pqxx::work work{connection_};
-
-    work.exec(R"(
-CREATE TABLE IF NOT EXISTS authors (
-    id UUID CONSTRAINT firstindex PRIMARY KEY,
-    name varchar(100) NOT NULL UNIQUE
-);
-)"_zv);
-
-    work.exec(R"(
-CREATE TABLE IF NOT EXISTS books (
-    id UUID PRIMARY KEY,
-    author_id UUID,
-    title VARCHAR(100) NOT NULL,
-    publication_year INT,
-    CONSTRAINT fk_authors
-        FOREIGN KEY(author_id)
-        REFERENCES authors(id)
-);
-)"_zv);
-
-    work.exec(R"(
-CREATE TABLE IF NOT EXISTS book_tags (
-    book_id UUID,
-    tag varchar(30) NOT NULL,
-    CONSTRAINT fk_books
-        FOREIGN KEY(book_id)
-        REFERENCES books(id)
-);
-)"_zv);
-
-    // коммитим изменения
-    work.commit();
+    MigrateSchema(connection_);
+}
+
+std::unique_ptr<app::UnitOfWork> Database::CreateUnitOfWork() {
+    return std::make_unique<UnitOfWorkImpl>(connection_, authors_cache_, books_cache_);
 }
 
 }  // namespace postgres
@@ -2,6 +2,8 @@
 #include <pqxx/connection>
 #include <pqxx/transaction>
 
+#include "../app/unit_of_work.h"
+#include "cache.h"
 #include "../domain/author.h"
 #include "../domain/book.h"
 #include "../domain/tag.h"
@@ -11,76 +13,117 @@ namespace postgres {
 
 class AuthorRepositoryImpl : public domain::AuthorRepository {
 public:
-    explicit AuthorRepositoryImpl(pqxx::connection& connection)
-        : connection_{connection} {
+    AuthorRepositoryImpl(pqxx::work& work, AuthorsCache& authors_cache, BooksCache& books_cache,
+                         PendingCacheUpdates& cache_updates)
+        : work_{work}
+        , authors_cache_{authors_cache}
+        , books_cache_{books_cache}
+        , cache_updates_{cache_updates} {
     }
 
     void Save(const domain::Author& author) override;
+    void SaveAll(const std::vector<domain::Author>& authors) override;
     void Delete(const std::string& id) override;
     void UpdateName(const std::string& id, const std::string& new_name) override;
     std::vector<domain::Author> GetAllAuthors() override;
-
+    std::optional<domain::AuthorId> FindIdByName(const std::string& name) override;
+    std::vector<domain::Author> GetAuthorsPage(const std::optional<std::string>& after_name, size_t limit) override;
 
 private:
-    pqxx::connection& connection_;
+    pqxx::work& work_;
+    AuthorsCache& authors_cache_;
+    BooksCache& books_cache_;
+    PendingCacheUpdates& cache_updates_;
 };
 
 class BookRepositoryImpl : public domain::BookRepository {
 public:
-    explicit BookRepositoryImpl(pqxx::connection& connection)
-        : connection_(connection) {
+    BookRepositoryImpl(pqxx::work& work, BooksCache& books_cache, PendingCacheUpdates& cache_updates)
+        : work_{work}
+        , books_cache_{books_cache}
+        , cache_updates_{cache_updates} {
     }
 
     void Save(const domain::Book& book) override;
+    void SaveAll(const std::vector<domain::Book>& books) override;
     void Delete(const std::string& id) override;
     std::vector<domain::Book> GetBooksBy(const std::string& author_id) override;
     std::vector<domain::Book> GetAllBooks() override;
-    std::vector<ui::detail::BookInfoAllBooks> GetAllBooksForShow() override;
+    std::vector<ui::detail::BookInfoAllBooks> GetBooksPageForShow(
+        const std::optional<ui::detail::BookInfoAllBooks>& after, size_t limit) override;
+    void ForEachBookForShow(const std::function<void(const ui::detail::BookInfoAllBooks&)>& fn) override;
     std::vector<ui::detail::BookInfoAllBooks> GetBooksBytitle(const std::string& title) override;
+    std::vector<ui::detail::BookInfoAllBooks> SearchBooks(const std::string& query, size_t limit) override;
     ui::detail::BookInfoAllBooks GetBook(const std::string& id) override;
     void UpdateBook(const std::string& book_id, const std::string& new_title, int new_year) override;
 
 private:
-    pqxx::connection& connection_;
+    pqxx::work& work_;
+    BooksCache& books_cache_;
+    PendingCacheUpdates& cache_updates_;
 };
 
 class TagRepositoryImpl : public domain::TagRepository {
 public:
-    explicit TagRepositoryImpl(pqxx::connection& connection)
-        : connection_(connection) {
+    explicit TagRepositoryImpl(pqxx::work& work)
+        : work_{work} {
     }
 
-    void Save(const domain::Tag& tag) override;
+    void SaveAll(const std::vector<domain::Tag>& tags) override;
     std::optional<std::string> GetTagsByBookId(const std::string book_id) override;
     void DeleteTagsByBookId(const std::string book_id) override;
-;
 
 
 private:
-    pqxx::connection& connection_;
+    pqxx::work& work_;
 };
 
-class Database {
+class UnitOfWorkImpl : public app::UnitOfWork {
 public:
-    explicit Database(pqxx::connection connection);
+    UnitOfWorkImpl(pqxx::connection& connection, AuthorsCache& authors_cache, BooksCache& books_cache)
+        : work_{connection}
+        , authors_{work_, authors_cache, books_cache, cache_updates_}
+        , books_{work_, books_cache, cache_updates_} {
+    }
 
-    AuthorRepositoryImpl& GetAuthors() & {
+    void Commit() override {
+        work_.commit();
+        cache_updates_.Apply();
+    }
+
+    domain::AuthorRepository& Authors() override {
         return authors_;
     }
 
-    BookRepositoryImpl& GetBooks() & {
+    domain::BookRepository& Books() override {
         return books_;
     }
 
-    TagRepositoryImpl& GetTags() & {
+    domain::TagRepository& Tags() override {
         return tags_;
     }
 
 private:
+    pqxx::work work_;
+    PendingCacheUpdates cache_updates_;
+    AuthorRepositoryImpl authors_;
+    BookRepositoryImpl books_;
+    TagRepositoryImpl tags_{work_};
+};
+
+class Database : public app::UnitOfWorkFactory {
+public:
+    explicit Database(pqxx::connection connection);
+
+    std::unique_ptr<app::UnitOfWork> CreateUnitOfWork() override;
+
+private:
+    // Сколько книг, прочитанных по id, держать в кеше
+    static constexpr size_t BOOKS_CACHE_SIZE = 256;
+
     pqxx::connection connection_;
-    AuthorRepositoryImpl authors_{connection_};
-    BookRepositoryImpl books_{connection_};
-    TagRepositoryImpl tags_{connection_};
+    AuthorsCache authors_cache_;
+    BooksCache books_cache_{BOOKS_CACHE_SIZE};
 };
 
 }  // namespace postgres
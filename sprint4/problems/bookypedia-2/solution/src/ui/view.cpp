@@ -3,6 +3,9 @@
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/algorithm/string.hpp>
 #include <cassert>
+#include <chrono>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -43,6 +46,47 @@ void PrintVector(std::ostream& out, const std::vector<T>& vector) {
     }
 }
 
+//        
+constexpr size_t PAGE_SIZE = 100;
+
+//     PAGE_SIZE,     PrintVector.
+//      ,      .
+//  page_starts ,      .
+//    
+template <typename T, typename GetPage>
+size_t PrintPages(std::ostream& out, GetPage&& get_page, std::vector<std::optional<T>>* page_starts = nullptr) {
+    size_t i = 1;
+    std::optional<T> last;
+    while (true) {
+        if (page_starts) {
+            page_starts->push_back(last);
+        }
+        std::vector<T> page = get_page(last, PAGE_SIZE);
+        for (auto& value : page) {
+            out << i++ << " " << value << std::endl;
+        }
+        if (page.size() < PAGE_SIZE) {
+            break;
+        }
+        last = std::move(page.back());
+    }
+    return i - 1;
+}
+
+//    number  ,  PrintPages.    
+template <typename T, typename GetPage>
+std::optional<T> GetPagedItem(GetPage&& get_page, const std::vector<std::optional<T>>& page_starts, size_t number) {
+    if (number == 0 || (number - 1) / PAGE_SIZE >= page_starts.size()) {
+        return std::nullopt;
+    }
+    std::vector<T> page = get_page(page_starts[(number - 1) / PAGE_SIZE], PAGE_SIZE);
+    const size_t index = (number - 1) % PAGE_SIZE;
+    if (index >= page.size()) {
+        return std::nullopt;
+    }
+    return std::move(page[index]);
+}
+
 
 std::set<std::string> normalizeTags(const std::string& input) {
 
@@ -99,6 +143,14 @@ View::View(menu::Menu& menu, app::UseCases& use_cases, std::istream& input, std:
 
     menu_.AddAction("ShowAuthorBooks"s, {}, "Show author books"s,
                     std::bind(&View::ShowAuthorBooks, this));
+
+    menu_.AddAction("SearchBooks"s, "<query>"s, "Searches books by part of title or author name"s,
+         [this](auto& cmd_input) { return SearchBooks(cmd_input); });
+
+    menu_.AddAction("ImportCatalog"s, "<file>"s, "Imports books from CSV file"s,
+         [this](auto& cmd_input) { return ImportCatalog(cmd_input); });
+    menu_.AddAction("ExportCatalog"s, "<file>"s, "Exports books to CSV file"s,
+         [this](auto& cmd_input) { return ExportCatalog(cmd_input); });
 }
 
 bool View::AddAuthor(std::istream& cmd_input) const {
@@ -186,7 +238,13 @@ bool View::EditAuthor(std::istream &cmd_input) const {
 }
 
 bool View::ShowAuthors() const {
-    PrintVector(output_, GetAuthors());
+    try {
+        PrintPages<detail::AuthorInfo>(output_, [this](const auto& after, size_t limit) {
+            return use_cases_.GetAuthorsPage(after, limit);
+        });
+    } catch (const std::exception&) {
+        output_ << "Failed to show authors"sv << std::endl;
+    }
     return true;
 }
 
@@ -202,8 +260,7 @@ bool View::AddBook(std::istream& cmd_input) const {
 
             std::set<std::string> normalized_tags = normalizeTags(input_tags);
 
-            auto new_book = use_cases_.AddBook(params->author_id, params->title, params->publication_year);
-            use_cases_.AddTagsBooks(normalized_tags, new_book.id);
+            use_cases_.AddBook(params->author_id, params->title, params->publication_year, normalized_tags);
         }
     } catch (const std::exception&) {
         output_ << "Failed to add book"sv << std::endl;
@@ -304,16 +361,7 @@ bool View::EditBook(std::istream &cmd_input) const {
         }
         std::getline(std::cin, new_tags);
 
-        use_cases_.UpdateBook(book_id.value(), new_title, new_year);
-
-        if (tags->empty()) {
-             std::set<std::string> normalized_tags = normalizeTags(new_tags);
-             use_cases_.AddTagsBooks(normalized_tags, book_id.value());
-        } else {
-            use_cases_.DeleteTagsByBookId(book_id.value());
-            std::set<std::string> normalized_tags = normalizeTags(new_tags);
-            use_cases_.AddTagsBooks(normalized_tags, book_id.value());
-        }
+        use_cases_.UpdateBook(book_id.value(), new_title, new_year, normalizeTags(new_tags));
 
 
     } catch (const std::exception&) {
@@ -332,19 +380,21 @@ bool View::AddTags(std::set<std::string>& tags, std::string &book_id) const {
 }
 
 bool View::ShowBooks() const {
-    PrintVector(output_, GetAllBooksForShow());
+    try {
+        PrintPages<detail::BookInfoAllBooks>(output_, GetBooksPage());
+    } catch (const std::exception&) {
+        output_ << "Failed to show books"sv << std::endl;
+    }
     return true;
 }
 
 void View::printBook(const ui::detail::BookInfoAllBooks& book) const{
 
-   std::optional<std::string> tags = use_cases_.GetTagsByBookId(book.id);
-
     std::cout << "Title: " << book.title << std::endl
               << "Author: " << book.author_name << std::endl
               << "Publication year: " << book.publication_year << std::endl;
-    if (tags) {
-              std::cout << "Tags: " << tags.value() << std::endl;
+    if (book.tags) {
+              std::cout << "Tags: " << book.tags.value() << std::endl;
     }
 }
 
@@ -355,17 +405,28 @@ bool View::ShowBook(std::istream& cmd_input) const{
         std::getline(cmd_input, title);
         boost::algorithm::trim(title);
 
-        std::vector<ui::detail::BookInfoAllBooks> books;
-
         if (title.empty()) {
-             books = use_cases_.GetAllBooksForShow();
-        } else {
-            books = use_cases_.GetBooksByTitle(title);
+            //    ,      
+            std::vector<std::optional<detail::BookInfoAllBooks>> page_starts;
+            if (PrintPages(output_, GetBooksPage(), &page_starts) == 0) {
+                return true;
+            }
+            std::string answer;
+            std::cout << "Enter the book # or empty line to cancel:" << std::endl;
+            std::getline(std::cin, answer);
+            if (!answer.empty() && std::all_of(answer.begin(), answer.end(), ::isdigit)) {
+                if (auto book = GetPagedItem(GetBooksPage(), page_starts, std::stoul(answer))) {
+                    printBook(*book);
+                }
+            }
+            return true;
         }
 
+        std::vector<ui::detail::BookInfoAllBooks> books = use_cases_.GetBooksByTitle(title);
+
         if (books.size() == 0) {
             return true;
-        } else if (books.size() == 1 && !title.empty()) {
+        } else if (books.size() == 1) {
             printBook(books[0]);
         } else {
             PrintVector(output_, books);
@@ -500,11 +561,10 @@ std::optional<std::string> View::SelectAuthor(std::vector<detail::AuthorInfo>& a
 }
 
 std::optional<std::string> View::SelectBook() const {
-    auto books = use_cases_.GetAllBooksForShow();
-    if (books.size() == 0) {
+    std::vector<std::optional<detail::BookInfoAllBooks>> page_starts;
+    if (PrintPages(output_, GetBooksPage(), &page_starts) == 0) {
        return "exit";
     }
-    PrintVector(output_, books);
     output_ << "Enter the book # or empty line to cancel" << std::endl;
 
     std::string str;
@@ -523,13 +583,23 @@ std::optional<std::string> View::SelectBook() const {
         throw std::runtime_error("Invalid book num");
     }
 
-    --book_idx;
-    if (book_idx < 0 or book_idx >= books.size()) {
+    if (book_idx < 1) {
+        throw std::runtime_error("Invalid author num");
+    }
+    auto book = GetPagedItem(GetBooksPage(), page_starts, static_cast<size_t>(book_idx));
+    if (!book) {
         throw std::runtime_error("Invalid author num");
     }
 
-    return books[book_idx].id;
+    return book->id;
+
+}
 
+std::function<std::vector<detail::BookInfoAllBooks>(const std::optional<detail::BookInfoAllBooks>&, size_t)>
+View::GetBooksPage() const {
+    return [this](const std::optional<detail::BookInfoAllBooks>& after, size_t limit) {
+        return use_cases_.GetBooksPageForShow(after, limit);
+    };
 }
 
 std::optional<std::string> View::SelectBookFromBooks(std::vector<ui::detail::BookInfoAllBooks> books) const {
@@ -573,18 +643,7 @@ std::vector<detail::AuthorInfo> View::GetAuthors() const {
 }
 
 std::optional<std::string> View::GetAuthorsIdByAuthorName(const std::string &author_name) const {
-    std::string author_id;
-    auto authors = GetAuthors();
-    auto it = std::find_if(authors.begin(), authors.end(),
-            [&author_name](const ui::detail::AuthorInfo& author) {
-                return author.name == author_name;
-    });
-    if (it != authors.end()) {
-        author_id = it->id;
-    } else {
-        return std::nullopt;
-    }
-    return author_id;
+    return use_cases_.GetAuthorIdByName(author_name);
 }
 
 detail::BookInfoAllBooks View::GetBookByBookId(const std::string &id) const{
@@ -597,12 +656,6 @@ std::vector<detail::BookInfo> View::GetBooks() const {
     return books;
 }
 
-std::vector<detail::BookInfoAllBooks> View::GetAllBooksForShow() const {
-    std::vector<detail::BookInfoAllBooks> books;
-    books = use_cases_.GetAllBooksForShow();
-    return books;
-}
-
 std::vector<detail::BookInfo> View::GetAuthorBooks(const std::string& author_id) const {
     std::vector<detail::BookInfo> books;
     books = use_cases_.GetBooksBy(author_id);
@@ -610,4 +663,96 @@ std::vector<detail::BookInfo> View::GetAuthorBooks(const std::string& author_id)
     return books;
 }
 
+//    SearchBooks
+constexpr size_t SEARCH_LIMIT = 20;
+
+bool View::SearchBooks(std::istream& cmd_input) const {
+    try {
+        std::string query;
+        std::getline(cmd_input, query);
+        boost::algorithm::trim(query);
+        if (query.empty()) {
+            throw std::runtime_error("Search query is empty");
+        }
+
+        auto books = use_cases_.SearchBooks(query, SEARCH_LIMIT);
+        if (books.empty()) {
+            output_ << "No books found"sv << std::endl;
+            return true;
+        }
+        PrintVector(output_, books);
+
+        std::string answer;
+        output_ << "Enter the book # or empty line to cancel:"sv << std::endl;
+        std::getline(input_, answer);
+        boost::algorithm::trim(answer);
+        if (!answer.empty() && std::all_of(answer.begin(), answer.end(), ::isdigit)) {
+            size_t selected_index = std::stoul(answer);
+            if (selected_index >= 1 && selected_index <= books.size()) {
+                printBook(books[selected_index - 1]);
+            }
+        }
+    } catch (const std::exception&) {
+        output_ << "Failed to search books"sv << std::endl;
+    }
+    return true;
+}
+
+namespace {
+
+void PrintCatalogRate(std::ostream& out, size_t rows, std::chrono::steady_clock::duration elapsed) {
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    out << rows << " books in "sv << seconds << " s"sv;
+    if (seconds > 0) {
+        out << " ("sv << static_cast<size_t>(rows / seconds) << " rows/s)"sv;
+    }
+    out << std::endl;
+}
+
+}  // namespace
+
+bool View::ImportCatalog(std::istream& cmd_input) const {
+    try {
+        std::string file_name;
+        std::getline(cmd_input, file_name);
+        boost::algorithm::trim(file_name);
+        std::ifstream file(file_name, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Can't open file " + file_name);
+        }
+        const auto start = std::chrono::steady_clock::now();
+        const auto stats = use_cases_.ImportCatalog(file);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        output_ << "Imported "sv;
+        PrintCatalogRate(output_, stats.books, elapsed);
+        output_ << "New authors: "sv << stats.authors << ", tags: "sv << stats.tags << std::endl;
+    } catch (const std::exception& e) {
+        output_ << "Failed to import catalog: "sv << e.what() << std::endl;
+    }
+    return true;
+}
+
+bool View::ExportCatalog(std::istream& cmd_input) const {
+    try {
+        std::string file_name;
+        std::getline(cmd_input, file_name);
+        boost::algorithm::trim(file_name);
+        std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("Can't open file " + file_name);
+        }
+        const auto start = std::chrono::steady_clock::now();
+        const size_t count = use_cases_.ExportCatalog(file);
+        file.flush();
+        if (!file) {
+            throw std::runtime_error("Can't write file " + file_name);
+        }
+        output_ << "Exported "sv;
+        PrintCatalogRate(output_, count, std::chrono::steady_clock::now() - start);
+    } catch (const std::exception& e) {
+        output_ << "Failed to export catalog: "sv << e.what() << std::endl;
+    }
+    return true;
+}
+
 }  // namespace ui
@@ -1,4 +1,5 @@
 #pragma once
+#include <functional>
 #include <iosfwd>
 #include <optional>
 #include <string>
@@ -39,6 +40,14 @@ struct BookInfoAllBooks {
     std::string title;
     std::string author_name;
     int publication_year;
+    // Теги через запятую, если они есть
+    std::optional<std::string> tags;
+};
+
+struct CatalogStats {
+    size_t books = 0;
+    size_t authors = 0;
+    size_t tags = 0;
 };
 
 }  // namespace detail
@@ -59,16 +68,21 @@ private:
     bool ShowBooks() const;
     bool ShowBook(std::istream& cmd_input) const;
     bool ShowAuthorBooks() const;
+    bool SearchBooks(std::istream& cmd_input) const;
+    bool ImportCatalog(std::istream& cmd_input) const;
+    bool ExportCatalog(std::istream& cmd_input) const;
 
     std::optional<detail::AddBookParams> GetBookParams(std::istream& cmd_input) const;
     std::optional<std::string> SelectAuthor(std::vector<detail::AuthorInfo>& authors) const;
     std::optional<std::string> SelectBook() const;
     std::optional<std::string> SelectBookFromBooks(std::vector<ui::detail::BookInfoAllBooks> books) const;
+    // Чтение страниц списка книг в порядке ShowBooks
+    std::function<std::vector<detail::BookInfoAllBooks>(const std::optional<detail::BookInfoAllBooks>&, size_t)>
+    GetBooksPage() const;
     std::vector<detail::AuthorInfo> GetAuthors() const;
     std::optional<std::string> GetAuthorsIdByAuthorName(const std::string& author_name) const;
     detail::BookInfoAllBooks GetBookByBookId(const std::string& id) const;
     std::vector<detail::BookInfo> GetBooks() const;
-    std::vector<detail::BookInfoAllBooks> GetAllBooksForShow() const;
     std::vector<detail::BookInfo> GetAuthorBooks(const std::string& author_id) const;
 
     void printBook(const ui::detail::BookInfoAllBooks& book) const;
@@ -0,0 +1,76 @@
+#include "csv.h"
+
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace util {
+
+std::optional<std::vector<std::string>> ReadCsvRecord(std::istream& input) {
+    std::string line;
+    if (!std::getline(input, line)) {
+        return std::nullopt;
+    }
+
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    size_t pos = 0;
+    while (true) {
+        if (pos == line.size()) {
+            if (!quoted) {
+                break;
+            }
+            // Перевод строки внутри кавычек относится к полю
+            if (!std::getline(input, line)) {
+                throw std::runtime_error("Unterminated quoted CSV field");
+            }
+            fields.back() += '\n';
+            pos = 0;
+            continue;
+        }
+        const char c = line[pos++];
+        if (quoted) {
+            if (c != '"') {
+                fields.back() += c;
+            } else if (pos < line.size() && line[pos] == '"') {
+                fields.back() += '"';
+                ++pos;
+            } else {
+                quoted = false;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.emplace_back();
+        } else if (c == '\r' && pos == line.size()) {
+            // \r в конце строки - часть перевода строки CRLF
+        } else {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+void WriteCsvRecord(std::ostream& output, const std::vector<std::string>& fields) {
+    for (size_t i = 0; i < fields.size(); ++i) {
+        if (i > 0) {
+            output << ',';
+        }
+        const std::string& field = fields[i];
+        if (field.find_first_of(",\"\r\n") == std::string::npos) {
+            output << field;
+            continue;
+        }
+        output << '"';
+        for (char c : field) {
+            if (c == '"') {
+                output << '"';
+            }
+            output << c;
+        }
+        output << '"';
+    }
+    output << '\n';
+}
+
+}  // namespace util
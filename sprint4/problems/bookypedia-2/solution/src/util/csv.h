@@ -0,0 +1,18 @@
+#pragma once
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace util {
+
+// Запись CSV по RFC 4180: поля через запятую, поле с запятой, кавычкой или переводом строки
+// берётся в двойные кавычки, кавычка внутри поля удваивается
+
+// Читает следующую запись, nullopt в конце потока.
+// Бросает std::runtime_error, если кавычка поля не закрыта
+std::optional<std::vector<std::string>> ReadCsvRecord(std::istream& input);
+
+void WriteCsvRecord(std::ostream& output, const std::vector<std::string>& fields);
+
+}  // namespace util
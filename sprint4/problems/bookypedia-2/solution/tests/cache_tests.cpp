@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/postgres/cache.h"
+
+using postgres::AuthorsCache;
+using postgres::BooksCache;
+
+namespace {
+
+ui::detail::BookInfoAllBooks MakeBook(const std::string& id, const std::string& title) {
+    return {id, title, "author", 2000, std::nullopt};
+}
+
+}  // namespace
+
+TEST_CASE("Authors cache") {
+    AuthorsCache cache;
+    const domain::Author tolkien{domain::AuthorId::New(), "Tolkien"};
+    const domain::Author rowling{domain::AuthorId::New(), "Rowling"};
+
+    SECTION("writes before the first fill are ignored") {
+        cache.Put(tolkien);
+        CHECK_FALSE(cache.IsFilled());
+        CHECK_FALSE(cache.FindIdByName("Tolkien"));
+    }
+
+    cache.Fill({rowling, tolkien});
+    REQUIRE(cache.HasSortedList());
+    CHECK(cache.FindIdByName("Tolkien") == tolkien.GetId());
+
+    SECTION("removing an author keeps the list") {
+        cache.Remove(rowling.GetId().ToString());
+        CHECK(cache.HasSortedList());
+        REQUIRE(cache.GetAll().size() == 1);
+        CHECK(cache.GetAll().front().GetName() == "Tolkien");
+        CHECK_FALSE(cache.FindIdByName("Rowling"));
+    }
+
+    SECTION("renaming an author invalidates only the sorted list") {
+        cache.Rename(tolkien.GetId().ToString(), "J. R. R. Tolkien");
+        CHECK_FALSE(cache.HasSortedList());
+        CHECK_FALSE(cache.FindIdByName("Tolkien"));
+        CHECK(cache.FindIdByName("J. R. R. Tolkien") == tolkien.GetId());
+    }
+
+    SECTION("renaming an unknown author changes nothing") {
+        cache.Rename(domain::AuthorId::New().ToString(), "Nobody");
+        CHECK(cache.HasSortedList());
+        CHECK_FALSE(cache.FindIdByName("Nobody"));
+    }
+}
+
+TEST_CASE("Books cache") {
+    BooksCache cache{2};
+    cache.Put("1", "a", MakeBook("1", "One"));
+    cache.Put("2", "b", MakeBook("2", "Two"));
+
+    SECTION("the least recently read book is evicted") {
+        CHECK(cache.Get("1"));
+        cache.Put("3", "a", MakeBook("3", "Three"));
+        CHECK(cache.GetSize() == 2);
+        CHECK(cache.Get("1"));
+        CHECK_FALSE(cache.Get("2"));
+        CHECK(cache.Get("3")->title == "Three");
+    }
+
+    SECTION("books of a removed author are dropped") {
+        cache.RemoveByAuthor("a");
+        CHECK_FALSE(cache.Get("1"));
+        CHECK(cache.Get("2"));
+    }
+
+    SECTION("putting a book again replaces it") {
+        cache.Put("1", "a", MakeBook("1", "One, revised"));
+        CHECK(cache.GetSize() == 2);
+        CHECK(cache.Get("1")->title == "One, revised");
+    }
+}
@@ -4,16 +4,31 @@
 #include "../src/domain/author.h"
 #include "../src/domain/book.h"
 #include "../src/domain/tag.h"
+#include "../src/menu/menu.h"
+#include "../src/ui/view.h"
+#include "../src/util/csv.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+
+using namespace std::literals;
 
 namespace {
 
 struct MockAuthorRepository : domain::AuthorRepository {
     std::vector<domain::Author> saved_authors;
+    std::vector<std::optional<std::string>> page_cursors;
 
     void Save(const domain::Author& author) override {
         saved_authors.emplace_back(author);
     }
 
+    void SaveAll(const std::vector<domain::Author>& authors) override {
+        saved_authors.insert(saved_authors.end(), authors.begin(), authors.end());
+    }
+
     void Delete(const std::string& id) override {
 
     }
@@ -23,19 +38,49 @@ struct MockAuthorRepository : domain::AuthorRepository {
     }
 
     std::vector<domain::Author> GetAllAuthors() override {
-        std::vector<domain::Author> authors;
-        return authors;
+        return saved_authors;
+    }
+
+    std::optional<domain::AuthorId> FindIdByName(const std::string& name) override {
+        for (const auto& author : saved_authors) {
+            if (author.GetName() == name) {
+                return author.GetId();
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Авторы добавляются в тестах уже по порядку имён
+    std::vector<domain::Author> GetAuthorsPage(const std::optional<std::string>& after_name, size_t limit) override {
+        page_cursors.push_back(after_name);
+        std::vector<domain::Author> page;
+        for (const auto& author : saved_authors) {
+            if ((!after_name || author.GetName() > *after_name) && page.size() < limit) {
+                page.push_back(author);
+            }
+        }
+        return page;
     }
 };
 
 struct MockBookRepository : domain::BookRepository {
     std::vector<domain::Book> saved_book;
+    size_t save_all_calls = 0;
+    // Книги для списков, уже в порядке названий
+    std::vector<ui::detail::BookInfoAllBooks> books_for_show;
+    std::vector<std::optional<std::string>> page_cursor_ids;
+    std::vector<std::string> search_queries;
+    std::vector<std::string> deleted_ids;
 
     void Save(const domain::Book& book) override {
         saved_book.emplace_back(book);
     }
+    void SaveAll(const std::vector<domain::Book>& books) override {
+        ++save_all_calls;
+        saved_book.insert(saved_book.end(), books.begin(), books.end());
+    }
     void Delete(const std::string& id) override {
-
+        deleted_ids.push_back(id);
     }
     std::vector<domain::Book> GetBooksBy(const std::string& author_id) override {
         std::vector<domain::Book> books;
@@ -47,16 +92,31 @@ struct MockBookRepository : domain::BookRepository {
 
         return books;
     }
-    std::vector<ui::detail::BookInfoAllBooks> GetAllBooksForShow() override {
-        std::vector<ui::detail::BookInfoAllBooks> books_info;
-
-        return books_info;
+    std::vector<ui::detail::BookInfoAllBooks> GetBooksPageForShow(
+        const std::optional<ui::detail::BookInfoAllBooks>& after, size_t limit) override {
+        page_cursor_ids.push_back(after ? std::optional{after->id} : std::nullopt);
+        auto it = books_for_show.begin();
+        if (after) {
+            it = std::find_if(books_for_show.begin(), books_for_show.end(), [&after](const auto& book) {
+                return book.id == after->id;
+            }) + 1;
+        }
+        return {it, it + std::min<size_t>(limit, books_for_show.end() - it)};
+    }
+    void ForEachBookForShow(const std::function<void(const ui::detail::BookInfoAllBooks&)>& fn) override {
+        for (const auto& book : books_for_show) {
+            fn(book);
+        }
     }
     std::vector<ui::detail::BookInfoAllBooks> GetBooksBytitle(const std::string& title) override {
         std::vector<ui::detail::BookInfoAllBooks> books_info;
 
         return books_info;
     }
+    std::vector<ui::detail::BookInfoAllBooks> SearchBooks(const std::string& query, size_t limit) override {
+        search_queries.push_back(query);
+        return {};
+    }
     ui::detail::BookInfoAllBooks GetBook(const std::string& id) override {
         ui::detail::BookInfoAllBooks book_info;
 
@@ -70,8 +130,10 @@ struct MockBookRepository : domain::BookRepository {
 
 struct MockTagRepository : domain::TagRepository {
     std::vector<domain::Tag> saved_tag;
-    void Save(const domain::Tag& tag) override {
-        saved_tag.emplace_back(tag);
+    size_t save_calls = 0;
+    void SaveAll(const std::vector<domain::Tag>& tags) override {
+        ++save_calls;
+        saved_tag.insert(saved_tag.end(), tags.begin(), tags.end());
     }
     std::optional<std::string> GetTagsByBookId(const std::string book_id) override{
         return std::nullopt;
@@ -81,17 +143,102 @@ struct MockTagRepository : domain::TagRepository {
     }
 };
 
-struct Fixture {
+struct MockRepositories {
     MockAuthorRepository authors;
     MockBookRepository books;
     MockTagRepository tags;
+    size_t commits = 0;
+};
+
+// Изменения мок-репозиториев видны сразу, единица работы только считает фиксации
+struct MockUnitOfWork : app::UnitOfWork {
+    explicit MockUnitOfWork(MockRepositories& repositories)
+        : repositories{repositories} {
+    }
+
+    void Commit() override {
+        ++repositories.commits;
+    }
+    domain::AuthorRepository& Authors() override {
+        return repositories.authors;
+    }
+    domain::BookRepository& Books() override {
+        return repositories.books;
+    }
+    domain::TagRepository& Tags() override {
+        return repositories.tags;
+    }
+
+    MockRepositories& repositories;
+};
+
+struct MockUnitOfWorkFactory : app::UnitOfWorkFactory {
+    std::unique_ptr<app::UnitOfWork> CreateUnitOfWork() override {
+        ++created;
+        return std::make_unique<MockUnitOfWork>(repositories);
+    }
+
+    MockRepositories repositories;
+    size_t created = 0;
+};
+
+// Единица работы с откатом: репозитории работают с копией данных,
+// которая заменяет общие данные только при Commit
+struct TransactionalUnitOfWorkFactory : app::UnitOfWorkFactory {
+    struct UnitOfWork : app::UnitOfWork {
+        explicit UnitOfWork(TransactionalUnitOfWorkFactory& factory)
+            : factory{factory}
+            , repositories{factory.repositories} {
+        }
+
+        ~UnitOfWork() override {
+            if (!committed) {
+                ++factory.rollbacks;
+            }
+        }
+
+        void Commit() override {
+            ++repositories.commits;
+            factory.repositories = repositories;
+            committed = true;
+        }
+        domain::AuthorRepository& Authors() override {
+            return repositories.authors;
+        }
+        domain::BookRepository& Books() override {
+            return repositories.books;
+        }
+        domain::TagRepository& Tags() override {
+            return repositories.tags;
+        }
+
+        TransactionalUnitOfWorkFactory& factory;
+        MockRepositories repositories;
+        bool committed = false;
+    };
+
+    std::unique_ptr<app::UnitOfWork> CreateUnitOfWork() override {
+        ++created;
+        return std::make_unique<UnitOfWork>(*this);
+    }
+
+    MockRepositories repositories;
+    size_t created = 0;
+    size_t rollbacks = 0;
+};
+
+struct Fixture {
+    MockUnitOfWorkFactory factory;
+    MockAuthorRepository& authors = factory.repositories.authors;
+    MockBookRepository& books = factory.repositories.books;
+    MockTagRepository& tags = factory.repositories.tags;
 };
 
 }  // namespace
 
 SCENARIO_METHOD(Fixture, "Book Adding") {
     GIVEN("Use cases") {
-        app::UseCasesImpl use_cases(authors, books, tags);
+        app::UseCasesImpl use_cases(factory);
 
         WHEN("Adding an author") {
             const auto author_name = "Joanne Rowling";
@@ -105,3 +252,232 @@ SCENARIO_METHOD(Fixture, "Book Adding") {
         }
     }
 }
+
+SCENARIO_METHOD(Fixture, "Unit of work") {
+    GIVEN("Use cases") {
+        app::UseCasesImpl use_cases(factory);
+        const std::string author_id = domain::AuthorId::New().ToString();
+
+        WHEN("Adding a book with tags") {
+            auto book = use_cases.AddBook(author_id, "Harry Potter", 1997, {"fantasy", "magic", "school"});
+
+            THEN("the book and all its tags are saved in one commit and one tag batch") {
+                CHECK(factory.created == 1);
+                CHECK(factory.repositories.commits == 1);
+                REQUIRE(books.saved_book.size() == 1);
+                CHECK(books.saved_book.at(0).GetId().ToString() == book.id);
+                CHECK(tags.save_calls == 1);
+                REQUIRE(tags.saved_tag.size() == 3);
+                CHECK(tags.saved_tag.at(0).GetBookId().ToString() == book.id);
+            }
+        }
+
+        WHEN("Editing a book") {
+            const std::string book_id = domain::BookId::New().ToString();
+            use_cases.UpdateBook(book_id, "Harry Potter", 1998, {"fantasy"});
+
+            THEN("the book and its tags are replaced in one commit") {
+                CHECK(factory.repositories.commits == 1);
+                CHECK(tags.save_calls == 1);
+            }
+        }
+
+        WHEN("Reading data") {
+            use_cases.GetAllAuthors();
+            use_cases.GetTagsByBookId(domain::BookId::New().ToString());
+
+            THEN("nothing is committed") {
+                CHECK(factory.created == 2);
+                CHECK(factory.repositories.commits == 0);
+            }
+        }
+    }
+}
+
+SCENARIO_METHOD(Fixture, "Catalog import and export") {
+    GIVEN("Use cases and a known author") {
+        app::UseCasesImpl use_cases(factory);
+        const domain::AuthorId tolkien_id = domain::AuthorId::New();
+        authors.saved_authors.emplace_back(tolkien_id, "J. R. R. Tolkien");
+
+        WHEN("Importing a catalog") {
+            std::istringstream input(
+                "title,author,publication_year,tags\r\n"
+                "The Hobbit,J. R. R. Tolkien,1937,\"fantasy, adventure\"\r\n"
+                "\"Hello, \"\"World\"\"\",Jane Doe,2001\r\n"
+                "Second,Jane Doe,2002,\r\n");
+            const auto stats = use_cases.ImportCatalog(input);
+
+            THEN("books are saved in one commit and authors are resolved by name") {
+                CHECK(factory.repositories.commits == 1);
+                CHECK(stats.books == 3);
+                CHECK(stats.authors == 1);
+                CHECK(stats.tags == 2);
+                REQUIRE(books.saved_book.size() == 3);
+                CHECK(books.save_all_calls == 1);
+                CHECK(books.saved_book.at(0).GetAuthorId() == tolkien_id);
+                CHECK(books.saved_book.at(1).GetTitle() == "Hello, \"World\"");
+                CHECK(books.saved_book.at(1).GetAuthorId() == books.saved_book.at(2).GetAuthorId());
+                REQUIRE(authors.saved_authors.size() == 2);
+                CHECK(authors.saved_authors.at(1).GetName() == "Jane Doe");
+                CHECK(authors.saved_authors.at(1).GetId() == books.saved_book.at(1).GetAuthorId());
+                REQUIRE(tags.saved_tag.size() == 2);
+                CHECK(tags.saved_tag.at(0).GetTag() == "adventure");
+                CHECK(tags.saved_tag.at(0).GetBookId() == books.saved_book.at(0).GetId());
+            }
+        }
+
+        WHEN("Importing a broken record") {
+            std::istringstream input("The Hobbit,J. R. R. Tolkien,nineteen\n");
+
+            THEN("nothing is committed") {
+                CHECK_THROWS(use_cases.ImportCatalog(input));
+                CHECK(factory.repositories.commits == 0);
+            }
+        }
+
+        WHEN("Exporting the catalog") {
+            books.books_for_show.push_back({"id", "Hello, \"World\"", "Jane Doe", 2001, "a, b"});
+            books.books_for_show.push_back({"id", "Untagged", "Jane Doe", 2002, std::nullopt});
+            std::stringstream output;
+            const size_t count = use_cases.ExportCatalog(output);
+
+            THEN("every book is written as a CSV record after the header") {
+                CHECK(count == 2);
+                CHECK(util::ReadCsvRecord(output)->at(0) == "title");
+                CHECK(*util::ReadCsvRecord(output)
+                      == std::vector<std::string>{"Hello, \"World\"", "Jane Doe", "2001", "a, b"});
+                CHECK(*util::ReadCsvRecord(output)
+                      == std::vector<std::string>{"Untagged", "Jane Doe", "2002", ""});
+                CHECK_FALSE(util::ReadCsvRecord(output));
+            }
+        }
+    }
+}
+
+SCENARIO("Catalog import transaction") {
+    GIVEN("Use cases over repositories that keep changes only on commit") {
+        TransactionalUnitOfWorkFactory factory;
+        app::UseCasesImpl use_cases(factory);
+        const MockRepositories& committed = factory.repositories;
+        // Больше, чем книг в одной пачке импорта, поэтому пачек несколько
+        constexpr size_t BOOKS_COUNT = 25'000;
+        std::ostringstream catalog;
+        for (size_t i = 0; i < BOOKS_COUNT; ++i) {
+            catalog << "Book " << i << ",Author " << i % 100 << ",2000,\"a, b\"\n";
+        }
+
+        WHEN("Importing a large catalog") {
+            std::istringstream input(catalog.str());
+            const auto stats = use_cases.ImportCatalog(input);
+
+            THEN("all batches are flushed in one transaction") {
+                CHECK(factory.created == 1);
+                CHECK(committed.commits == 1);
+                CHECK(committed.books.save_all_calls > 1);
+                CHECK(committed.books.saved_book.size() == BOOKS_COUNT);
+                CHECK(committed.authors.saved_authors.size() == 100);
+                CHECK(committed.tags.saved_tag.size() == 2 * BOOKS_COUNT);
+                CHECK(stats.books == BOOKS_COUNT);
+            }
+        }
+
+        WHEN("A broken record follows batches that were already flushed") {
+            std::istringstream input(catalog.str() + "Broken,Author 0,nineteen\n");
+
+            THEN("the whole import is rolled back") {
+                CHECK_THROWS(use_cases.ImportCatalog(input));
+                CHECK(factory.rollbacks == 1);
+                CHECK(committed.commits == 0);
+                CHECK(committed.books.saved_book.empty());
+                CHECK(committed.authors.saved_authors.empty());
+                CHECK(committed.tags.saved_tag.empty());
+            }
+        }
+    }
+}
+
+// SQL постраничных запросов здесь не проверяется: для этого нужен PostgreSQL.
+// Проверяется, какой ключ страницы use case передаёт репозиторию
+SCENARIO_METHOD(Fixture, "Authors paging") {
+    GIVEN("Use cases and five authors") {
+        app::UseCasesImpl use_cases(factory);
+        for (const char* name : {"A", "B", "C", "D", "E"}) {
+            authors.saved_authors.emplace_back(domain::AuthorId::New(), name);
+        }
+
+        WHEN("Reading authors by pages of two") {
+            std::vector<std::string> names;
+            std::optional<ui::detail::AuthorInfo> last;
+            size_t pages = 0;
+            while (true) {
+                auto page = use_cases.GetAuthorsPage(last, 2);
+                ++pages;
+                for (const auto& author : page) {
+                    names.push_back(author.name);
+                }
+                if (page.size() < 2) {
+                    break;
+                }
+                last = page.back();
+            }
+
+            THEN("the repository is asked for the page after the name of the last author shown") {
+                CHECK(authors.page_cursors
+                      == std::vector<std::optional<std::string>>{std::nullopt, "B"s, "D"s});
+                CHECK(names == std::vector<std::string>{"A", "B", "C", "D", "E"});
+                CHECK(pages == 3);
+                CHECK(factory.repositories.commits == 0);
+            }
+        }
+    }
+}
+
+SCENARIO_METHOD(Fixture, "Selecting a book from the whole catalog") {
+    GIVEN("A view over a catalog of several pages") {
+        app::UseCasesImpl use_cases(factory);
+        for (int i = 1; i <= 250; ++i) {
+            char title[16];
+            std::snprintf(title, sizeof(title), "Book %03d", i);
+            books.books_for_show.push_back({"id" + std::to_string(i), title, "Jane Doe", 2000, std::nullopt});
+        }
+
+        WHEN("Deleting a book chosen by its number in the list") {
+            std::istringstream input("DeleteBook\n150\n");
+            std::ostringstream output;
+            menu::Menu menu{input, output};
+            ui::View view{menu, use_cases, input, output};
+            menu.Run();
+
+            THEN("the list is read page by page and only the page of the chosen book is read again") {
+                CHECK(books.deleted_ids == std::vector<std::string>{"id150"});
+                CHECK(books.page_cursor_ids
+                      == std::vector<std::optional<std::string>>{std::nullopt, "id100"s, "id200"s, "id100"s});
+                CHECK(output.str().find("250 Book 250 by Jane Doe, 2000\n") != std::string::npos);
+            }
+        }
+    }
+}
+
+SCENARIO_METHOD(Fixture, "Book search") {
+    GIVEN("Use cases") {
+        app::UseCasesImpl use_cases(factory);
+
+        WHEN("Searching with extra spaces") {
+            use_cases.SearchBooks("  harry   potter ", 10);
+
+            THEN("the query is normalized before it reaches the repository") {
+                CHECK(books.search_queries == std::vector<std::string>{"harry potter"});
+            }
+        }
+
+        WHEN("Searching with a blank query") {
+            use_cases.SearchBooks("   ", 10);
+
+            THEN("the repository is not queried") {
+                CHECK(books.search_queries.empty());
+                CHECK(factory.created == 0);
+            }
+        }
+    }
+}
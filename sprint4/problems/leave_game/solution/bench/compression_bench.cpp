@@ -0,0 +1,109 @@
+// Цена сжатия ответов: время процессора на уровнях zlib против сэкономленных байтов.
+// Без аргументов сжимает синтетическое состояние игры разного размера, с аргументами - указанные
+// файлы (например, static/js/three.min.js или static/assets/pug.fbx)
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../src/model/random.h"
+#include "../src/wire/compression.h"
+#include "../src/wire/json_writer.h"
+
+using namespace std::literals;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// Суммарный объём, который сжимается на каждом уровне, чтобы время замера не зависело от размера данных
+constexpr size_t BYTES_PER_MEASURE = 64 * 1024 * 1024;
+
+struct Payload {
+    std::string name;
+    std::string data;
+};
+
+// Ответ /api/v1/game/state с dogs собаками и таким же числом потерянных предметов
+std::string MakeStateJson(size_t dogs, model::random::Engine& random) {
+    wire::JsonWriter writer;
+    writer.StartObject();
+    writer.Key("players"sv);
+    writer.StartObject();
+    for (size_t i = 0; i < dogs; ++i) {
+        writer.Key(std::to_string(i));
+        writer.StartObject();
+        writer.Key("pos"sv);
+        writer.Pair(random.UniformReal() * 100.0, random.UniformReal() * 100.0);
+        writer.Key("speed"sv);
+        writer.Pair(random.UniformInt(0, 1) == 0 ? 0.0 : 3.0, 0.0);
+        writer.Key("dir"sv);
+        writer.String("U"sv);
+        writer.Key("bag"sv);
+        writer.StartArray();
+        writer.EndArray();
+        writer.Key("score"sv);
+        writer.Uint(static_cast<uint64_t>(random.UniformInt(0, 500)));
+        writer.EndObject();
+    }
+    writer.EndObject();
+    writer.Key("lostObjects"sv);
+    writer.StartObject();
+    for (size_t i = 0; i < dogs; ++i) {
+        writer.Key(std::to_string(dogs + i));
+        writer.StartObject();
+        writer.Key("type"sv);
+        writer.Uint(static_cast<uint64_t>(random.UniformInt(0, 4)));
+        writer.Key("pos"sv);
+        writer.Pair(static_cast<double>(random.UniformInt(0, 100)), static_cast<double>(random.UniformInt(0, 100)));
+        writer.EndObject();
+    }
+    writer.EndObject();
+    writer.EndObject();
+    return writer.TakeBuffer();
+}
+
+void Measure(const Payload& payload, int level) {
+    const size_t iterations = std::max<size_t>(1, BYTES_PER_MEASURE / std::max<size_t>(payload.data.size(), 1));
+    size_t compressed_size = 0;
+    const auto start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        compressed_size = wire::Compress(payload.data, wire::ContentEncoding::GZIP, level).size();
+    }
+    const double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / iterations;
+    const double saved = static_cast<double>(payload.data.size()) - static_cast<double>(compressed_size);
+    std::cout << "  level " << level << ": " << us << " us, " << compressed_size << " bytes ("
+              << 100.0 * compressed_size / payload.data.size() << "%), "
+              << payload.data.size() / us << " MB/s, "
+              << saved / us << " bytes saved per us" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    std::vector<Payload> payloads;
+    if (argc > 1) {
+        for (int i = 1; i < argc; ++i) {
+            std::ifstream input{argv[i], std::ios::binary};
+            if (!input) {
+                std::cerr << "Failed to open " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+            payloads.push_back({argv[i], std::string{std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{}}});
+        }
+    } else {
+        model::random::Engine random{42};
+        for (size_t dogs : {20, 200, 2000}) {
+            payloads.push_back({"state json, "s + std::to_string(dogs) + " dogs"s, MakeStateJson(dogs, random)});
+        }
+    }
+
+    for (const Payload& payload : payloads) {
+        std::cout << payload.name << ", " << payload.data.size() << " bytes:" << std::endl;
+        for (int level : {1, 6, 9}) {
+            Measure(payload, level);
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+// Время загрузки большого конфига с несколькими картами: одним потоком, всеми ядрами и из кеша карт.
+// Запуск: config_load_bench [размер конфига в МБ, по умолчанию 500] [число карт, по умолчанию 64]
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "../src/json_loader/json_loader.h"
+#include "../src/json_loader/map_cache.h"
+
+using namespace std::literals;
+using Clock = std::chrono::steady_clock;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int ROAD_LENGTH = 40;
+// Дороги карты укладываются в квадрат, чтобы граф дорог строился при загрузке
+constexpr int ROADS_PER_ROW = 100;
+constexpr int ROW_STEP = 4;
+
+void WriteMap(std::ostream& out, int index, uint64_t roads_bytes) {
+    out << R"({"id":"map)" << index << R"(","name":"Map )" << index << R"(","dogSpeed":3.5,"roads":[)";
+    const std::streamoff start = out.tellp();
+    for (int i = 0; static_cast<uint64_t>(out.tellp() - start) < roads_bytes; ++i) {
+        const int row = i / ROADS_PER_ROW % 1000;
+        const int column = i % ROADS_PER_ROW;
+        if (i > 0) {
+            out << ',';
+        }
+        if (i % 2 == 0) {
+            out << R"({"x0":)" << column * ROW_STEP << R"(,"y0":)" << row * ROW_STEP
+                << R"(,"x1":)" << column * ROW_STEP + ROAD_LENGTH << '}';
+        } else {
+            out << R"({"x0":)" << column * ROW_STEP << R"(,"y0":)" << row * ROW_STEP
+                << R"(,"y1":)" << row * ROW_STEP + ROAD_LENGTH << '}';
+        }
+    }
+    out << R"(],"buildings":[{"x":1,"y":1,"w":2,"h":2}],)"
+        << R"("offices":[{"id":"o0","x":0,"y":0,"offsetX":5,"offsetY":0}],)"
+        << R"("lootTypes":[{"name":"key","file":"assets/key.obj","type":"obj","rotation":90,"color":"#338844","scale":0.03,"value":10}]})";
+}
+
+void WriteConfig(const fs::path& path, uint64_t size_bytes, int maps) {
+    std::ofstream out(path);
+    out << R"({"defaultDogSpeed":3.0,"lootGeneratorConfig":{"period":5.0,"probability":0.5},"maps":[)";
+    for (int i = 0; i < maps; ++i) {
+        if (i > 0) {
+            out << ',';
+        }
+        WriteMap(out, i, size_bytes / maps);
+    }
+    out << "]}";
+}
+
+void Measure(const fs::path& path, unsigned threads) {
+    const auto start = Clock::now();
+    const model::Game game = json_loader::LoadGame(path, threads);
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    const double megabytes = static_cast<double>(fs::file_size(path)) / (1024 * 1024);
+    std::cout << "threads " << threads << ": " << game.GetMaps().size() << " maps in " << seconds << " s, "
+              << megabytes / seconds << " MB/s" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    try {
+        const uint64_t size_mb = argc > 1 ? std::stoull(argv[1]) : 500;
+        const int maps = argc > 2 ? std::stoi(argv[2]) : 64;
+        if (maps <= 0) {
+            throw std::invalid_argument("Maps count must be positive"s);
+        }
+
+        const fs::path path = fs::temp_directory_path() / "config_load_bench.json"s;
+        WriteConfig(path, size_mb * 1024 * 1024, maps);
+        std::cout << "config: " << fs::file_size(path) << " bytes, " << maps << " maps" << std::endl;
+
+        // Первый проход прогревает кеш страниц, чтобы замеры не зависели от диска
+        Measure(path, 1);
+        Measure(path, 1);
+        Measure(path, std::max(std::thread::hardware_concurrency(), 1u));
+
+        const fs::path cache_path = fs::temp_directory_path() / "config_load_bench.cache"s;
+        json_loader::SaveGameCache(json_loader::LoadGame(path), path, cache_path);
+        const auto start = Clock::now();
+        const auto cached_game = json_loader::LoadGameFromCache(path, cache_path);
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (!cached_game) {
+            throw std::runtime_error("Map cache does not match the config"s);
+        }
+        std::cout << "cache: " << cached_game->GetMaps().size() << " maps in " << seconds << " s, "
+                  << fs::file_size(cache_path) << " bytes" << std::endl;
+
+        fs::remove(cache_path);
+        fs::remove(path);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,393 @@
+// Нагрузочный тест game_server: эмулирует N игроков, которые входят в игру, случайно
+// двигаются и опрашивают состояние с заданной частотой. Результат выводится в виде JSON
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/json.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "../src/metrics/metrics.h"
+
+namespace net = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace json = boost::json;
+using tcp = net::ip::tcp;
+using namespace std::literals;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Args {
+    std::string host{"127.0.0.1"};
+    std::string port{"8080"};
+    std::string map_id;
+    uint32_t players{100};
+    uint32_t threads{4};
+    double duration_s{30.0};
+    double move_rate{2.0};
+    double state_rate{10.0};
+    double tick_rate{0.0};
+    uint32_t tick_delta_ms{50};
+    uint32_t seed{42};
+    std::string output;
+};
+
+std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
+    namespace po = boost::program_options;
+
+    po::options_description desc{"All options"s};
+    Args args;
+    desc.add_options()
+            ("help,h", "produce help message")
+            ("host", po::value(&args.host)->value_name("address"s), "server address")
+            ("port", po::value(&args.port)->value_name("port"s), "server port")
+            ("map", po::value(&args.map_id)->value_name("id"s), "map to join, the first map by default")
+            ("players,n", po::value(&args.players)->value_name("count"s), "number of simulated players")
+            ("threads,j", po::value(&args.threads)->value_name("count"s), "number of client threads")
+            ("duration,d", po::value(&args.duration_s)->value_name("seconds"s), "test duration")
+            ("move-rate", po::value(&args.move_rate)->value_name("rps"s), "moves per second per player")
+            ("state-rate", po::value(&args.state_rate)->value_name("rps"s), "state polls per second per player")
+            ("tick-rate", po::value(&args.tick_rate)->value_name("rps"s), "manual ticks per second, 0 to disable")
+            ("tick-delta", po::value(&args.tick_delta_ms)->value_name("milliseconds"s), "time delta of manual ticks")
+            ("seed", po::value(&args.seed)->value_name("number"s), "random seed")
+            ("output,o", po::value(&args.output)->value_name("file"s), "write JSON report to file instead of stdout");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.contains("help"s)) {
+        std::cout << desc;
+        return std::nullopt;
+    }
+    if (args.players == 0 || args.threads == 0 || args.duration_s <= 0) {
+        throw std::runtime_error("players, threads and duration must be positive"s);
+    }
+    return args;
+}
+
+enum class Endpoint {
+    JOIN,
+    MOVE,
+    STATE,
+    TICK,
+    COUNT
+};
+
+constexpr std::array<std::string_view, static_cast<size_t>(Endpoint::COUNT)> ENDPOINT_NAMES{
+    "/api/v1/game/join"sv, "/api/v1/game/player/action"sv, "/api/v1/game/state"sv, "/api/v1/game/tick"sv
+};
+
+struct EndpointStats {
+    // От запланированного момента запроса до ответа. Если клиент отстал от расписания,
+    // ожидание входит в задержку, иначе медленные ответы скрывали бы очередь (coordinated omission)
+    metrics::Histogram latency;
+    // От отправки запроса до ответа
+    metrics::Histogram service_time;
+    metrics::Counter errors;
+};
+
+using Stats = std::array<EndpointStats, static_cast<size_t>(Endpoint::COUNT)>;
+
+// Синхронный HTTP-клиент с keep-alive соединением, переподключается после ошибок
+class Client {
+public:
+    Client(net::io_context& ioc, const Args& args)
+        : ioc_{ioc}
+        , args_{args} {
+    }
+
+    http::response<http::string_body> Send(http::verb method, std::string_view target,
+                                           const std::string& body = {}, const std::string& token = {}) {
+        if (!stream_) {
+            Connect();
+        }
+        http::request<http::string_body> req{method, target, 11};
+        req.set(http::field::host, args_.host);
+        req.keep_alive(true);
+        if (!token.empty()) {
+            req.set(http::field::authorization, "Bearer "s + token);
+        }
+        if (method == http::verb::post) {
+            req.set(http::field::content_type, "application/json");
+            req.body() = body;
+        }
+        req.prepare_payload();
+
+        try {
+            http::write(*stream_, req);
+            http::response<http::string_body> res;
+            http::read(*stream_, buffer_, res);
+            if (res.need_eof()) {
+                stream_.reset();
+            }
+            return res;
+        } catch (...) {
+            stream_.reset();
+            throw;
+        }
+    }
+
+private:
+    void Connect() {
+        tcp::resolver resolver{ioc_};
+        stream_.emplace(ioc_);
+        stream_->connect(resolver.resolve(args_.host, args_.port));
+        stream_->socket().set_option(tcp::no_delay(true));
+        buffer_.clear();
+    }
+
+    net::io_context& ioc_;
+    const Args& args_;
+    std::optional<beast::tcp_stream> stream_;
+    beast::flat_buffer buffer_;
+};
+
+struct Player {
+    std::string token;
+    Clock::time_point next_move;
+    Clock::time_point next_state;
+};
+
+// Нулевая частота означает, что запросы этого вида не отправляются
+Clock::duration RateToPeriod(double rate) {
+    if (rate <= 0) {
+        return Clock::duration::max();
+    }
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+}
+
+Clock::time_point Advance(Clock::time_point time, Clock::duration period) {
+    if (period == Clock::duration::max()) {
+        return Clock::time_point::max();
+    }
+    return time + period;
+}
+
+std::string FetchDefaultMap(net::io_context& ioc, const Args& args) {
+    Client client{ioc, args};
+    auto res = client.Send(http::verb::get, "/api/v1/maps"sv);
+    const auto maps = json::parse(res.body()).as_array();
+    if (maps.empty()) {
+        throw std::runtime_error("Server has no maps"s);
+    }
+    return json::value_to<std::string>(maps.front().at("id"));
+}
+
+// Выполняет запрос, запланированный на момент scheduled, и записывает его длительность.
+// Возвращает ответ при коде 200
+std::optional<http::response<http::string_body>> Measure(Client& client, EndpointStats& stats, Clock::time_point scheduled,
+                                                         http::verb method, std::string_view target,
+                                                         const std::string& body = {}, const std::string& token = {}) {
+    const auto start = Clock::now();
+    auto record = [&stats, scheduled, start] {
+        const auto end = Clock::now();
+        stats.latency.Record(end - std::min(scheduled, start));
+        stats.service_time.Record(end - start);
+    };
+    try {
+        auto res = client.Send(method, target, body, token);
+        record();
+        if (res.result() != http::status::ok) {
+            stats.errors.Add();
+            return std::nullopt;
+        }
+        return res;
+    } catch (const std::exception&) {
+        record();
+        stats.errors.Add();
+        return std::nullopt;
+    }
+}
+
+void RunWorker(const Args& args, const std::string& map_id, uint32_t first_player, uint32_t players_count,
+               bool drive_ticks, Clock::time_point deadline, Stats& stats) {
+    net::io_context ioc;
+    Client client{ioc, args};
+    std::mt19937 random{args.seed + first_player};
+    std::uniform_int_distribution<size_t> move_dist{0, 4};
+    constexpr std::array<std::string_view, 5> MOVES{"L"sv, "R"sv, "U"sv, "D"sv, ""sv};
+
+    const auto move_period = RateToPeriod(args.move_rate);
+    const auto state_period = RateToPeriod(args.state_rate);
+    const auto tick_period = drive_ticks ? RateToPeriod(args.tick_rate) : Clock::duration::max();
+    // Разносим первые запросы игроков по времени, чтобы они не приходили пачкой
+    const auto spread = std::min({move_period, state_period, Clock::duration{1s}});
+    std::uniform_int_distribution<Clock::rep> phase{0, spread.count()};
+
+    std::vector<Player> players;
+    players.reserve(players_count);
+    const std::string name_prefix = "bench_"s + std::to_string(::getpid()) + "_"s;
+    for (uint32_t i = first_player; i < first_player + players_count; ++i) {
+        json::object join_body{{"userName", name_prefix + std::to_string(i)}, {"mapId", map_id}};
+        // Вход в игру не следует расписанию, он начинается сразу после предыдущего
+        auto res = Measure(client, stats[static_cast<size_t>(Endpoint::JOIN)], Clock::now(), http::verb::post,
+                           ENDPOINT_NAMES[static_cast<size_t>(Endpoint::JOIN)], json::serialize(join_body));
+        if (!res) {
+            continue;
+        }
+        const auto now = Clock::now();
+        players.push_back({json::value_to<std::string>(json::parse(res->body()).at("authToken")),
+                           Advance(now, move_period == Clock::duration::max() ? move_period : Clock::duration{phase(random)}),
+                           Advance(now, state_period == Clock::duration::max() ? state_period : Clock::duration{phase(random)})});
+    }
+
+    auto next_tick = drive_ticks ? Clock::now() : Clock::time_point::max();
+    while (!players.empty()) {
+        auto it = std::min_element(players.begin(), players.end(), [](const Player& lhs, const Player& rhs) {
+            return std::min(lhs.next_move, lhs.next_state) < std::min(rhs.next_move, rhs.next_state);
+        });
+        const auto next_event = std::min({it->next_move, it->next_state, next_tick});
+        if (next_event >= deadline) {
+            break;
+        }
+        std::this_thread::sleep_until(next_event);
+
+        if (next_event == next_tick) {
+            json::object tick_body{{"timeDelta", args.tick_delta_ms}};
+            Measure(client, stats[static_cast<size_t>(Endpoint::TICK)], next_event, http::verb::post,
+                    ENDPOINT_NAMES[static_cast<size_t>(Endpoint::TICK)], json::serialize(tick_body));
+            next_tick = Advance(next_tick, tick_period);
+        } else if (next_event == it->next_move) {
+            json::object move_body{{"move", MOVES[move_dist(random)]}};
+            Measure(client, stats[static_cast<size_t>(Endpoint::MOVE)], next_event, http::verb::post,
+                    ENDPOINT_NAMES[static_cast<size_t>(Endpoint::MOVE)], json::serialize(move_body), it->token);
+            it->next_move = Advance(it->next_move, move_period);
+        } else {
+            Measure(client, stats[static_cast<size_t>(Endpoint::STATE)], next_event, http::verb::get,
+                    ENDPOINT_NAMES[static_cast<size_t>(Endpoint::STATE)], {}, it->token);
+            it->next_state = Advance(it->next_state, state_period);
+        }
+    }
+}
+
+double MicrosecondsToMilliseconds(uint64_t value_us) {
+    return static_cast<double>(value_us) / 1000.0;
+}
+
+json::object MakeReport(const Args& args, const std::string& map_id, const Stats& stats, double elapsed_s) {
+    json::object endpoints;
+    uint64_t total_requests = 0;
+    for (size_t i = 0; i < stats.size(); ++i) {
+        const auto snapshot = stats[i].latency.TakeSnapshot();
+        if (snapshot.Count() == 0) {
+            continue;
+        }
+        const auto service_snapshot = stats[i].service_time.TakeSnapshot();
+        total_requests += snapshot.Count();
+        endpoints[ENDPOINT_NAMES[i]] = json::object{
+            {"requests", snapshot.Count()},
+            {"errors", stats[i].errors.Value()},
+            {"rps", static_cast<double>(snapshot.Count()) / elapsed_s},
+            {"mean_ms", MicrosecondsToMilliseconds(snapshot.Sum()) / static_cast<double>(snapshot.Count())},
+            {"p50_ms", MicrosecondsToMilliseconds(snapshot.Percentile(0.5))},
+            {"p99_ms", MicrosecondsToMilliseconds(snapshot.Percentile(0.99))},
+            {"p999_ms", MicrosecondsToMilliseconds(snapshot.Percentile(0.999))},
+            {"max_ms", MicrosecondsToMilliseconds(snapshot.Percentile(1.0))},
+            {"service_p50_ms", MicrosecondsToMilliseconds(service_snapshot.Percentile(0.5))},
+            {"service_p99_ms", MicrosecondsToMilliseconds(service_snapshot.Percentile(0.99))},
+            {"service_max_ms", MicrosecondsToMilliseconds(service_snapshot.Percentile(1.0))}
+        };
+    }
+
+    return json::object{
+        {"config", json::object{
+            {"host", args.host},
+            {"port", args.port},
+            {"map", map_id},
+            {"players", args.players},
+            {"threads", args.threads},
+            {"duration_s", args.duration_s},
+            {"move_rate", args.move_rate},
+            {"state_rate", args.state_rate},
+            {"tick_rate", args.tick_rate},
+            {"seed", args.seed}
+        }},
+        {"elapsed_s", elapsed_s},
+        {"requests", total_requests},
+        {"throughput_rps", static_cast<double>(total_requests) / elapsed_s},
+        {"endpoints", std::move(endpoints)}
+    };
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    try {
+        auto args = ParseCommandLine(argc, argv);
+        if (!args) {
+            return EXIT_SUCCESS;
+        }
+
+        std::string map_id = args->map_id;
+        if (map_id.empty()) {
+            net::io_context ioc;
+            map_id = FetchDefaultMap(ioc, *args);
+        }
+
+        Stats stats;
+        const auto start = Clock::now();
+        const auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>(args->duration_s));
+        const uint32_t threads = std::min(args->threads, args->players);
+        // Исключение рабочего потока не должно завершать программу через std::terminate:
+        // оно переносится в главный поток и выбрасывается после join
+        std::vector<std::exception_ptr> errors(threads);
+        // Время нагрузки заканчивается с последним рабочим потоком, а не после join
+        std::vector<Clock::time_point> finished(threads, start);
+        {
+            std::vector<std::jthread> workers;
+            uint32_t first_player = 0;
+            for (uint32_t i = 0; i < threads; ++i) {
+                const uint32_t count = args->players / threads + (i < args->players % threads ? 1 : 0);
+                // Ручные тики отправляет только первый поток
+                const bool drive_ticks = i == 0 && args->tick_rate > 0;
+                workers.emplace_back([&args, &map_id, &stats, &errors, &finished, i, first_player, count, drive_ticks, deadline] {
+                    try {
+                        RunWorker(*args, map_id, first_player, count, drive_ticks, deadline, stats);
+                    } catch (...) {
+                        errors[i] = std::current_exception();
+                    }
+                    finished[i] = Clock::now();
+                });
+                first_player += count;
+            }
+        }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        const auto end = *std::max_element(finished.begin(), finished.end());
+        const double elapsed_s = std::chrono::duration<double>(end - start).count();
+
+        const std::string report = json::serialize(MakeReport(*args, map_id, stats, elapsed_s));
+        if (args->output.empty()) {
+            std::cout << report << std::endl;
+        } else {
+            std::ofstream out{args->output};
+            out << report << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
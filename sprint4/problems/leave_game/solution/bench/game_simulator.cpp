@@ -0,0 +1,267 @@
+// Детерминированная симуляция модели игры без HTTP-сервера, базы данных и таймеров.
+// Создаёт K сессий по M собак, которые двигаются по сценарию или под управлением ботов, и продвигает их
+// фиксированными шагами времени так быстро, как возможно. Результат выводится в виде JSON
+#include <boost/json.hpp>
+#include <boost/program_options.hpp>
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/json_loader/json_loader.h"
+#include "../src/metrics/metrics.h"
+#include "../src/model/random.h"
+
+namespace net = boost::asio;
+namespace json = boost::json;
+using namespace std::literals;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Args {
+    std::string config_file;
+    std::string map_id;
+    uint32_t sessions{4};
+    uint32_t dogs{constants::MAXPLAYERSINMAP};
+    uint32_t ticks{10'000};
+    uint32_t tick_delta_ms{50};
+    uint32_t turn_period{20};
+    uint64_t seed{42};
+    std::string bot_policy;
+    std::string output;
+};
+
+std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
+    namespace po = boost::program_options;
+
+    po::options_description desc{"All options"s};
+    Args args;
+    desc.add_options()
+            ("help,h", "produce help message")
+            ("config-file,c", po::value(&args.config_file)->value_name("file"s), "set config file path")
+            ("map", po::value(&args.map_id)->value_name("id"s), "map of the sessions, the first map by default")
+            ("sessions,k", po::value(&args.sessions)->value_name("count"s), "number of game sessions")
+            ("dogs,m", po::value(&args.dogs)->value_name("count"s), "number of dogs in each session")
+            ("ticks,n", po::value(&args.ticks)->value_name("count"s), "number of ticks to simulate")
+            ("tick-delta", po::value(&args.tick_delta_ms)->value_name("milliseconds"s), "time delta of a tick")
+            ("turn-period", po::value(&args.turn_period)->value_name("ticks"s), "ticks between direction changes")
+            ("seed", po::value(&args.seed)->value_name("number"s), "random seed")
+            ("bot-policy", po::value(&args.bot_policy)->value_name("name"s), "drive dogs by server-side bots: randomWalk or lootSeeker")
+            ("output,o", po::value(&args.output)->value_name("file"s), "write JSON report to file instead of stdout");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.contains("help"s)) {
+        std::cout << desc;
+        return std::nullopt;
+    }
+    if (!vm.contains("config-file"s)) {
+        throw std::runtime_error("Config file have not been specified"s);
+    }
+    if (args.sessions == 0 || args.tick_delta_ms == 0 || args.turn_period == 0) {
+        throw std::runtime_error("sessions, tick-delta and turn-period must be positive"s);
+    }
+    return args;
+}
+
+// Собака, управляемая сценарием: раз в turn_period тиков или после остановки
+// на конце дороги выбирает новое случайное направление
+struct ScriptedDog {
+    std::shared_ptr<model::Dog> dog;
+    uint32_t ticks_to_turn = 0;
+};
+
+void Turn(model::Dog& dog, double speed, model::random::Engine& random) {
+    constexpr std::array<constants::Direction, 4> DIRECTIONS{
+        constants::Direction::WEST, constants::Direction::EAST, constants::Direction::NORTH, constants::Direction::SOUTH
+    };
+    std::uniform_int_distribution<size_t> dist{0, DIRECTIONS.size() - 1};
+    const auto direction = DIRECTIONS[dist(random)];
+    dog.SetDirection(direction);
+    switch (direction) {
+        case constants::Direction::WEST:
+            dog.SetSpeed({-speed, 0});
+            break;
+        case constants::Direction::EAST:
+            dog.SetSpeed({speed, 0});
+            break;
+        case constants::Direction::NORTH:
+            dog.SetSpeed({0, -speed});
+            break;
+        default:
+            dog.SetSpeed({0, speed});
+            break;
+    }
+}
+
+struct PhaseReport {
+    std::string_view name;
+    metrics::Histogram& histogram;
+};
+
+json::object MakePhasesReport(double total_us) {
+    auto& registry = metrics::Registry::Instance();
+    const std::string name = "game_server_session_phase_duration_seconds";
+    const std::string help = "Duration of game session update phases";
+    const std::array<PhaseReport, 5> phases{
+        PhaseReport{"bots"sv, registry.GetHistogram(name, help, {{"phase", "bots"}})},
+        PhaseReport{"move"sv, registry.GetHistogram(name, help, {{"phase", "move"}})},
+        PhaseReport{"loot"sv, registry.GetHistogram(name, help, {{"phase", "loot"}})},
+        PhaseReport{"collect"sv, registry.GetHistogram(name, help, {{"phase", "collect"}})},
+        PhaseReport{"retire"sv, registry.GetHistogram(name, help, {{"phase", "retire"}})}
+    };
+
+    json::object result;
+    for (const auto& phase : phases) {
+        const auto snapshot = phase.histogram.TakeSnapshot();
+        const double count = static_cast<double>(std::max<uint64_t>(snapshot.Count(), 1));
+        result[phase.name] = json::object{
+            {"calls", snapshot.Count()},
+            {"mean_us", static_cast<double>(snapshot.Sum()) / count},
+            {"p50_us", snapshot.Percentile(0.5)},
+            {"p99_us", snapshot.Percentile(0.99)},
+            {"max_us", snapshot.Percentile(1.0)},
+            {"share", total_us > 0 ? static_cast<double>(snapshot.Sum()) / total_us : 0.0}
+        };
+    }
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    try {
+        auto args = ParseCommandLine(argc, argv);
+        if (!args) {
+            return EXIT_SUCCESS;
+        }
+
+        model::Game game = json_loader::LoadGame(args->config_file);
+        game.SetRandomSeed(args->seed);
+        if (game.GetMaps().empty()) {
+            throw std::runtime_error("Config has no maps"s);
+        }
+        const model::Map* map = args->map_id.empty() ? &game.GetMaps().front()
+                                                     : game.FindMap(model::Map::Id{args->map_id});
+        if (!map) {
+            throw std::runtime_error("Map not found: "s + args->map_id);
+        }
+
+        std::optional<model::BotPolicyType> bot_policy;
+        std::shared_ptr<const model::RoadNavigation> navigation;
+        if (!args->bot_policy.empty()) {
+            bot_policy = model::ParseBotPolicy(args->bot_policy);
+            if (!bot_policy) {
+                throw std::runtime_error("Unknown bot policy: "s + args->bot_policy);
+            }
+            navigation = map->GetNavigation();
+            if (!navigation) {
+                navigation = std::make_shared<const model::RoadNavigation>(*map);
+            }
+        }
+
+        // Стренды сессий не используются: io_context не запускается, тики выполняются в этом потоке
+        net::io_context ioc;
+        model::random::Engine script_random{args->seed};
+        std::vector<std::shared_ptr<model::GameSession>> sessions;
+        std::vector<std::vector<ScriptedDog>> scripts(args->sessions);
+        for (uint32_t i = 0; i < args->sessions; ++i) {
+            auto session = std::make_shared<model::GameSession>(map, std::chrono::milliseconds{0},
+                                                                game.GetLootGeneratorConfig(), ioc,
+                                                                game.NextSessionSeed());
+            for (uint32_t j = 0; j < args->dogs; ++j) {
+                std::string name = "dog_"s + std::to_string(i) + "_"s + std::to_string(j);
+                auto dog = std::make_shared<model::Dog>(name);
+                if (bot_policy) {
+                    session->AddBot(dog, model::MakeBotPolicy(*bot_policy), navigation, true);
+                } else {
+                    session->AddDog(dog, true);
+                    scripts[i].push_back({dog, 0});
+                }
+            }
+            sessions.push_back(std::move(session));
+        }
+
+        const std::chrono::milliseconds tick_delta{args->tick_delta_ms};
+        metrics::Histogram tick_duration;
+        const auto start = Clock::now();
+        for (uint32_t tick = 0; tick < args->ticks; ++tick) {
+            metrics::ScopedTimer timer{tick_duration};
+            for (size_t i = 0; i < sessions.size(); ++i) {
+                for (auto& scripted : scripts[i]) {
+                    const auto speed = scripted.dog->GetSpeed();
+                    if (scripted.ticks_to_turn == 0 || (speed.first == 0 && speed.second == 0)) {
+                        Turn(*scripted.dog, map->GetDogSpeed(), script_random);
+                        scripted.ticks_to_turn = args->turn_period;
+                    }
+                    --scripted.ticks_to_turn;
+                }
+                sessions[i]->UpdateSessionByTime(tick_delta);
+            }
+        }
+        const auto elapsed = Clock::now() - start;
+        const double elapsed_s = std::chrono::duration<double>(elapsed).count();
+        const double elapsed_us = std::chrono::duration<double, std::micro>(elapsed).count();
+
+        // Контрольные значения итогового состояния: при одинаковом зерне они должны совпадать между запусками
+        uint64_t dogs_left = 0;
+        uint64_t loot_left = 0;
+        uint64_t total_score = 0;
+        for (const auto& session : sessions) {
+            dogs_left += session->GetDogsCount();
+            loot_left += session->GetLostObjects().size();
+            for (const auto& dog : session->GetDogs()) {
+                total_score += dog->GetScore();
+            }
+        }
+
+        const auto tick_snapshot = tick_duration.TakeSnapshot();
+        json::object report{
+            {"config", json::object{
+                {"config_file", args->config_file},
+                {"map", *map->GetId()},
+                {"sessions", args->sessions},
+                {"dogs", args->dogs},
+                {"ticks", args->ticks},
+                {"tick_delta_ms", args->tick_delta_ms},
+                {"turn_period", args->turn_period},
+                {"bot_policy", args->bot_policy},
+                {"seed", args->seed}
+            }},
+            {"elapsed_s", elapsed_s},
+            {"ticks_per_second", static_cast<double>(args->ticks) / elapsed_s},
+            {"session_updates_per_second", static_cast<double>(args->ticks) * args->sessions / elapsed_s},
+            {"tick_us", json::object{
+                {"p50", tick_snapshot.Percentile(0.5)},
+                {"p99", tick_snapshot.Percentile(0.99)},
+                {"max", tick_snapshot.Percentile(1.0)}
+            }},
+            {"phases", MakePhasesReport(elapsed_us)},
+            {"result", json::object{
+                {"dogs", dogs_left},
+                {"loot", loot_left},
+                {"score", total_score}
+            }}
+        };
+
+        const std::string text = json::serialize(report);
+        if (args->output.empty()) {
+            std::cout << text << std::endl;
+        } else {
+            std::ofstream out{args->output};
+            out << text << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
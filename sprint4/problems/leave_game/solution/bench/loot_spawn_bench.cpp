@@ -0,0 +1,96 @@
+// Замер скорости появления трофеев: сколько трофеев в секунду сессия может разместить на карте.
+// Для сравнения замеряется прежний способ выбора точки через std::random_device на каждый вызов
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "../src/model/game_session.h"
+
+using namespace std::literals;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr int ROADS_COUNT = 100;
+constexpr int ROAD_LENGTH = 40;
+constexpr unsigned DOGS_COUNT = 20;
+constexpr int ITERATIONS = 50'000;
+// Прежний способ на два порядка медленнее, поэтому для него итераций меньше
+constexpr int LEGACY_ITERATIONS = ITERATIONS / 100;
+
+model::Map MakeMap() {
+    model::Map map{model::Map::Id{"bench"s}, "bench"s};
+    for (int i = 0; i < ROADS_COUNT; ++i) {
+        if (i % 2 == 0) {
+            map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, i * 5}, ROAD_LENGTH));
+        } else {
+            map.AddRoad(model::Road(model::Road::VERTICAL, {i * 5, 0}, ROAD_LENGTH));
+        }
+    }
+    for (int i = 0; i < 4; ++i) {
+        map.AddLootType({});
+    }
+    map.SetDogSpeed(1.0);
+    map.SetBagCapaccity(3);
+    return map;
+}
+
+int LegacyRandomNumber(int min, int max) {
+    std::random_device rd;
+    std::default_random_engine eng(rd());
+    std::uniform_int_distribution<int> distr(min, max);
+    return distr(eng);
+}
+
+model::Point LegacyRandomPoint(const model::Map& map) {
+    const auto& roads = map.GetRoads();
+    const model::Road& road = roads[LegacyRandomNumber(0, static_cast<int>(roads.size()) - 1)];
+    const model::Point start = road.GetStart();
+    const model::Point end = road.GetEnd();
+    if (road.IsHorizontal()) {
+        return {LegacyRandomNumber(std::min(start.x, end.x), std::max(start.x, end.x)), start.y};
+    }
+    return {start.x, LegacyRandomNumber(std::min(start.y, end.y), std::max(start.y, end.y))};
+}
+
+void Report(std::string_view name, uint64_t spawned, Clock::duration elapsed) {
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    std::cout << name << ": " << spawned << " loot in " << seconds << " s, "
+              << static_cast<double>(spawned) / seconds << " loot/s, "
+              << seconds * 1e9 / static_cast<double>(spawned) << " ns/loot" << std::endl;
+}
+
+}  // namespace
+
+int main() {
+    const model::Map map = MakeMap();
+    net::io_context ioc;
+    model::GameSession session{&map, 0ms, model::LootGeneratorConfig{1.0, 1.0}, ioc, 42};
+    for (unsigned i = 0; i < DOGS_COUNT; ++i) {
+        std::string name = "dog_"s + std::to_string(i);
+        session.AddDog(std::make_shared<model::Dog>(name), true);
+    }
+
+    // Каждую итерацию трофеи убираются, и генератор заполняет карту заново: по трофею на собаку
+    uint64_t spawned = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        session.GetLostObjects().clear();
+        session.UpdateLootGenerationByTime(1s);
+        spawned += session.GetLostObjects().size();
+    }
+    Report("session"sv, spawned, Clock::now() - start);
+
+    uint64_t checksum = 0;
+    start = Clock::now();
+    for (int i = 0; i < LEGACY_ITERATIONS; ++i) {
+        for (unsigned j = 0; j < DOGS_COUNT; ++j) {
+            const model::Point point = LegacyRandomPoint(map);
+            checksum += static_cast<uint64_t>(point.x + point.y + LegacyRandomNumber(0, 3));
+        }
+    }
+    Report("random_device per call"sv, uint64_t{LEGACY_ITERATIONS} * DOGS_COUNT, Clock::now() - start);
+
+    return checksum == 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
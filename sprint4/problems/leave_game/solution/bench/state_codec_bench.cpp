@@ -0,0 +1,107 @@
+// Сравнение кодирования состояния игры: дерево boost::json, потоковый JSON и двоичный формат
+// application/x-game-state. Время кодирования одного кадра и его размер для нескольких размеров сессии
+#include <boost/json.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../src/model/random.h"
+#include "../src/wire/game_state_codec.h"
+
+namespace json = boost::json;
+using namespace std::literals;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr int ITERATIONS = 20'000;
+
+struct FrameSize {
+    size_t dogs;
+    size_t loot;
+};
+
+wire::StateFrame MakeFrame(FrameSize size, model::random::Engine& random) {
+    wire::StateFrame frame;
+    uint64_t next_id = 1;
+    for (size_t i = 0; i < size.dogs; ++i) {
+        wire::DogState dog;
+        dog.id = i;
+        dog.x = random.UniformReal() * 100.0;
+        dog.y = random.UniformReal() * 100.0;
+        dog.vx = random.UniformInt(0, 1) == 0 ? 0.0 : 3.0;
+        dog.direction = static_cast<constants::Direction>(random.UniformInt(0, 3));
+        dog.score = static_cast<uint64_t>(random.UniformInt(0, 500));
+        for (int64_t j = random.UniformInt(0, 3); j > 0; --j) {
+            dog.bag.push_back({next_id++, static_cast<uint64_t>(random.UniformInt(0, 4))});
+        }
+        frame.players.push_back(std::move(dog));
+    }
+    for (size_t i = 0; i < size.loot; ++i) {
+        frame.lost_objects.push_back({next_id++, static_cast<uint64_t>(random.UniformInt(0, 4)),
+                                      static_cast<double>(random.UniformInt(0, 100)),
+                                      static_cast<double>(random.UniformInt(0, 100))});
+    }
+    return frame;
+}
+
+// Прежний способ: дерево boost::json, затем json::serialize
+json::object MakeJsonDom(const wire::StateFrame& frame) {
+    json::object players_json;
+    for (const wire::DogState& dog : frame.players) {
+        json::array bag_json;
+        for (const wire::BagItemState& item : dog.bag) {
+            bag_json.push_back(json::object{{"id", item.id}, {"type", item.type}});
+        }
+        players_json[std::to_string(dog.id)] = json::object{
+            {"pos", {dog.x, dog.y}},
+            {"speed", {dog.vx, dog.vy}},
+            {"dir", "U"},
+            {"bag", std::move(bag_json)},
+            {"score", dog.score}
+        };
+    }
+    json::object lost_objects_json;
+    for (const wire::LootState& loot : frame.lost_objects) {
+        lost_objects_json[std::to_string(loot.id)] = json::object{{"type", loot.type}, {"pos", {loot.x, loot.y}}};
+    }
+    return json::object{{"players", std::move(players_json)}, {"lostObjects", std::move(lost_objects_json)}};
+}
+
+template <typename Encode>
+void Measure(std::string_view name, const wire::StateFrame& frame, Encode encode) {
+    size_t bytes = 0;
+    const auto start = Clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        bytes += encode(frame).size();
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ITERATIONS;
+    std::cout << "  " << name << ": " << ns << " ns/frame, " << bytes / ITERATIONS << " bytes/frame" << std::endl;
+}
+
+}  // namespace
+
+int main() {
+    model::random::Engine random{42};
+    for (const FrameSize size : {FrameSize{1, 1}, FrameSize{20, 20}, FrameSize{200, 200}}) {
+        const wire::StateFrame frame = MakeFrame(size, random);
+        std::cout << size.dogs << " dogs, " << size.loot << " lost objects:" << std::endl;
+        Measure("json dom"sv, frame, [](const wire::StateFrame& frame) {
+            return json::serialize(MakeJsonDom(frame));
+        });
+        // Потоковая запись без окна: весь документ в одной строке, как в ответе с Content-Length
+        Measure("json stream"sv, frame, [](const wire::StateFrame& frame) {
+            auto producer = wire::StateJson(std::make_shared<const wire::StateFrame>(frame));
+            wire::JsonWriter writer;
+            while (producer(writer)) {
+            }
+            return writer.TakeBuffer();
+        });
+        Measure("binary"sv, frame, [](const wire::StateFrame& frame) {
+            return wire::EncodeBinary(frame);
+        });
+    }
+    return EXIT_SUCCESS;
+}
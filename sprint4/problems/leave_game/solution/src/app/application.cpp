@@ -1,25 +1,49 @@
 #include "application.h"
 
+#include "../metrics/metrics.h"
+
 namespace app {
 
-std::pair<app::Token, app::Player::ID> app::Application::JoinGame(std::string userName, const model::Map *map) {
+namespace {
 
-    std::shared_ptr<model::Dog> dog = std::make_shared<model::Dog>(userName);
-    std::shared_ptr<model::GameSession> validSession = game_.FindValidSession(map, tick_period_, ioc_);
-    if (validSession->GetDogs().size() == 0) {
-        ConnectGameSessionSignals(validSession);
+metrics::Gauge& PlayersGauge() {
+    static auto& players_gauge = metrics::Registry::Instance().GetGauge(
+                "game_server_players", "Number of players in the game");
+    return players_gauge;
+}
+
+}  // namespace
+
+std::optional<std::pair<Token, Player::ID>> Application::JoinGame(std::string userName, const model::Map *map) {
+    // Проверка имени и добавление игрока выполняются атомарно, иначе два одновременных
+    // запроса могли бы добавить на карту собак с одинаковыми именами
+    std::lock_guard lock{players_mutex_};
+    if (FindPlayer(userName, *map->GetId())) {
+        return std::nullopt;
     }
-    validSession->AddDog(dog, randomize_spawn_points_);
+
+    std::shared_ptr<model::Dog> dog = std::make_shared<model::Dog>(userName);
+    std::shared_ptr<model::GameSession> validSession = game_.FindValidSession(
+                map, tick_period_, ioc_, [this](const auto& new_session) {
+        ConnectGameSessionSignals(new_session);
+    });
+    // Собака попадёт в сессию в её strand, а токен и id игрока известны уже сейчас
+    validSession->PostAddDog(dog, randomize_spawn_points_);
     std::shared_ptr<Player> player = std::make_shared<Player>(dog, validSession);
     players_.push_back(player);
+    PlayersGauge().Set(static_cast<int64_t>(players_.size()));
     Token authToken = player_tokens_.AddPlayer(player);
     Player::ID playerId = player->GetPlayerId();
 
-    return make_pair(authToken, playerId);
+    return std::make_pair(authToken, playerId);
 }
 
-Player* Application::FindByDogNameAndMapId(const std::string &dogName, const std::string &mapId) {
+std::shared_ptr<Player> Application::FindByDogNameAndMapId(const std::string &dogName, const std::string &mapId) {
+    std::lock_guard lock{players_mutex_};
+    return FindPlayer(dogName, mapId);
+}
 
+std::shared_ptr<Player> Application::FindPlayer(const std::string &dogName, const std::string &mapId) const {
     auto it = std::find_if(players_.begin(), players_.end(),
            [&dogName, &mapId](const std::shared_ptr<Player>& player) {
                auto dog = player->GetDog().lock();
@@ -27,11 +51,30 @@ Player* Application::FindByDogNameAndMapId(const std::string &dogName, const std
                return dog && session && dog->GetName() == dogName && *session->GetId() == mapId;
            });
 
-    return it != players_.end() ? it->get() : nullptr;
-
+    return it != players_.end() ? *it : nullptr;
 }
 
 
+void Application::AddBots(const model::Map* map, const model::BotsConfig& config) {
+    if (config.count == 0) {
+        return;
+    }
+    // Граф дорог обычно строится при загрузке карты
+    std::shared_ptr<const model::RoadNavigation> navigation = map->GetNavigation();
+    if (!navigation) {
+        navigation = std::make_shared<const model::RoadNavigation>(*map);
+    }
+    for (size_t i = 0; i < config.count; ++i) {
+        std::string name = "Bot "s + std::to_string(i + 1);
+        auto dog = std::make_shared<model::Dog>(name);
+        std::shared_ptr<model::GameSession> session = game_.FindValidSession(
+                    map, tick_period_, ioc_, [this](const auto& new_session) {
+            ConnectGameSessionSignals(new_session);
+        });
+        session->PostAddBot(dog, model::MakeBotPolicy(config.policy), navigation, randomize_spawn_points_);
+    }
+}
+
 PlayerTokens &Application::GetPlayerTokens(){
     return player_tokens_;
 }
@@ -66,7 +109,7 @@ void Application::LoadGame(std::filesystem::__cxx11::path game_save_path, std::c
         return;
     }
 
-    save_ticker_ = std::make_shared<time_tiker::Ticker>(
+    timer_wheel_->Add(
             *api_strand_,
             save_period,
             [self_weak = weak_from_this()](const std::chrono::milliseconds& delta) {
@@ -75,8 +118,6 @@ void Application::LoadGame(std::filesystem::__cxx11::path game_save_path, std::c
             self->SaveGame();
         }
     });
-
-    save_ticker_->Start();
 }
 
 void Application::LoadGameFromArchive() {
@@ -94,12 +135,24 @@ void Application::LoadGameFromArchive() {
     iarchive >> sessions_resp >> players_resp;
     infstream.close();
 
+    std::lock_guard lock{players_mutex_};
     for (auto& session_resp : sessions_resp) {
+        // Сессия, в которой были только боты, не восстанавливается
+        if (session_resp.GetDogsResp().empty()) {
+            continue;
+        }
         auto new_session = std::make_shared<model::GameSession>(
                     game_.FindMap(session_resp.RestoreMapId()),
                     tick_period_,
                     game_.GetLootGeneratorConfig(),
-                    ioc_);
+                    ioc_,
+                    game_.NextSessionSeed());
+        if (game_.GetViewRadius() > 0) {
+            new_session->EnableInterestIndex(game_.GetViewRadius());
+        }
+        if (const auto& random_state = session_resp.GetRandomState()) {
+            new_session->GetRandomEngine().SetState(*random_state);
+        }
         for(auto& lost_obj_resp : session_resp.GetLostObjectsResp()) {
             auto lost_object = std::make_shared<model::LostObject>(std::move(lost_obj_resp.Restore()));
             new_session->AddLostObject(lost_object);
@@ -119,9 +172,12 @@ void Application::LoadGameFromArchive() {
             }
         }
 
+        // Иначе ушедшие из восстановленной сессии игроки не попадут в таблицу рекордов
+        ConnectGameSessionSignals(new_session);
         game_.AddSession(new_session);
-        new_session->Run();
+        new_session->Run(timer_wheel_);
     }
+    PlayersGauge().Set(static_cast<int64_t>(players_.size()));
 }
 
 void Application::SaveGameByTime(const std::chrono::milliseconds &delta_time) {
@@ -138,6 +194,10 @@ void Application::SaveGame() {
         return;
     }
 
+    static auto& save_duration = metrics::Registry::Instance().GetHistogram(
+                "game_server_save_duration_seconds", "Time spent saving the game state");
+    metrics::ScopedTimer timer{save_duration};
+
     std::vector<serialization::GameSessionResp> sessions_resp;
     for(auto session : game_.GetAllSession()) {
         sessions_resp.emplace_back(*session);
@@ -168,18 +228,29 @@ void Application::SaveGame() {
 }
 
 void Application::HandleRetiredPlayers(std::vector<domain::RetiredPlayers> retired_players) {
-    use_cases_.AddRetiredPlayers(retired_players);
-
-    for (const auto& retired_player : retired_players) {
-        uint32_t player_id = retired_player.GetPlayerId();
-        player_tokens_.RemovePlayerById(player_id);
-        auto it = std::remove_if(players_.begin(), players_.end(),
-                                 [player_id](const std::shared_ptr<Player>& player) {
-            return player->GetPlayerId() == player_id;
-        });
-        players_.erase(it, players_.end());
+    // В таблицу рекордов попадают только игроки: у ботов сервера нет записи в players_
+    std::vector<domain::RetiredPlayers> records;
+    {
+        std::lock_guard lock{players_mutex_};
+        for (auto& retired_player : retired_players) {
+            uint32_t player_id = retired_player.GetPlayerId();
+            auto it = std::remove_if(players_.begin(), players_.end(),
+                                     [player_id](const std::shared_ptr<Player>& player) {
+                return player->GetPlayerId() == player_id;
+            });
+            if (it == players_.end()) {
+                continue;
+            }
+            players_.erase(it, players_.end());
+            player_tokens_.RemovePlayerById(player_id);
+            records.push_back(std::move(retired_player));
+        }
+        PlayersGauge().Set(static_cast<int64_t>(players_.size()));
+    }
+
+    if (!records.empty()) {
+        use_cases_.AddRetiredPlayers(records);
     }
-    retired_players.clear();
 }
 
 void Application::ConnectGameSessionSignals(std::shared_ptr<model::GameSession> session) {
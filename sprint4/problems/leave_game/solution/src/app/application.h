@@ -9,11 +9,13 @@
 #include <functional>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <optional>
 
 #include "players.h"
 #include "player_tokens.h"
 #include "../model/game.h"
-#include "../time/ticker.h"
+#include "../time/timer_wheel.h"
 
 #include "../serialization/game_session_serialization.h"
 #include "../serialization/player_serialization.h"
@@ -32,14 +34,25 @@ class Application : public std::enable_shared_from_this<Application> {
 public:
     using Strand = net::strand<net::io_context::executor_type>;
 
+    // Слот колеса таймеров в несколько раз короче тика, чтобы сессии с невыровненной
+    // фазой распределялись по слотам, а не срабатывали все вместе
+    static constexpr uint32_t MAX_TIMER_WHEEL_SLOTS_PER_TICK = 8;
+
     Application(model::Game& game, net::io_context& ioc, uint32_t tick_period,
-                bool randomize_spawn_points, const db_app::DBSettings& db_settings) :
+                bool randomize_spawn_points, bool align_ticks, const db_app::DBSettings& db_settings) :
         game_{game},
         tick_period_{tick_period},
         randomize_spawn_points_{randomize_spawn_points},
         ioc_{ioc},
         api_strand_{std::make_shared<Strand>(net::make_strand(ioc))},
         db_{std::move(db_settings)} {
+        if (tick_period_.count() != 0) {
+            timer_wheel_ = std::make_shared<time_tiker::TimerWheel>(
+                        ioc, time_tiker::TimerWheel::SplitPeriod(tick_period_, MAX_TIMER_WHEEL_SLOTS_PER_TICK),
+                        align_ticks);
+            timer_wheel_->Start();
+            game_.SetTimerWheel(timer_wheel_);
+        }
     }
 
     Application(const Application&) = delete;
@@ -47,8 +60,11 @@ public:
     Application(Application&&) = delete;
     Application& operator=(Application&&) = delete;
 
-    std::pair<Token, Player::ID> JoinGame(std::string userName, const model::Map* map);
-    Player* FindByDogNameAndMapId(const std::string& dogName, const std::string& mapId);
+    // Возвращает std::nullopt, если на карте уже есть собака с таким именем
+    std::optional<std::pair<Token, Player::ID>> JoinGame(std::string userName, const model::Map* map);
+    // Запускает на карте ботов: собак под управлением стратегии сервера, без игроков и токенов
+    void AddBots(const model::Map* map, const model::BotsConfig& config);
+    std::shared_ptr<Player> FindByDogNameAndMapId(const std::string& dogName, const std::string& mapId);
     PlayerTokens& GetPlayerTokens();
     model::Game& GetGame();
     std::shared_ptr<Strand> GetStrand();
@@ -63,17 +79,21 @@ public:
     std::vector<domain::RetiredPlayers> GetTableRecords(size_t start, size_t maxItems);
 
 private:
+    std::shared_ptr<Player> FindPlayer(const std::string& dogName, const std::string& mapId) const;
+
     model::Game game_;
     std::chrono::milliseconds tick_period_;
     bool randomize_spawn_points_ = false;
     net::io_context& ioc_;
     std::shared_ptr<Strand> api_strand_;
+    // Список игроков изменяется обработчиками запросов и strand-ами сессий. Чтение токенов
+    // в обработчиках запросов не блокируется: PlayerTokens хранит их в снимках
+    mutable std::mutex players_mutex_;
     std::vector<std::shared_ptr<Player>> players_;
     PlayerTokens player_tokens_;
-    std::shared_ptr<time_tiker::Ticker> ticker_;
+    std::shared_ptr<time_tiker::TimerWheel> timer_wheel_;
     std::optional<fs::path> game_save_path_;
     std::chrono::milliseconds save_period_;
-    std::shared_ptr<time_tiker::Ticker> save_ticker_;
     postgres::Database db_;
     db_app::UseCasesImpl use_cases_{db_.GetRetiredPlayers()};
 };
@@ -3,6 +3,11 @@
 namespace app {
 
 Token app::PlayerTokens::GenerateToken() {
+    std::lock_guard lock{write_mutex_};
+    return MakeToken();
+}
+
+Token PlayerTokens::MakeToken() {
     auto random_number1 = generator1_();
     auto random_number2 = generator2_();
 
@@ -14,37 +19,62 @@ Token app::PlayerTokens::GenerateToken() {
 }
 
 Token PlayerTokens::AddPlayer(std::shared_ptr<Player> player) {
-    Token token = GenerateToken();
-    token_to_player_[token] = player;
+    std::lock_guard lock{write_mutex_};
+    Token token = MakeToken();
+    InsertToken(std::move(player), token);
     return token;
 }
 
 void PlayerTokens::AddPlayerToken(std::shared_ptr<Player> player, const Token &token) {
-    token_to_player_[token] = player;
+    std::lock_guard lock{write_mutex_};
+    InsertToken(std::move(player), token);
+}
+
+void PlayerTokens::InsertToken(std::shared_ptr<Player> player, const Token &token) {
+    const uint32_t player_id = player->GetPlayerId();
+    GetShard(token).Update([&token, &player](MapTokenToPlayer& token_to_player) {
+        token_to_player[token] = std::move(player);
+    });
+    player_id_to_token_.insert_or_assign(player_id, token);
 }
 
-std::shared_ptr<Player> PlayerTokens::FindPlayerByToken(const Token &token) {
-    auto it = token_to_player_.find(token);
-    if (it != token_to_player_.end()) {
+std::shared_ptr<Player> PlayerTokens::FindPlayerByToken(const Token &token) const {
+    const auto token_to_player = GetShard(token).Load();
+    auto it = token_to_player->find(token);
+    if (it != token_to_player->end()) {
         return it->second;
     }
     return nullptr;
 }
 
-PlayerTokens::MapTokenToPlayer PlayerTokens::GetPlayerToken() {
-    return token_to_player_;
+PlayerTokens::MapTokenToPlayer PlayerTokens::GetPlayerToken() const {
+    MapTokenToPlayer result;
+    for (const Shard& shard : shards_) {
+        const auto token_to_player = shard.Load();
+        result.insert(token_to_player->begin(), token_to_player->end());
+    }
+    return result;
 }
 
 void PlayerTokens::RemovePlayerById(uint32_t player_id) {
-    auto it = std::find_if(token_to_player_.begin(), token_to_player_.end(),
-                           [player_id](const std::pair<Token, std::shared_ptr<Player>>& pair) {
-        return pair.second->GetPlayerId() == player_id;
+    std::lock_guard lock{write_mutex_};
+    auto it = player_id_to_token_.find(player_id);
+    if (it == player_id_to_token_.end()) {
+        return;
+    }
+    const Token token = std::move(it->second);
+    player_id_to_token_.erase(it);
+    GetShard(token).Update([&token](MapTokenToPlayer& token_to_player) {
+        token_to_player.erase(token);
     });
+}
 
-    if (it != token_to_player_.end()) {
-        token_to_player_.erase(it);
-    }
+PlayerTokens::Shard& PlayerTokens::GetShard(const Token& token) {
+    return shards_[MapTokenHasher{}(token) % SHARDS_COUNT];
 }
 
+const PlayerTokens::Shard& PlayerTokens::GetShard(const Token& token) const {
+    return shards_[MapTokenHasher{}(token) % SHARDS_COUNT];
+}
 
 }   //namepsace app
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "players.h"
+#include "../shared_snapshot.h"
+
+#include <array>
+#include <mutex>
 
 namespace detail {
 struct TokenTag {
@@ -11,17 +15,24 @@ namespace app {
 
 using Token = util::Tagged<std::string, detail::TokenTag>;
 
+/*
+ *  Токены игроков. Таблица разбита на SHARDS_COUNT снимков (см. util::SharedSnapshot):
+ *  поиск по токену не блокируется, а добавление и удаление копируют только один шард
+ *  и выполняются под мьютексом писателей.
+ */
 class PlayerTokens {
 public:
     using MapTokenHasher = util::TaggedHasher<Token>;
     using MapTokenToPlayer = std::unordered_map<Token, std::shared_ptr<Player>, MapTokenHasher>;
 
+    static constexpr size_t SHARDS_COUNT = 16;
+
     PlayerTokens() = default;
     Token GenerateToken();
     Token AddPlayer(std::shared_ptr<Player> player);
     void AddPlayerToken(std::shared_ptr<Player> player, const Token& token);
-    std::shared_ptr<Player> FindPlayerByToken(const Token& token);
-    MapTokenToPlayer GetPlayerToken();
+    std::shared_ptr<Player> FindPlayerByToken(const Token& token) const;
+    MapTokenToPlayer GetPlayerToken() const;
     void RemovePlayerById(uint32_t player_id);
 
 private:
@@ -39,7 +50,17 @@ private:
     // Вы можете поэкспериментировать с алгоритмом генерирования токенов,
     // чтобы сделать их подбор ещё более затруднительным
 
-    MapTokenToPlayer token_to_player_;
+    using Shard = util::SharedSnapshot<MapTokenToPlayer>;
+
+    Token MakeToken();
+    void InsertToken(std::shared_ptr<Player> player, const Token& token);
+    Shard& GetShard(const Token& token);
+    const Shard& GetShard(const Token& token) const;
+
+    std::array<Shard, SHARDS_COUNT> shards_;
+    // Генераторы и индекс ниже используются только писателями
+    std::mutex write_mutex_;
+    std::unordered_map<uint32_t, Token> player_id_to_token_;
 
 };
 
@@ -4,6 +4,9 @@
 #include <pqxx/connection>
 #include <mutex>
 #include <condition_variable>
+#include <chrono>
+
+#include "../metrics/metrics.h"
 
 namespace db_app {
 
@@ -55,13 +58,17 @@ public:
     }
 
     ConnectionWrapper GetConnection() {
+        metrics::ScopedTimer timer{wait_time_};
         std::unique_lock lock{mutex_};
+        waiting_.Add(1);
         // Блокируем текущий поток и ждём, пока cond_var_ не получит уведомление и не освободится
         // хотя бы одно соединение
         cond_var_.wait(lock, [this] {
             return used_connections_ < pool_.size();
         });
         // После выхода из цикла ожидания мьютекс остаётся захваченным
+        waiting_.Add(-1);
+        in_use_.Set(static_cast<int64_t>(used_connections_ + 1));
 
         return {std::move(pool_[used_connections_++]), *this};
     }
@@ -73,6 +80,7 @@ private:
             std::lock_guard lock{mutex_};
             assert(used_connections_ != 0);
             pool_[--used_connections_] = std::move(conn);
+            in_use_.Set(static_cast<int64_t>(used_connections_));
         }
         // Уведомляем один из ожидающих потоков об изменении состояния пула
         cond_var_.notify_one();
@@ -82,6 +90,13 @@ private:
     std::condition_variable cond_var_;
     std::vector<ConnectionPtr> pool_;
     size_t used_connections_ = 0;
+
+    metrics::Histogram& wait_time_ = metrics::Registry::Instance().GetHistogram(
+            "game_server_db_pool_wait_seconds", "Time spent waiting for a free database connection");
+    metrics::Gauge& waiting_ = metrics::Registry::Instance().GetGauge(
+            "game_server_db_pool_waiting", "Number of threads waiting for a database connection");
+    metrics::Gauge& in_use_ = metrics::Registry::Instance().GetGauge(
+            "game_server_db_pool_in_use", "Number of database connections in use");
 };
 
 } // namespace db_app
@@ -1,7 +1,46 @@
 #include "files.h"
 
+#include <fstream>
+#include <iterator>
+
 namespace files_path {
 
+namespace {
+
+// Сжатая копия должна быть меньше файла хотя бы на десятую часть, иначе она бесполезна
+constexpr double MAX_COMPRESSION_RATIO = 0.9;
+
+fs::path WithExtension(const fs::path& path, std::string_view extension) {
+    fs::path result = path;
+    result += extension;
+    return result;
+}
+
+bool IsFresh(const fs::path& copy, const fs::path& original) {
+    std::error_code ec;
+    const auto copy_time = fs::last_write_time(copy, ec);
+    if (ec) {
+        return false;
+    }
+    const auto original_time = fs::last_write_time(original, ec);
+    return !ec && copy_time >= original_time;
+}
+
+bool IsPrecompressedCopy(const fs::path& path) {
+    const std::string extension = path.extension().string();
+    return extension == wire::EncodingFileExtension(wire::ContentEncoding::GZIP)
+            || extension == wire::EncodingFileExtension(wire::ContentEncoding::BROTLI);
+}
+
+// Форматы, которые уже сжаты, повторно не сжимаются
+bool IsAlreadyCompressed(fs::path path) {
+    const std::string mime = MimeDecode(path);
+    return mime == "image/png"sv || mime == "image/jpeg"sv || mime == "image/gif"sv
+            || mime == "audio/mpeg"sv || path.extension() == ".svgz";
+}
+
+}  // namespace
+
 bool IsSubPath(fs::path path, fs::path base) {
 
     path = fs::weakly_canonical(path);
@@ -48,4 +87,72 @@ std::string MimeDecode(fs::path& path) {
     return "application/octet-stream";
 }
 
+Precompressed ChoosePrecompressed(const fs::path& path, std::string_view accept_encoding) {
+    using wire::ContentEncoding;
+
+    const fs::path brotli = WithExtension(path, wire::EncodingFileExtension(ContentEncoding::BROTLI));
+    const fs::path gzip = WithExtension(path, wire::EncodingFileExtension(ContentEncoding::GZIP));
+    const bool has_brotli = IsFresh(brotli, path);
+    const bool has_gzip = IsFresh(gzip, path);
+
+    Precompressed result{path, ContentEncoding::IDENTITY, has_brotli || has_gzip};
+    if (has_brotli && wire::ChooseEncoding(accept_encoding, {ContentEncoding::BROTLI}) == ContentEncoding::BROTLI) {
+        result.path = brotli;
+        result.encoding = ContentEncoding::BROTLI;
+    } else if (has_gzip && wire::ChooseEncoding(accept_encoding, {ContentEncoding::GZIP}) == ContentEncoding::GZIP) {
+        result.path = gzip;
+        result.encoding = ContentEncoding::GZIP;
+    }
+    return result;
+}
+
+PrecompressStats PrecompressFiles(const fs::path& root, int level) {
+    PrecompressStats stats;
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(root, ec); !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        const fs::path& path = it->path();
+        std::error_code file_ec;
+        if (!it->is_regular_file(file_ec) || IsPrecompressedCopy(path) || IsAlreadyCompressed(path)) {
+            continue;
+        }
+        const fs::path gzip = WithExtension(path, wire::EncodingFileExtension(wire::ContentEncoding::GZIP));
+        if (IsFresh(gzip, path)) {
+            continue;
+        }
+
+        std::ifstream input{path, std::ios::binary};
+        const std::string data{std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{}};
+        if (!input && !input.eof()) {
+            ++stats.failed;
+            continue;
+        }
+        const std::string compressed = wire::Compress(data, wire::ContentEncoding::GZIP, level);
+        if (compressed.size() > data.size() * MAX_COMPRESSION_RATIO) {
+            continue;
+        }
+
+        // Копия пишется во временный файл и переименовывается, чтобы сервер не отдал её недописанной
+        fs::path temp = WithExtension(gzip, ".tmp"sv);
+        {
+            std::ofstream output{temp, std::ios::binary | std::ios::trunc};
+            output.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+            if (!output) {
+                ++stats.failed;
+                fs::remove(temp, file_ec);
+                continue;
+            }
+        }
+        fs::rename(temp, gzip, file_ec);
+        if (file_ec) {
+            ++stats.failed;
+            fs::remove(temp, file_ec);
+            continue;
+        }
+        ++stats.files;
+        stats.original_bytes += data.size();
+        stats.compressed_bytes += compressed.size();
+    }
+    return stats;
+}
+
 }
@@ -4,6 +4,7 @@
 #include <cassert>
 #include <string>
 #include "constants.h"
+#include "wire/compression.h"
 
 namespace fs = std::filesystem;
 using namespace std::literals;
@@ -14,4 +15,26 @@ namespace files_path {
     std::string UrlDecode(const std::string& url);
     std::string MimeDecode(fs::path& path);
 
+    // Сжатая копия статического файла, которую можно отдать клиенту вместо него
+    struct Precompressed {
+        fs::path path;
+        wire::ContentEncoding encoding = wire::ContentEncoding::IDENTITY;
+        // У файла есть сжатые копии, значит ответ зависит от Accept-Encoding
+        bool has_variants = false;
+    };
+
+    // Выбирает копию .br или .gz, которую принимает клиент. Копия старше файла не используется
+    Precompressed ChoosePrecompressed(const fs::path& path, std::string_view accept_encoding);
+
+    struct PrecompressStats {
+        size_t files = 0;
+        uintmax_t original_bytes = 0;
+        uintmax_t compressed_bytes = 0;
+        size_t failed = 0;
+    };
+
+    // Создаёт рядом с файлами каталога копии .gz, если их ещё нет или они устарели.
+    // Копия сохраняется, только если она заметно меньше файла
+    PrecompressStats PrecompressFiles(const fs::path& root, int level);
+
 }
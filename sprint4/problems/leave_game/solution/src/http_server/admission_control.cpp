@@ -0,0 +1,106 @@
+#include "admission_control.h"
+
+#include "../metrics/metrics.h"
+
+namespace http_server {
+
+namespace {
+
+metrics::Gauge& ActiveConnectionsGauge() {
+    static metrics::Gauge& gauge = metrics::Registry::Instance().GetGauge(
+                "game_server_http_connections_active", "Open HTTP connections");
+    return gauge;
+}
+
+metrics::Counter& RejectedConnections(const std::string& reason) {
+    return metrics::Registry::Instance().GetCounter(
+                "game_server_http_connections_rejected_total", "Connections answered with 503 without reading the request",
+                {{"reason", reason}});
+}
+
+}  // namespace
+
+AdmissionControl::Slot::Slot(std::shared_ptr<AdmissionControl> owner, std::string address)
+    : owner_{std::move(owner)}
+    , address_{std::move(address)} {
+}
+
+AdmissionControl::Slot::Slot(Slot&& other) noexcept
+    : owner_{std::move(other.owner_)}
+    , address_{std::move(other.address_)} {
+}
+
+AdmissionControl::Slot& AdmissionControl::Slot::operator=(Slot&& other) noexcept {
+    if (this != &other) {
+        Release();
+        owner_ = std::move(other.owner_);
+        address_ = std::move(other.address_);
+    }
+    return *this;
+}
+
+AdmissionControl::Slot::~Slot() {
+    Release();
+}
+
+void AdmissionControl::Slot::Release() noexcept {
+    if (owner_) {
+        owner_->Release(address_);
+        owner_.reset();
+    }
+}
+
+AdmissionControl::AdmissionControl(size_t max_connections, size_t max_per_address)
+    : max_connections_{max_connections}
+    , max_per_address_{max_per_address} {
+}
+
+AdmissionControl::Slot AdmissionControl::TryAdmit(const std::string& address) {
+    static metrics::Counter& rejected_total = RejectedConnections("max_connections");
+    static metrics::Counter& rejected_per_address = RejectedConnections("max_connections_per_address");
+    {
+        std::lock_guard lock{mutex_};
+        if (max_connections_ != 0 && active_ >= max_connections_) {
+            rejected_total.Add();
+            return {};
+        }
+        if (max_per_address_ != 0) {
+            size_t& count = per_address_[address];
+            if (count >= max_per_address_) {
+                rejected_per_address.Add();
+                return {};
+            }
+            ++count;
+        }
+        ++active_;
+    }
+    ActiveConnectionsGauge().Add(1);
+    return Slot{shared_from_this(), address};
+}
+
+size_t AdmissionControl::ActiveConnections() const {
+    std::lock_guard lock{mutex_};
+    return active_;
+}
+
+size_t AdmissionControl::ActiveConnections(const std::string& address) const {
+    std::lock_guard lock{mutex_};
+    auto it = per_address_.find(address);
+    return it == per_address_.end() ? 0 : it->second;
+}
+
+void AdmissionControl::Release(const std::string& address) noexcept {
+    {
+        std::lock_guard lock{mutex_};
+        --active_;
+        if (max_per_address_ != 0) {
+            auto it = per_address_.find(address);
+            if (it != per_address_.end() && --it->second == 0) {
+                per_address_.erase(it);
+            }
+        }
+    }
+    ActiveConnectionsGauge().Add(-1);
+}
+
+}  // namespace http_server
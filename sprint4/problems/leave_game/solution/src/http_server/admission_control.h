@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace http_server {
+
+// Ограничения, которые сервер применяет к соединениям. Ноль в лимите означает его отсутствие
+struct ServerLimits {
+    size_t max_connections = 4096;
+    size_t max_connections_per_address = 0;
+    // Сколько соединение может ждать первого байта следующего запроса
+    std::chrono::milliseconds idle_timeout{30'000};
+    // Сколько может длиться чтение заголовков (и отдельно тела) запроса после первого байта
+    std::chrono::milliseconds header_timeout{10'000};
+};
+
+/*
+ *  Учёт открытых соединений. Listener спрашивает разрешение до создания сессии и при отказе
+ *  отвечает 503, не читая запрос. Разрешение возвращается, когда сессия уничтожается.
+ */
+class AdmissionControl : public std::enable_shared_from_this<AdmissionControl> {
+public:
+    // Место, занятое одним соединением. Освобождается в деструкторе
+    class Slot {
+    public:
+        Slot() = default;
+        Slot(Slot&& other) noexcept;
+        Slot& operator=(Slot&& other) noexcept;
+        ~Slot();
+
+        explicit operator bool() const noexcept {
+            return owner_ != nullptr;
+        }
+
+    private:
+        friend class AdmissionControl;
+        Slot(std::shared_ptr<AdmissionControl> owner, std::string address);
+        void Release() noexcept;
+
+        std::shared_ptr<AdmissionControl> owner_;
+        std::string address_;
+    };
+
+    AdmissionControl(size_t max_connections, size_t max_per_address);
+
+    // Пустой Slot означает, что соединение нужно отклонить
+    Slot TryAdmit(const std::string& address);
+
+    size_t ActiveConnections() const;
+    // Соединения с адреса считаются, только если задан лимит на адрес
+    size_t ActiveConnections(const std::string& address) const;
+
+private:
+    void Release(const std::string& address) noexcept;
+
+    const size_t max_connections_;
+    const size_t max_per_address_;
+
+    mutable std::mutex mutex_;
+    size_t active_ = 0;
+    std::unordered_map<std::string, size_t> per_address_;
+};
+
+}  // namespace http_server
@@ -3,6 +3,29 @@
 
 namespace http_server {
 
+namespace {
+
+struct TimeoutCounters {
+    metrics::Counter& idle;
+    metrics::Counter& header;
+    metrics::Counter& body;
+};
+
+// Счётчики ищутся в реестре один раз, а не при каждом таймауте
+TimeoutCounters& GetTimeoutCounters() {
+    auto& registry = metrics::Registry::Instance();
+    const std::string name = "game_server_http_timeouts_total";
+    const std::string help = "Connections closed by a read timeout";
+    static TimeoutCounters counters{
+        registry.GetCounter(name, help, {{"stage", "idle"}}),
+        registry.GetCounter(name, help, {{"stage", "header"}}),
+        registry.GetCounter(name, help, {{"stage", "body"}})
+    };
+    return counters;
+}
+
+}  // namespace
+
 void SessionBase::ReportError(beast::error_code ec, std::string_view what) {
     json::value custom_data = json::object{
             {"code"s, ec.value()},
@@ -27,16 +50,55 @@ void SessionBase::OnWrite(bool close, beast::error_code ec, std::size_t bytes_wr
     Read();
 }
 
-void SessionBase::Read() {   { /* Асинхронное чтение запроса */ }
-    using namespace std::literals;
-    // Очищаем запрос от прежнего значения (метод Read может быть вызван несколько раз)
-    request_ = {};
-    stream_.expires_after(30s);
-    // Считываем request_ из stream_, используя buffer_ для хранения считанных данных
-    http::async_read(stream_, buffer_, request_,
-    // По окончании операции будет вызван метод OnRead
-    beast::bind_front_handler(&SessionBase::OnRead, GetSharedThis()));
-                         }
+void SessionBase::Read() {
+    // Читать запрос будем в новый парсер (метод Read может быть вызван несколько раз)
+    parser_.emplace();
+    if (buffer_.size() != 0) {
+        // Клиент уже прислал начало следующего запроса вместе с предыдущим
+        return ReadHeader();
+    }
+    // Ждём первого байта запроса не дольше таймаута простоя
+    stream_.expires_after(limits_.idle_timeout);
+    stream_.async_read_some(buffer_.prepare(READ_CHUNK_SIZE),
+        beast::bind_front_handler(&SessionBase::OnIdleRead, GetSharedThis()));
+}
+
+void SessionBase::OnIdleRead(beast::error_code ec, std::size_t bytes_read) {
+    buffer_.commit(bytes_read);
+    if (ec == net::error::eof) {
+        // Нормальная ситуация - клиент закрыл соединение
+        return Close();
+    }
+    if (HandleTimeout(ec, GetTimeoutCounters().idle)) {
+        return;
+    }
+    if (ec) {
+        return ReportError(ec, "read"sv);
+    }
+    ReadHeader();
+}
+
+void SessionBase::ReadHeader() {
+    stream_.expires_after(limits_.header_timeout);
+    http::async_read_header(stream_, buffer_, *parser_,
+        beast::bind_front_handler(&SessionBase::OnReadHeader, GetSharedThis()));
+}
+
+void SessionBase::OnReadHeader(beast::error_code ec, std::size_t bytes_read) {
+    if (ec == http::error::end_of_stream) {
+        return Close();
+    }
+    if (HandleTimeout(ec, GetTimeoutCounters().header)) {
+        return;
+    }
+    if (ec) {
+        return ReportError(ec, "read"sv);
+    }
+    // На тело даётся столько же времени, сколько на заголовки
+    stream_.expires_after(limits_.header_timeout);
+    http::async_read(stream_, buffer_, *parser_,
+        beast::bind_front_handler(&SessionBase::OnRead, GetSharedThis()));
+}
 
 void SessionBase::OnRead(beast::error_code ec, std::size_t bytes_read) {
     using namespace std::literals;
@@ -44,10 +106,24 @@ void SessionBase::OnRead(beast::error_code ec, std::size_t bytes_read) {
         // Нормальная ситуация - клиент закрыл соединение
         return Close();
     }
+    if (HandleTimeout(ec, GetTimeoutCounters().body)) {
+        return;
+    }
     if (ec) {
         return ReportError(ec, "read"sv);
     }
-    HandleRequest(std::move(request_));
+    HandleRequest(parser_->release());
+}
+
+bool SessionBase::HandleTimeout(beast::error_code ec, metrics::Counter& timeouts) {
+    if (ec != beast::error::timeout) {
+        return false;
+    }
+    // Таймаут - ожидаемое событие (простой keep-alive, медленный клиент), поэтому
+    // он только считается в метриках, а не пишется в журнал как ошибка.
+    // tcp_stream уже закрыл сокет
+    timeouts.Add();
+    return true;
 }
 
 void SessionBase::Close() {
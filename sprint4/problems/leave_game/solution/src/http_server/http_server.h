@@ -2,11 +2,15 @@
 #include "../sdk.h"
 
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/strand.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 #include <iostream>
+#include <optional>
 #include "../logger/logger.h"
+#include "../metrics/metrics.h"
+#include "admission_control.h"
 
 namespace http_server {
 
@@ -21,8 +25,10 @@ class SessionBase {
 protected:
     using HttpRequest = http::request<http::string_body>;
     ~SessionBase() = default;
-    explicit SessionBase(tcp::socket&& socket)
-        : stream_(std::move(socket)) {
+    SessionBase(tcp::socket&& socket, const ServerLimits& limits, AdmissionControl::Slot slot)
+        : stream_(std::move(socket))
+        , limits_(limits)
+        , slot_(std::move(slot)) {
     }
 
     template <typename Body, typename Fields>
@@ -30,6 +36,8 @@ protected:
         // Запись выполняется асинхронно, поэтому response перемещаем в область кучи
         auto safe_response = std::make_shared<http::response<Body, Fields>>(std::move(response));
 
+        // Клиент, который не забирает ответ, держит соединение не дольше простоя
+        stream_.expires_after(limits_.idle_timeout);
         auto self = GetSharedThis();
         http::async_write(stream_, *safe_response,
           [safe_response, self](beast::error_code ec, std::size_t bytes_written) {
@@ -44,17 +52,30 @@ public:
     void Run();
 
 private:
+    static constexpr std::size_t READ_CHUNK_SIZE = 4096;
+
     // tcp_stream содержит внутри себя сокет и добавляет поддержку таймаутов
     beast::tcp_stream stream_;
     beast::flat_buffer buffer_;
-    HttpRequest request_;
+    std::optional<http::request_parser<http::string_body>> parser_;
+    ServerLimits limits_;
+    // Место в AdmissionControl освобождается вместе с сессией
+    AdmissionControl::Slot slot_;
 
     virtual std::shared_ptr<SessionBase> GetSharedThis() = 0;
 
     void ReportError(beast::error_code ec, std::string_view what);
     void OnWrite(bool close, beast::error_code ec, [[maybe_unused]] std::size_t bytes_written);
+    // Чтение запроса идёт в три шага с разными таймаутами: ожидание первого байта (простой
+    // keep-alive соединения), заголовки, тело
     void Read();
+    void OnIdleRead(beast::error_code ec, std::size_t bytes_read);
+    void ReadHeader();
+    void OnReadHeader(beast::error_code ec, [[maybe_unused]] std::size_t bytes_read);
     void OnRead(beast::error_code ec, [[maybe_unused]] std::size_t bytes_read);
+    // Закрывает соединение, если чтение прервано таймаутом, и увеличивает счётчик таймаутов
+    // этого шага чтения. Возвращает false для прочих ошибок
+    bool HandleTimeout(beast::error_code ec, metrics::Counter& timeouts);
     void Close();
 
     // Обработку запроса делегируем подклассу
@@ -67,8 +88,9 @@ class Session : public SessionBase, public std::enable_shared_from_this<Session<
 
 public:
     template <typename Handler>
-    Session(tcp::socket&& socket, Handler&& request_handler, const std::string& client_ip)
-        : SessionBase(std::move(socket))
+    Session(tcp::socket&& socket, const ServerLimits& limits, AdmissionControl::Slot slot,
+            Handler&& request_handler, const std::string& client_ip)
+        : SessionBase(std::move(socket), limits, std::move(slot))
         , request_handler_(std::forward<Handler>(request_handler))
         , client_ip_(client_ip) {
     }
@@ -94,10 +116,13 @@ template <typename RequestHandler>
 class Listener : public std::enable_shared_from_this<Listener<RequestHandler>> {
 public:
     template <typename Handler>
-    Listener(net::io_context& ioc, const tcp::endpoint& endpoint, Handler&& request_handler)
+    Listener(net::io_context& ioc, const tcp::endpoint& endpoint, const ServerLimits& limits, Handler&& request_handler)
         : ioc_(ioc)
         // Обработчики асинхронных операций acceptor_ будут вызываться в своём strand
         , acceptor_(net::make_strand(ioc))
+        , retry_timer_(acceptor_.get_executor())
+        , limits_(limits)
+        , admission_(std::make_shared<AdmissionControl>(limits.max_connections, limits.max_connections_per_address))
         , request_handler_(std::forward<Handler>(request_handler)) {
         // Открываем acceptor, используя протокол (IPv4 или IPv6), указанный в endpoint
         acceptor_.open(endpoint.protocol());
@@ -118,8 +143,14 @@ public:
         DoAccept();
     }
 private:
+    // Пауза перед повторным accept, если он завершился ошибкой (например, кончились дескрипторы)
+    static constexpr auto ACCEPT_RETRY_DELAY = 100ms;
+
     net::io_context& ioc_;
     tcp::acceptor acceptor_;
+    net::steady_timer retry_timer_;
+    ServerLimits limits_;
+    std::shared_ptr<AdmissionControl> admission_;
     RequestHandler request_handler_;
 
     void ReportError(beast::error_code ec, std::string_view what) {
@@ -151,30 +182,65 @@ private:
     void OnAccept(beast::error_code ec, tcp::socket socket) {     //sys::error_code ec
         using namespace std::literals;
 
+        if (ec == net::error::operation_aborted) {
+            return;
+        }
         if (ec) {
-            return ReportError(ec, "accept"sv);
+            // Прекращать приём соединений из-за одной ошибки нельзя: при нехватке дескрипторов
+            // повторяем accept после паузы, за которую часть соединений успеет закрыться
+            ReportError(ec, "accept"sv);
+            retry_timer_.expires_after(ACCEPT_RETRY_DELAY);
+            retry_timer_.async_wait([self = this->shared_from_this()](beast::error_code ec) {
+                if (!ec) {
+                    self->DoAccept();
+                }
+            });
+            return;
         }
 
-        std::string client_ip = socket.remote_endpoint().address().to_string();
+        beast::error_code endpoint_ec;
+        std::string client_ip = socket.remote_endpoint(endpoint_ec).address().to_string();
 
-        // Асинхронно обрабатываем сессию
-        AsyncRunSession(std::move(socket), client_ip);
+        if (auto slot = admission_->TryAdmit(client_ip)) {
+            // Асинхронно обрабатываем сессию
+            AsyncRunSession(std::move(socket), std::move(slot), client_ip);
+        } else {
+            RejectOverloaded(std::move(socket));
+        }
 
         // Принимаем новое соединение
         DoAccept();
     }
 
-    void AsyncRunSession(tcp::socket&& socket, const std::string& client_ip) {
-        std::make_shared<Session<RequestHandler>>(std::move(socket), request_handler_, client_ip)->Run();
+    void AsyncRunSession(tcp::socket&& socket, AdmissionControl::Slot slot, const std::string& client_ip) {
+        std::make_shared<Session<RequestHandler>>(std::move(socket), limits_, std::move(slot),
+                                                  request_handler_, client_ip)->Run();
+    }
+
+    // Быстрый отказ при перегрузке: заранее готовый ответ 503 без чтения и разбора запроса
+    static void RejectOverloaded(tcp::socket&& socket) {
+        static constexpr std::string_view RESPONSE =
+                "HTTP/1.1 503 Service Unavailable\r\n"
+                "Retry-After: 1\r\n"
+                "Content-Length: 0\r\n"
+                "Connection: close\r\n"
+                "\r\n"sv;
+        auto safe_socket = std::make_shared<tcp::socket>(std::move(socket));
+        net::async_write(*safe_socket, net::buffer(RESPONSE.data(), RESPONSE.size()),
+            [safe_socket](beast::error_code, std::size_t) {
+                beast::error_code ec;
+                safe_socket->shutdown(tcp::socket::shutdown_send, ec);
+                safe_socket->close(ec);
+            });
     }
 };
 
 template <typename RequestHandler>
-void ServeHttp(net::io_context& ioc, const tcp::endpoint& endpoint, RequestHandler&& handler) {
+void ServeHttp(net::io_context& ioc, const tcp::endpoint& endpoint, const ServerLimits& limits, RequestHandler&& handler) {
     // При помощи decay_t исключим ссылки из типа RequestHandler,
     // чтобы Listener хранил RequestHandler по значению
     using MyListener = Listener<std::decay_t<RequestHandler>>;
-    std::make_shared<MyListener>(ioc, endpoint, std::forward<RequestHandler>(handler))->Run();
+    std::make_shared<MyListener>(ioc, endpoint, limits, std::forward<RequestHandler>(handler))->Run();
 }
 
 }  // namespace http_server
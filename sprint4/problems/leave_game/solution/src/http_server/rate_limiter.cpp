@@ -0,0 +1,58 @@
+#include "rate_limiter.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace http_server {
+
+TokenBucketRateLimiter::TokenBucketRateLimiter(double rate, double burst)
+    : rate_{std::max(rate, 0.0)}
+    , burst_{std::max(burst, 1.0)} {
+}
+
+bool TokenBucketRateLimiter::TryAcquire(std::string_view key, Clock::time_point now) {
+    if (!Enabled()) {
+        return true;
+    }
+    Shard& shard = shards_[std::hash<std::string_view>{}(key) % SHARDS_COUNT];
+    std::lock_guard lock{shard.mutex};
+
+    if (++shard.requests % CLEANUP_PERIOD == 0) {
+        Cleanup(shard, now);
+    }
+
+    auto [it, inserted] = shard.buckets.try_emplace(std::string{key}, Bucket{burst_, now});
+    Bucket& bucket = it->second;
+    if (!inserted) {
+        bucket.tokens = Refill(bucket, now);
+        bucket.updated = now;
+    }
+    if (bucket.tokens < 1.0) {
+        return false;
+    }
+    bucket.tokens -= 1.0;
+    return true;
+}
+
+size_t TokenBucketRateLimiter::Size() const {
+    size_t result = 0;
+    for (const Shard& shard : shards_) {
+        std::lock_guard lock{shard.mutex};
+        result += shard.buckets.size();
+    }
+    return result;
+}
+
+double TokenBucketRateLimiter::Refill(const Bucket& bucket, Clock::time_point now) const noexcept {
+    const double elapsed = std::chrono::duration<double>(now - bucket.updated).count();
+    return std::min(burst_, bucket.tokens + std::max(elapsed, 0.0) * rate_);
+}
+
+void TokenBucketRateLimiter::Cleanup(Shard& shard, Clock::time_point now) {
+    // Полная корзина ничем не отличается от новой, её можно не хранить
+    std::erase_if(shard.buckets, [this, now](const auto& item) {
+        return Refill(item.second, now) >= burst_;
+    });
+}
+
+}  // namespace http_server
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace http_server {
+
+/*
+ *  Ограничение частоты запросов по ключу (например, по токену игрока) алгоритмом token bucket:
+ *  в корзину ключа поступает rate жетонов в секунду, но не больше burst, каждый запрос забирает
+ *  один жетон. Ключи распределены по шардам, чтобы потоки реже ждали друг друга.
+ */
+class TokenBucketRateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Нулевая частота отключает ограничение
+    TokenBucketRateLimiter(double rate, double burst);
+
+    bool Enabled() const noexcept {
+        return rate_ > 0;
+    }
+
+    bool TryAcquire(std::string_view key, Clock::time_point now = Clock::now());
+
+    // Число ключей, для которых хранится корзина
+    size_t Size() const;
+
+private:
+    static constexpr size_t SHARDS_COUNT = 16;
+    // Через столько запросов к шарду из него удаляются полные корзины
+    static constexpr size_t CLEANUP_PERIOD = 1024;
+
+    struct Bucket {
+        double tokens;
+        Clock::time_point updated;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, Bucket> buckets;
+        size_t requests = 0;
+    };
+
+    double Refill(const Bucket& bucket, Clock::time_point now) const noexcept;
+    void Cleanup(Shard& shard, Clock::time_point now);
+
+    const double rate_;
+    const double burst_;
+    std::array<Shard, SHARDS_COUNT> shards_;
+};
+
+}  // namespace http_server
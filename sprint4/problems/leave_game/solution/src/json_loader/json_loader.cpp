@@ -1,30 +1,94 @@
 #include "json_loader.h"
 
+#include "mapped_file.h"
+#include "parallel_maps.h"
+#include "../model/bots.h"
 
 namespace json_loader {
 
 namespace json = boost::json;
 using namespace std::literals;
 
-model::Game LoadGame(const std::filesystem::path& json_path) {
-    // Загрузить содержимое файла json_path, например, в виде строки
-    // Распарсить строку как JSON, используя boost::json::parse
-    // Загрузить модель игры из файла
-    model::Game game;
+namespace {
+
+// Значения по умолчанию из корня конфига, общие для всех карт
+struct MapDefaults {
+    double dog_speed = 1;
+    int bag_capacity = 3;
+};
+
+json::value ParseConfig(std::string_view data) {
+    // Все узлы дерева живут в одном монотонном буфере и освобождаются разом
+    json::stream_parser parser;
+    parser.reset(json::make_shared_resource<json::monotonic_resource>());
+    json::error_code ec;
+    parser.write(data.data(), data.size(), ec);
+    if (!ec) {
+        parser.finish(ec);
+    }
+    if (ec) {
+        throw std::runtime_error("Failed to parse JSON: " + ec.message());
+    }
+    return parser.release();
+}
+
+model::Map ParseMap(const json::value& mapData, const MapDefaults& defaults) {
+    std::string mapId = mapData.as_object().at(constants::ID).as_string().c_str();
+    std::string mapName = mapData.as_object().at(constants::NAME).as_string().c_str();
+    model::Map map(model::Map::Id(mapId), mapName);
 
-    std::ifstream file(json_path);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file: " + json_path.string());
+    double dogSpeed = defaults.dog_speed;
+    if (mapData.as_object().contains("dogSpeed")) {
+        dogSpeed = mapData.as_object().at("dogSpeed").as_double();
+    }
+    map.SetDogSpeed(dogSpeed);
+
+    int bagCapacity = defaults.bag_capacity;
+    if (mapData.as_object().contains("bagCapacity")) {
+        bagCapacity = mapData.as_object().at("bagCapacity").as_int64();
+    }
+    map.SetBagCapaccity(bagCapacity);
+
+    if (mapData.as_object().contains("bots")) {
+        const auto& bots_json = mapData.as_object().at("bots").as_object();
+        model::BotsConfig bots_config;
+        bots_config.count = static_cast<size_t>(bots_json.at("count").as_int64());
+        if (bots_json.contains("policy")) {
+            const auto& policy_name = bots_json.at("policy").as_string();
+            auto policy = model::ParseBotPolicy({policy_name.data(), policy_name.size()});
+            if (!policy) {
+                throw std::runtime_error("Unknown bot policy in map " + mapId + ": " + std::string(policy_name.c_str()));
+            }
+            bots_config.policy = *policy;
+        }
+        map.SetBotsConfig(bots_config);
     }
 
-    std::string jsonDataStr((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    json::value jsonData;
     try {
-        jsonData = json::parse(jsonDataStr);
-    } catch (std::exception& e) {
-        throw std::runtime_error("Failed to parse JSON: " + std::string(e.what()));
+        ParseRoads(mapData, map);
+        ParseBuildings(mapData, map);
+        ParseOffices(mapData, map);
+        ParseLootTypes(mapData, map);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Error while parsing map data in map: " + mapId + ": " + std::string(e.what()));
     }
 
+    // Граф дорог и расстояния до баз нужны ботам, строим их здесь, а не при первом запуске сессии
+    if (model::RoadGraph::CanBuild(map)) {
+        map.SetNavigation(std::make_shared<const model::RoadNavigation>(map));
+    }
+    return map;
+}
+
+}  // namespace
+
+model::Game LoadGame(const std::filesystem::path& json_path, unsigned threads) {
+    model::Game game;
+
+    // Файл отображается в память и разбирается без промежуточной копии в строке
+    const MappedFile file(json_path);
+    const json::value jsonData = ParseConfig(file.GetData());
+
     if (jsonData.as_object().contains("defaultDogSpeed")) {
        game.SetDefaultDogSpeed(jsonData.as_object().at("defaultDogSpeed").as_double());
     }
@@ -49,33 +113,13 @@ model::Game LoadGame(const std::filesystem::path& json_path) {
         model::Dog::SetRetirementTime(time_ms);
     }
 
-    const auto& mapsArray = jsonData.as_object()[constants::MAPS].as_array();
-    for (const auto& mapData : mapsArray) {
-        std::string mapId = mapData.as_object().at(constants::ID).as_string().c_str();
-        std::string mapName = mapData.as_object().at(constants::NAME).as_string().c_str();
-        model::Map map(model::Map::Id(mapId), mapName);
-
-        double dogSpeed = game.GetDefaultDogSpeed();
-        if (mapData.as_object().contains("dogSpeed")) {
-            dogSpeed = mapData.as_object().at("dogSpeed").as_double();
-        }
-        map.SetDogSpeed(dogSpeed);
-
-        int bagCapacity = game.GetDefaultBagCapacity();
-        if (mapData.as_object().contains("bagCapacity")) {
-            bagCapacity = mapData.as_object().at("bagCapacity").as_int64();
-        }
-        map.SetBagCapaccity(bagCapacity);
-
-        try {
-            ParseRoads(mapData, map);
-            ParseBuildings(mapData, map);
-            ParseOffices(mapData, map);
-            ParseLootTypes(mapData, map);
-        } catch (const std::exception& e) {
-            throw std::runtime_error("Error while parsing map data in map: " + mapId + ": " + std::string(e.what()));
-        }
-        game.AddMap(map);
+    const MapDefaults defaults{game.GetDefaultDogSpeed(), game.GetDefaultBagCapacity()};
+    const auto& mapsArray = jsonData.as_object().at(constants::MAPS).as_array();
+    auto maps = BuildMapsInParallel(mapsArray.size(), threads, [&mapsArray, &defaults](size_t index) {
+        return ParseMap(mapsArray[index], defaults);
+    });
+    for (model::Map& map : maps) {
+        game.AddMap(std::move(map));
     }
 
     return game;
@@ -2,6 +2,7 @@
 
 #include <filesystem>
 #include <fstream>
+#include <thread>
 #include <boost/json.hpp>
 
 #include "../model/model.h"
@@ -11,7 +12,9 @@
 
 namespace json_loader {
 
-model::Game LoadGame(const std::filesystem::path& json_path);
+// Карты разбираются параллельно в threads потоках
+model::Game LoadGame(const std::filesystem::path& json_path,
+                     unsigned threads = std::thread::hardware_concurrency());
 void ParseRoads(const boost::json::value& mapData, model::Map& map);
 void ParseBuildings(const boost::json::value& mapData, model::Map& map);
 void ParseOffices(const boost::json::value& mapData, model::Map& map);
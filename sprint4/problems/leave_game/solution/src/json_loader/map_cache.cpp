@@ -0,0 +1,400 @@
+#include "map_cache.h"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "mapped_file.h"
+#include "parallel_maps.h"
+#include "../model/bots.h"
+#include "../model/dog.h"
+
+namespace json_loader {
+
+using namespace std::literals;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::array<char, 8> CACHE_MAGIC{'G', 'M', 'A', 'P', 'C', 'A', 'C', 'H'};
+// Увеличивается при любом изменении формата
+constexpr uint32_t CACHE_VERSION = 2;
+// Кеш не переносится между машинами с разным порядком байт
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct CacheHeader {
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t config_size;
+    uint64_t config_hash;
+};
+
+// Дороги и здания хранятся плоскими массивами чисел и читаются одним копированием.
+// Дорога - начало, координата конца и признак горизонтальной дороги
+using RoadRecord = std::array<int32_t, 4>;
+using BuildingRecord = std::array<int32_t, 4>;
+
+class CacheWriter {
+public:
+    template <typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void WriteString(std::string_view str) {
+        Write(static_cast<uint64_t>(str.size()));
+        WriteBytes(str);
+    }
+
+    void WriteBytes(std::string_view bytes) {
+        buffer_.append(bytes);
+    }
+
+    template <typename T>
+    void WriteArray(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Write(static_cast<uint64_t>(values.size()));
+        buffer_.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    const std::string& GetBuffer() const noexcept {
+        return buffer_;
+    }
+
+private:
+    std::string buffer_;
+};
+
+class CacheReader {
+public:
+    explicit CacheReader(std::string_view data) noexcept
+        : data_{data} {
+    }
+
+    template <typename T>
+    T Read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string ReadString() {
+        return std::string{ReadBytes(Read<uint64_t>())};
+    }
+
+    std::string_view ReadBytes(uint64_t size) {
+        return {Take(size), size};
+    }
+
+    template <typename T>
+    std::vector<T> ReadArray() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const uint64_t size = Read<uint64_t>();
+        if (size > data_.size() / sizeof(T)) {
+            throw std::runtime_error("Map cache is truncated"s);
+        }
+        std::vector<T> values(size);
+        std::memcpy(values.data(), Take(size * sizeof(T)), size * sizeof(T));
+        return values;
+    }
+
+    bool AtEnd() const noexcept {
+        return pos_ == data_.size();
+    }
+
+private:
+    const char* Take(uint64_t size) {
+        if (size > data_.size() - pos_) {
+            throw std::runtime_error("Map cache is truncated"s);
+        }
+        const char* result = data_.data() + pos_;
+        pos_ += size;
+        return result;
+    }
+
+    std::string_view data_;
+    size_t pos_ = 0;
+};
+
+void WriteNavigation(CacheWriter& writer, const model::RoadNavigation& navigation) {
+    const model::RoadGraph::Data graph = navigation.graph.GetData();
+    writer.Write(graph.min.x);
+    writer.Write(graph.min.y);
+    writer.Write(graph.width);
+    writer.Write(graph.height);
+    // Сетка узлов восстанавливается по точкам, поэтому не хранится
+    // Point не копируется побайтно, поэтому точки хранятся парами координат
+    std::vector<std::array<model::Coord, 2>> points;
+    points.reserve(graph.points.size());
+    for (const model::Point& point : graph.points) {
+        points.push_back({point.x, point.y});
+    }
+    writer.WriteArray(points);
+    writer.WriteArray(graph.neighbors);
+    writer.WriteArray(navigation.office_distances);
+}
+
+std::shared_ptr<const model::RoadNavigation> ReadNavigation(CacheReader& reader) {
+    model::RoadGraph::Data graph;
+    graph.min.x = reader.Read<model::Coord>();
+    graph.min.y = reader.Read<model::Coord>();
+    graph.width = reader.Read<model::Coord>();
+    graph.height = reader.Read<model::Coord>();
+    const auto points = reader.ReadArray<std::array<model::Coord, 2>>();
+    graph.neighbors = reader.ReadArray<std::array<model::RoadGraph::NodeId, model::RoadGraph::DIRECTIONS>>();
+    auto office_distances = reader.ReadArray<uint32_t>();
+    if (graph.width < 0 || graph.height < 0 || graph.neighbors.size() != points.size()
+        || office_distances.size() != points.size()) {
+        throw std::runtime_error("Map cache has an inconsistent road graph"s);
+    }
+
+    graph.grid.assign(static_cast<size_t>(graph.width) * static_cast<size_t>(graph.height), model::RoadGraph::NO_NODE);
+    graph.points.reserve(points.size());
+    for (const auto& [x, y] : points) {
+        if (x < graph.min.x || y < graph.min.y || x >= graph.min.x + graph.width || y >= graph.min.y + graph.height) {
+            throw std::runtime_error("Map cache has an inconsistent road graph"s);
+        }
+        const size_t index = static_cast<size_t>(y - graph.min.y) * static_cast<size_t>(graph.width)
+                             + static_cast<size_t>(x - graph.min.x);
+        graph.grid[index] = static_cast<model::RoadGraph::NodeId>(graph.points.size());
+        graph.points.push_back({x, y});
+    }
+    return std::make_shared<const model::RoadNavigation>(model::RoadGraph{std::move(graph)},
+                                                          std::move(office_distances));
+}
+
+void WriteMap(CacheWriter& writer, const model::Map& map) {
+    writer.WriteString(*map.GetId());
+    writer.WriteString(map.GetName());
+    writer.Write(map.GetDogSpeed());
+    writer.Write(static_cast<int32_t>(map.GetBagCapacity()));
+    writer.Write(static_cast<uint64_t>(map.GetBotsConfig().count));
+    writer.Write(static_cast<uint8_t>(map.GetBotsConfig().policy));
+
+    std::vector<RoadRecord> roads;
+    roads.reserve(map.GetRoads().size());
+    for (const model::Road& road : map.GetRoads()) {
+        const model::Point start = road.GetStart();
+        if (road.IsHorizontal()) {
+            roads.push_back({start.x, start.y, road.GetEnd().x, 1});
+        } else {
+            roads.push_back({start.x, start.y, road.GetEnd().y, 0});
+        }
+    }
+    writer.WriteArray(roads);
+
+    std::vector<BuildingRecord> buildings;
+    buildings.reserve(map.GetBuildings().size());
+    for (const model::Building& building : map.GetBuildings()) {
+        const model::Rectangle& bounds = building.GetBounds();
+        buildings.push_back({bounds.position.x, bounds.position.y, bounds.size.width, bounds.size.height});
+    }
+    writer.WriteArray(buildings);
+
+    writer.Write(static_cast<uint64_t>(map.GetOffices().size()));
+    for (const model::Office& office : map.GetOffices()) {
+        writer.WriteString(*office.GetId());
+        writer.Write(office.GetPosition().x);
+        writer.Write(office.GetPosition().y);
+        writer.Write(office.GetOffset().dx);
+        writer.Write(office.GetOffset().dy);
+    }
+
+    writer.Write(static_cast<uint64_t>(map.GetLootTypes().size()));
+    for (const model::LootType& loot_type : map.GetLootTypes()) {
+        writer.WriteString(loot_type.name);
+        writer.WriteString(loot_type.file);
+        writer.WriteString(loot_type.type);
+        writer.Write(loot_type.rotation);
+        writer.WriteString(loot_type.color);
+        writer.Write(loot_type.scale);
+        writer.Write(loot_type.value);
+    }
+
+    const auto& navigation = map.GetNavigation();
+    writer.Write(static_cast<uint8_t>(navigation ? 1 : 0));
+    if (navigation) {
+        WriteNavigation(writer, *navigation);
+    }
+}
+
+model::Map ReadMap(CacheReader& reader) {
+    std::string id = reader.ReadString();
+    std::string name = reader.ReadString();
+    model::Map map{model::Map::Id{std::move(id)}, std::move(name)};
+    map.SetDogSpeed(reader.Read<double>());
+    map.SetBagCapaccity(reader.Read<int32_t>());
+    model::BotsConfig bots_config;
+    bots_config.count = static_cast<size_t>(reader.Read<uint64_t>());
+    bots_config.policy = static_cast<model::BotPolicyType>(reader.Read<uint8_t>());
+    map.SetBotsConfig(bots_config);
+
+    for (const auto& [start_x, start_y, end, horizontal] : reader.ReadArray<RoadRecord>()) {
+        if (horizontal != 0) {
+            map.AddRoad(model::Road(model::Road::HORIZONTAL, {start_x, start_y}, end));
+        } else {
+            map.AddRoad(model::Road(model::Road::VERTICAL, {start_x, start_y}, end));
+        }
+    }
+
+    for (const auto& [x, y, w, h] : reader.ReadArray<BuildingRecord>()) {
+        map.AddBuilding(model::Building({{x, y}, {w, h}}));
+    }
+
+    const uint64_t offices_count = reader.Read<uint64_t>();
+    for (uint64_t i = 0; i < offices_count; ++i) {
+        std::string office_id = reader.ReadString();
+        const model::Coord x = reader.Read<model::Coord>();
+        const model::Coord y = reader.Read<model::Coord>();
+        const model::Dimension dx = reader.Read<model::Dimension>();
+        const model::Dimension dy = reader.Read<model::Dimension>();
+        map.AddOffice(model::Office{model::Office::Id{std::move(office_id)}, {x, y}, {dx, dy}});
+    }
+
+    const uint64_t loot_types_count = reader.Read<uint64_t>();
+    for (uint64_t i = 0; i < loot_types_count; ++i) {
+        model::LootType loot_type;
+        loot_type.name = reader.ReadString();
+        loot_type.file = reader.ReadString();
+        loot_type.type = reader.ReadString();
+        loot_type.rotation = reader.Read<int>();
+        loot_type.color = reader.ReadString();
+        loot_type.scale = reader.Read<double>();
+        loot_type.value = reader.Read<int>();
+        map.AddLootType(loot_type);
+    }
+
+    if (reader.Read<uint8_t>() != 0) {
+        map.SetNavigation(ReadNavigation(reader));
+    }
+    return map;
+}
+
+}  // namespace
+
+uint64_t HashConfig(std::string_view data) noexcept {
+    // FNV-1a по 8 байт за шаг с перемешиванием старших бит
+    constexpr uint64_t PRIME = 0x100000001b3;
+    uint64_t hash = 0xcbf29ce484222325 ^ data.size();
+    size_t pos = 0;
+    for (; pos + sizeof(uint64_t) <= data.size(); pos += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data.data() + pos, sizeof(word));
+        hash = (hash ^ word) * PRIME;
+        hash ^= hash >> 29;
+    }
+    for (; pos < data.size(); ++pos) {
+        hash = (hash ^ static_cast<unsigned char>(data[pos])) * PRIME;
+    }
+    return hash;
+}
+
+std::optional<model::Game> LoadGameFromCache(const fs::path& config_path, const fs::path& cache_path,
+                                             unsigned threads) {
+    std::error_code ec;
+    if (!fs::exists(cache_path, ec)) {
+        return std::nullopt;
+    }
+
+    const MappedFile cache(cache_path);
+    CacheReader reader{cache.GetData()};
+    const auto header = reader.Read<CacheHeader>();
+    if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.byte_order != BYTE_ORDER_MARK) {
+        return std::nullopt;
+    }
+    if (header.config_size != fs::file_size(config_path)) {
+        return std::nullopt;
+    }
+    // Время изменения не проверяется: его сохраняют копирование и восстановление из архива
+    // и оно грубое на некоторых файловых системах. Хеш дешевле разбора JSON
+    {
+        const MappedFile config(config_path);
+        if (HashConfig(config.GetData()) != header.config_hash) {
+            return std::nullopt;
+        }
+    }
+
+    model::Game game;
+    game.SetDefaultDogSpeed(reader.Read<double>());
+    game.SetDefaultBagCapacity(reader.Read<int32_t>());
+    model::LootGeneratorConfig loot_gen_config;
+    loot_gen_config.period = reader.Read<double>();
+    loot_gen_config.probability = reader.Read<double>();
+    game.SetLootGeneratorConfig(loot_gen_config);
+    model::Dog::SetRetirementTime(reader.Read<uint32_t>());
+
+    // Карты лежат подряд после таблицы их размеров и читаются параллельно
+    const auto map_sizes = reader.ReadArray<uint64_t>();
+    std::vector<std::string_view> map_data;
+    map_data.reserve(map_sizes.size());
+    for (uint64_t size : map_sizes) {
+        map_data.push_back(reader.ReadBytes(size));
+    }
+    if (!reader.AtEnd()) {
+        throw std::runtime_error("Map cache has trailing data"s);
+    }
+
+    auto maps = BuildMapsInParallel(map_data.size(), threads, [&map_data](size_t index) {
+        CacheReader map_reader{map_data[index]};
+        model::Map map = ReadMap(map_reader);
+        if (!map_reader.AtEnd()) {
+            throw std::runtime_error("Map cache has trailing data"s);
+        }
+        return map;
+    });
+    for (model::Map& map : maps) {
+        game.AddMap(std::move(map));
+    }
+    return game;
+}
+
+void SaveGameCache(const model::Game& game, const fs::path& config_path, const fs::path& cache_path) {
+    CacheHeader header{};
+    header.magic = CACHE_MAGIC;
+    header.version = CACHE_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    {
+        const MappedFile config(config_path);
+        header.config_size = config.GetData().size();
+        header.config_hash = HashConfig(config.GetData());
+    }
+
+    CacheWriter writer;
+    writer.Write(header);
+    writer.Write(game.GetDefaultDogSpeed());
+    writer.Write(static_cast<int32_t>(game.GetDefaultBagCapacity()));
+    writer.Write(game.GetLootGeneratorConfig().period);
+    writer.Write(game.GetLootGeneratorConfig().probability);
+    writer.Write(model::Dog::GetRetirementTime());
+    std::vector<CacheWriter> map_writers(game.GetMaps().size());
+    std::vector<uint64_t> map_sizes;
+    map_sizes.reserve(map_writers.size());
+    for (size_t i = 0; i < map_writers.size(); ++i) {
+        WriteMap(map_writers[i], game.GetMaps()[i]);
+        map_sizes.push_back(map_writers[i].GetBuffer().size());
+    }
+    writer.WriteArray(map_sizes);
+    for (const CacheWriter& map_writer : map_writers) {
+        writer.WriteBytes(map_writer.GetBuffer());
+    }
+
+    fs::path tmp_path = cache_path;
+    tmp_path += ".tmp"s;
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        out.write(writer.GetBuffer().data(), static_cast<std::streamsize>(writer.GetBuffer().size()));
+        if (!out.flush()) {
+            throw std::runtime_error("Failed to write map cache: "s + tmp_path.string());
+        }
+    }
+    fs::rename(tmp_path, cache_path);
+}
+
+}  // namespace json_loader
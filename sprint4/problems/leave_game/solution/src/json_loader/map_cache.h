@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <thread>
+
+#include "../model/game.h"
+
+namespace json_loader {
+
+/*
+ *  Кеш разобранного конфига: двоичный файл с картами, настройками игры и графами дорог.
+ *  Массивы дорог, зданий и узлов графа хранятся плоско и копируются целиком, карты читаются параллельно.
+ *  Кеш привязан к конфигу по размеру и хешу содержимого: конфиг при загрузке кеша
+ *  всегда читается и хешируется, совпадения размера и времени изменения недостаточно.
+ */
+
+// Хеш содержимого конфига, не криптографический
+uint64_t HashConfig(std::string_view data) noexcept;
+
+// nullopt, если кеша нет, он другой версии или не соответствует конфигу.
+// Бросает std::runtime_error, если файл кеша повреждён
+std::optional<model::Game> LoadGameFromCache(const std::filesystem::path& config_path,
+                                             const std::filesystem::path& cache_path,
+                                             unsigned threads = std::thread::hardware_concurrency());
+
+// Записывает кеш через временный файл, чтобы сервер не прочитал недописанный кеш.
+// Вызывается сразу после загрузки game из config_path
+void SaveGameCache(const model::Game& game, const std::filesystem::path& config_path,
+                   const std::filesystem::path& cache_path);
+
+}  // namespace json_loader
@@ -0,0 +1,57 @@
+#include "mapped_file.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace json_loader {
+
+using namespace std::literals;
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: "s + path.string() + ": "s + std::strerror(errno));
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0) {
+        const int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Failed to stat file: "s + path.string() + ": "s + std::strerror(error));
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    // Пустой файл отобразить нельзя, он читается как пустая строка
+    if (size_ != 0) {
+        data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    const int error = errno;
+    // Отображение остаётся действительным и после закрытия дескриптора
+    ::close(fd);
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        throw std::runtime_error("Failed to map file: "s + path.string() + ": "s + std::strerror(error));
+    }
+    if (data_) {
+        // Файл читается один раз от начала до конца
+        ::madvise(data_, size_, MADV_SEQUENTIAL);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (data_) {
+        ::munmap(data_, size_);
+    }
+}
+
+std::string_view MappedFile::GetData() const noexcept {
+    return {static_cast<const char*>(data_), data_ ? size_ : 0};
+}
+
+}  // namespace json_loader
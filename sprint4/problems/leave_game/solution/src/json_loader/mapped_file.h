@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+namespace json_loader {
+
+/*
+ *  Файл, отображённый в память только для чтения. Страницы подгружаются ядром по мере чтения,
+ *  поэтому большой конфиг не копируется в отдельную строку.
+ */
+class MappedFile {
+public:
+    // Бросает std::runtime_error, если файл не удалось открыть или отобразить
+    explicit MappedFile(const std::filesystem::path& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    std::string_view GetData() const noexcept;
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}  // namespace json_loader
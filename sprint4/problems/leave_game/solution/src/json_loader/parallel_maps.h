@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "../model/maps.h"
+
+namespace json_loader {
+
+/*
+ *  Строит count карт вызовами make_map(index) в threads потоках.
+ *  Карты сильно различаются по размеру, поэтому потоки берут их по одной.
+ *  Карты возвращаются по порядку индексов, при ошибках пробрасывается ошибка первой по порядку карты.
+ */
+template <typename MakeMap>
+std::vector<model::Map> BuildMapsInParallel(size_t count, unsigned threads, MakeMap&& make_map) {
+    std::vector<std::optional<model::Map>> built(count);
+    std::vector<std::exception_ptr> errors(count);
+    std::atomic<size_t> next_index{0};
+    auto worker = [&]() {
+        for (size_t i = next_index++; i < count; i = next_index++) {
+            try {
+                built[i].emplace(make_map(i));
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    const size_t workers_count = std::min<size_t>(std::max(threads, 1u), count);
+    if (workers_count <= 1) {
+        worker();
+    } else {
+        std::vector<std::jthread> workers;
+        workers.reserve(workers_count - 1);
+        for (size_t i = 1; i < workers_count; ++i) {
+            workers.emplace_back(worker);
+        }
+        worker();
+    }
+
+    std::vector<model::Map> maps;
+    maps.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (errors[i]) {
+            std::rethrow_exception(errors[i]);
+        }
+        maps.emplace_back(std::move(*built[i]));
+    }
+    return maps;
+}
+
+}  // namespace json_loader
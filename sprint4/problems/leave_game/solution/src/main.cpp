@@ -5,10 +5,14 @@
 #include <thread>
 
 #include "json_loader/json_loader.h"
+#include "json_loader/map_cache.h"
 #include "request_handler/request_handler.h"
 #include "request_handler/api_request_handler.h"
 #include "request_handler/logging_request_handler.h"
 #include "request_handler/static_request_handler.h"
+#include "request_handler/metrics_request_handler.h"
+#include "request_handler/profiler_request_handler.h"
+#include "request_handler/compression_request_handler.h"
 #include "files.h"
 #include "logger/logger.h"
 #include "app/players.h"
@@ -68,7 +72,45 @@ int main(int argc, const char* argv[]) {
         // 2. Загружаем карту из файла и построить модель игры
         model::Game game;
         try {
-            game = json_loader::LoadGame(json_path);
+            const auto load_start = std::chrono::steady_clock::now();
+            std::optional<model::Game> cached_game;
+            if (!args->map_cache.empty()) {
+                // Повреждённый кеш не мешает запуску: конфиг читается заново, а кеш перезаписывается
+                try {
+                    cached_game = json_loader::LoadGameFromCache(json_path, args->map_cache);
+                } catch (const std::exception& e) {
+                    json::value cache_data = json::object{{"error"s, e.what()}};
+                    BOOST_LOG_TRIVIAL(warning) << logging::add_value(additional_data, cache_data) << "map cache ignored"sv;
+                }
+            }
+            const bool from_cache = cached_game.has_value();
+            if (from_cache) {
+                game = std::move(*cached_game);
+            } else {
+                game = json_loader::LoadGame(json_path);
+                if (!args->map_cache.empty()) {
+                    try {
+                        json_loader::SaveGameCache(game, json_path, args->map_cache);
+                    } catch (const std::exception& e) {
+                        json::value cache_data = json::object{{"error"s, e.what()}};
+                        BOOST_LOG_TRIVIAL(warning) << logging::add_value(additional_data, cache_data) << "map cache not saved"sv;
+                    }
+                }
+            }
+            const auto load_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - load_start);
+            game.SetViewRadius(args->view_radius);
+            if (args->random_seed) {
+                game.SetRandomSeed(*args->random_seed);
+            }
+
+            json::value load_data = json::object{
+                    {"duration_ms"s, load_duration.count()},
+                    {"maps"s, game.GetMaps().size()},
+                    {"bytes"s, fs::file_size(json_path)},
+                    {"from_cache"s, from_cache}
+            };
+            BOOST_LOG_TRIVIAL(info) << logging::add_value(additional_data, load_data) << "config loaded"sv;
         } catch (const std::exception& e) {
             std::cerr << "Error: " << e.what() << std::endl;
             return EXIT_FAILURE;
@@ -78,6 +120,7 @@ int main(int argc, const char* argv[]) {
         net::io_context ioc(num_threads);
         auto application = std::make_shared<app::Application>(game, ioc, args->tick_period,
                                                               args->randomize_spawn_points,
+                                                              args->align_ticks,
                                                               db_settings);
 
         // 4. Загрузка сохраненной игры
@@ -85,6 +128,25 @@ int main(int argc, const char* argv[]) {
             application->LoadGame(args->state_file, std::chrono::milliseconds(args->save_state_period));
         }
 
+        // Боты запускаются после загрузки сохранения и занимают свободные места в сессиях
+        std::optional<model::BotPolicyType> bot_policy;
+        if (!args->bot_policy.empty()) {
+            bot_policy = model::ParseBotPolicy(args->bot_policy);
+            if (!bot_policy) {
+                throw std::runtime_error("Unknown bot policy: "s + args->bot_policy);
+            }
+        }
+        for (const model::Map& map : application->GetGame().GetMaps()) {
+            model::BotsConfig bots_config = map.GetBotsConfig();
+            if (args->bots) {
+                bots_config.count = *args->bots;
+            }
+            if (bot_policy) {
+                bots_config.policy = *bot_policy;
+            }
+            application->AddBots(&map, bots_config);
+        }
+
         // 5. Добавляем асинхронный обработчик сигналов SIGINT и SIGTERM
         // Подписываемся на сигналы и при их получении завершаем работу сервера
         net::signal_set signals(ioc, SIGINT, SIGTERM);
@@ -98,18 +160,49 @@ int main(int argc, const char* argv[]) {
             }
         });
 
+        // Сжатые копии статических файлов создаются один раз, поэтому с наибольшим уровнем сжатия
+        if (args->compression_level > 0) {
+            const auto stats = files_path::PrecompressFiles(static_path, 9);
+            json::value precompress_data = json::object{
+                    {"files"s, stats.files},
+                    {"original_bytes"s, stats.original_bytes},
+                    {"compressed_bytes"s, stats.compressed_bytes},
+                    {"failed"s, stats.failed}
+            };
+            BOOST_LOG_TRIVIAL(info) << logging::add_value(additional_data, precompress_data) << "static files precompressed"sv;
+        }
+
         // 6. Создаём обработчик HTTP-запросов и связываем его с моделью игры
-        auto api_handler = std::make_shared<http_handler::ApiRequestHandler>(*application, static_path);
+        auto api_handler = std::make_shared<http_handler::ApiRequestHandler>(
+                    *application, static_path,
+                    http_handler::ApiRequestHandler::ActionRateLimit{args->action_rate, args->action_burst});
         auto static_file_handler = std::make_shared<http_handler::StaticFileRequestHandler>(*application, static_path);
 
-        http_handler::LoggingRequestHandler<http_handler::ApiRequestHandler> logging_api_handler{*api_handler};
+        using CompressionApiHandler = http_handler::CompressionRequestHandler<http_handler::ApiRequestHandler>;
+        CompressionApiHandler compression_api_handler{
+                    *api_handler, wire::CompressionSettings{args->compression_level, args->compression_threshold}};
+        http_handler::LoggingRequestHandler<CompressionApiHandler> logging_api_handler{compression_api_handler};
         http_handler::LoggingRequestHandler<http_handler::StaticFileRequestHandler> logging_static_file_handler{*static_file_handler};
+        http_handler::MetricsRequestHandler metrics_handler;
+        std::optional<http_handler::ProfilerRequestHandler> profiler_handler;
+        if (args->enable_profiler) {
+            profiler_handler.emplace(ioc);
+        }
 
         // 7. Запустить обработчик HTTP-запросов, делегируя их обработчику запросов
         const auto address = net::ip::make_address("0.0.0.0");
         constexpr net::ip::port_type port = 8080;
-        http_server::ServeHttp(ioc, {address, port}, [&logging_api_handler, &logging_static_file_handler](auto&& req, const std::string& client_ip, auto&& send) {
-            if (req.target().starts_with("/api/")) {
+        http_server::ServerLimits limits;
+        limits.max_connections = args->max_connections;
+        limits.max_connections_per_address = args->max_connections_per_ip;
+        limits.idle_timeout = std::chrono::milliseconds(args->idle_timeout);
+        limits.header_timeout = std::chrono::milliseconds(args->header_timeout);
+        http_server::ServeHttp(ioc, {address, port}, limits, [&logging_api_handler, &logging_static_file_handler, &metrics_handler, &profiler_handler](auto&& req, const std::string& client_ip, auto&& send) {
+            if (req.target() == "/metrics") {
+                metrics_handler(std::forward<decltype(req)>(req), std::forward<decltype(send)>(send));
+            } else if (profiler_handler && req.target().starts_with(http_handler::ProfilerRequestHandler::PATH)) {
+                (*profiler_handler)(std::forward<decltype(req)>(req), std::forward<decltype(send)>(send));
+            } else if (req.target().starts_with("/api/")) {
                 logging_api_handler(std::forward<decltype(req)>(req), client_ip, std::forward<decltype(send)>(send));
             } else {
                 logging_static_file_handler(std::forward<decltype(req)>(req), client_ip, std::forward<decltype(send)>(send));
@@ -123,7 +216,12 @@ int main(int argc, const char* argv[]) {
         BOOST_LOG_TRIVIAL(info) << logging::add_value(additional_data, custom_data) << "server started"sv;
 
         // 8. Запускаем обработку асинхронных операций
-        RunWorkers(std::max(1u, num_threads), [&ioc] {
+        RunWorkers(std::max(1u, num_threads), [&ioc, enable_profiler = args->enable_profiler] {
+            // Профилируются только потоки io_context
+            std::optional<profiler::ThreadRegistration> profiler_registration;
+            if (enable_profiler) {
+                profiler_registration.emplace();
+            }
             ioc.run();
         });
 
@@ -0,0 +1,259 @@
+#include "metrics.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <sstream>
+
+namespace metrics {
+
+namespace {
+
+// Границы корзин гистограмм в экспозиции Prometheus, микросекунды
+constexpr std::array<uint64_t, 17> EXPORT_BOUNDS_US{
+    50, 100, 250, 500,
+    1'000, 2'500, 5'000, 10'000, 25'000, 50'000, 100'000, 250'000, 500'000,
+    1'000'000, 2'500'000, 5'000'000, 10'000'000
+};
+
+std::atomic<size_t> next_shard{0};
+
+std::string EscapeLabelValue(const std::string& value) {
+    std::string result;
+    result.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            result += '\\';
+            result += c;
+        } else if (c == '\n') {
+            result += "\\n";
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+std::string LabelsToString(const Labels& labels) {
+    std::string result;
+    for (const auto& [key, value] : labels) {
+        if (!result.empty()) {
+            result += ',';
+        }
+        result += key + "=\"" + EscapeLabelValue(value) + '"';
+    }
+    return result;
+}
+
+std::string WithLabels(const std::string& labels, const std::string& extra = {}) {
+    if (labels.empty() && extra.empty()) {
+        return {};
+    }
+    if (labels.empty() || extra.empty()) {
+        return '{' + labels + extra + '}';
+    }
+    return '{' + labels + ',' + extra + '}';
+}
+
+double MicrosecondsToSeconds(uint64_t value_us) {
+    return static_cast<double>(value_us) / 1'000'000.0;
+}
+
+}  // namespace
+
+size_t CurrentShard() noexcept {
+    thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % SHARDS_COUNT;
+    return shard;
+}
+
+void Counter::Add(uint64_t value) noexcept {
+    shards_[CurrentShard()].value.fetch_add(value, std::memory_order_relaxed);
+}
+
+uint64_t Counter::Value() const noexcept {
+    uint64_t result = 0;
+    for (const auto& shard : shards_) {
+        result += shard.value.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void Gauge::Set(int64_t value) noexcept {
+    value_.store(value, std::memory_order_relaxed);
+}
+
+void Gauge::Add(int64_t delta) noexcept {
+    value_.fetch_add(delta, std::memory_order_relaxed);
+}
+
+int64_t Gauge::Value() const noexcept {
+    return value_.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::Snapshot::Count() const noexcept {
+    return count_;
+}
+
+uint64_t Histogram::Snapshot::Sum() const noexcept {
+    return sum_;
+}
+
+uint64_t Histogram::Snapshot::Percentile(double q) const noexcept {
+    if (count_ == 0) {
+        return 0;
+    }
+    q = std::clamp(q, 0.0, 1.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(count_))));
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        cumulative += buckets_[i];
+        if (cumulative >= rank) {
+            return BucketUpperBound(i);
+        }
+    }
+    return BucketUpperBound(buckets_.size() - 1);
+}
+
+uint64_t Histogram::Snapshot::CountLessOrEqual(uint64_t value) const noexcept {
+    uint64_t result = 0;
+    for (size_t i = 0; i < buckets_.size() && BucketUpperBound(i) <= value; ++i) {
+        result += buckets_[i];
+    }
+    return result;
+}
+
+void Histogram::Snapshot::Merge(const Snapshot& other) noexcept {
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    sum_ += other.sum_;
+    count_ += other.count_;
+}
+
+Histogram::Histogram()
+    : shards_{std::make_unique<Shard[]>(SHARDS_COUNT)} {
+}
+
+void Histogram::Record(uint64_t value_us) noexcept {
+    Shard& shard = shards_[CurrentShard()];
+    shard.buckets[BucketIndex(value_us)].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value_us, std::memory_order_relaxed);
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Histogram::Record(std::chrono::steady_clock::duration duration) noexcept {
+    const auto value_us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    Record(static_cast<uint64_t>(std::max<int64_t>(0, value_us)));
+}
+
+Histogram::Snapshot Histogram::TakeSnapshot() const {
+    Snapshot snapshot;
+    for (size_t s = 0; s < SHARDS_COUNT; ++s) {
+        const Shard& shard = shards_[s];
+        for (size_t i = 0; i < BUCKETS_COUNT; ++i) {
+            snapshot.buckets_[i] += shard.buckets[i].load(std::memory_order_relaxed);
+        }
+        snapshot.sum_ += shard.sum.load(std::memory_order_relaxed);
+        snapshot.count_ += shard.count.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+size_t Histogram::BucketIndex(uint64_t value) noexcept {
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+    const unsigned bits = static_cast<unsigned>(std::bit_width(value));
+    if (bits > MAX_VALUE_BITS) {
+        return BUCKETS_COUNT - 1;
+    }
+    const unsigned shift = bits - SUB_BUCKET_BITS;
+    const uint64_t top = value >> shift;
+    return static_cast<size_t>(SUB_BUCKETS + (shift - 1) * SUB_BUCKETS_HALF + (top - SUB_BUCKETS_HALF));
+}
+
+uint64_t Histogram::BucketUpperBound(size_t index) noexcept {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    const size_t offset = index - SUB_BUCKETS;
+    const unsigned shift = static_cast<unsigned>(offset / SUB_BUCKETS_HALF) + 1;
+    const uint64_t top = offset % SUB_BUCKETS_HALF + SUB_BUCKETS_HALF;
+    return ((top + 1) << shift) - 1;
+}
+
+Registry& Registry::Instance() {
+    static Registry registry;
+    return registry;
+}
+
+template <typename Metric>
+Metric& Registry::GetOrCreate(std::map<std::string, Family<Metric>>& families, const std::string& name,
+                              const std::string& help, const Labels& labels) {
+    auto& family = families[name];
+    if (family.help.empty()) {
+        family.help = help;
+    }
+    auto& metric = family.series[LabelsToString(labels)];
+    if (!metric) {
+        metric = std::make_unique<Metric>();
+    }
+    return *metric;
+}
+
+Counter& Registry::GetCounter(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard lock{mutex_};
+    return GetOrCreate(counters_, name, help, labels);
+}
+
+Gauge& Registry::GetGauge(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard lock{mutex_};
+    return GetOrCreate(gauges_, name, help, labels);
+}
+
+Histogram& Registry::GetHistogram(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard lock{mutex_};
+    return GetOrCreate(histograms_, name, help, labels);
+}
+
+std::string Registry::Render() const {
+    std::ostringstream out;
+    std::lock_guard lock{mutex_};
+
+    for (const auto& [name, family] : counters_) {
+        out << "# HELP " << name << ' ' << family.help << '\n';
+        out << "# TYPE " << name << " counter\n";
+        for (const auto& [labels, counter] : family.series) {
+            out << name << WithLabels(labels) << ' ' << counter->Value() << '\n';
+        }
+    }
+
+    for (const auto& [name, family] : gauges_) {
+        out << "# HELP " << name << ' ' << family.help << '\n';
+        out << "# TYPE " << name << " gauge\n";
+        for (const auto& [labels, gauge] : family.series) {
+            out << name << WithLabels(labels) << ' ' << gauge->Value() << '\n';
+        }
+    }
+
+    for (const auto& [name, family] : histograms_) {
+        out << "# HELP " << name << ' ' << family.help << '\n';
+        out << "# TYPE " << name << " histogram\n";
+        for (const auto& [labels, histogram] : family.series) {
+            const auto snapshot = histogram->TakeSnapshot();
+            for (uint64_t bound : EXPORT_BOUNDS_US) {
+                std::ostringstream le;
+                le << "le=\"" << MicrosecondsToSeconds(bound) << '"';
+                out << name << "_bucket" << WithLabels(labels, le.str()) << ' '
+                    << snapshot.CountLessOrEqual(bound) << '\n';
+            }
+            out << name << "_bucket" << WithLabels(labels, "le=\"+Inf\"") << ' ' << snapshot.Count() << '\n';
+            out << name << "_sum" << WithLabels(labels) << ' ' << MicrosecondsToSeconds(snapshot.Sum()) << '\n';
+            out << name << "_count" << WithLabels(labels) << ' ' << snapshot.Count() << '\n';
+        }
+    }
+
+    return out.str();
+}
+
+}  // namespace metrics
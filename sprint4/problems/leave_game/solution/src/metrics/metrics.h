@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace metrics {
+
+// Каждый поток пишет в свой шард, суммирование шардов выполняется только при чтении
+constexpr size_t SHARDS_COUNT = 16;
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+size_t CurrentShard() noexcept;
+
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+class Counter {
+public:
+    void Add(uint64_t value = 1) noexcept;
+    uint64_t Value() const noexcept;
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Shard, SHARDS_COUNT> shards_;
+};
+
+class Gauge {
+public:
+    void Set(int64_t value) noexcept;
+    void Add(int64_t delta) noexcept;
+    int64_t Value() const noexcept;
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+/*
+ *  Гистограмма длительностей в микросекундах с лог-линейными корзинами (как в HdrHistogram).
+ *  Значения меньше SUB_BUCKETS хранятся точно, остальные - с относительной погрешностью
+ *  не более 1 / SUB_BUCKETS_HALF.
+ */
+class Histogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr uint64_t SUB_BUCKETS = uint64_t{1} << SUB_BUCKET_BITS;
+    static constexpr uint64_t SUB_BUCKETS_HALF = SUB_BUCKETS / 2;
+    static constexpr unsigned MAX_VALUE_BITS = 40;
+    static constexpr size_t BUCKETS_COUNT = SUB_BUCKETS + (MAX_VALUE_BITS - SUB_BUCKET_BITS) * SUB_BUCKETS_HALF;
+
+    class Snapshot {
+    public:
+        Snapshot() : buckets_(BUCKETS_COUNT, 0) {}
+
+        uint64_t Count() const noexcept;
+        uint64_t Sum() const noexcept;
+        // Возвращает верхнюю границу корзины, в которую попадает квантиль q из [0, 1]
+        uint64_t Percentile(double q) const noexcept;
+        uint64_t CountLessOrEqual(uint64_t value) const noexcept;
+        void Merge(const Snapshot& other) noexcept;
+
+    private:
+        friend class Histogram;
+        std::vector<uint64_t> buckets_;
+        uint64_t sum_ = 0;
+        uint64_t count_ = 0;
+    };
+
+    Histogram();
+
+    void Record(uint64_t value_us) noexcept;
+    void Record(std::chrono::steady_clock::duration duration) noexcept;
+    Snapshot TakeSnapshot() const;
+
+    static size_t BucketIndex(uint64_t value) noexcept;
+    static uint64_t BucketUpperBound(size_t index) noexcept;
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        std::array<std::atomic<uint64_t>, BUCKETS_COUNT> buckets{};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> count{0};
+    };
+    std::unique_ptr<Shard[]> shards_;
+};
+
+// Замеряет время жизни объекта и записывает его в гистограмму
+class ScopedTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ScopedTimer(Histogram& histogram) noexcept
+        : histogram_{histogram}
+        , start_{Clock::now()} {
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer() {
+        histogram_.Record(Clock::now() - start_);
+    }
+
+private:
+    Histogram& histogram_;
+    Clock::time_point start_;
+};
+
+/*
+ *  Реестр метрик процесса. Метрики создаются один раз и живут до завершения программы,
+ *  поэтому ссылки на них можно кешировать в местах инструментирования.
+ */
+class Registry {
+public:
+    static Registry& Instance();
+
+    Counter& GetCounter(const std::string& name, const std::string& help, const Labels& labels = {});
+    Gauge& GetGauge(const std::string& name, const std::string& help, const Labels& labels = {});
+    Histogram& GetHistogram(const std::string& name, const std::string& help, const Labels& labels = {});
+
+    // Текстовый формат экспозиции Prometheus
+    std::string Render() const;
+
+private:
+    template <typename Metric>
+    struct Family {
+        std::string help;
+        std::map<std::string, std::unique_ptr<Metric>> series;
+    };
+
+    template <typename Metric>
+    static Metric& GetOrCreate(std::map<std::string, Family<Metric>>& families, const std::string& name,
+                               const std::string& help, const Labels& labels);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family<Counter>> counters_;
+    std::map<std::string, Family<Gauge>> gauges_;
+    std::map<std::string, Family<Histogram>> histograms_;
+};
+
+}  // namespace metrics
@@ -0,0 +1,216 @@
+#include "bots.h"
+
+#include <array>
+#include <cmath>
+
+namespace model {
+
+using namespace std::literals;
+
+namespace {
+
+constexpr std::array<constants::Direction, 4> DIRECTIONS{
+    constants::Direction::NORTH, constants::Direction::SOUTH, constants::Direction::WEST, constants::Direction::EAST
+};
+
+// Дошла ли собака, идущая в направлении direction, до точки point
+bool IsReached(const geom::Point2D& position, constants::Direction direction, Point point) noexcept {
+    switch (direction) {
+        case constants::Direction::NORTH:
+            return position.y <= point.y;
+        case constants::Direction::SOUTH:
+            return position.y >= point.y;
+        case constants::Direction::WEST:
+            return position.x <= point.x;
+        case constants::Direction::EAST:
+            return position.x >= point.x;
+        default:
+            return true;
+    }
+}
+
+void Go(Dog& dog, constants::Direction direction, double speed) noexcept {
+    dog.SetDirection(direction);
+    switch (direction) {
+        case constants::Direction::NORTH:
+            dog.SetSpeed({0, -speed});
+            break;
+        case constants::Direction::SOUTH:
+            dog.SetSpeed({0, speed});
+            break;
+        case constants::Direction::WEST:
+            dog.SetSpeed({-speed, 0});
+            break;
+        case constants::Direction::EAST:
+            dog.SetSpeed({speed, 0});
+            break;
+        default:
+            dog.SetSpeed({0, 0});
+    }
+}
+
+}  // namespace
+
+RoadNavigation::RoadNavigation(const Map& map)
+    : graph{map} {
+    std::vector<RoadGraph::NodeId> offices;
+    for (const Office& office : map.GetOffices()) {
+        if (auto node = graph.FindNode(office.GetPosition())) {
+            offices.push_back(*node);
+        }
+    }
+    graph.FindDistances(offices, office_distances);
+}
+
+RoadNavigation::RoadNavigation(RoadGraph graph, RoadGraph::Distances office_distances) noexcept
+    : graph{std::move(graph)}
+    , office_distances{std::move(office_distances)} {
+}
+
+const RoadGraph& BotContext::GetGraph() const noexcept {
+    return graph_;
+}
+
+random::Engine& BotContext::GetRandom() noexcept {
+    return random_;
+}
+
+size_t BotContext::GetBagCapacity() const noexcept {
+    return bag_capacity_;
+}
+
+bool BotContext::HasLoot() const noexcept {
+    return !lost_objects_.empty();
+}
+
+const RoadGraph::Distances& BotContext::GetOfficeDistances() const noexcept {
+    return office_distances_;
+}
+
+const RoadGraph::Distances& BotContext::GetLootDistances() {
+    if (!loot_distances_ready_) {
+        std::vector<RoadGraph::NodeId> sources;
+        sources.reserve(lost_objects_.size());
+        for (const auto& lost_object : lost_objects_) {
+            const geom::Point2D coord = lost_object->GetCoordinate();
+            if (auto node = graph_.FindNode({static_cast<Coord>(std::round(coord.x)), static_cast<Coord>(std::round(coord.y))})) {
+                sources.push_back(*node);
+            }
+        }
+        graph_.FindDistances(sources, loot_distances_);
+        loot_distances_ready_ = true;
+    }
+    return loot_distances_;
+}
+
+constants::Direction RandomWalkPolicy::ChooseDirection(const Dog& dog, RoadGraph::NodeId node, BotContext& context) {
+    const RoadGraph& graph = context.GetGraph();
+    const constants::Direction back = dog.GetSpeed() == std::pair{0.0, 0.0} ? constants::Direction::STOP : Reverse(dog.GetDirection());
+
+    std::array<constants::Direction, 4> choices;
+    size_t count = 0;
+    for (constants::Direction direction : DIRECTIONS) {
+        if (direction != back && graph.GetNeighbor(node, direction) != RoadGraph::NO_NODE) {
+            choices[count++] = direction;
+        }
+    }
+    if (count == 0) {
+        // Тупик: возвращаемся, если есть куда
+        return graph.GetNeighbor(node, back) != RoadGraph::NO_NODE ? back : constants::Direction::STOP;
+    }
+    return choices[static_cast<size_t>(context.GetRandom().UniformInt(0, static_cast<int64_t>(count) - 1))];
+}
+
+constants::Direction LootSeekerPolicy::ChooseDirection(const Dog& dog, RoadGraph::NodeId node, BotContext& context) {
+    const RoadGraph::Distances* distances = nullptr;
+    if (dog.GetSizeBag() < context.GetBagCapacity() && context.HasLoot()) {
+        distances = &context.GetLootDistances();
+    } else if (dog.GetSizeBag() > 0) {
+        distances = &context.GetOfficeDistances();
+    }
+    if (!distances) {
+        return random_walk_.ChooseDirection(dog, node, context);
+    }
+
+    // Спускаемся к ближайшей цели, из равноценных шагов выбираем случайный
+    const RoadGraph& graph = context.GetGraph();
+    constants::Direction best = constants::Direction::STOP;
+    uint32_t best_distance = RoadGraph::UNREACHABLE;
+    int64_t ties = 0;
+    for (constants::Direction direction : DIRECTIONS) {
+        const RoadGraph::NodeId neighbor = graph.GetNeighbor(node, direction);
+        if (neighbor == RoadGraph::NO_NODE) {
+            continue;
+        }
+        const uint32_t distance = (*distances)[neighbor];
+        if (distance < best_distance) {
+            best = direction;
+            best_distance = distance;
+            ties = 1;
+        } else if (distance == best_distance && distance != RoadGraph::UNREACHABLE
+                   && context.GetRandom().UniformInt(0, ties++) == 0) {
+            best = direction;
+        }
+    }
+    if (best_distance == RoadGraph::UNREACHABLE) {
+        // Цель недостижима с этой дороги
+        return random_walk_.ChooseDirection(dog, node, context);
+    }
+    return best;
+}
+
+std::optional<BotPolicyType> ParseBotPolicy(std::string_view name) noexcept {
+    if (name == "randomWalk"sv) {
+        return BotPolicyType::RANDOM_WALK;
+    }
+    if (name == "lootSeeker"sv) {
+        return BotPolicyType::LOOT_SEEKER;
+    }
+    return std::nullopt;
+}
+
+std::unique_ptr<BotPolicy> MakeBotPolicy(BotPolicyType type) {
+    switch (type) {
+        case BotPolicyType::RANDOM_WALK:
+            return std::make_unique<RandomWalkPolicy>();
+        default:
+            return std::make_unique<LootSeekerPolicy>();
+    }
+}
+
+void Bot::Update(BotContext& context, double speed) {
+    const RoadGraph& graph = context.GetGraph();
+    Dog& dog = *dog_;
+    const bool moving = dog.GetSpeed() != std::pair{0.0, 0.0};
+    if (moving && target_ && !IsReached(dog.GetCoordinate(), dog.GetDirection(), graph.GetPoint(*target_))) {
+        return;
+    }
+
+    // Собака, которую остановил край дороги, продолжает путь из ближайшего узла
+    std::optional<RoadGraph::NodeId> node = moving ? target_ : std::nullopt;
+    if (!node) {
+        const geom::Point2D coord = dog.GetCoordinate();
+        node = graph.FindNode({static_cast<Coord>(std::round(coord.x)), static_cast<Coord>(std::round(coord.y))});
+    }
+    if (!node) {
+        Go(dog, constants::Direction::STOP, speed);
+        target_.reset();
+        return;
+    }
+
+    const constants::Direction direction = policy_->ChooseDirection(dog, *node, context);
+    const RoadGraph::NodeId next = graph.GetNeighbor(*node, direction);
+    if (next == RoadGraph::NO_NODE) {
+        Go(dog, constants::Direction::STOP, speed);
+        target_.reset();
+        return;
+    }
+    // За тик собака могла проскочить узел, поворачивает она точно в нём
+    if (!moving || direction != dog.GetDirection()) {
+        dog.SetCoordinateByPoint(graph.GetPoint(*node));
+    }
+    Go(dog, direction, speed);
+    target_ = next;
+}
+
+}  // namespace model
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_set>
+
+#include "dog.h"
+#include "lost_object.h"
+#include "random.h"
+#include "road_graph.h"
+
+namespace model {
+
+// Граф дорог карты и расстояния до её баз, общие для всех сессий карты
+struct RoadNavigation {
+    explicit RoadNavigation(const Map& map);
+    RoadNavigation(RoadGraph graph, RoadGraph::Distances office_distances) noexcept;
+
+    RoadGraph graph;
+    RoadGraph::Distances office_distances;
+};
+
+/*
+ *  Что видит бот, выбирая направление. Создаётся сессией на каждый тик.
+ *  Расстояния до предметов считаются при первом обращении за тик и общие для всех ботов сессии.
+ */
+class BotContext {
+public:
+    using LostObjects = std::unordered_set<std::shared_ptr<LostObject>>;
+
+    BotContext(const RoadNavigation& navigation, const LostObjects& lost_objects,
+               RoadGraph::Distances& loot_distances, size_t bag_capacity, random::Engine& random) noexcept
+        : graph_{navigation.graph}
+        , office_distances_{navigation.office_distances}
+        , lost_objects_{lost_objects}
+        , loot_distances_{loot_distances}
+        , bag_capacity_{bag_capacity}
+        , random_{random} {
+    }
+
+    const RoadGraph& GetGraph() const noexcept;
+    random::Engine& GetRandom() noexcept;
+    size_t GetBagCapacity() const noexcept;
+    bool HasLoot() const noexcept;
+    const RoadGraph::Distances& GetOfficeDistances() const noexcept;
+    const RoadGraph::Distances& GetLootDistances();
+
+private:
+    const RoadGraph& graph_;
+    const RoadGraph::Distances& office_distances_;
+    const LostObjects& lost_objects_;
+    RoadGraph::Distances& loot_distances_;
+    bool loot_distances_ready_ = false;
+    size_t bag_capacity_;
+    random::Engine& random_;
+};
+
+// Стратегия бота. Вызывается, когда собака дошла до узла графа дорог или стоит на месте
+class BotPolicy {
+public:
+    virtual ~BotPolicy() = default;
+    // Направление, в котором собака пойдёт из узла node, STOP - остаться на месте
+    virtual constants::Direction ChooseDirection(const Dog& dog, RoadGraph::NodeId node, BotContext& context) = 0;
+};
+
+// Случайное блуждание: на перекрёстке выбирает случайную дорогу, назад поворачивает только в тупике
+class RandomWalkPolicy : public BotPolicy {
+public:
+    constants::Direction ChooseDirection(const Dog& dog, RoadGraph::NodeId node, BotContext& context) override;
+};
+
+// Идёт кратчайшим путём к ближайшему предмету, с полным рюкзаком или когда предметов нет - к ближайшей базе
+class LootSeekerPolicy : public BotPolicy {
+public:
+    constants::Direction ChooseDirection(const Dog& dog, RoadGraph::NodeId node, BotContext& context) override;
+
+private:
+    RandomWalkPolicy random_walk_;
+};
+
+// Имена стратегий в конфиге и командной строке: randomWalk, lootSeeker
+std::optional<BotPolicyType> ParseBotPolicy(std::string_view name) noexcept;
+std::unique_ptr<BotPolicy> MakeBotPolicy(BotPolicyType type);
+
+/*
+ *  Собака под управлением стратегии. Бот ведёт собаку к выбранному соседнему узлу
+ *  и спрашивает стратегию о следующем шаге, когда собака до него дошла.
+ */
+class Bot {
+public:
+    Bot(std::shared_ptr<Dog> dog, std::unique_ptr<BotPolicy> policy) noexcept
+        : dog_{std::move(dog)}
+        , policy_{std::move(policy)} {
+    }
+
+    // Вызывается перед перемещением собак, speed - скорость собак на карте
+    void Update(BotContext& context, double speed);
+
+private:
+    std::shared_ptr<Dog> dog_;
+    std::unique_ptr<BotPolicy> policy_;
+    std::optional<RoadGraph::NodeId> target_;
+};
+
+}  // namespace model
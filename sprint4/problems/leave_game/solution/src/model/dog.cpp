@@ -83,6 +83,10 @@ void Dog::SetRetirementTime(uint32_t retired_time_in_ms) {
     retirementTime_ = std::chrono::milliseconds(retired_time_in_ms);
 }
 
+uint32_t Dog::GetRetirementTime() noexcept {
+    return static_cast<uint32_t>(retirementTime_.count());
+}
+
 void Dog::AddTime(const std::chrono::milliseconds &time_delta) noexcept {
     game_time_ += time_delta;
 
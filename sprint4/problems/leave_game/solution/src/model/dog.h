@@ -45,6 +45,7 @@ public:
     const collision_detector::Gatherer& GetGather() const noexcept;
 
     static void SetRetirementTime(uint32_t retired_time_in_ms);
+    static uint32_t GetRetirementTime() noexcept;
     void AddTime(const std::chrono::milliseconds& time_delta) noexcept;
     bool IsRetired();
     uint32_t GetGameTime();
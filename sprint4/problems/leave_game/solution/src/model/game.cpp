@@ -8,8 +8,10 @@ void Game::AddMap(Map map) {
         throw std::invalid_argument("Map with id "s + *map.GetId() + " already exists"s);
     } else {
         try {
+            session_managers_.emplace(map.GetId(), std::make_shared<SessionManager>(map.GetId()));
             maps_.emplace_back(std::move(map));
         } catch (...) {
+            session_managers_.erase(it->first);
             map_id_to_index_.erase(it);
             throw;
         }
@@ -17,28 +19,36 @@ void Game::AddMap(Map map) {
 }
 
 void Game::AddSession(std::shared_ptr<GameSession> session) {
-    sessions_.push_back(session);
-}
-
-std::vector<std::shared_ptr<GameSession> > &Game::GetAllSession() {
-    return sessions_;
+    auto it = session_managers_.find(session->GetId());
+    if (it == session_managers_.end()) {
+        throw std::invalid_argument("Session map "s + *session->GetId() + " not found"s);
+    }
+    const size_t dogs_count = session->GetDogsCount();
+    it->second->Add(std::move(session), dogs_count);
 }
 
-std::shared_ptr<GameSession> Game::FindValidSession(const Map *map, std::chrono::milliseconds tick_period, net::io_context& ioc) {
-
-    auto it = std::find_if(sessions_.begin(), sessions_.end(),
-        [map](const std::shared_ptr<GameSession>& session) {
-            return session->GetMapName() == map->GetName() && session->GetDogsCount() < constants::MAXPLAYERSINMAP;
-        });
-
-    if (it != sessions_.end()) {
-        return *it;
+std::vector<std::shared_ptr<GameSession>> Game::GetAllSession() const {
+    std::vector<std::shared_ptr<GameSession>> result;
+    for (const Map& map : maps_) {
+        const auto sessions = session_managers_.at(map.GetId())->GetSessions();
+        result.insert(result.end(), sessions->begin(), sessions->end());
     }
+    return result;
+}
 
-    auto newSession = std::make_shared<GameSession>(map, tick_period, lood_gen_config_, ioc);
-    AddSession(newSession);
-    newSession->Run();
-    return newSession;
+std::shared_ptr<GameSession> Game::FindValidSession(const Map *map, std::chrono::milliseconds tick_period, net::io_context& ioc,
+                                                    const SessionCreated& on_created) {
+    return session_managers_.at(map->GetId())->Acquire([this, map, tick_period, &ioc, &on_created] {
+        auto newSession = std::make_shared<GameSession>(map, tick_period, lood_gen_config_, ioc, NextSessionSeed());
+        if (view_radius_ > 0) {
+            newSession->EnableInterestIndex(view_radius_);
+        }
+        if (on_created) {
+            on_created(newSession);
+        }
+        newSession->Run(timer_wheel_);
+        return newSession;
+    });
 }
 
 const Game::Maps &Game::GetMaps() const noexcept {
@@ -56,7 +66,7 @@ void Game::SetDefaultDogSpeed(double defaultDogSpeed){
     defaultDogSpeed_= defaultDogSpeed;
 }
 
-const double Game::GetDefaultDogSpeed() {
+const double Game::GetDefaultDogSpeed() const noexcept {
     return defaultDogSpeed_;
 }
 
@@ -64,7 +74,7 @@ void Game::SetDefaultBagCapacity(int defaultBagCapacity) {
     defaultBagCapacity_ = defaultBagCapacity;
 }
 
-int Game::GetDefaultBagCapacity() {
+int Game::GetDefaultBagCapacity() const noexcept {
     return defaultBagCapacity_;
 }
 
@@ -72,8 +82,32 @@ void Game::SetLootGeneratorConfig(LootGeneratorConfig &lood_gen_config) {
     lood_gen_config_ = lood_gen_config;
 }
 
-LootGeneratorConfig &Game::GetLootGeneratorConfig() {
+const LootGeneratorConfig& Game::GetLootGeneratorConfig() const noexcept {
     return lood_gen_config_;
 }
 
+void Game::SetRandomSeed(uint64_t seed) noexcept {
+    session_seeds_.Reset(seed);
+}
+
+uint64_t Game::NextSessionSeed() noexcept {
+    return session_seeds_.Next();
+}
+
+void Game::SetViewRadius(double view_radius) noexcept {
+    view_radius_ = view_radius;
+}
+
+double Game::GetViewRadius() const noexcept {
+    return view_radius_;
+}
+
+void Game::SetTimerWheel(std::shared_ptr<time_tiker::TimerWheel> timer_wheel) {
+    timer_wheel_ = std::move(timer_wheel);
+}
+
+const std::shared_ptr<time_tiker::TimerWheel>& Game::GetTimerWheel() const noexcept {
+    return timer_wheel_;
+}
+
 } // namespace model
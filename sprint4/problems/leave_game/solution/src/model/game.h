@@ -1,11 +1,13 @@
 #pragma once
 
+#include <functional>
 #include <vector>
 #include <string>
 
 #include "model.h"
 #include "maps.h"
 #include "game_session.h"
+#include "session_manager.h"
 
 namespace model {
 
@@ -18,30 +20,54 @@ public:
     void AddMap(Map map);
     void AddSession(std::shared_ptr<GameSession> session);
 
-    std::vector<std::shared_ptr<GameSession>>& GetAllSession();
-    std::shared_ptr<GameSession> FindValidSession(const Map* map, std::chrono::milliseconds tick_period, net::io_context& ioc);
+    // Снимок всех работающих сессий, порядок - по порядку карт
+    std::vector<std::shared_ptr<GameSession>> GetAllSession() const;
+    using SessionCreated = std::function<void(const std::shared_ptr<GameSession>&)>;
+
+    // Возвращает сессию карты со свободным местом и занимает его, при необходимости создаёт сессию.
+    // on_created вызывается для новой сессии до запуска её тиков
+    std::shared_ptr<GameSession> FindValidSession(const Map* map, std::chrono::milliseconds tick_period, net::io_context& ioc,
+                                                  const SessionCreated& on_created = {});
 
     const Maps& GetMaps() const noexcept;
     const Map* FindMap(const Map::Id& id) const noexcept;
 
     void SetDefaultDogSpeed(double defaultDogSpeed);
-    const double GetDefaultDogSpeed();
+    const double GetDefaultDogSpeed() const noexcept;
 
     void SetDefaultBagCapacity(int defaultBagCapacity);
-    int GetDefaultBagCapacity();
+    int GetDefaultBagCapacity() const noexcept;
     void SetLootGeneratorConfig(LootGeneratorConfig& lood_gen_config);
-    LootGeneratorConfig& GetLootGeneratorConfig();
+    const LootGeneratorConfig& GetLootGeneratorConfig() const noexcept;
+
+    // Мастер-зерно, из которого выводятся зёрна генераторов всех сессий.
+    // NextSessionSeed можно вызывать из разных потоков
+    void SetRandomSeed(uint64_t seed) noexcept;
+    uint64_t NextSessionSeed() noexcept;
+
+    // Радиус видимости игрока в ответе /game/state, 0 - игрок видит всех собак и все вещи.
+    // Если он задан, новые сессии ведут пространственный индекс с клеткой такого размера
+    void SetViewRadius(double view_radius) noexcept;
+    double GetViewRadius() const noexcept;
+
+    // Колесо таймеров, на которое подписываются новые сессии
+    void SetTimerWheel(std::shared_ptr<time_tiker::TimerWheel> timer_wheel);
+    const std::shared_ptr<time_tiker::TimerWheel>& GetTimerWheel() const noexcept;
 
 private:
     using MapIdHasher = util::TaggedHasher<Map::Id>;
     using MapIdToIndex = std::unordered_map<Map::Id, size_t, MapIdHasher>;
+    using MapIdToSessionManager = std::unordered_map<Map::Id, std::shared_ptr<SessionManager>, MapIdHasher>;
 
     std::vector<Map> maps_;
     MapIdToIndex map_id_to_index_;
-    std::vector<std::shared_ptr<GameSession>> sessions_;
+    MapIdToSessionManager session_managers_;
     double defaultDogSpeed_ = 1;
     int defaultBagCapacity_ = 3;
     LootGeneratorConfig lood_gen_config_;
+    random::SeedSequence session_seeds_{random::MakeRandomSeed()};
+    double view_radius_ = 0;
+    std::shared_ptr<time_tiker::TimerWheel> timer_wheel_;
 };
 
 
@@ -1,19 +1,81 @@
 #include "game_session.h"
 
+#include "../metrics/metrics.h"
+
 namespace model {
 
+namespace {
+
+struct SessionPhaseMetrics {
+    metrics::Histogram& bots;
+    metrics::Histogram& move;
+    metrics::Histogram& loot;
+    metrics::Histogram& collect;
+    metrics::Histogram& retire;
+};
+
+SessionPhaseMetrics& GetSessionPhaseMetrics() {
+    auto& registry = metrics::Registry::Instance();
+    const std::string name = "game_server_session_phase_duration_seconds";
+    const std::string help = "Duration of game session update phases";
+    static SessionPhaseMetrics phase_metrics{
+        registry.GetHistogram(name, help, {{"phase", "bots"}}),
+        registry.GetHistogram(name, help, {{"phase", "move"}}),
+        registry.GetHistogram(name, help, {{"phase", "loot"}}),
+        registry.GetHistogram(name, help, {{"phase", "collect"}}),
+        registry.GetHistogram(name, help, {{"phase", "retire"}})
+    };
+    return phase_metrics;
+}
+
+}  // namespace
+
 void GameSession::AddDog(std::shared_ptr<Dog> dog, bool randomize_spawn_points) {
     if (randomize_spawn_points) {
-        Point dog_coord = map_->GetRandomPointRoadMap();
+        Point dog_coord = map_->GetRandomPointRoadMap(spawn_random_);
         dog->SetCoordinateByPoint(dog_coord);
     } else {       
        dog->SetCoordinateByPoint(map_->GetStartPointRoadMap());
     }
-    dogs_.insert(dog);
+    AddDog(std::move(dog));
 }
 
 void GameSession::AddDog(std::shared_ptr<Dog> dog) {
-    dogs_.insert(dog);
+    if (dogs_index_) {
+        dogs_index_->Insert(dog);
+    }
+    dogs_.insert(std::move(dog));
+    dogs_count_.store(dogs_.size(), std::memory_order_relaxed);
+}
+
+void GameSession::AddBot(std::shared_ptr<Dog> dog, std::unique_ptr<BotPolicy> policy,
+                         std::shared_ptr<const RoadNavigation> navigation, bool randomize_spawn_points) {
+    navigation_ = std::move(navigation);
+    const uint32_t dog_id = dog->GetId();
+    AddDog(dog, randomize_spawn_points);
+    bots_.emplace(dog_id, Bot{std::move(dog), std::move(policy)});
+}
+
+void GameSession::PostAddDog(std::shared_ptr<Dog> dog, bool randomize_spawn_points) {
+    net::post(*game_session_strand_, [self = shared_from_this(), dog = std::move(dog), randomize_spawn_points]() mutable {
+        self->AddDog(std::move(dog), randomize_spawn_points);
+    });
+}
+
+void GameSession::PostAddBot(std::shared_ptr<Dog> dog, std::unique_ptr<BotPolicy> policy,
+                             std::shared_ptr<const RoadNavigation> navigation, bool randomize_spawn_points) {
+    net::post(*game_session_strand_, [self = shared_from_this(), dog = std::move(dog), policy = std::move(policy),
+                                      navigation = std::move(navigation), randomize_spawn_points]() mutable {
+        self->AddBot(std::move(dog), std::move(policy), std::move(navigation), randomize_spawn_points);
+    });
+}
+
+bool GameSession::IsBot(uint32_t dog_id) const {
+    return bots_.contains(dog_id);
+}
+
+size_t GameSession::GetBotsCount() const noexcept {
+    return bots_.size();
 }
 
 const std::string &model::GameSession::GetMapName() const noexcept {
@@ -25,7 +87,7 @@ const Map *GameSession::GetMap() noexcept {
 }
 
 const size_t GameSession::GetDogsCount() const noexcept {
-    return dogs_.size();
+    return dogs_count_.load(std::memory_order_relaxed);
 }
 
 std::unordered_set<std::shared_ptr<Dog>>& GameSession::GetDogs() noexcept {
@@ -37,15 +99,54 @@ std::unordered_set<std::shared_ptr<LostObject>> &GameSession::GetLostObjects() n
 }
 
 void GameSession::AddLostObject(std::shared_ptr<LostObject> &lost_object) {
+    if (lost_objects_index_) {
+        lost_objects_index_->Insert(lost_object);
+    }
     lost_objects_.insert(lost_object);
 }
 
+void GameSession::EnableInterestIndex(double cell_size) {
+    dogs_index_.emplace(cell_size);
+    lost_objects_index_.emplace(cell_size);
+    for (const auto& dog : dogs_) {
+        dogs_index_->Insert(dog);
+    }
+    for (const auto& lost_object : lost_objects_) {
+        lost_objects_index_->Insert(lost_object);
+    }
+}
+
 void GameSession::UpdateSessionByTime(const std::chrono::milliseconds& time_delta) {
+    auto& phase_metrics = GetSessionPhaseMetrics();
+    if (!bots_.empty()) {
+        metrics::ScopedTimer timer{phase_metrics.bots};
+        UpdateBots();
+    }
+    {
+        metrics::ScopedTimer timer{phase_metrics.move};
+        UpdateDogsCoordinatsByTime(time_delta);
+    }
+    {
+        metrics::ScopedTimer timer{phase_metrics.loot};
+        UpdateLootGenerationByTime(time_delta);
+    }
+    {
+        metrics::ScopedTimer timer{phase_metrics.collect};
+        Collector();
+    }
+    {
+        metrics::ScopedTimer timer{phase_metrics.retire};
+        DeleteRetiredDog();
+    }
+}
 
-    UpdateDogsCoordinatsByTime(time_delta);
-    UpdateLootGenerationByTime(time_delta);
-    Collector();
-    DeleteRetiredDog();
+void GameSession::UpdateBots() {
+    BotContext context{*navigation_, lost_objects_, loot_distances_,
+                       static_cast<size_t>(map_->GetBagCapacity()), random_};
+    const double speed = map_->GetDogSpeed();
+    for (auto& [id, bot] : bots_) {
+        bot.Update(context, speed);
+    }
 }
 
 void GameSession::UpdateDogsCoordinatsByTime(const std::chrono::milliseconds& time_delta_ms){
@@ -140,7 +241,10 @@ void GameSession::UpdateDogsCoordinatsByTime(const std::chrono::milliseconds& ti
                 }
             }
         }
-        dog->SetCoordinate(finish);        
+        dog->SetCoordinate(finish);
+        if (dogs_index_) {
+            dogs_index_->Update(dog);
+        }
     }
 }
 
@@ -153,10 +257,10 @@ void GameSession::UpdateLootGenerationByTime(const std::chrono::milliseconds& ti
 
     for (unsigned i = 0; i < new_loot_count; ++i) {
         auto lost_object = std::make_shared<LostObject>();
-        Point loot_coord = map_->GetRandomPointRoadMap();
+        Point loot_coord = map_->GetRandomPointRoadMap(random_);
         lost_object->SetCoordinateByPoint(loot_coord);
         lost_object->SetType(GetRandomTypeLostObject());
-        lost_objects_.insert(lost_object);
+        AddLostObject(lost_object);
     }
 }
 
@@ -198,6 +302,9 @@ void GameSession::Collector() {
             if (dog->GetSizeBag() < map_->GetBagCapacity()) {
                 dog->AddToBag(lost_object);
                 lost_object_it->second = nullptr;
+                if (lost_objects_index_) {
+                    lost_objects_index_->Erase(lost_object.get());
+                }
                 lost_objects_.erase(lost_object);
             }
         } else if (item.type == 1) {
@@ -210,20 +317,18 @@ void GameSession::Collector() {
 }
 
 size_t GameSession::GetRandomTypeLostObject() {
-    std::random_device rd;
-    std::default_random_engine eng(rd());
-    std::uniform_int_distribution<size_t> dis(0, map_->GetLootTypes().size() - 1);
-    return dis(eng);
+    return static_cast<size_t>(random_.UniformInt(0, static_cast<int64_t>(map_->GetLootTypes().size()) - 1));
 }
 
 std::shared_ptr<GameSession::Strand> GameSession::GetSessionStrand() {
     return game_session_strand_;
 }
 
-void GameSession::Run() {
+void GameSession::Run(const std::shared_ptr<time_tiker::TimerWheel>& timer_wheel) {
 
-    if(time_update_.count() != 0) {
-        ticker_ = std::make_shared<time_tiker::Ticker>(
+    if(time_update_.count() != 0 && timer_wheel && !timer_id_) {
+        timer_wheel_ = timer_wheel;
+        timer_id_ = timer_wheel->Add(
                     *game_session_strand_,
                     time_update_,
                     [self_weak = weak_from_this()](std::chrono::milliseconds delta) {
@@ -232,10 +337,19 @@ void GameSession::Run() {
             }
         }
         );
-        ticker_->Start();
     }
 }
 
+void GameSession::Stop() {
+    if (!timer_id_) {
+        return;
+    }
+    if (auto timer_wheel = timer_wheel_.lock()) {
+        timer_wheel->Remove(*timer_id_);
+    }
+    timer_id_.reset();
+}
+
 void GameSession::DeleteRetiredDog() {
     std::vector<domain::RetiredPlayers> retired_players;
 
@@ -246,11 +360,17 @@ void GameSession::DeleteRetiredDog() {
                                          (*it)->GetId(),
                                          (*it)->GetScore(),
                                          (*it)->GetGameTime());
+            // Место бота тоже освобождается, в таблицу рекордов он не попадает: у него нет игрока
+            bots_.erase((*it)->GetId());
+            if (dogs_index_) {
+                dogs_index_->Erase(it->get());
+            }
             it = dogs_.erase(it);
         } else {
             ++it;
         }
     }
+    dogs_count_.store(dogs_.size(), std::memory_order_relaxed);
 
     if (retired_players.empty()) {
         return;
@@ -263,6 +383,10 @@ boost::signals2::connection GameSession::ConnectRetiredPlayersSignal(RetiredPlay
     return retired_players_signal_.connect(slot);
 }
 
+random::Engine& GameSession::GetRandomEngine() noexcept {
+    return random_;
+}
+
 const GameSession::Id &GameSession::GetId() const noexcept {
     return map_->GetId();
 }
@@ -5,11 +5,15 @@
 #include "maps.h"
 #include "lost_object.h"
 #include "loot_generator.h"
-#include "../time/ticker.h"
+#include "random.h"
+#include "../time/timer_wheel.h"
 #include "item_gatherer_provider.h"
+#include "bots.h"
+#include "spatial_grid.h"
 #include "../events/geom.h"
 #include "../database/retired_players.h"
 
+#include <atomic>
 #include <cmath>
 #include <random>
 #include <boost/asio/strand.hpp>
@@ -28,17 +32,32 @@ public:
     using Strand = net::strand<net::io_context::executor_type>;
     using RetiredPlayersSignal = boost::signals2::signal<void(std::vector<domain::RetiredPlayers>)>;
 
+    // seed - зерно генератора случайных чисел сессии, см. Game::NextSessionSeed
     GameSession(const Map* map,
             loot_gen::LootGenerator::TimeInterval time_update,
-            LootGeneratorConfig loot_gen_config, net::io_context& ioc)
+            LootGeneratorConfig loot_gen_config, net::io_context& ioc,
+            uint64_t seed)
         : map_{map}
         , loot_generator_(loot_gen::LootGenerator::TimeInterval(static_cast<uint32_t>(loot_gen_config.period * 1000)), loot_gen_config.probability)
         , game_session_strand_{std::make_shared<Strand>(net::make_strand(ioc))}
-        , time_update_(time_update) {
+        , time_update_(time_update)
+        , random_{seed}
+        , spawn_random_{seed ^ SPAWN_SEED_SALT} {
     }
 
+    // AddDog и AddBot вызываются до запуска тиков или в strand сессии
     void AddDog(std::shared_ptr<Dog> dog, bool randomize_spawn_points);
     void AddDog(std::shared_ptr<Dog> dog);
+    // Добавляет собаку под управлением бота
+    void AddBot(std::shared_ptr<Dog> dog, std::unique_ptr<BotPolicy> policy,
+                std::shared_ptr<const RoadNavigation> navigation, bool randomize_spawn_points);
+    // Добавляют собаку из любого потока: вставка выполняется в strand сессии и не пересекается
+    // с тиком. Собака появляется в сессии после уже поставленных в strand обработчиков
+    void PostAddDog(std::shared_ptr<Dog> dog, bool randomize_spawn_points);
+    void PostAddBot(std::shared_ptr<Dog> dog, std::unique_ptr<BotPolicy> policy,
+                    std::shared_ptr<const RoadNavigation> navigation, bool randomize_spawn_points);
+    bool IsBot(uint32_t dog_id) const;
+    size_t GetBotsCount() const noexcept;
     const std::string& GetMapName() const noexcept;
     const Map* GetMap() noexcept;
     const Id& GetId() const noexcept;
@@ -46,26 +65,85 @@ public:
     std::unordered_set<std::shared_ptr<Dog>>& GetDogs() noexcept;
     std::unordered_set<std::shared_ptr<LostObject>>& GetLostObjects() noexcept;
     void AddLostObject(std::shared_ptr<LostObject>& lost_object);
+    // Включает пространственный индекс собак и вещей, который обновляется каждый тик.
+    // cell_size - размер клетки индекса, удобнее всего равный радиусу выборки
+    void EnableInterestIndex(double cell_size);
+    // Вызывают fn для собак и вещей не дальше radius от center. Без индекса перебирают всех
+    template <typename Fn>
+    void ForEachDogInRadius(geom::Point2D center, double radius, Fn&& fn) const;
+    template <typename Fn>
+    void ForEachLostObjectInRadius(geom::Point2D center, double radius, Fn&& fn) const;
     size_t GetRandomTypeLostObject();
     void UpdateSessionByTime(const std::chrono::milliseconds& time_delta);
+    void UpdateBots();
     void UpdateDogsCoordinatsByTime(const std::chrono::milliseconds& time_delta);
     void UpdateLootGenerationByTime(const std::chrono::milliseconds& time_delta);
     void Collector();
     std::shared_ptr<Strand> GetSessionStrand();
-    void Run();
+    // Подписывает сессию на тики колеса таймеров, если задан период обновления
+    void Run(const std::shared_ptr<time_tiker::TimerWheel>& timer_wheel);
+    void Stop();
     void DeleteRetiredDog();
     boost::signals2::connection ConnectRetiredPlayersSignal(RetiredPlayersSignal::slot_type slot);
+    random::Engine& GetRandomEngine() noexcept;
 
 private:
     std::unordered_set<std::shared_ptr<Dog>> dogs_;
+    // Копия dogs_.size(), которую можно читать вне strand сессии
+    std::atomic<size_t> dogs_count_{0};
     std::unordered_set<std::shared_ptr<LostObject>> lost_objects_;
     loot_gen::LootGenerator loot_generator_;
     loot_gen::LootGenerator::TimeInterval time_update_;
     const Map* map_;
     std::shared_ptr<Strand> game_session_strand_;
-    std::shared_ptr<time_tiker::Ticker> ticker_;
-    std::shared_ptr<time_tiker::Ticker> loot_ticker_;
+    std::weak_ptr<time_tiker::TimerWheel> timer_wheel_;
+    std::optional<time_tiker::TimerWheel::Id> timer_id_;
     RetiredPlayersSignal retired_players_signal_;
+    // Генератор тиков: вещи, боты. Используется только в strand-е сессии
+    random::Engine random_;
+    // Точки появления собак выбираются при входе игрока, а не в тике, поэтому у них свой
+    // генератор: общий с тиком random_ читался бы из двух потоков
+    static constexpr uint64_t SPAWN_SEED_SALT = 0x5bd1e9955bd1e995ULL;
+    random::Engine spawn_random_;
+    std::shared_ptr<const RoadNavigation> navigation_;
+    RoadGraph::Distances loot_distances_;
+    std::unordered_map<uint32_t, Bot> bots_;
+    std::optional<SpatialGrid<Dog>> dogs_index_;
+    std::optional<SpatialGrid<LostObject>> lost_objects_index_;
 };
 
+namespace detail {
+
+template <typename T, typename Fn>
+void ForEachInRadius(const std::unordered_set<std::shared_ptr<T>>& objects, geom::Point2D center, double radius, Fn&& fn) {
+    const double radius_sq = radius * radius;
+    for (const std::shared_ptr<T>& object : objects) {
+        const double dx = object->GetCoordinate().x - center.x;
+        const double dy = object->GetCoordinate().y - center.y;
+        if (dx * dx + dy * dy <= radius_sq) {
+            fn(object);
+        }
+    }
+}
+
+}  // namespace detail
+
+template <typename Fn>
+void GameSession::ForEachDogInRadius(geom::Point2D center, double radius, Fn&& fn) const {
+    if (dogs_index_) {
+        dogs_index_->ForEachInRadius(center, radius, std::forward<Fn>(fn));
+    } else {
+        detail::ForEachInRadius(dogs_, center, radius, std::forward<Fn>(fn));
+    }
+}
+
+template <typename Fn>
+void GameSession::ForEachLostObjectInRadius(geom::Point2D center, double radius, Fn&& fn) const {
+    if (lost_objects_index_) {
+        lost_objects_index_->ForEachInRadius(center, radius, std::forward<Fn>(fn));
+    } else {
+        detail::ForEachInRadius(lost_objects_, center, radius, std::forward<Fn>(fn));
+    }
+}
+
 } //namespace model
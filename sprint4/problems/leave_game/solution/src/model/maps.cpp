@@ -112,44 +112,57 @@ const int Map::GetBagCapacity() const noexcept {
     return bagCapacity_;
 }
 
-int Map::GetRandomNumber(int min, int max) {
-    std::random_device rd;
-    std::default_random_engine eng(rd());
-    std::uniform_int_distribution<int> distr(min, max);
-    return distr(eng);
+void Map::SetBotsConfig(BotsConfig bots_config) noexcept {
+    bots_config_ = bots_config;
 }
 
-Point Map::GetRandomPointOnRoad(const Road &road) const {
+const BotsConfig& Map::GetBotsConfig() const noexcept {
+    return bots_config_;
+}
+
+void Map::SetNavigation(std::shared_ptr<const RoadNavigation> navigation) noexcept {
+    navigation_ = std::move(navigation);
+}
+
+const std::shared_ptr<const RoadNavigation>& Map::GetNavigation() const noexcept {
+    return navigation_;
+}
+
+int Map::GetRandomNumber(int min, int max, random::Engine& engine) {
+    return static_cast<int>(engine.UniformInt(min, max));
+}
+
+Point Map::GetRandomPointOnRoad(const Road &road, random::Engine& engine) const {
     Point start = road.GetStart();
     Point end = road.GetEnd();
 
     if (road.IsHorizontal()) {
         Dimension random_x;
         if (start.x <=  end.x) {
-            random_x = GetRandomNumber(start.x, end.x);
+            random_x = GetRandomNumber(start.x, end.x, engine);
         } else {
-            random_x = GetRandomNumber(end.x, start.x);
+            random_x = GetRandomNumber(end.x, start.x, engine);
         }
         return {random_x, start.y};
     } else if (road.IsVertical()) {
         Dimension random_y;
         if (start.y <=  end.y) {
-            random_y = GetRandomNumber(start.y, end.y);
+            random_y = GetRandomNumber(start.y, end.y, engine);
         } else {
-            random_y = GetRandomNumber(end.y, start.y);
+            random_y = GetRandomNumber(end.y, start.y, engine);
         }
         return {start.x, random_y};
     }
     return start;
 }
 
-Point Map::GetRandomPointRoadMap() const {
+Point Map::GetRandomPointRoadMap(random::Engine& engine) const {
     if (roads_.empty()) {
         throw std::runtime_error("Road list is empty");
     }
-    size_t random_index = GetRandomNumber(0, roads_.size() - 1);
+    size_t random_index = GetRandomNumber(0, roads_.size() - 1, engine);
     const Road& random_road = roads_[random_index];
-    return GetRandomPointOnRoad(random_road);
+    return GetRandomPointOnRoad(random_road, engine);
 }
 
 const Point &Map::GetStartPointRoadMap() const noexcept{
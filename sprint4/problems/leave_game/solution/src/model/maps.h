@@ -1,9 +1,14 @@
 #pragma once
 
+#include <memory>
+
 #include "model.h"
+#include "random.h"
 
 namespace model {
 
+struct RoadNavigation;
+
 class Map {
 public:
     using Id = util::Tagged<std::string, Map>;
@@ -38,9 +43,16 @@ public:
     void SetBagCapaccity(int bagCapacity);
     const int GetBagCapacity() const noexcept;
 
-    static int GetRandomNumber(int min, int max);
-    Point GetRandomPointOnRoad(const Road& road) const;
-    Point GetRandomPointRoadMap() const;
+    void SetBotsConfig(BotsConfig bots_config) noexcept;
+    const BotsConfig& GetBotsConfig() const noexcept;
+
+    // Граф дорог, построенный при загрузке карты, или nullptr
+    void SetNavigation(std::shared_ptr<const RoadNavigation> navigation) noexcept;
+    const std::shared_ptr<const RoadNavigation>& GetNavigation() const noexcept;
+
+    static int GetRandomNumber(int min, int max, random::Engine& engine);
+    Point GetRandomPointOnRoad(const Road& road, random::Engine& engine) const;
+    Point GetRandomPointRoadMap(random::Engine& engine) const;
 
     const Point& GetStartPointRoadMap() const noexcept;
     std::uint32_t GetScoreByLootType(size_t id);
@@ -58,6 +70,8 @@ private:
     LootTypes loot_types_;
     double dogSpeed_;
     int bagCapacity_;
+    BotsConfig bots_config_;
+    std::shared_ptr<const RoadNavigation> navigation_;
 
     OfficeIdToIndex warehouse_id_to_index_;
     Offices offices_;
@@ -117,6 +117,17 @@ struct LootGeneratorConfig {
     double probability;
 };
 
+enum class BotPolicyType {
+    RANDOM_WALK,
+    LOOT_SEEKER
+};
+
+// Боты, которых сервер запускает на карте при старте
+struct BotsConfig {
+    size_t count = 0;
+    BotPolicyType policy = BotPolicyType::LOOT_SEEKER;
+};
+
 struct LootType {
     std::string name{""};
     std::string file{""};
@@ -0,0 +1,92 @@
+#include "random.h"
+
+#include <bit>
+#include <random>
+
+namespace model::random {
+
+namespace {
+
+constexpr uint64_t SPLITMIX64_GAMMA = 0x9e3779b97f4a7c15ULL;
+
+}  // namespace
+
+uint64_t SplitMix64(uint64_t& state) noexcept {
+    uint64_t z = (state += SPLITMIX64_GAMMA);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+uint64_t MakeRandomSeed() {
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) | rd();
+}
+
+void SeedSequence::Reset(uint64_t seed) noexcept {
+    state_.store(seed, std::memory_order_relaxed);
+}
+
+uint64_t SeedSequence::Next() noexcept {
+    // fetch_add выдаёт каждому вызову своё состояние, SplitMix64 прибавляет шаг к нему ещё раз,
+    // поэтому последовательность та же, что и при последовательных вызовах SplitMix64
+    uint64_t state = state_.fetch_add(SPLITMIX64_GAMMA, std::memory_order_relaxed);
+    return SplitMix64(state);
+}
+
+Xoshiro256::Xoshiro256(uint64_t seed) noexcept {
+    // Состояние из нулей недопустимо, SplitMix64 его не выдаёт ни для какого зерна
+    for (auto& word : state_) {
+        word = SplitMix64(seed);
+    }
+}
+
+Xoshiro256::result_type Xoshiro256::operator()() noexcept {
+    const uint64_t result = std::rotl(state_[1] * 5, 7) * 9;
+    const uint64_t t = state_[1] << 17;
+
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = std::rotl(state_[3], 45);
+
+    return result;
+}
+
+double Xoshiro256::UniformReal() noexcept {
+    // Старшие 53 бита дают равномерную сетку в [0, 1) с шагом 2^-53
+    return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+}
+
+int64_t Xoshiro256::UniformInt(int64_t min, int64_t max) noexcept {
+    if (min >= max) {
+        return min;
+    }
+    const uint64_t range = static_cast<uint64_t>(max - min) + 1;
+    if (range == 0) {
+        return static_cast<int64_t>((*this)());
+    }
+    // Метод Лемира: умножение вместо деления, отбрасывание только для смещённого хвоста
+    unsigned __int128 product = static_cast<unsigned __int128>((*this)()) * range;
+    uint64_t low = static_cast<uint64_t>(product);
+    if (low < range) {
+        const uint64_t threshold = -range % range;
+        while (low < threshold) {
+            product = static_cast<unsigned __int128>((*this)()) * range;
+            low = static_cast<uint64_t>(product);
+        }
+    }
+    return min + static_cast<int64_t>(product >> 64);
+}
+
+const Xoshiro256::State& Xoshiro256::GetState() const noexcept {
+    return state_;
+}
+
+void Xoshiro256::SetState(const State& state) noexcept {
+    state_ = state;
+}
+
+}  // namespace model::random
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace model::random {
+
+/*
+ *  SplitMix64: из одного мастер-зерна получает последовательность независимых зёрен
+ *  для генераторов сессий. state продвигается при каждом вызове.
+ */
+uint64_t SplitMix64(uint64_t& state) noexcept;
+
+// Зерно из std::random_device, когда детерминированность не нужна
+uint64_t MakeRandomSeed();
+
+/*
+ *  Последовательность зёрен SplitMix64 от мастер-зерна, которую можно продвигать из разных
+ *  потоков: каждый вызов Next получает своё зерно. Копирование переносит текущее состояние.
+ */
+class SeedSequence {
+public:
+    explicit SeedSequence(uint64_t seed) noexcept
+        : state_{seed} {
+    }
+
+    SeedSequence(const SeedSequence& other) noexcept
+        : state_{other.state_.load(std::memory_order_relaxed)} {
+    }
+
+    SeedSequence& operator=(const SeedSequence& other) noexcept {
+        state_.store(other.state_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+
+    void Reset(uint64_t seed) noexcept;
+    uint64_t Next() noexcept;
+
+private:
+    std::atomic<uint64_t> state_;
+};
+
+/*
+ *  Генератор xoshiro256** (Blackman, Vigna). Удовлетворяет требованиям
+ *  UniformRandomBitGenerator, поэтому подходит для распределений из <random>.
+ *  Состояние - 32 байта, его можно сохранить и восстановить.
+ */
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+    using State = std::array<uint64_t, 4>;
+
+    explicit Xoshiro256(uint64_t seed = 0) noexcept;
+
+    static constexpr result_type min() noexcept {
+        return 0;
+    }
+    static constexpr result_type max() noexcept {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() noexcept;
+
+    // Равномерно распределённое число в [0, 1), совместимо с LootGenerator::RandomGenerator
+    double UniformReal() noexcept;
+    // Равномерно распределённое целое число в [min, max]
+    int64_t UniformInt(int64_t min, int64_t max) noexcept;
+
+    const State& GetState() const noexcept;
+    void SetState(const State& state) noexcept;
+
+private:
+    State state_;
+};
+
+using Engine = Xoshiro256;
+
+}  // namespace model::random
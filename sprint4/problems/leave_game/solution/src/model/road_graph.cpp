@@ -0,0 +1,175 @@
+#include "road_graph.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace model {
+
+using namespace std::literals;
+
+namespace {
+
+// Сетка для поиска узла по точке занимает 4 байта на клетку охватывающего прямоугольника
+constexpr size_t MAX_GRID_CELLS = size_t{1} << 26;
+
+// Прямоугольник, охватывающий концы всех дорог
+std::pair<Point, Point> GetRoadsBounds(const Map::Roads& roads) noexcept {
+    Point min = roads.front().GetStart();
+    Point max = min;
+    for (const Road& road : roads) {
+        for (Point point : {road.GetStart(), road.GetEnd()}) {
+            min = {std::min(min.x, point.x), std::min(min.y, point.y)};
+            max = {std::max(max.x, point.x), std::max(max.y, point.y)};
+        }
+    }
+    return {min, max};
+}
+
+size_t GetGridCells(Point min, Point max) noexcept {
+    return static_cast<size_t>(max.x - min.x + 1) * static_cast<size_t>(max.y - min.y + 1);
+}
+
+}  // namespace
+
+constants::Direction Reverse(constants::Direction direction) noexcept {
+    switch (direction) {
+        case constants::Direction::NORTH:
+            return constants::Direction::SOUTH;
+        case constants::Direction::SOUTH:
+            return constants::Direction::NORTH;
+        case constants::Direction::WEST:
+            return constants::Direction::EAST;
+        case constants::Direction::EAST:
+            return constants::Direction::WEST;
+        default:
+            return constants::Direction::STOP;
+    }
+}
+
+RoadGraph::RoadGraph(const Map& map) {
+    const Map::Roads& roads = map.GetRoads();
+    if (roads.empty()) {
+        return;
+    }
+
+    const auto [min, max] = GetRoadsBounds(roads);
+    if (GetGridCells(min, max) > MAX_GRID_CELLS) {
+        throw std::invalid_argument("Map "s + *map.GetId() + " is too large for the road graph"s);
+    }
+    min_ = min;
+    width_ = max.x - min.x + 1;
+    height_ = max.y - min.y + 1;
+    grid_.assign(GetGridCells(min, max), NO_NODE);
+
+    for (const Road& road : roads) {
+        const Point start = road.GetStart();
+        const Point end = road.GetEnd();
+        if (road.IsHorizontal()) {
+            NodeId previous = AddNode({std::min(start.x, end.x), start.y});
+            for (Coord x = std::min(start.x, end.x) + 1; x <= std::max(start.x, end.x); ++x) {
+                const NodeId current = AddNode({x, start.y});
+                Link(previous, current, constants::Direction::EAST);
+                previous = current;
+            }
+        } else {
+            NodeId previous = AddNode({start.x, std::min(start.y, end.y)});
+            for (Coord y = std::min(start.y, end.y) + 1; y <= std::max(start.y, end.y); ++y) {
+                const NodeId current = AddNode({start.x, y});
+                Link(previous, current, constants::Direction::SOUTH);
+                previous = current;
+            }
+        }
+    }
+}
+
+RoadGraph::RoadGraph(Data data) noexcept
+    : min_{data.min}
+    , width_{data.width}
+    , height_{data.height}
+    , grid_{std::move(data.grid)}
+    , points_{std::move(data.points)}
+    , neighbors_{std::move(data.neighbors)} {
+}
+
+bool RoadGraph::CanBuild(const Map& map) noexcept {
+    if (map.GetRoads().empty()) {
+        return true;
+    }
+    const auto [min, max] = GetRoadsBounds(map.GetRoads());
+    return GetGridCells(min, max) <= MAX_GRID_CELLS;
+}
+
+RoadGraph::Data RoadGraph::GetData() const {
+    return {min_, width_, height_, grid_, points_, neighbors_};
+}
+
+size_t RoadGraph::GetNodesCount() const noexcept {
+    return points_.size();
+}
+
+std::optional<RoadGraph::NodeId> RoadGraph::FindNode(Point point) const noexcept {
+    if (point.x < min_.x || point.y < min_.y || point.x >= min_.x + width_ || point.y >= min_.y + height_) {
+        return std::nullopt;
+    }
+    const NodeId node = grid_[GridIndex(point)];
+    if (node == NO_NODE) {
+        return std::nullopt;
+    }
+    return node;
+}
+
+Point RoadGraph::GetPoint(NodeId node) const noexcept {
+    return points_[node];
+}
+
+RoadGraph::NodeId RoadGraph::GetNeighbor(NodeId node, constants::Direction direction) const noexcept {
+    if (direction == constants::Direction::STOP) {
+        return NO_NODE;
+    }
+    return neighbors_[node][static_cast<size_t>(direction)];
+}
+
+void RoadGraph::FindDistances(const std::vector<NodeId>& sources, Distances& result) const {
+    result.assign(points_.size(), UNREACHABLE);
+    // Очередь поиска в ширину: каждый узел попадает в неё не больше одного раза
+    std::vector<NodeId> queue;
+    queue.reserve(points_.size());
+    for (NodeId source : sources) {
+        if (result[source] != 0) {
+            result[source] = 0;
+            queue.push_back(source);
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const NodeId node = queue[head];
+        const uint32_t distance = result[node] + 1;
+        for (NodeId neighbor : neighbors_[node]) {
+            if (neighbor != NO_NODE && result[neighbor] == UNREACHABLE) {
+                result[neighbor] = distance;
+                queue.push_back(neighbor);
+            }
+        }
+    }
+}
+
+RoadGraph::NodeId RoadGraph::AddNode(Point point) {
+    NodeId& node = grid_[GridIndex(point)];
+    if (node == NO_NODE) {
+        node = static_cast<NodeId>(points_.size());
+        points_.push_back(point);
+        neighbors_.push_back({NO_NODE, NO_NODE, NO_NODE, NO_NODE});
+    }
+    return node;
+}
+
+void RoadGraph::Link(NodeId from, NodeId to, constants::Direction direction) noexcept {
+    neighbors_[from][static_cast<size_t>(direction)] = to;
+    neighbors_[to][static_cast<size_t>(Reverse(direction))] = from;
+}
+
+size_t RoadGraph::GridIndex(Point point) const noexcept {
+    return static_cast<size_t>(point.y - min_.y) * static_cast<size_t>(width_) + static_cast<size_t>(point.x - min_.x);
+}
+
+}  // namespace model
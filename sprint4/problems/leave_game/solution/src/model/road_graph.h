@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "maps.h"
+
+namespace model {
+
+// Противоположное направление, для STOP - STOP
+constants::Direction Reverse(constants::Direction direction) noexcept;
+
+/*
+ *  Граф дорог карты: узлы - целочисленные точки на дорогах, рёбра соединяют соседние точки
+ *  вдоль дороги. Собака может повернуть только в узле, поэтому граф описывает все её пути.
+ *  Узлы нумеруются подряд, точка переводится в номер узла через плотную сетку
+ *  по прямоугольнику, охватывающему дороги.
+ */
+class RoadGraph {
+public:
+    using NodeId = uint32_t;
+    // Расстояние в шагах по дорогам для каждого узла
+    using Distances = std::vector<uint32_t>;
+
+    static constexpr NodeId NO_NODE = std::numeric_limits<NodeId>::max();
+    static constexpr uint32_t UNREACHABLE = std::numeric_limits<uint32_t>::max();
+    // Направления в порядке значений constants::Direction без STOP
+    static constexpr size_t DIRECTIONS = 4;
+
+    // Внутреннее представление графа, сохраняется в кеш карт целиком
+    struct Data {
+        Point min{0, 0};
+        Coord width = 0;
+        Coord height = 0;
+        std::vector<NodeId> grid;
+        std::vector<Point> points;
+        std::vector<std::array<NodeId, DIRECTIONS>> neighbors;
+    };
+
+    // Бросает std::invalid_argument, если сетка карты слишком велика (см. CanBuild)
+    explicit RoadGraph(const Map& map);
+
+    // Граф из кеша карт, данные не проверяются
+    explicit RoadGraph(Data data) noexcept;
+
+    static bool CanBuild(const Map& map) noexcept;
+    Data GetData() const;
+
+    size_t GetNodesCount() const noexcept;
+    std::optional<NodeId> FindNode(Point point) const noexcept;
+    Point GetPoint(NodeId node) const noexcept;
+    // Соседний узел в направлении direction или NO_NODE, если дороги в эту сторону нет
+    NodeId GetNeighbor(NodeId node, constants::Direction direction) const noexcept;
+
+    // Кратчайшие расстояния от каждого узла до ближайшего из sources (поиск в ширину),
+    // result переиспользуется между вызовами, чтобы не выделять память на каждом тике
+    void FindDistances(const std::vector<NodeId>& sources, Distances& result) const;
+
+private:
+    NodeId AddNode(Point point);
+    void Link(NodeId from, NodeId to, constants::Direction direction) noexcept;
+    size_t GridIndex(Point point) const noexcept;
+
+    Point min_{0, 0};
+    Coord width_ = 0;
+    Coord height_ = 0;
+    std::vector<NodeId> grid_;
+    std::vector<Point> points_;
+    std::vector<std::array<NodeId, DIRECTIONS>> neighbors_;
+};
+
+}  // namespace model
@@ -0,0 +1,131 @@
+#include "session_manager.h"
+
+namespace model {
+
+namespace {
+
+metrics::Gauge& TotalSessionsGauge() {
+    static auto& sessions_gauge = metrics::Registry::Instance().GetGauge(
+                "game_server_sessions", "Number of running game sessions");
+    return sessions_gauge;
+}
+
+}  // namespace
+
+SessionManager::SessionManager(const Map::Id& map_id, size_t max_dogs)
+    : max_dogs_{std::max<size_t>(max_dogs, 1)}
+    , occupancy_{
+        metrics::Registry::Instance().GetGauge("game_server_map_sessions", "Number of game sessions on the map", {{"map", *map_id}}),
+        metrics::Registry::Instance().GetGauge("game_server_map_players", "Number of players on the map", {{"map", *map_id}}),
+        metrics::Registry::Instance().GetGauge("game_server_map_free_slots", "Number of free player slots in the map sessions", {{"map", *map_id}})
+    } {
+}
+
+std::shared_ptr<GameSession> SessionManager::Acquire(const SessionFactory& factory) {
+    std::lock_guard lock{mutex_};
+    if (free_sessions_.empty()) {
+        auto session = factory();
+        Insert(session, 1);
+        UpdateMetrics();
+        return session;
+    }
+
+    SessionSlots& slots = sessions_.at(free_sessions_.front());
+    ++slots.dogs;
+    ++dogs_count_;
+    UpdateFreeQueue(slots);
+    UpdateMetrics();
+    return slots.session;
+}
+
+void SessionManager::Add(std::shared_ptr<GameSession> session, size_t dogs_count) {
+    std::lock_guard lock{mutex_};
+    Insert(std::move(session), dogs_count);
+    UpdateMetrics();
+}
+
+void SessionManager::Release(const GameSession* session, size_t count) {
+    std::shared_ptr<GameSession> stopped;
+    {
+        std::lock_guard lock{mutex_};
+        auto it = sessions_.find(session);
+        if (it == sessions_.end()) {
+            return;
+        }
+        SessionSlots& slots = it->second;
+        count = std::min(count, slots.dogs);
+        slots.dogs -= count;
+        dogs_count_ -= count;
+
+        if (slots.dogs == 0) {
+            if (slots.has_free_slots) {
+                free_sessions_.erase(slots.free_position);
+            }
+            stopped = std::move(slots.session);
+            sessions_.erase(it);
+            TotalSessionsGauge().Add(-1);
+            PublishSessions();
+        } else {
+            UpdateFreeQueue(slots);
+        }
+        UpdateMetrics();
+    }
+    // Сессия может ещё выполнять тик, она будет освобождена после его завершения
+    if (stopped) {
+        stopped->Stop();
+    }
+}
+
+util::SharedSnapshot<SessionManager::Sessions>::Ptr SessionManager::GetSessions() const {
+    return sessions_snapshot_.Load();
+}
+
+void SessionManager::Insert(std::shared_ptr<GameSession> session, size_t dogs_count) {
+    const GameSession* key = session.get();
+    auto [it, inserted] = sessions_.emplace(key, SessionSlots{std::move(session), dogs_count});
+    if (!inserted) {
+        return;
+    }
+    dogs_count_ += dogs_count;
+    TotalSessionsGauge().Add(1);
+    PublishSessions();
+
+    // Собаки уходят на покой в strand сессии, освобождаем их места
+    it->second.session->ConnectRetiredPlayersSignal(
+        [self_weak = weak_from_this(), key](std::vector<domain::RetiredPlayers> retired_players) {
+            if (auto self = self_weak.lock()) {
+                self->Release(key, retired_players.size());
+            }
+        });
+    UpdateFreeQueue(it->second);
+}
+
+void SessionManager::UpdateFreeQueue(SessionSlots& slots) {
+    const bool has_free_slots = slots.dogs < max_dogs_;
+    if (has_free_slots == slots.has_free_slots) {
+        return;
+    }
+    if (has_free_slots) {
+        slots.free_position = free_sessions_.insert(free_sessions_.end(), slots.session.get());
+    } else {
+        free_sessions_.erase(slots.free_position);
+    }
+    slots.has_free_slots = has_free_slots;
+}
+
+void SessionManager::PublishSessions() {
+    Sessions sessions;
+    sessions.reserve(sessions_.size());
+    for (const auto& [ptr, slots] : sessions_) {
+        sessions.push_back(slots.session);
+    }
+    sessions_snapshot_.Store(std::make_shared<const Sessions>(std::move(sessions)));
+}
+
+void SessionManager::UpdateMetrics() {
+    occupancy_.sessions.Set(static_cast<int64_t>(sessions_.size()));
+    occupancy_.players.Set(static_cast<int64_t>(dogs_count_));
+    occupancy_.free_slots.Set(static_cast<int64_t>(sessions_.size() * max_dogs_) - static_cast<int64_t>(dogs_count_));
+}
+
+}  // namespace model
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "maps.h"
+#include "game_session.h"
+#include "../metrics/metrics.h"
+#include "../shared_snapshot.h"
+
+namespace model {
+
+/*
+ *  Сессии одной карты. Сессии со свободными местами хранятся в очереди, поэтому
+ *  подбор сессии для нового игрока выполняется за O(1). Места учитываются менеджером
+ *  под мьютексом: место занимается при подборе сессии и освобождается, когда собаки
+ *  уходят на покой. Опустевшая сессия останавливается и удаляется.
+ *  Список сессий публикуется снимком, поэтому его чтение не захватывает мьютекс.
+ */
+class SessionManager : public std::enable_shared_from_this<SessionManager> {
+public:
+    using SessionFactory = std::function<std::shared_ptr<GameSession>()>;
+    using Sessions = std::vector<std::shared_ptr<GameSession>>;
+
+    explicit SessionManager(const Map::Id& map_id, size_t max_dogs = constants::MAXPLAYERSINMAP);
+
+    SessionManager(const SessionManager&) = delete;
+    SessionManager& operator=(const SessionManager&) = delete;
+
+    // Возвращает сессию со свободным местом и занимает в ней место для одной собаки.
+    // Если свободных мест нет, создаёт новую сессию с помощью factory
+    std::shared_ptr<GameSession> Acquire(const SessionFactory& factory);
+    // Добавляет сессию, в которой уже есть dogs_count собак, например восстановленную из архива
+    void Add(std::shared_ptr<GameSession> session, size_t dogs_count);
+    void Release(const GameSession* session, size_t count);
+
+    util::SharedSnapshot<Sessions>::Ptr GetSessions() const;
+
+private:
+    struct SessionSlots {
+        std::shared_ptr<GameSession> session;
+        size_t dogs = 0;
+        std::list<const GameSession*>::iterator free_position{};
+        bool has_free_slots = false;
+    };
+
+    struct Occupancy {
+        metrics::Gauge& sessions;
+        metrics::Gauge& players;
+        metrics::Gauge& free_slots;
+    };
+
+    void Insert(std::shared_ptr<GameSession> session, size_t dogs_count);
+    void UpdateFreeQueue(SessionSlots& slots);
+    void UpdateMetrics();
+    void PublishSessions();
+
+    size_t max_dogs_;
+    mutable std::mutex mutex_;
+    std::unordered_map<const GameSession*, SessionSlots> sessions_;
+    std::list<const GameSession*> free_sessions_;
+    size_t dogs_count_ = 0;
+    Occupancy occupancy_;
+    util::SharedSnapshot<Sessions> sessions_snapshot_;
+};
+
+}  // namespace model
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "../events/geom.h"
+
+namespace model {
+
+/*
+ *  Равномерная сетка объектов с координатами (T::GetCoordinate()) для выборки объектов
+ *  вокруг точки. Хранятся только непустые клетки, поэтому размер сетки не зависит от размера карты.
+ *  Сетка не следит за объектами сама: после перемещения объекта нужно вызвать Update,
+ *  который перекладывает объект, только если он перешёл в другую клетку.
+ */
+template <typename T>
+class SpatialGrid {
+public:
+    explicit SpatialGrid(double cell_size)
+        : cell_size_{cell_size} {
+    }
+
+    void Insert(const std::shared_ptr<T>& object) {
+        const CellKey key = KeyOf(object->GetCoordinate());
+        cells_[key].push_back(object);
+        cell_of_[object.get()] = key;
+    }
+
+    void Update(const std::shared_ptr<T>& object) {
+        auto it = cell_of_.find(object.get());
+        if (it == cell_of_.end()) {
+            Insert(object);
+            return;
+        }
+        const CellKey key = KeyOf(object->GetCoordinate());
+        if (key == it->second) {
+            return;
+        }
+        RemoveFromCell(it->second, object.get());
+        cells_[key].push_back(object);
+        it->second = key;
+    }
+
+    void Erase(const T* object) {
+        if (auto it = cell_of_.find(object); it != cell_of_.end()) {
+            RemoveFromCell(it->second, object);
+            cell_of_.erase(it);
+        }
+    }
+
+    size_t Size() const noexcept {
+        return cell_of_.size();
+    }
+
+    // Вызывает fn для каждого объекта не дальше radius от center
+    template <typename Fn>
+    void ForEachInRadius(geom::Point2D center, double radius, Fn&& fn) const {
+        const int64_t min_x = CellIndex(center.x - radius);
+        const int64_t max_x = CellIndex(center.x + radius);
+        const int64_t min_y = CellIndex(center.y - radius);
+        const int64_t max_y = CellIndex(center.y + radius);
+        const double radius_sq = radius * radius;
+        auto visit = [&](const Cell& cell) {
+            for (const std::shared_ptr<T>& object : cell) {
+                const geom::Point2D pos = object->GetCoordinate();
+                const double dx = pos.x - center.x;
+                const double dy = pos.y - center.y;
+                if (dx * dx + dy * dy <= radius_sq) {
+                    fn(object);
+                }
+            }
+        };
+
+        // При радиусе больше карты дешевле обойти непустые клетки, чем все клетки квадрата
+        const double cells_in_square = static_cast<double>(max_x - min_x + 1) * static_cast<double>(max_y - min_y + 1);
+        if (cells_in_square > static_cast<double>(cells_.size())) {
+            for (const auto& [key, cell] : cells_) {
+                visit(cell);
+            }
+            return;
+        }
+        for (int64_t y = min_y; y <= max_y; ++y) {
+            for (int64_t x = min_x; x <= max_x; ++x) {
+                if (auto it = cells_.find(MakeKey(x, y)); it != cells_.end()) {
+                    visit(it->second);
+                }
+            }
+        }
+    }
+
+private:
+    using CellKey = uint64_t;
+    using Cell = std::vector<std::shared_ptr<T>>;
+
+    int64_t CellIndex(double coord) const noexcept {
+        return static_cast<int64_t>(std::floor(coord / cell_size_));
+    }
+
+    static CellKey MakeKey(int64_t x, int64_t y) noexcept {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+
+    CellKey KeyOf(geom::Point2D pos) const noexcept {
+        return MakeKey(CellIndex(pos.x), CellIndex(pos.y));
+    }
+
+    void RemoveFromCell(CellKey key, const T* object) {
+        auto cell_it = cells_.find(key);
+        if (cell_it == cells_.end()) {
+            return;
+        }
+        Cell& cell = cell_it->second;
+        auto it = std::find_if(cell.begin(), cell.end(), [object](const std::shared_ptr<T>& item) {
+            return item.get() == object;
+        });
+        if (it != cell.end()) {
+            // Порядок объектов в клетке не важен
+            *it = std::move(cell.back());
+            cell.pop_back();
+        }
+        if (cell.empty()) {
+            cells_.erase(cell_it);
+        }
+    }
+
+    double cell_size_;
+    std::unordered_map<CellKey, Cell> cells_;
+    std::unordered_map<const T*, CellKey> cell_of_;
+};
+
+}  // namespace model
@@ -0,0 +1,328 @@
+#include "sampling_profiler.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+
+// Старые glibc не объявляют поле получателя сигнала для SIGEV_THREAD_ID
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+namespace profiler {
+
+namespace {
+
+// Регистры прерванного сигналом кода: адрес инструкции, указатель стека и указатель кадра
+struct InterruptedRegisters {
+    void* pc = nullptr;
+    uintptr_t sp = 0;
+    uintptr_t fp = 0;
+};
+
+InterruptedRegisters GetInterruptedRegisters(void* context) noexcept {
+    [[maybe_unused]] const auto* ucontext = static_cast<const ucontext_t*>(context);
+#if defined(__x86_64__)
+    return {reinterpret_cast<void*>(ucontext->uc_mcontext.gregs[REG_RIP]),
+            static_cast<uintptr_t>(ucontext->uc_mcontext.gregs[REG_RSP]),
+            static_cast<uintptr_t>(ucontext->uc_mcontext.gregs[REG_RBP])};
+#elif defined(__aarch64__)
+    return {reinterpret_cast<void*>(ucontext->uc_mcontext.pc),
+            static_cast<uintptr_t>(ucontext->uc_mcontext.sp),
+            static_cast<uintptr_t>(ucontext->uc_mcontext.regs[29])};
+#else
+    return {};
+#endif
+}
+
+std::string FrameName(void* address, bool is_leaf) {
+    // Для вызывающих кадров известен адрес возврата, он может принадлежать следующей функции
+    const auto lookup = static_cast<char*>(address) - (is_leaf ? 0 : 1);
+    Dl_info info{};
+    if (dladdr(lookup, &info) != 0) {
+        if (info.dli_sname != nullptr) {
+            int status = 0;
+            std::unique_ptr<char, decltype(&std::free)> demangled{
+                abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status), &std::free};
+            return status == 0 ? demangled.get() : info.dli_sname;
+        }
+        // Функция не экспортирована: имя модуля и смещение, как у perf для неизвестных символов
+        if (info.dli_fname != nullptr) {
+            const char* module = std::strrchr(info.dli_fname, '/');
+            char offset[32];
+            std::snprintf(offset, sizeof(offset), "+0x%zx",
+                          static_cast<size_t>(lookup - static_cast<char*>(info.dli_fbase)));
+            return std::string{module != nullptr ? module + 1 : info.dli_fname} + offset;
+        }
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%p", address);
+    return buffer;
+}
+
+}  // namespace
+
+SamplingProfiler::SampleBuffer::SampleBuffer()
+    : words_{std::make_unique<void*[]>(CAPACITY)} {
+}
+
+void SamplingProfiler::SampleBuffer::Push(void* pc, uintptr_t sp, uintptr_t fp, uintptr_t stack_top) noexcept {
+    const size_t pos = size_.load(std::memory_order_relaxed);
+    if (pos + 1 + MAX_DEPTH > CAPACITY) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // Адреса пишутся прямо в буфер и публикуются сдвигом размера
+    void** frames = &words_[pos + 1];
+    size_t depth = 0;
+    frames[depth++] = pc;
+    // backtrace в обработчике сигнала вызывать нельзя: раскрутка по таблицам .eh_frame берёт
+    // блокировку загрузчика и может зависнуть, если сигнал прервал dlopen или сам раскрутчик.
+    // Цепочка указателей кадров читается без вызовов: в кадре лежат указатель кадра вызывающей
+    // функции и адрес возврата. Читается только память между указателем стека прерванного
+    // кода и верхом стека потока, и кадры должны идти вверх по стеку, поэтому испорченный
+    // или чужой указатель кадра обрывает стек, а не приводит к чтению чужой памяти
+    while (depth < MAX_DEPTH && fp >= sp && fp % alignof(void*) == 0 && fp <= stack_top - 2 * sizeof(void*)) {
+        void* const* record = reinterpret_cast<void* const*>(fp);
+        if (record[1] == nullptr) {
+            break;
+        }
+        frames[depth++] = record[1];
+        const auto next = reinterpret_cast<uintptr_t>(record[0]);
+        if (next <= fp) {
+            break;
+        }
+        fp = next;
+    }
+    words_[pos] = reinterpret_cast<void*>(static_cast<uintptr_t>(depth));
+    size_.store(pos + 1 + depth, std::memory_order_release);
+}
+
+void SamplingProfiler::SampleBuffer::Clear() noexcept {
+    size_.store(0, std::memory_order_relaxed);
+    dropped_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t SamplingProfiler::SampleBuffer::Dropped() const noexcept {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+thread_local SamplingProfiler::ThreadSlot* SamplingProfiler::current_slot_ = nullptr;
+
+SamplingProfiler& SamplingProfiler::Instance() {
+    static SamplingProfiler instance;
+    return instance;
+}
+
+void SamplingProfiler::OnSignal(int /*signal*/, siginfo_t* /*info*/, void* context) {
+    const int saved_errno = errno;
+    ThreadSlot* slot = current_slot_;
+    if (slot != nullptr && Instance().active_.load(std::memory_order_relaxed)) {
+        const InterruptedRegisters registers = GetInterruptedRegisters(context);
+        slot->buffer.Push(registers.pc, registers.sp, registers.fp, slot->stack_top);
+    }
+    errno = saved_errno;
+}
+
+void SamplingProfiler::RegisterCurrentThread() {
+    auto slot = std::make_unique<ThreadSlot>();
+    slot->tid = gettid();
+    if (const int error = pthread_getcpuclockid(pthread_self(), &slot->clock); error != 0) {
+        throw std::system_error(error, std::generic_category(), "pthread_getcpuclockid");
+    }
+    // Граница стека ограничивает чтение кадров в обработчике сигнала
+    pthread_attr_t attr;
+    if (const int error = pthread_getattr_np(pthread_self(), &attr); error != 0) {
+        throw std::system_error(error, std::generic_category(), "pthread_getattr_np");
+    }
+    void* stack_addr = nullptr;
+    size_t stack_size = 0;
+    const int error = pthread_attr_getstack(&attr, &stack_addr, &stack_size);
+    pthread_attr_destroy(&attr);
+    if (error != 0) {
+        throw std::system_error(error, std::generic_category(), "pthread_attr_getstack");
+    }
+    slot->stack_top = reinterpret_cast<uintptr_t>(stack_addr) + stack_size;
+
+    std::lock_guard lock{mutex_};
+    if (active_) {
+        StartTimer(*slot);
+    }
+    current_slot_ = slot.get();
+    threads_.push_back(std::move(slot));
+}
+
+void SamplingProfiler::UnregisterCurrentThread() {
+    std::lock_guard lock{mutex_};
+    ThreadSlot* slot = current_slot_;
+    if (slot == nullptr) {
+        return;
+    }
+    // Сигналы этого потока приходят только в этот поток, после сброса указателя буфер свободен
+    current_slot_ = nullptr;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    StopTimer(*slot);
+    if (active_) {
+        slot->retired = true;
+        return;
+    }
+    std::erase_if(threads_, [slot](const auto& thread) {
+        return thread.get() == slot;
+    });
+}
+
+bool SamplingProfiler::Start(unsigned frequency) {
+    if (frequency == 0 || frequency > MAX_FREQUENCY) {
+        throw std::invalid_argument("Sampling frequency must be from 1 to " + std::to_string(MAX_FREQUENCY) + " Hz");
+    }
+
+    std::lock_guard lock{mutex_};
+    if (active_) {
+        return false;
+    }
+    InstallHandler();
+    interval_ = std::chrono::nanoseconds{std::chrono::seconds{1}} / frequency;
+    for (auto& thread : threads_) {
+        thread->buffer.Clear();
+    }
+    active_ = true;
+    try {
+        for (auto& thread : threads_) {
+            StartTimer(*thread);
+        }
+    } catch (...) {
+        for (auto& thread : threads_) {
+            StopTimer(*thread);
+        }
+        active_ = false;
+        throw;
+    }
+    return true;
+}
+
+SamplingProfiler::Profile SamplingProfiler::Stop() {
+    std::map<std::vector<void*>, uint64_t> stacks;
+    Profile profile;
+    {
+        std::lock_guard lock{mutex_};
+        if (!active_) {
+            return profile;
+        }
+        for (auto& thread : threads_) {
+            StopTimer(*thread);
+        }
+        active_ = false;
+
+        for (auto& thread : threads_) {
+            thread->buffer.ForEach([&stacks](void* const* frames, size_t depth) {
+                if (depth > 0) {
+                    ++stacks[std::vector<void*>(frames, frames + depth)];
+                }
+            });
+            profile.dropped += thread->buffer.Dropped();
+        }
+        std::erase_if(threads_, [](const auto& thread) {
+            return thread->retired;
+        });
+    }
+
+    // Имена функций ищутся вне блокировки: это дольше, чем сам сбор
+    std::unordered_map<void*, std::string> callers;
+    std::unordered_map<void*, std::string> leaves;
+    auto name_of = [&callers, &leaves](void* address, bool is_leaf) -> const std::string& {
+        auto& names = is_leaf ? leaves : callers;
+        auto it = names.find(address);
+        if (it == names.end()) {
+            std::string name = FrameName(address, is_leaf);
+            // ';' разделяет кадры в свёрнутом формате
+            std::replace(name.begin(), name.end(), ';', ':');
+            it = names.emplace(address, std::move(name)).first;
+        }
+        return it->second;
+    };
+
+    // Разные адреса внутри одной функции дают одинаковые строки, их счётчики складываются
+    std::map<std::string, uint64_t> folded;
+    for (const auto& [frames, count] : stacks) {
+        std::string line;
+        for (size_t i = frames.size(); i-- > 0;) {
+            line += name_of(frames[i], i == 0);
+            if (i != 0) {
+                line += ';';
+            }
+        }
+        folded[line] += count;
+        profile.samples += count;
+    }
+    for (const auto& [line, count] : folded) {
+        profile.folded += line;
+        profile.folded += ' ';
+        profile.folded += std::to_string(count);
+        profile.folded += '\n';
+    }
+    return profile;
+}
+
+bool SamplingProfiler::IsActive() const noexcept {
+    return active_.load(std::memory_order_relaxed);
+}
+
+void SamplingProfiler::InstallHandler() {
+    if (handler_installed_) {
+        return;
+    }
+    // Обработчик не снимается: сигнал, пришедший после остановки таймера, иначе завершил бы процесс
+    struct sigaction action{};
+    action.sa_sigaction = &SamplingProfiler::OnSignal;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+        throw std::system_error(errno, std::generic_category(), "sigaction(SIGPROF)");
+    }
+    handler_installed_ = true;
+}
+
+void SamplingProfiler::StartTimer(ThreadSlot& slot) {
+    if (slot.retired) {
+        return;
+    }
+    // Таймер идёт по процессорному времени потока и посылает сигнал именно этому потоку
+    sigevent event{};
+    event.sigev_notify = SIGEV_THREAD_ID;
+    event.sigev_signo = SIGPROF;
+    event.sigev_notify_thread_id = slot.tid;
+    if (timer_create(slot.clock, &event, &slot.timer) != 0) {
+        throw std::system_error(errno, std::generic_category(), "timer_create");
+    }
+    slot.has_timer = true;
+
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(interval_);
+    itimerspec spec{};
+    spec.it_interval.tv_sec = seconds.count();
+    spec.it_interval.tv_nsec = (interval_ - seconds).count();
+    spec.it_value = spec.it_interval;
+    if (timer_settime(slot.timer, 0, &spec, nullptr) != 0) {
+        throw std::system_error(errno, std::generic_category(), "timer_settime");
+    }
+}
+
+void SamplingProfiler::StopTimer(ThreadSlot& slot) noexcept {
+    if (slot.has_timer) {
+        timer_delete(slot.timer);
+        slot.has_timer = false;
+    }
+}
+
+}  // namespace profiler
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <signal.h>
+#include <time.h>
+
+namespace profiler {
+
+/*
+ *  Выборочный профилировщик процессорного времени. Зарегистрированные потоки получают SIGPROF
+ *  от таймеров на своих часах процессорного времени, обработчик сигнала снимает стек вызовов
+ *  в буфер своего потока без блокировок. Стек снимается по цепочке указателей кадров, поэтому
+ *  код нужно собирать с -fno-omit-frame-pointer: функция без указателя кадра пропадает из стека. Простаивающий поток сигналов не получает, поэтому
+ *  профиль показывает, на что уходит процессор, как perf record с cpu-clock.
+ */
+class SamplingProfiler {
+public:
+    static constexpr unsigned DEFAULT_FREQUENCY = 99;
+    static constexpr unsigned MAX_FREQUENCY = 1000;
+    static constexpr size_t MAX_DEPTH = 64;
+
+    struct Profile {
+        // Свёрнутые стеки для flamegraph.pl: "main;f;g 12", корневой кадр первым
+        std::string folded;
+        uint64_t samples = 0;
+        // Снимки, не поместившиеся в буферы потоков
+        uint64_t dropped = 0;
+    };
+
+    static SamplingProfiler& Instance();
+
+    SamplingProfiler(const SamplingProfiler&) = delete;
+    SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+    void RegisterCurrentThread();
+    void UnregisterCurrentThread();
+
+    // Возвращает false, если уже идёт другой сеанс
+    bool Start(unsigned frequency = DEFAULT_FREQUENCY);
+    Profile Stop();
+    bool IsActive() const noexcept;
+
+private:
+    // Один писатель - обработчик сигнала в своём потоке. Читается после остановки таймеров
+    class SampleBuffer {
+    public:
+        static constexpr size_t CAPACITY = size_t{1} << 18;
+
+        SampleBuffer();
+
+        // Снимает стек из обработчика сигнала. pc, sp и fp - регистры прерванного кода,
+        // stack_top - верхняя граница стека потока
+        void Push(void* pc, uintptr_t sp, uintptr_t fp, uintptr_t stack_top) noexcept;
+        void Clear() noexcept;
+        uint64_t Dropped() const noexcept;
+
+        // Перебирает снимки: fn(void* const* frames, size_t depth), кадр 0 - вершина стека
+        template <typename Fn>
+        void ForEach(Fn&& fn) const {
+            const size_t size = size_.load(std::memory_order_acquire);
+            for (size_t pos = 0; pos < size;) {
+                const auto depth = reinterpret_cast<uintptr_t>(words_[pos]);
+                fn(&words_[pos + 1], static_cast<size_t>(depth));
+                pos += depth + 1;
+            }
+        }
+
+    private:
+        // Снимок - глубина стека и адреса кадров подряд
+        std::unique_ptr<void*[]> words_;
+        std::atomic<size_t> size_{0};
+        std::atomic<uint64_t> dropped_{0};
+    };
+
+    struct ThreadSlot {
+        pid_t tid = 0;
+        clockid_t clock{};
+        uintptr_t stack_top = 0;
+        timer_t timer{};
+        bool has_timer = false;
+        // Поток завершился во время сеанса, его снимки ещё не собраны
+        bool retired = false;
+        SampleBuffer buffer;
+    };
+
+    SamplingProfiler() = default;
+
+    static void OnSignal(int signal, siginfo_t* info, void* context);
+
+    void InstallHandler();
+    void StartTimer(ThreadSlot& slot);
+    void StopTimer(ThreadSlot& slot) noexcept;
+
+    // Буфер текущего потока, единственное, что читает обработчик сигнала
+    static thread_local ThreadSlot* current_slot_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadSlot>> threads_;
+    std::chrono::nanoseconds interval_{};
+    bool handler_installed_ = false;
+    std::atomic<bool> active_{false};
+};
+
+// Регистрирует текущий поток в профилировщике на время своей жизни
+class ThreadRegistration {
+public:
+    ThreadRegistration() {
+        SamplingProfiler::Instance().RegisterCurrentThread();
+    }
+
+    ThreadRegistration(const ThreadRegistration&) = delete;
+    ThreadRegistration& operator=(const ThreadRegistration&) = delete;
+
+    ~ThreadRegistration() {
+        SamplingProfiler::Instance().UnregisterCurrentThread();
+    }
+};
+
+}  // namespace profiler
@@ -13,10 +13,25 @@ std::optional<Args> ParseCommandLine(int argc, const char * const argv[]) {
             ("help,h", "produce help message")
             ("tick-period,t", po::value(&args.tick_period)->value_name("milliseconds"s), "set tick period")
             ("config-file,c", po::value(&args.config_file)->value_name("file"s), "set config file path")
+            ("map-cache", po::value(&args.map_cache)->value_name("file"s), "load maps from this binary cache when it matches the config, otherwise rebuild it")
             ("www-root,w", po::value(&args.www_root)->value_name("dir"s), "set static files root")
             ("randomize-spawn-points", po::bool_switch(&args.randomize_spawn_points), "spawn dogs at random positions")
+            ("align-ticks", po::bool_switch(&args.align_ticks), "tick all game sessions in the same phase")
             ("state-file", po::value(&args.state_file)->value_name("file"s), "set file to save the game state")
-            ("save-state-period", po::value(&args.save_state_period)->value_name("milliseconds"s), "sets the period for automatic saving of the server status");
+            ("save-state-period", po::value(&args.save_state_period)->value_name("milliseconds"s), "sets the period for automatic saving of the server status")
+            ("max-connections", po::value(&args.max_connections)->value_name("count"s), "limit of open connections, 0 for no limit")
+            ("max-connections-per-ip", po::value(&args.max_connections_per_ip)->value_name("count"s), "limit of open connections from one address, 0 for no limit")
+            ("idle-timeout", po::value(&args.idle_timeout)->value_name("milliseconds"s), "close a keep-alive connection idle for this time")
+            ("header-timeout", po::value(&args.header_timeout)->value_name("milliseconds"s), "time limit to read request headers and, separately, its body")
+            ("action-rate", po::value(&args.action_rate)->value_name("rps"s), "player actions per second allowed for one token, 0 for no limit")
+            ("action-burst", po::value(&args.action_burst)->value_name("count"s), "player actions allowed in a burst above action-rate")
+            ("compression-level", po::value(&args.compression_level)->value_name("0-9"s), "gzip/deflate level of API responses, 0 disables compression and precompression of static files")
+            ("compression-threshold", po::value(&args.compression_threshold)->value_name("bytes"s), "compress API responses of at least this size")
+            ("view-radius", po::value(&args.view_radius)->value_name("cells"s), "game state includes only dogs and loot within this distance of the player, 0 for the whole state")
+            ("bots", po::value<size_t>()->value_name("count"s), "run this number of server-side bots on every map instead of the config value")
+            ("bot-policy", po::value(&args.bot_policy)->value_name("name"s), "policy of server-side bots: randomWalk or lootSeeker")
+            ("random-seed", po::value<uint64_t>()->value_name("seed"s), "master seed of the game session generators, for reproducible runs")
+            ("enable-profiler", po::bool_switch(&args.enable_profiler), "serve CPU profiles of the server threads as folded stacks at /debug/pprof/profile");
 
     // variables_map хранит значения опций после разбора
     po::variables_map vm;
@@ -36,6 +51,22 @@ std::optional<Args> ParseCommandLine(int argc, const char * const argv[]) {
         throw std::runtime_error("static files root is not specified"s);
     }
 
+    if (vm.contains("random-seed"s)) {
+        args.random_seed = vm["random-seed"s].as<uint64_t>();
+    }
+
+    if (vm.contains("bots"s)) {
+        args.bots = vm["bots"s].as<size_t>();
+    }
+
+    if (args.view_radius < 0) {
+        throw std::runtime_error("view radius must not be negative"s);
+    }
+
+    if (args.compression_level < 0 || args.compression_level > 9) {
+        throw std::runtime_error("compression level must be from 0 to 9"s);
+    }
+
     return args;
 
 }
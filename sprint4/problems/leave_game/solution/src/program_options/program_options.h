@@ -12,11 +12,31 @@ using namespace std::literals;
 struct Args {
     uint32_t tick_period{0};
     std::string config_file;
+    // Двоичный кеш разобранного конфига, пустая строка - без кеша
+    std::string map_cache{};
     std::string www_root;
     bool randomize_spawn_points{false};
+    bool align_ticks{false};
     boost::filesystem::path base_path;
     std::string state_file{};
     uint32_t save_state_period{0};
+    size_t max_connections{4096};
+    size_t max_connections_per_ip{0};
+    uint32_t idle_timeout{30'000};
+    uint32_t header_timeout{10'000};
+    double action_rate{0};
+    double action_burst{10};
+    int compression_level{1};
+    size_t compression_threshold{1024};
+    double view_radius{0};
+    // Число ботов на каждой карте и их стратегия вместо заданных в конфиге
+    std::optional<size_t> bots;
+    std::string bot_policy{};
+    // Мастер-зерно генераторов сессий: с одним зерном и одной последовательностью запросов
+    // запуск воспроизводится. Без него зерно берётся из std::random_device
+    std::optional<uint64_t> random_seed;
+    // Отдавать профиль процессорного времени по /debug/pprof/profile
+    bool enable_profiler{false};
 };
 
 [[nodiscard]] std::optional<Args>  ParseCommandLine(int argc, const char* const argv[]);
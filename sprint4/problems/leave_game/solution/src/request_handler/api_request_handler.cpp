@@ -17,97 +17,128 @@ std::map<std::string, std::string> ApiRequestHandler::ParseQuery(const std::stri
     return query_map;
 }
 
-json::object ApiRequestHandler::CreateMapJson(const model::Map& map) {
-
-    json::object mapJson;
-    mapJson[constants::ID] = json::string(*map.GetId());
-    mapJson[constants::NAME] = json::string(map.GetName());
-
-    json::array roadsJsonArray;
-    for (const auto& road : map.GetRoads()) {
-        roadsJsonArray.push_back(std::move(SerializeRoad(road)));
-    }
-    mapJson[constants::ROADS] = std::move(roadsJsonArray);
-
-    json::array buildingsJsonArray;
-    for (const auto& building : map.GetBuildings()) {
-        buildingsJsonArray.push_back(std::move(SerializeBuilding(building)));
-    }
-    mapJson[constants::BUILDINGS] = std::move(buildingsJsonArray);
-
-    json::array officesJsonArray;
-    for (const auto& office : map.GetOffices()) {
-        officesJsonArray.push_back(std::move(SerializeOffice(office)));
-    }
-    mapJson[constants::OFFICES] = std::move(officesJsonArray);
-
-    json::array loot_typeJsonArray;
-    for (const auto& loot_type : map.GetLootTypes()) {
-        loot_typeJsonArray.push_back(std::move(SerializeLootType(loot_type)));
-    }
-    mapJson[constants::LOOT_TYPES] = std::move(loot_typeJsonArray);
-
-    return mapJson;
+wire::JsonProducer ApiRequestHandler::MapJson(const model::Map& map) {
+    // Карты хранятся в model::Game всё время работы сервера, поэтому их можно читать при отправке
+    const model::Map* map_ptr = &map;
+    return wire::JsonSequence{}
+        .Then([map_ptr](wire::JsonWriter& writer) {
+            writer.StartObject();
+            writer.Key(constants::ID);
+            writer.String(*map_ptr->GetId());
+            writer.Key(constants::NAME);
+            writer.String(map_ptr->GetName());
+            writer.Key(constants::ROADS);
+            writer.StartArray();
+        })
+        .ForEach(map.GetRoads().size(), [map_ptr](size_t index, wire::JsonWriter& writer) {
+            WriteRoad(writer, map_ptr->GetRoads()[index]);
+        })
+        .Then([](wire::JsonWriter& writer) {
+            writer.EndArray();
+            writer.Key(constants::BUILDINGS);
+            writer.StartArray();
+        })
+        .ForEach(map.GetBuildings().size(), [map_ptr](size_t index, wire::JsonWriter& writer) {
+            WriteBuilding(writer, map_ptr->GetBuildings()[index]);
+        })
+        .Then([](wire::JsonWriter& writer) {
+            writer.EndArray();
+            writer.Key(constants::OFFICES);
+            writer.StartArray();
+        })
+        .ForEach(map.GetOffices().size(), [map_ptr](size_t index, wire::JsonWriter& writer) {
+            WriteOffice(writer, map_ptr->GetOffices()[index]);
+        })
+        .Then([](wire::JsonWriter& writer) {
+            writer.EndArray();
+            writer.Key(constants::LOOT_TYPES);
+            writer.StartArray();
+        })
+        .ForEach(map.GetLootTypes().size(), [map_ptr](size_t index, wire::JsonWriter& writer) {
+            WriteLootType(writer, map_ptr->GetLootTypes()[index]);
+        })
+        .Then([](wire::JsonWriter& writer) {
+            writer.EndArray();
+            writer.EndObject();
+        })
+        .Build();
 }
 
-json::object ApiRequestHandler::SerializeRoad(const model::Road &road) {
-
-    json::object roadJson;
-    roadJson[constants::X0] = road.GetStart().x;
-    roadJson[constants::Y0] = road.GetStart().y;
+void ApiRequestHandler::WriteRoad(wire::JsonWriter& writer, const model::Road &road) {
+    writer.StartObject();
+    writer.Key(constants::X0);
+    writer.Int(road.GetStart().x);
+    writer.Key(constants::Y0);
+    writer.Int(road.GetStart().y);
     if (road.IsHorizontal()) {
-        roadJson[constants::X1] = road.GetEnd().x;
+        writer.Key(constants::X1);
+        writer.Int(road.GetEnd().x);
     } else {
-        roadJson[constants::Y1] = road.GetEnd().y;
+        writer.Key(constants::Y1);
+        writer.Int(road.GetEnd().y);
     }
-    return roadJson;
+    writer.EndObject();
 }
 
-json::object ApiRequestHandler::SerializeBuilding(const model::Building &building) {
-
-    json::object buildingJson;
-    buildingJson[constants::X] = building.GetBounds().position.x;
-    buildingJson[constants::Y] = building.GetBounds().position.y;
-    buildingJson[constants::W] = building.GetBounds().size.width;
-    buildingJson[constants::H] = building.GetBounds().size.height;
-    return buildingJson;
+void ApiRequestHandler::WriteBuilding(wire::JsonWriter& writer, const model::Building &building) {
+    writer.StartObject();
+    writer.Key(constants::X);
+    writer.Int(building.GetBounds().position.x);
+    writer.Key(constants::Y);
+    writer.Int(building.GetBounds().position.y);
+    writer.Key(constants::W);
+    writer.Int(building.GetBounds().size.width);
+    writer.Key(constants::H);
+    writer.Int(building.GetBounds().size.height);
+    writer.EndObject();
 }
 
-json::object ApiRequestHandler::SerializeOffice(const model::Office &office) {
-
-    json::object officeJson;
-    officeJson[constants::ID] = json::string(*office.GetId());
-    officeJson[constants::X] = office.GetPosition().x;
-    officeJson[constants::Y] = office.GetPosition().y;
-    officeJson[constants::OFFSET_X] = office.GetOffset().dx;
-    officeJson[constants::OFFSET_Y] = office.GetOffset().dy;
-    return officeJson;
+void ApiRequestHandler::WriteOffice(wire::JsonWriter& writer, const model::Office &office) {
+    writer.StartObject();
+    writer.Key(constants::ID);
+    writer.String(*office.GetId());
+    writer.Key(constants::X);
+    writer.Int(office.GetPosition().x);
+    writer.Key(constants::Y);
+    writer.Int(office.GetPosition().y);
+    writer.Key(constants::OFFSET_X);
+    writer.Int(office.GetOffset().dx);
+    writer.Key(constants::OFFSET_Y);
+    writer.Int(office.GetOffset().dy);
+    writer.EndObject();
 }
 
-json::object ApiRequestHandler::SerializeLootType(const model::LootType &loot_type) {
-    json::object lootJson;
+void ApiRequestHandler::WriteLootType(wire::JsonWriter& writer, const model::LootType &loot_type) {
+    writer.StartObject();
     if (!loot_type.name.empty()) {
-        lootJson[constants::NAME] = loot_type.name;
+        writer.Key(constants::NAME);
+        writer.String(loot_type.name);
     }
     if (!loot_type.file.empty()) {
-        lootJson[constants::FILE] = loot_type.file;
+        writer.Key(constants::FILE);
+        writer.String(loot_type.file);
     }
     if (!loot_type.type.empty()) {
-        lootJson[constants::TYPE] = loot_type.type;
+        writer.Key(constants::TYPE);
+        writer.String(loot_type.type);
     }
     if (loot_type.rotation != std::numeric_limits<int>::min()) {
-        lootJson[constants::ROTATION] = loot_type.rotation;
+        writer.Key(constants::ROTATION);
+        writer.Int(loot_type.rotation);
     }
     if (!loot_type.color.empty()) {
-        lootJson[constants::COLOR] = loot_type.color;
+        writer.Key(constants::COLOR);
+        writer.String(loot_type.color);
     }
     if (!std::isnan(loot_type.scale)) {
-        lootJson[constants::SCALE] = loot_type.scale;
+        writer.Key(constants::SCALE);
+        writer.Double(loot_type.scale);
     }
     if (loot_type.value != std::numeric_limits<int>::min()) {
-        lootJson[constants::VALUE] = loot_type.value;
+        writer.Key(constants::VALUE);
+        writer.Int(loot_type.value);
     }
-    return lootJson;
+    writer.EndObject();
 }
 
 } //namespace http_handler
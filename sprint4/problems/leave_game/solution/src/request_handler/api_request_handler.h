@@ -2,37 +2,78 @@
 
 #include "request_handler.h"
 #include "../database/retired_players.h"
+#include "../metrics/metrics.h"
+#include "../http_server/rate_limiter.h"
+#include "../wire/game_state_codec.h"
+#include "../wire/state_collector.h"
 
 namespace http_handler {
 
 class ApiRequestHandler : public BaseRequestHandler, public std::enable_shared_from_this<ApiRequestHandler> {
 public:
-    using BaseRequestHandler::BaseRequestHandler;
+    // Частота действий одного игрока ограничивается token bucket, нулевая частота снимает ограничение
+    struct ActionRateLimit {
+        double rate = 0;
+        double burst = 1;
+    };
+
+    ApiRequestHandler(app::Application& application, fs::path static_path, ActionRateLimit action_limit = {})
+        : BaseRequestHandler(application, std::move(static_path))
+        , action_limiter_{action_limit.rate, action_limit.burst} {
+    }
 
     template <typename Body, typename Allocator, typename Send>
     void operator()(http::request<Body, http::basic_fields<Allocator>>&& req, Send&& send) {
 
         if (req.target() == "/api/v1/maps") {
+            metrics::ScopedTimer timer{maps_latency_};
             HandleGetMapsRequest(req, std::forward<Send>(send));
         } else if (req.target().starts_with("/api/v1/maps/")) {
+            metrics::ScopedTimer timer{map_latency_};
             HandleGetMapByIdRequest(req, std::forward<Send>(send));
         } else if (req.target() == "/api/v1/game/players" ) {
+            metrics::ScopedTimer timer{players_latency_};
             HandleGetPlayersRequest(req, std::forward<Send>(send));
         } else if (req.target() == "/api/v1/game/join") {
+            metrics::ScopedTimer timer{join_latency_};
             HandleJoinGameRequest(req, std::forward<Send>(send));
         } else if (req.target() == "/api/v1/game/state") {
+            // Время ответа учитывается при отправке кадра, которая происходит уже после возврата
             HandleGetState(req, std::forward<Send>(send));
         } else if (req.target() == "/api/v1/game/player/action") {
+            metrics::ScopedTimer timer{action_latency_};
             HandleSetPlayerAction(req, std::forward<Send>(send));
         } else if (req.target() == "/api/v1/game/tick") {
+            metrics::ScopedTimer timer{tick_latency_};
             HandleSetPlayersTick(req, std::forward<Send>(send));
         } else if (req.target().starts_with("/api/v1/game/records")) {
+            metrics::ScopedTimer timer{records_latency_};
             HandleGetTableRecords(req, std::forward<Send>(send));
         } else {
+            metrics::ScopedTimer timer{unknown_latency_};
             SendErrorResponse("badRequest", "Bad request", http::status::bad_request, std::forward<Send>(send));
         }
     }
 private:
+    static metrics::Histogram& RouteLatency(const std::string& route) {
+        return metrics::Registry::Instance().GetHistogram(
+                    "game_server_http_request_duration_seconds", "API request handling time", {{"route", route}});
+    }
+
+    metrics::Histogram& maps_latency_ = RouteLatency("/api/v1/maps");
+    metrics::Histogram& map_latency_ = RouteLatency("/api/v1/maps/{id}");
+    metrics::Histogram& players_latency_ = RouteLatency("/api/v1/game/players");
+    metrics::Histogram& join_latency_ = RouteLatency("/api/v1/game/join");
+    metrics::Histogram& state_latency_ = RouteLatency("/api/v1/game/state");
+    metrics::Histogram& action_latency_ = RouteLatency("/api/v1/game/player/action");
+    metrics::Histogram& tick_latency_ = RouteLatency("/api/v1/game/tick");
+    metrics::Histogram& records_latency_ = RouteLatency("/api/v1/game/records");
+    metrics::Histogram& unknown_latency_ = RouteLatency("unknown");
+    metrics::Counter& rate_limited_actions_ = metrics::Registry::Instance().GetCounter(
+                "game_server_rate_limited_total", "API requests rejected by the rate limiter",
+                {{"route", "/api/v1/game/player/action"}});
+
+    http_server::TokenBucketRateLimiter action_limiter_;
 
     template <typename Send>
     void HandleGetMapsRequest(const http::request<http::string_body>& req, Send&& send) {
@@ -67,8 +108,7 @@ private:
         const model::Map* map = application_.GetGame().FindMap(mapId);
 
         if (map != nullptr) {
-            json::object mapJson = CreateMapJson(*map);
-            SendJsonResponse(mapJson, std::forward<Send>(send));
+            SendJsonStream(MapJson(*map), std::forward<Send>(send));
         } else {
             SendErrorResponse("mapNotFound", "Map not found", http::status::not_found, std::forward<Send>(send));
         }
@@ -106,13 +146,14 @@ private:
                 return;
             }
 
-            if (application_.FindByDogNameAndMapId(userName, mapId) != nullptr) {
+            auto joined = application_.JoinGame(userName, map);
+            if (!joined) {
                 SendErrorResponse("invalidArgument", "User with the same dog name on same map exists", http::status::bad_request, std::forward<Send>(send));
                 return;
             }
 
             json::object responseBody;
-            auto [authToken, playerId] = application_.JoinGame(userName, map);
+            auto [authToken, playerId] = *joined;
 
             responseBody = {
                 {"authToken", *authToken},
@@ -137,14 +178,23 @@ private:
 
         ExecuteAuthorized(req, std::forward<Send>(send), [this, &send](const app::Token& token) {
 
+            // Игрок мог уйти из игры после проверки токена, тогда его сессия уже освобождена
             auto player = application_.GetPlayerTokens().FindPlayerByToken(token);
-            std::weak_ptr<model::GameSession> player_session = player->GetSession();
+            auto player_session = player ? player->GetSession().lock() : nullptr;
+            if (!player_session) {
+                SendErrorResponse("unknownToken", "Player token has not been found", http::status::unauthorized, std::forward<Send>(send));
+                return;
+            }
             boost::json::object response_json;
 
-            for (const std::weak_ptr<model::Dog>& dog : player_session.lock()->GetDogs()) {      //std::shared_ptr<model::Dog>&
+            for (const std::weak_ptr<model::Dog>& dog : player_session->GetDogs()) {      //std::shared_ptr<model::Dog>&
+                auto locked_dog = dog.lock();
+                if (!locked_dog) {
+                    continue;
+                }
                 boost::json::object dog_json;
-                dog_json["name"] = dog.lock()->GetName();
-                response_json[std::to_string(dog.lock()->GetId())] = dog_json;
+                dog_json["name"] = locked_dog->GetName();
+                response_json[std::to_string(locked_dog->GetId())] = dog_json;
             }
 
             SendJsonResponse(response_json, std::forward<Send>(send));
@@ -167,6 +217,12 @@ private:
 
         ExecuteAuthorized(req, std::forward<Send>(send), [this, &req, &send](const app::Token& token) {
 
+            if (!action_limiter_.TryAcquire(*token)) {
+                rate_limited_actions_.Add();
+                SendErrorResponse("tooManyRequests", "Too many actions", http::status::too_many_requests, std::forward<Send>(send));
+                return;
+            }
+
             try {
                 json::value parsedJson = json::parse(req.body());
                 json::object obj = parsedJson.as_object();
@@ -178,33 +234,43 @@ private:
 
                 std::string move = obj["move"].as_string().c_str();
                 auto player = application_.GetPlayerTokens().FindPlayerByToken(token);
+                auto session = player ? player->GetSession().lock() : nullptr;
+                if (!session) {
+                    SendErrorResponse("unknownToken", "Player token has not been found", http::status::unauthorized, std::forward<Send>(send));
+                    return;
+                }
 
                 std::weak_ptr<model::Dog> dog = player->GetDog();
-                const model::Map* map = player->GetSession().lock()->GetMap();
-                double speed = map->GetDogSpeed();
-
-                net::dispatch(*player->GetSession().lock()->GetSessionStrand(), [self = shared_from_this(),
-                              &move, &dog, &speed, req = std::move(req), send = std::forward<Send>(send)]() mutable {
-
-                    if (move == "L") {
-                        dog.lock()->SetDirection(constants::Direction::WEST);
-                        dog.lock()->SetSpeed({-speed, 0});
-                    } else if (move == "R") {
-                        dog.lock()->SetDirection(constants::Direction::EAST);
-                        dog.lock()->SetSpeed({speed, 0});
-                    } else if (move == "U") {
-                        dog.lock()->SetDirection(constants::Direction::NORTH);
-                        dog.lock()->SetSpeed({0, -speed});
-                    } else if (move == "D") {
-                        dog.lock()->SetDirection(constants::Direction::SOUTH);
-                        dog.lock()->SetSpeed({0, speed});
-                    } else if (move == "") {
-                        dog.lock()->SetSpeed({0, 0});
-                    } else {
-                        self->SendErrorResponse("invalidArgument", "Invalid move value", http::status::bad_request, std::forward<Send>(send));
-                        return;
-                    }
+                double speed = session->GetMap()->GetDogSpeed();
+
+                // Пустая команда останавливает собаку, не меняя её направления
+                std::optional<constants::Direction> direction;
+                std::pair<double, double> velocity{0, 0};
+                if (move == "L") {
+                    direction = constants::Direction::WEST;
+                    velocity = {-speed, 0};
+                } else if (move == "R") {
+                    direction = constants::Direction::EAST;
+                    velocity = {speed, 0};
+                } else if (move == "U") {
+                    direction = constants::Direction::NORTH;
+                    velocity = {0, -speed};
+                } else if (move == "D") {
+                    direction = constants::Direction::SOUTH;
+                    velocity = {0, speed};
+                } else if (move != "") {
+                    SendErrorResponse("invalidArgument", "Invalid move value", http::status::bad_request, std::forward<Send>(send));
+                    return;
+                }
 
+                // Лямбда может выполниться после ответа, поэтому захватывает только значения
+                net::dispatch(*session->GetSessionStrand(), [dog, direction, velocity] {
+                    if (auto locked_dog = dog.lock()) {
+                        if (direction) {
+                            locked_dog->SetDirection(*direction);
+                        }
+                        locked_dog->SetSpeed(velocity);
+                    }
                 });
 
                 SendJsonResponse("{}", std::forward<Send>(send));
@@ -226,63 +292,37 @@ private:
 
         ExecuteAuthorized(req, std::forward<Send>(send), [this, &req, &send](const app::Token& token) {
 
-            json::object response_json;
-
-            boost::json::object players_json;
-            boost::json::object lost_objects_json;
-
-            std::vector<std::shared_ptr<model::GameSession>> sessions = application_.GetGame().GetAllSession();
-            for (std::shared_ptr<model::GameSession>& session : sessions) {
-                net::dispatch(*session->GetSessionStrand(), [self = shared_from_this(), req = std::move(req), &players_json, &lost_objects_json, &session, send = std::forward<Send>(send)]()  {
-
-                    for (const std::shared_ptr<model::Dog>& dog : session->GetDogs()) {
-                        boost::json::object dog_json;
-                        dog_json["pos"] = {dog->GetCoordinate().x, dog->GetCoordinate().y};
-                        dog_json["speed"] = {dog->GetSpeed().first, dog->GetSpeed().second};
-
-                        switch (dog->GetDirection()) {
-                            case constants::Direction::NORTH:
-                                dog_json["dir"] = "U";
-                                break;
-                            case constants::Direction::WEST:
-                                dog_json["dir"] = "L";
-                                break;
-                            case constants::Direction::EAST:
-                                dog_json["dir"] = "R";
-                                break;
-                            case constants::Direction::SOUTH:
-                                dog_json["dir"] = "D";
-                                break;
-                            default:
-                                dog_json["dir"] = "Unknown";
-                                break;
-                        }
-
-                        boost::json::array bag_json;
-                        for (const auto& item : dog->GetBag()) {
-                            boost::json::object item_json;
-                            item_json["id"] = item->GetId();
-                            item_json["type"] = item->GetType();
-                            bag_json.push_back(item_json);
-                        }
-                        dog_json["bag"] = bag_json;
-                        dog_json["score"] = dog->GetScore();
-
-                        players_json[std::to_string(dog->GetId())] = dog_json;
-                    }
-                    for (const std::shared_ptr<model::LostObject>& lost_object: session->GetLostObjects()) {
-                        boost::json::object lost_object_json;
-                        lost_object_json["type"] = lost_object->GetType();
-                        lost_object_json["pos"] = {lost_object->GetCoordinate().x, lost_object->GetCoordinate().y};
+            // Кадр заполняется в strand-ах сессий, ответ отправляется, когда отработают все
+            const auto accept = req[http::field::accept];
+            const bool binary = wire::AcceptsContentType({accept.data(), accept.size()}, wire::GAME_STATE_CONTENT_TYPE);
+            auto respond = [self = shared_from_this(), binary, start = metrics::ScopedTimer::Clock::now(),
+                            send = std::forward<Send>(send)](std::shared_ptr<const wire::StateFrame> frame) mutable {
+                if (binary) {
+                    self->SendBinaryResponse(wire::EncodeBinary(*frame), wire::GAME_STATE_CONTENT_TYPE, std::move(send));
+                } else {
+                    self->SendJsonStream(wire::StateJson(std::move(frame)), std::move(send));
+                }
+                self->state_latency_.Record(metrics::ScopedTimer::Clock::now() - start);
+            };
 
-                        lost_objects_json[std::to_string(lost_object->GetId())] = lost_object_json;
-                    }
-                });
+            const double view_radius = application_.GetGame().GetViewRadius();
+            if (view_radius > 0) {
+                // Игрок видит только окрестность своей собаки в своей сессии
+                auto player = application_.GetPlayerTokens().FindPlayerByToken(token);
+                auto session = player ? player->GetSession().lock() : nullptr;
+                auto dog = player ? player->GetDog().lock() : nullptr;
+                std::vector<std::shared_ptr<model::GameSession>> sessions;
+                if (session && dog) {
+                    sessions.push_back(std::move(session));
+                }
+                wire::CollectStateFrame(std::move(sessions), [dog, view_radius](wire::StateFrame& frame, model::GameSession& session) {
+                    wire::AppendSessionView(frame, session, *dog, view_radius);
+                }, std::move(respond));
+            } else {
+                wire::CollectStateFrame(application_.GetGame().GetAllSession(), [](wire::StateFrame& frame, model::GameSession& session) {
+                    wire::AppendSession(frame, session);
+                }, std::move(respond));
             }
-
-            response_json["players"] = players_json;
-            response_json["lostObjects"] = lost_objects_json;
-            SendJsonResponse(response_json, std::forward<Send>(send));
         });
     }
 
@@ -315,13 +355,14 @@ private:
 
             std::vector<std::shared_ptr<model::GameSession>> sessions = application_.GetGame().GetAllSession();
             for (std::shared_ptr<model::GameSession>& session : sessions) {
-                net::dispatch(*session->GetSessionStrand(), [self = shared_from_this(), &delta, &session, req = std::move(req), send = std::forward<Send>(send)]() mutable {
+                net::dispatch(*session->GetSessionStrand(), [session, delta] {
                     session->UpdateSessionByTime(delta);
                 });
             }
             application_.SaveGameByTime(delta);
         } catch (const std::exception& e) {
             SendErrorResponse("invalidArgument", "Failed to parse action", http::status::bad_request, std::forward<Send>(send));
+            return;
         }
         json::object response_json = {};
         SendJsonResponse(response_json, std::forward<Send>(send));
@@ -371,17 +412,28 @@ private:
             }
         }
 
-        auto retired_players = application_.GetTableRecords(start, maxItems);
-
-        boost::json::array response_json;
-        for (const auto& player : retired_players) {
-            boost::json::object player_json;
-            player_json["name"] = player.GetName();
-            player_json["score"] = player.GetScore();
-            player_json["playTime"] = player.GetPlayTime() / 1000.0;
-            response_json.push_back(player_json);
-        }
-        SendJsonResponse(response_json, std::forward<Send>(send));
+        auto retired_players = std::make_shared<const std::vector<domain::RetiredPlayers>>(
+                    application_.GetTableRecords(start, maxItems));
+
+        SendJsonStream(wire::JsonSequence{}
+            .Then([](wire::JsonWriter& writer) {
+                writer.StartArray();
+            })
+            .ForEach(retired_players->size(), [retired_players](size_t index, wire::JsonWriter& writer) {
+                const auto& player = (*retired_players)[index];
+                writer.StartObject();
+                writer.Key("name"sv);
+                writer.String(player.GetName());
+                writer.Key("score"sv);
+                writer.Uint(player.GetScore());
+                writer.Key("playTime"sv);
+                writer.Double(player.GetPlayTime() / 1000.0);
+                writer.EndObject();
+            })
+            .Then([](wire::JsonWriter& writer) {
+                writer.EndArray();
+            })
+            .Build(), std::forward<Send>(send));
     }
 
 
@@ -419,11 +471,12 @@ private:
         action(token);
     }
 
-    json::object CreateMapJson(const model::Map& map);
-    json::object SerializeRoad(const model::Road& road);
-    json::object SerializeBuilding(const model::Building& building);
-    json::object SerializeOffice(const model::Office& office);
-    json::object SerializeLootType(const model::LootType &loot_type);
+    // Карта выдаётся по одной дороге, зданию, офису или типу трофея за вызов
+    static wire::JsonProducer MapJson(const model::Map& map);
+    static void WriteRoad(wire::JsonWriter& writer, const model::Road& road);
+    static void WriteBuilding(wire::JsonWriter& writer, const model::Building& building);
+    static void WriteOffice(wire::JsonWriter& writer, const model::Office& office);
+    static void WriteLootType(wire::JsonWriter& writer, const model::LootType& loot_type);
 };
 
 } //namespace http_handler
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <type_traits>
+
+#include "request_handler.h"
+#include "../wire/compression.h"
+
+namespace http_handler {
+
+/*
+ *  Сжимает динамические ответы декорируемого обработчика, если клиент принимает gzip или deflate.
+ *  Ответ целиком в памяти сжимается при размере от порога, потоковый ответ - по мере отправки окон.
+ */
+template<class SomeRequestHandler>
+class CompressionRequestHandler {
+public:
+    CompressionRequestHandler(SomeRequestHandler& handler, wire::CompressionSettings settings)
+        : decorated_(handler)
+        , settings_(settings) {
+    }
+
+    template <typename Body, typename Allocator, typename Send>
+    void operator()(http::request<Body, http::basic_fields<Allocator>>&& req, Send&& send) {
+        if (settings_.level == 0) {
+            decorated_(std::move(req), std::forward<Send>(send));
+            return;
+        }
+
+        const auto accept_encoding = req[http::field::accept_encoding];
+        const wire::ContentEncoding encoding = wire::ChooseEncoding({accept_encoding.data(), accept_encoding.size()},
+                                                                    {wire::ContentEncoding::GZIP, wire::ContentEncoding::DEFLATE});
+
+        // Ответ может быть отправлен после возврата из operator(), например из strand-а сессии
+        decorated_(std::move(req), [settings = settings_, encoding, send = std::forward<Send>(send)](auto&& response) mutable {
+            Compress(response, encoding, settings);
+            send(std::move(response));
+        });
+    }
+
+private:
+    template <typename Body, typename Fields>
+    static void Compress(http::response<Body, Fields>& response, wire::ContentEncoding encoding,
+                         const wire::CompressionSettings& settings) {
+        const auto content_type = response[http::field::content_type];
+        if (!wire::IsCompressible({content_type.data(), content_type.size()})
+                || response.find(http::field::content_encoding) != response.end()) {
+            return;
+        }
+        AddVary(response);
+        if (encoding == wire::ContentEncoding::IDENTITY) {
+            return;
+        }
+
+        if constexpr (std::is_same_v<Body, http::string_body>) {
+            if (response.body().size() < settings.threshold) {
+                return;
+            }
+            response.body() = wire::Compress(response.body(), encoding, settings.level);
+            response.content_length(response.body().size());
+            SetContentEncoding(response, encoding);
+        } else if constexpr (std::is_same_v<Body, wire::JsonStreamBody>) {
+            // Потоковое тело заведомо больше окна, а значит и порога
+            response.body().SetCompressor(wire::Compressor{encoding, settings.level});
+            SetContentEncoding(response, encoding);
+        }
+    }
+
+    template <typename Body, typename Fields>
+    static void SetContentEncoding(http::response<Body, Fields>& response, wire::ContentEncoding encoding) {
+        const std::string_view name = wire::EncodingName(encoding);
+        response.set(http::field::content_encoding, beast::string_view{name.data(), name.size()});
+    }
+
+    // Кеши должны хранить сжатый и несжатый ответы отдельно
+    template <typename Body, typename Fields>
+    static void AddVary(http::response<Body, Fields>& response) {
+        const auto vary = response[http::field::vary];
+        if (vary.empty()) {
+            response.set(http::field::vary, "Accept-Encoding");
+        } else {
+            response.set(http::field::vary, vary.to_string() + ", Accept-Encoding");
+        }
+    }
+
+    SomeRequestHandler& decorated_;
+    wire::CompressionSettings settings_;
+};
+
+} //namespace http_handler
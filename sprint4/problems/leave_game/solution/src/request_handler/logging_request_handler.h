@@ -17,7 +17,8 @@ public:
         auto start = std::chrono::high_resolution_clock::now();
         LogRequest(req, client_ip);
 
-        decorated_(std::move(req), [&](auto&& response) {
+        // Ответ может быть отправлен после возврата из operator(), поэтому всё захватывается по значению
+        decorated_(std::move(req), [start, client_ip, send = std::forward<Send>(send)](auto&& response) mutable {
             auto end = std::chrono::high_resolution_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
             LogResponse(response, duration, client_ip);
@@ -38,7 +39,7 @@ private:
     }
 
     template <typename Body>
-    void LogResponse(const http::response<Body>& resp, int64_t response_time, const std::string& client_ip) {
+    static void LogResponse(const http::response<Body>& resp, int64_t response_time, const std::string& client_ip) {
 
         json::value custom_data = json::object{
                 {"ip"s, client_ip},
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "request_handler.h"
+#include "../metrics/metrics.h"
+
+namespace http_handler {
+
+// Отдаёт метрики в текстовом формате Prometheus. Не оборачивается в LoggingRequestHandler,
+// чтобы частый опрос сборщиком метрик не засорял журнал
+class MetricsRequestHandler {
+public:
+    template <typename Body, typename Allocator, typename Send>
+    void operator()(http::request<Body, http::basic_fields<Allocator>>&& req, Send&& send) {
+        StringResponse response;
+        response.version(req.version());
+        response.set(http::field::cache_control, "no-cache");
+
+        if (req.method() != http::verb::get && req.method() != http::verb::head) {
+            response.result(http::status::method_not_allowed);
+            response.set(http::field::allow, "GET, HEAD");
+            response.prepare_payload();
+            send(std::move(response));
+            return;
+        }
+
+        response.result(http::status::ok);
+        response.set(http::field::content_type, "text/plain; version=0.0.4");
+        response.body() = metrics::Registry::Instance().Render();
+        response.prepare_payload();
+        send(std::move(response));
+    }
+};
+
+} //namespace http_handler
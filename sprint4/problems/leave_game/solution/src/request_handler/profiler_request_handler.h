@@ -0,0 +1,104 @@
+#pragma once
+
+#include "request_handler.h"
+#include "../profiler/sampling_profiler.h"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <charconv>
+
+namespace http_handler {
+
+namespace net = boost::asio;
+
+/*
+ *  GET /debug/pprof/profile?seconds=N&hz=F снимает профиль процессорного времени потоков
+ *  io_context в течение N секунд и отдаёт свёрнутые стеки для flamegraph.pl:
+ *      curl 'localhost:8080/debug/pprof/profile?seconds=10' | flamegraph.pl > graph.svg
+ *  Ответ отправляется по таймеру, поток io_context на время сеанса не занимается.
+ *  Подключается только с ключом --enable-profiler.
+ */
+class ProfilerRequestHandler {
+public:
+    static constexpr std::string_view PATH = "/debug/pprof/profile"sv;
+    static constexpr unsigned DEFAULT_SECONDS = 30;
+    static constexpr unsigned MAX_SECONDS = 300;
+
+    explicit ProfilerRequestHandler(net::io_context& ioc)
+        : ioc_{ioc} {
+    }
+
+    template <typename Body, typename Allocator, typename Send>
+    void operator()(http::request<Body, http::basic_fields<Allocator>>&& req, Send&& send) {
+        if (req.method() != http::verb::get) {
+            auto response = MakeResponse(req.version(), http::status::method_not_allowed, "Only GET method is expected\n"s);
+            response.set(http::field::allow, "GET");
+            send(std::move(response));
+            return;
+        }
+
+        unsigned seconds = DEFAULT_SECONDS;
+        unsigned frequency = profiler::SamplingProfiler::DEFAULT_FREQUENCY;
+        const std::string_view target{req.target().data(), req.target().size()};
+        const auto query_start = target.find('?');
+        const std::string_view query = query_start == std::string_view::npos ? ""sv : target.substr(query_start + 1);
+        if (!ParseParameter(query, "seconds"sv, seconds) || seconds == 0 || seconds > MAX_SECONDS
+                || !ParseParameter(query, "hz"sv, frequency)
+                || frequency == 0 || frequency > profiler::SamplingProfiler::MAX_FREQUENCY) {
+            send(MakeResponse(req.version(), http::status::bad_request,
+                              "seconds must be from 1 to " + std::to_string(MAX_SECONDS) + ", hz from 1 to "
+                              + std::to_string(profiler::SamplingProfiler::MAX_FREQUENCY) + "\n"));
+            return;
+        }
+
+        bool started = false;
+        try {
+            started = profiler::SamplingProfiler::Instance().Start(frequency);
+        } catch (const std::exception& ex) {
+            send(MakeResponse(req.version(), http::status::internal_server_error, ex.what() + "\n"s));
+            return;
+        }
+        if (!started) {
+            send(MakeResponse(req.version(), http::status::conflict, "Another profile is being collected\n"s));
+            return;
+        }
+
+        auto timer = std::make_shared<net::steady_timer>(ioc_, std::chrono::seconds{seconds});
+        timer->async_wait([timer, version = req.version(), send = std::forward<Send>(send)](sys::error_code) mutable {
+            auto profile = profiler::SamplingProfiler::Instance().Stop();
+            auto response = MakeResponse(version, http::status::ok, std::move(profile.folded));
+            response.set("X-Profile-Samples", std::to_string(profile.samples));
+            response.set("X-Profile-Dropped", std::to_string(profile.dropped));
+            send(std::move(response));
+        });
+    }
+
+private:
+    net::io_context& ioc_;
+
+    static StringResponse MakeResponse(unsigned version, http::status status, std::string body) {
+        StringResponse response{status, version};
+        response.set(http::field::content_type, "text/plain");
+        response.set(http::field::cache_control, "no-cache");
+        response.body() = std::move(body);
+        response.prepare_payload();
+        return response;
+    }
+
+    // Отсутствующий параметр оставляет значение по умолчанию
+    static bool ParseParameter(std::string_view query, std::string_view name, unsigned& value) {
+        while (!query.empty()) {
+            const auto end = query.find('&');
+            const std::string_view param = query.substr(0, end);
+            query = end == std::string_view::npos ? ""sv : query.substr(end + 1);
+            if (param.size() > name.size() && param.starts_with(name) && param[name.size()] == '=') {
+                const std::string_view text = param.substr(name.size() + 1);
+                const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+                return ec == std::errc{} && ptr == text.data() + text.size();
+            }
+        }
+        return true;
+    }
+};
+
+} //namespace http_handler
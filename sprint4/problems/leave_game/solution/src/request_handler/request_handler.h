@@ -11,6 +11,7 @@
 #include "../app/players.h"
 #include "../app/player_tokens.h"
 #include "../app/application.h"
+#include "../wire/json_stream_body.h"
 
 #include <boost/json.hpp>
 #include <boost/beast.hpp>
@@ -82,6 +83,49 @@ protected:
         send(std::move(response));
     }
 
+    // Ответ, который помещается в одно окно, отправляется целиком с Content-Length,
+    // остальные формируются во время отправки и передаются chunked
+    template <typename Send>
+    void SendJsonStream(wire::JsonProducer producer, Send&& send) {
+        wire::JsonWriter writer;
+        bool more = true;
+        while (more && writer.Size() < wire::JsonStreamBody::WINDOW_SIZE) {
+            more = producer(writer);
+        }
+
+        if (!more) {
+            StringResponse response;
+            response.result(http::status::ok);
+            response.set(http::field::content_type, "application/json");
+            response.body() = writer.TakeBuffer();
+            response.content_length(response.body().size());
+            response.set(http::field::cache_control, "no-cache");
+            send(std::move(response));
+            return;
+        }
+
+        http::response<wire::JsonStreamBody> response;
+        response.result(http::status::ok);
+        response.set(http::field::content_type, "application/json");
+        response.set(http::field::cache_control, "no-cache");
+        response.body() = wire::JsonStreamBody::value_type{std::move(writer), std::move(producer)};
+        response.chunked(true);
+        send(std::move(response));
+    }
+
+    template <typename Send>
+    void SendBinaryResponse(std::string body, std::string_view content_type, Send&& send) {
+        StringResponse response;
+        response.result(http::status::ok);
+        response.set(http::field::content_type, std::string{content_type});
+        response.body() = std::move(body);
+        response.content_length(response.body().size());
+        response.set(http::field::cache_control, "no-cache");
+        // Ответ на тот же адрес зависит от заголовка Accept
+        response.set(http::field::vary, "Accept");
+        send(std::move(response));
+    }
+
     template <typename Send>
     void SendTextResponse(const std::string& text, http::status status, Send&& send) {
         http::response<http::string_body> response;
@@ -92,12 +136,14 @@ protected:
         send(std::move(response));
     }
 
+    // Если рядом с файлом есть сжатая копия, которую принимает клиент, отдаётся она
     template <typename Send>
-    void SendFileResponse(fs::path& file_path, Send&& send) {
+    void SendFileResponse(fs::path& file_path, std::string_view accept_encoding, Send&& send) {
         std::string mime_types = files_path::MimeDecode(file_path);
+        const files_path::Precompressed variant = files_path::ChoosePrecompressed(file_path, accept_encoding);
         http::file_body::value_type file;
 
-        if (sys::error_code ec; file.open(file_path.string().c_str(), beast::file_mode::read, ec), ec) {
+        if (sys::error_code ec; file.open(variant.path.string().c_str(), beast::file_mode::read, ec), ec) {
             SendTextResponse("Failed to open file: " + ec.message(), http::status::internal_server_error, std::forward<Send>(send));
             return;
         }
@@ -105,6 +151,13 @@ protected:
         http::response<http::file_body> response;
         response.result(http::status::ok);
         response.set(http::field::content_type, mime_types);
+        if (variant.encoding != wire::ContentEncoding::IDENTITY) {
+            const std::string_view encoding = wire::EncodingName(variant.encoding);
+            response.set(http::field::content_encoding, beast::string_view{encoding.data(), encoding.size()});
+        }
+        if (variant.has_variants) {
+            response.set(http::field::vary, "Accept-Encoding");
+        }
         response.content_length(file.size());
         response.body() = std::move(file);
         response.prepare_payload();
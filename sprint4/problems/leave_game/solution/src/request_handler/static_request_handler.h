@@ -37,7 +37,8 @@ private:
         }
 
         if (fs::exists(file_path) && fs::is_regular_file(file_path)) {
-            SendFileResponse(file_path, std::forward<Send>(send));
+            const auto accept_encoding = req[http::field::accept_encoding];
+            SendFileResponse(file_path, {accept_encoding.data(), accept_encoding.size()}, std::forward<Send>(send));
         } else {
             SendTextResponse("Invalid request: File does not exist\n", http::status::not_found, std::forward<Send>(send));
         }
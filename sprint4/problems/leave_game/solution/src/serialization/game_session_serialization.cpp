@@ -14,5 +14,8 @@ const std::vector<DogRepr> &GameSessionResp::GetDogsResp() const {
     return dogs_repr_;
 }
 
+const std::optional<model::random::Engine::State> &GameSessionResp::GetRandomState() const {
+    return random_state_;
+}
 
 } //serialization
@@ -5,6 +5,9 @@
 #include "lost_object_serialization.h"
 #include "dog_serialization.h"
 
+#include <boost/serialization/array.hpp>
+#include <boost/serialization/version.hpp>
+
 namespace serialization {
 
 class GameSessionResp {
@@ -12,7 +15,8 @@ public:
     GameSessionResp() = default;
     GameSessionResp(
         model::GameSession& game_session) :
-            map_id_(*(game_session.GetMap()->GetId())) {
+            map_id_(*(game_session.GetMap()->GetId()))
+          , random_state_(game_session.GetRandomEngine().GetState()) {
 
         const auto& lost_objects = game_session.GetLostObjects();
         for (const auto& lost_object : lost_objects) {
@@ -21,24 +25,41 @@ public:
 
         const auto& dogs = game_session.GetDogs();
         for (const auto& dog : dogs) {
-            dogs_repr_.emplace_back(*dog);
+            // Боты не сохраняются, при запуске сервер создаёт их заново
+            if (!game_session.IsBot(dog->GetId())) {
+                dogs_repr_.emplace_back(*dog);
+            }
         }
     };
 
     [[nodiscard]] model::Map::Id RestoreMapId() const;
     [[nodiscard]] const std::vector<LostObjectRepr>& GetLostObjectsResp() const;
     [[nodiscard]] const std::vector<DogRepr>& GetDogsResp() const;
+    // Пусто для архивов версии 0, сохранённых до появления генератора сессии
+    [[nodiscard]] const std::optional<model::random::Engine::State>& GetRandomState() const;
 
     template <typename Archive>
-    void serialize(Archive& ar, [[maybe_unused]] const unsigned version) {
+    void serialize(Archive& ar, const unsigned version) {
         ar& map_id_;
         ar& lost_objects_repr_;
         ar& dogs_repr_;
+        if (version >= 1) {
+            if constexpr (Archive::is_saving::value) {
+                ar& *random_state_;
+            } else {
+                model::random::Engine::State state;
+                ar& state;
+                random_state_ = state;
+            }
+        }
     }
 private:
     std::string map_id_;
     std::vector<LostObjectRepr> lost_objects_repr_;
     std::vector<DogRepr> dogs_repr_;
+    std::optional<model::random::Engine::State> random_state_;
 };
 
 } //serialization
+
+BOOST_CLASS_VERSION(::serialization::GameSessionResp, 1)
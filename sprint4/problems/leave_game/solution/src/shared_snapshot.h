@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace util {
+
+/*
+ *  Неизменяемый снимок данных, заменяемый целиком (read-copy-update).
+ *  Писатель готовит новую копию и публикует её через Store, читатели получают
+ *  текущий снимок через Load и могут пользоваться им, пока держат указатель.
+ *
+ *  Читатель не ждёт, пока писатель копирует и изменяет данные: атомарно заменяется
+ *  только указатель. Запись должна выполняться из одного потока или под мьютексом.
+ *
+ *  Load берёт блокировку. В libstdc++ atomic_load/atomic_store для shared_ptr захватывают
+ *  мьютекс из пула из 16 штук, выбранный по адресу снимка, на время копирования указателя
+ *  и изменения счётчика ссылок. Блокировка короткая и не зависит от размера данных, но
+ *  чтение не wait-free: читатели снимков с одним мьютексом выстраиваются в очередь.
+ *  std::atomic<std::shared_ptr> из GCC 12 тоже блокирует (бит в самом указателе), а его
+ *  load снимает блокировку с memory_order_relaxed, и ThreadSanitizer находит гонку
+ *  между load и store, поэтому он здесь не используется.
+ */
+template <typename T>
+class SharedSnapshot {
+public:
+    using Ptr = std::shared_ptr<const T>;
+
+    explicit SharedSnapshot(T value = {})
+        : current_{std::make_shared<const T>(std::move(value))} {
+    }
+
+    SharedSnapshot(const SharedSnapshot&) = delete;
+    SharedSnapshot& operator=(const SharedSnapshot&) = delete;
+
+    Ptr Load() const {
+        return std::atomic_load_explicit(&current_, std::memory_order_acquire);
+    }
+
+    void Store(Ptr snapshot) {
+        std::atomic_store_explicit(&current_, std::move(snapshot), std::memory_order_release);
+    }
+
+    // Копирует текущий снимок, изменяет копию функцией fn и публикует её.
+    // Копирование идёт вне блокировки, но стоит O(размера снимка), поэтому большие
+    // данные стоит дробить на снимки поменьше (см. PlayerTokens)
+    template <typename Fn>
+    void Update(Fn&& fn) {
+        auto copy = std::make_shared<T>(*Load());
+        fn(*copy);
+        Store(std::move(copy));
+    }
+
+private:
+    Ptr current_;
+};
+
+}  // namespace util
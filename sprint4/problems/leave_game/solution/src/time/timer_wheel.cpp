@@ -0,0 +1,255 @@
+#include "timer_wheel.h"
+
+#include "../metrics/metrics.h"
+
+namespace time_tiker {
+
+namespace {
+
+struct TimerWheelMetrics {
+    metrics::Histogram& tick_duration;
+    metrics::Histogram& tick_lag;
+    metrics::Counter& ticks;
+    metrics::Counter& wakeups;
+    metrics::Counter& skipped;
+    metrics::Gauge& subscriptions;
+};
+
+TimerWheelMetrics& GetTimerWheelMetrics() {
+    auto& registry = metrics::Registry::Instance();
+    static TimerWheelMetrics wheel_metrics{
+        registry.GetHistogram("game_server_tick_duration_seconds", "Time spent in ticker handlers"),
+        registry.GetHistogram("game_server_tick_lag_seconds", "Delay of ticks relative to the scheduled period"),
+        registry.GetCounter("game_server_ticks_total", "Number of ticks handled"),
+        registry.GetCounter("game_server_timer_wheel_wakeups_total", "Number of timer wheel wakeups"),
+        registry.GetCounter("game_server_timer_wheel_skipped_total", "Ticks skipped because the previous one was still running"),
+        registry.GetGauge("game_server_timer_wheel_subscriptions", "Number of timer wheel subscriptions")
+    };
+    return wheel_metrics;
+}
+
+constexpr uint64_t SLOT_MASK = TimerWheel::SLOTS - 1;
+
+}  // namespace
+
+void TimerWheel::Start() {
+    net::dispatch(strand_, [self = shared_from_this()] {
+        if (self->running_) {
+            return;
+        }
+        self->running_ = true;
+        self->epoch_ = Clock::now();
+        self->current_tick_ = 0;
+        self->manual_tick_ = 0;
+        self->ScheduleWakeup();
+    });
+}
+
+void TimerWheel::Stop() {
+    net::dispatch(strand_, [self = shared_from_this()] {
+        self->running_ = false;
+        self->timer_.cancel();
+    });
+}
+
+TimerWheel::Id TimerWheel::Add(Strand strand, std::chrono::milliseconds period, Handler handler) {
+    const Id id = next_id_.fetch_add(1, std::memory_order_relaxed);
+    const uint64_t period_ticks = std::max<uint64_t>(1, (period + resolution_ / 2) / resolution_);
+    Entry entry{std::move(strand), period_ticks, 0, Clock::time_point{},
+                std::make_shared<Handler>(std::move(handler)), std::make_shared<std::atomic<bool>>(false)};
+    net::dispatch(strand_, [self = shared_from_this(), id, entry = std::move(entry)]() mutable {
+        self->Insert(id, std::move(entry));
+    });
+    return id;
+}
+
+void TimerWheel::Remove(Id id) {
+    // Идентификатор остаётся в слоте и будет пропущен при сработке
+    net::dispatch(strand_, [self = shared_from_this(), id] {
+        self->entries_.erase(id);
+        GetTimerWheelMetrics().subscriptions.Set(static_cast<int64_t>(self->entries_.size()));
+    });
+}
+
+void TimerWheel::Advance(uint64_t ticks) {
+    assert(manual_);
+    net::dispatch(strand_, [self = shared_from_this(), ticks] {
+        self->manual_tick_ += ticks;
+        while (self->running_ && self->scheduled_tick_ <= self->manual_tick_) {
+            self->OnWakeup({});
+        }
+    });
+}
+
+std::chrono::milliseconds TimerWheel::GetResolution() const noexcept {
+    return resolution_;
+}
+
+std::chrono::milliseconds TimerWheel::SplitPeriod(std::chrono::milliseconds period, uint32_t max_parts) noexcept {
+    for (uint32_t parts = max_parts; parts > 1; --parts) {
+        if (period.count() % parts == 0) {
+            return period / parts;
+        }
+    }
+    return period;
+}
+
+void TimerWheel::Insert(Id id, Entry entry) {
+    assert(strand_.running_in_this_thread());
+    const auto now = Now();
+    // Пока колесо спит до ближайшего занятого слота, current_tick_ отстаёт от реального времени
+    const uint64_t now_tick = running_ ? std::max(current_tick_, static_cast<uint64_t>((now - epoch_) / resolution_))
+                                       : current_tick_;
+    if (align_phases_) {
+        entry.due_tick = (now_tick + entry.period_ticks) / entry.period_ticks * entry.period_ticks;
+    } else {
+        entry.due_tick = now_tick + entry.period_ticks;
+    }
+    entry.last_fire = now;
+    const uint64_t due_tick = entry.due_tick;
+    entries_.insert_or_assign(id, std::move(entry));
+    Place(id, due_tick);
+    GetTimerWheelMetrics().subscriptions.Set(static_cast<int64_t>(entries_.size()));
+
+    if (running_ && due_tick < scheduled_tick_) {
+        ScheduleWakeup();
+    }
+}
+
+void TimerWheel::Place(Id id, uint64_t due_tick) {
+    const uint64_t delta = due_tick > current_tick_ ? due_tick - current_tick_ : 0;
+    for (size_t level = 0; level < LEVELS; ++level) {
+        const unsigned shift = static_cast<unsigned>(level * SLOT_BITS);
+        if (delta < (uint64_t{1} << (shift + SLOT_BITS)) || level == LEVELS - 1) {
+            // Срок за пределами колеса кладём в последний слот старшего уровня, при каскаде
+            // подписка будет переложена заново
+            const uint64_t tick = delta < (uint64_t{1} << (shift + SLOT_BITS))
+                    ? std::max(due_tick, current_tick_)
+                    : current_tick_ + ((SLOTS - 1) << shift);
+            levels_[level][(tick >> shift) & SLOT_MASK].push_back(id);
+            return;
+        }
+    }
+}
+
+void TimerWheel::Cascade(size_t level) {
+    const unsigned shift = static_cast<unsigned>(level * SLOT_BITS);
+    Slot slot = std::move(levels_[level][(current_tick_ >> shift) & SLOT_MASK]);
+    levels_[level][(current_tick_ >> shift) & SLOT_MASK].clear();
+    for (Id id : slot) {
+        if (auto it = entries_.find(id); it != entries_.end()) {
+            Place(id, it->second.due_tick);
+        }
+    }
+}
+
+void TimerWheel::AdvanceTick() {
+    ++current_tick_;
+    // При обороте младшего уровня перекладываем подписки из текущего слота старшего
+    for (size_t level = 1; level < LEVELS; ++level) {
+        if ((current_tick_ & ((uint64_t{1} << (level * SLOT_BITS)) - 1)) != 0) {
+            break;
+        }
+        Cascade(level);
+    }
+
+    Slot& slot = levels_[0][current_tick_ & SLOT_MASK];
+    if (slot.empty()) {
+        return;
+    }
+    Slot due = std::move(slot);
+    slot.clear();
+
+    const auto now = Now();
+    for (Id id : due) {
+        auto it = entries_.find(id);
+        if (it == entries_.end()) {
+            continue;
+        }
+        Entry& entry = it->second;
+        if (entry.due_tick > current_tick_) {
+            // Срок ещё не наступил: подписка попала сюда с более высокого уровня
+            Place(id, entry.due_tick);
+            continue;
+        }
+        Fire(id, entry, now);
+    }
+}
+
+void TimerWheel::Fire(Id id, Entry& entry, Clock::time_point now) {
+    auto& wheel_metrics = GetTimerWheelMetrics();
+    // После опоздания колеса не выполняем пропущенные сработки подряд, а сдвигаем срок вперёд
+    entry.due_tick = std::max(entry.due_tick + entry.period_ticks, current_tick_ + 1);
+    Place(id, entry.due_tick);
+
+    if (entry.in_flight->exchange(true, std::memory_order_acq_rel)) {
+        wheel_metrics.skipped.Add();
+        return;
+    }
+
+    const auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(now - entry.last_fire);
+    const auto period = resolution_ * entry.period_ticks;
+    entry.last_fire = now;
+    wheel_metrics.ticks.Add();
+    wheel_metrics.tick_lag.Record(delta > period ? delta - period : Clock::duration::zero());
+
+    net::post(entry.strand, [handler = entry.handler, in_flight = entry.in_flight, delta] {
+        try {
+            metrics::ScopedTimer timer{GetTimerWheelMetrics().tick_duration};
+            (*handler)(delta);
+        } catch (...) {
+        }
+        in_flight->store(false, std::memory_order_release);
+    });
+}
+
+uint64_t TimerWheel::TicksToNextEvent() const noexcept {
+    // Не дальше ближайшего оборота уровня 0: на нём нужно выполнить каскад
+    const uint64_t to_wrap = SLOTS - (current_tick_ & SLOT_MASK);
+    for (uint64_t ticks = 1; ticks < to_wrap; ++ticks) {
+        if (!levels_[0][(current_tick_ + ticks) & SLOT_MASK].empty()) {
+            return ticks;
+        }
+    }
+    return to_wrap;
+}
+
+void TimerWheel::ScheduleWakeup() {
+    assert(strand_.running_in_this_thread());
+    // Пустые слоты не требуют пробуждения. Время отсчитывается от эпохи колеса,
+    // поэтому задержки пробуждений не накапливаются
+    scheduled_tick_ = current_tick_ + TicksToNextEvent();
+    if (manual_) {
+        return;
+    }
+    timer_.expires_at(epoch_ + resolution_ * scheduled_tick_);
+    timer_.async_wait([self = shared_from_this()](sys::error_code ec) {
+        self->OnWakeup(ec);
+    });
+}
+
+void TimerWheel::OnWakeup(sys::error_code ec) {
+    assert(strand_.running_in_this_thread());
+    if (ec || !running_) {
+        return;
+    }
+    GetTimerWheelMetrics().wakeups.Add();
+
+    // Проходим пустые слоты, а если пробуждение опоздало - и пропущенные занятые
+    const auto elapsed = Now() - epoch_;
+    const uint64_t target_tick = std::max(scheduled_tick_, static_cast<uint64_t>(elapsed / resolution_));
+    do {
+        AdvanceTick();
+    } while (current_tick_ < target_tick);
+
+    ScheduleWakeup();
+}
+
+TimerWheel::Clock::time_point TimerWheel::Now() const noexcept {
+    if (manual_) {
+        return epoch_ + resolution_ * static_cast<int64_t>(manual_tick_);
+    }
+    return Clock::now();
+}
+
+} // namespace time_tiker
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <boost/asio.hpp>
+
+namespace time_tiker {
+
+namespace net = boost::asio;
+namespace sys = boost::system;
+
+/*
+ *  Иерархическое колесо таймеров. Вместо отдельного steady_timer на каждую сессию
+ *  колесо держит один таймер и просыпается только на занятых слотами длиной resolution.
+ *  Все подписки, срок которых попал в один слот, обрабатываются за одно пробуждение:
+ *  их обработчики отправляются в strand подписчика.
+ *
+ *  Колесо состоит из LEVELS уровней по SLOTS слотов. Уровень 0 хранит ближайшие
+ *  SLOTS тиков, каждый следующий уровень - в SLOTS раз более крупные слоты, которые
+ *  каскадно перекладываются вниз при обороте младшего уровня.
+ *
+ *  Если align_phases == true, первая сработка подписки выравнивается на границу,
+ *  кратную её периоду, и все подписки с одинаковым периодом срабатывают в одном слоте.
+ *  Иначе фаза подписки определяется моментом её добавления.
+ *
+ *  Если manual == true, колесо не заводит steady_timer, а его время сдвигается только
+ *  вызовами Advance. Так сработки можно проверить без зависимости от планировщика.
+ */
+class TimerWheel : public std::enable_shared_from_this<TimerWheel> {
+public:
+    using Strand = net::strand<net::io_context::executor_type>;
+    using Handler = std::function<void(std::chrono::milliseconds delta)>;
+    using Id = uint64_t;
+
+    static constexpr unsigned SLOT_BITS = 6;
+    static constexpr size_t SLOTS = size_t{1} << SLOT_BITS;
+    static constexpr size_t LEVELS = 3;
+
+    TimerWheel(net::io_context& ioc, std::chrono::milliseconds resolution, bool align_phases, bool manual = false)
+        : strand_{net::make_strand(ioc)}
+        , resolution_{std::max(resolution, std::chrono::milliseconds{1})}
+        , align_phases_{align_phases}
+        , manual_{manual} {
+    }
+
+    void Start();
+    void Stop();
+
+    // Потокобезопасны. Обработчик вызывается внутри strand с интервалом period,
+    // delta - фактическое время, прошедшее с предыдущего вызова
+    Id Add(Strand strand, std::chrono::milliseconds period, Handler handler);
+    void Remove(Id id);
+
+    // Только для manual == true: время колеса сдвигается на ticks слотов, и колесо
+    // просыпается так же, как от steady_timer
+    void Advance(uint64_t ticks);
+
+    std::chrono::milliseconds GetResolution() const noexcept;
+
+    // Наибольшая длина слота не короче period / max_parts, на которую period делится нацело
+    static std::chrono::milliseconds SplitPeriod(std::chrono::milliseconds period, uint32_t max_parts) noexcept;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using Slot = std::vector<Id>;
+
+    struct Entry {
+        Strand strand;
+        uint64_t period_ticks;
+        uint64_t due_tick;
+        Clock::time_point last_fire;
+        std::shared_ptr<Handler> handler;
+        // Пока предыдущий вызов не завершился, новые сработки пропускаются, чтобы
+        // медленная сессия не накапливала очередь обработчиков в своём strand
+        std::shared_ptr<std::atomic<bool>> in_flight;
+    };
+
+    void Insert(Id id, Entry entry);
+    void Place(Id id, uint64_t due_tick);
+    void Cascade(size_t level);
+    void AdvanceTick();
+    void Fire(Id id, Entry& entry, Clock::time_point now);
+    uint64_t TicksToNextEvent() const noexcept;
+    void ScheduleWakeup();
+    void OnWakeup(sys::error_code ec);
+    Clock::time_point Now() const noexcept;
+
+    Strand strand_;
+    net::steady_timer timer_{strand_};
+    std::chrono::milliseconds resolution_;
+    bool align_phases_;
+    bool manual_;
+    bool running_ = false;
+    Clock::time_point epoch_;
+    uint64_t current_tick_ = 0;
+    uint64_t scheduled_tick_ = 0;
+    // Время колеса в режиме manual, в слотах от эпохи
+    uint64_t manual_tick_ = 0;
+    std::atomic<Id> next_id_{1};
+    std::unordered_map<Id, Entry> entries_;
+    std::array<std::array<Slot, SLOTS>, LEVELS> levels_;
+};
+
+} // namespace time_tiker
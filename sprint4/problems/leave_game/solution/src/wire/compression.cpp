@@ -0,0 +1,143 @@
+#include "compression.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <zlib.h>
+
+#include "header_list.h"
+
+namespace wire {
+
+using namespace std::literals;
+
+namespace {
+
+// Размер окна zlib: 15 бит - максимальное окно, +16 добавляет заголовок и CRC gzip
+constexpr int WINDOW_BITS = 15;
+constexpr int GZIP_WINDOW_BITS = WINDOW_BITS + 16;
+constexpr int MEMORY_LEVEL = 8;
+
+int WindowBits(ContentEncoding encoding) {
+    if (encoding == ContentEncoding::GZIP) {
+        return GZIP_WINDOW_BITS;
+    }
+    if (encoding == ContentEncoding::DEFLATE) {
+        return WINDOW_BITS;
+    }
+    throw std::invalid_argument("Only gzip and deflate can be compressed on the fly"s);
+}
+
+}  // namespace
+
+std::string_view EncodingName(ContentEncoding encoding) noexcept {
+    switch (encoding) {
+        case ContentEncoding::GZIP:
+            return "gzip"sv;
+        case ContentEncoding::DEFLATE:
+            return "deflate"sv;
+        case ContentEncoding::BROTLI:
+            return "br"sv;
+        default:
+            return "identity"sv;
+    }
+}
+
+std::string_view EncodingFileExtension(ContentEncoding encoding) noexcept {
+    switch (encoding) {
+        case ContentEncoding::GZIP:
+            return ".gz"sv;
+        case ContentEncoding::BROTLI:
+            return ".br"sv;
+        default:
+            return {};
+    }
+}
+
+ContentEncoding ChooseEncoding(std::string_view accept_encoding, std::initializer_list<ContentEncoding> available) {
+    const std::vector<HeaderListItem> items = ParseHeaderList(accept_encoding);
+    for (ContentEncoding encoding : available) {
+        // Явно названное кодирование важнее "*"
+        double quality = -1.0;
+        for (const HeaderListItem& item : items) {
+            if (EqualsIgnoreCase(item.value, EncodingName(encoding))
+                    || (encoding == ContentEncoding::GZIP && EqualsIgnoreCase(item.value, "x-gzip"sv))) {
+                quality = item.quality;
+                break;
+            }
+            if (item.value == "*"sv) {
+                quality = item.quality;
+            }
+        }
+        if (quality > 0.0) {
+            return encoding;
+        }
+    }
+    return ContentEncoding::IDENTITY;
+}
+
+bool IsCompressible(std::string_view content_type) noexcept {
+    const std::string_view type = Trim(content_type.substr(0, content_type.find(';')));
+    return type.starts_with("text/"sv)
+            || EqualsIgnoreCase(type, "application/json"sv)
+            || EqualsIgnoreCase(type, "application/xml"sv)
+            || EqualsIgnoreCase(type, "application/javascript"sv)
+            || EqualsIgnoreCase(type, "image/svg+xml"sv);
+}
+
+void Compressor::StreamDeleter::operator()(z_stream_s* stream) const noexcept {
+    deflateEnd(stream);
+    delete stream;
+}
+
+Compressor::Compressor(ContentEncoding encoding, int level) {
+    const int window_bits = WindowBits(encoding);
+    auto stream = std::make_unique<z_stream>();
+    if (deflateInit2(stream.get(), level, Z_DEFLATED, window_bits, MEMORY_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("Failed to initialize zlib"s);
+    }
+    // deflateEnd вызывается только для успешно инициализированного потока
+    stream_.reset(stream.release());
+}
+
+Compressor::Compressor(Compressor&& other) noexcept = default;
+Compressor& Compressor::operator=(Compressor&& other) noexcept = default;
+Compressor::~Compressor() = default;
+
+void Compressor::Write(std::string_view data, std::string& out) {
+    Deflate(data, Z_SYNC_FLUSH, out);
+}
+
+void Compressor::Finish(std::string_view data, std::string& out) {
+    Deflate(data, Z_FINISH, out);
+}
+
+void Compressor::Deflate(std::string_view data, int flush, std::string& out) {
+    z_stream& stream = *stream_;
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    do {
+        // Дописываем в конец out, увеличивая его по оценке размера сжатых данных
+        const size_t used = out.size();
+        const size_t reserve = std::max<size_t>(deflateBound(&stream, stream.avail_in), 64);
+        out.resize(used + reserve);
+        stream.next_out = reinterpret_cast<Bytef*>(out.data() + used);
+        stream.avail_out = static_cast<uInt>(reserve);
+        const int result = deflate(&stream, flush);
+        out.resize(used + reserve - stream.avail_out);
+        if (result == Z_STREAM_END) {
+            return;
+        }
+        if (result != Z_OK && result != Z_BUF_ERROR) {
+            throw std::runtime_error("zlib compression failed"s);
+        }
+    } while (flush == Z_FINISH || stream.avail_in != 0 || stream.avail_out == 0);
+}
+
+std::string Compress(std::string_view data, ContentEncoding encoding, int level) {
+    Compressor compressor{encoding, level};
+    std::string result;
+    compressor.Finish(data, result);
+    return result;
+}
+
+}  // namespace wire
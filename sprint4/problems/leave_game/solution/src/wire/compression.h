@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Состояние потока zlib, чтобы не включать zlib.h в заголовок
+struct z_stream_s;
+
+namespace wire {
+
+enum class ContentEncoding {
+    IDENTITY,
+    GZIP,
+    DEFLATE,
+    BROTLI
+};
+
+// Значение заголовка Content-Encoding
+std::string_view EncodingName(ContentEncoding encoding) noexcept;
+// Расширение предварительно сжатой копии файла: .gz или .br
+std::string_view EncodingFileExtension(ContentEncoding encoding) noexcept;
+
+/*
+ *  Выбирает первое из доступных кодирований (в порядке предпочтения сервера), которое клиент
+ *  принимает согласно Accept-Encoding. Если ни одно не подходит, возвращает IDENTITY.
+ */
+ContentEncoding ChooseEncoding(std::string_view accept_encoding, std::initializer_list<ContentEncoding> available);
+
+// Стоит ли сжимать ответ такого типа: текст сжимается хорошо, картинки и звук уже сжаты
+bool IsCompressible(std::string_view content_type) noexcept;
+
+struct CompressionSettings {
+    // Уровень zlib от 1 (быстрее) до 9 (меньше), 0 отключает сжатие
+    int level = 1;
+    // Ответы меньше порога отправляются как есть: выигрыш не окупает заголовки и время
+    size_t threshold = 1024;
+};
+
+/*
+ *  Потоковое сжатие gzip или deflate (формат zlib, как требует HTTP). Вход подаётся частями,
+ *  сжатый текст дописывается в out.
+ */
+class Compressor {
+public:
+    Compressor(ContentEncoding encoding, int level);
+    Compressor(Compressor&& other) noexcept;
+    Compressor& operator=(Compressor&& other) noexcept;
+    ~Compressor();
+
+    // Сжимает часть данных и выталкивает в out всё, что можно распаковать к этому моменту
+    void Write(std::string_view data, std::string& out);
+    // Сжимает последнюю часть данных и завершает поток, после этого Write вызывать нельзя
+    void Finish(std::string_view data, std::string& out);
+
+private:
+    struct StreamDeleter {
+        void operator()(z_stream_s* stream) const noexcept;
+    };
+
+    void Deflate(std::string_view data, int flush, std::string& out);
+
+    std::unique_ptr<z_stream_s, StreamDeleter> stream_;
+};
+
+std::string Compress(std::string_view data, ContentEncoding encoding, int level);
+
+}  // namespace wire
@@ -0,0 +1,349 @@
+#include "game_state_codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "header_list.h"
+#include "../model/game_session.h"
+
+namespace wire {
+
+using namespace std::literals;
+
+namespace {
+
+constexpr char MAGIC[] = {'G', 'S'};
+constexpr uint8_t DIRECTION_STOP = 4;
+
+uint8_t DirectionToCode(constants::Direction direction) {
+    switch (direction) {
+        case constants::Direction::NORTH:
+            return 0;
+        case constants::Direction::SOUTH:
+            return 1;
+        case constants::Direction::WEST:
+            return 2;
+        case constants::Direction::EAST:
+            return 3;
+        default:
+            return DIRECTION_STOP;
+    }
+}
+
+constants::Direction CodeToDirection(uint8_t code) {
+    switch (code) {
+        case 0:
+            return constants::Direction::NORTH;
+        case 1:
+            return constants::Direction::SOUTH;
+        case 2:
+            return constants::Direction::WEST;
+        case 3:
+            return constants::Direction::EAST;
+        case DIRECTION_STOP:
+            return constants::Direction::STOP;
+        default:
+            throw std::invalid_argument("Unknown direction code "s + std::to_string(code));
+    }
+}
+
+std::string_view DirectionToString(constants::Direction direction) {
+    switch (direction) {
+        case constants::Direction::NORTH:
+            return "U"sv;
+        case constants::Direction::WEST:
+            return "L"sv;
+        case constants::Direction::EAST:
+            return "R"sv;
+        case constants::Direction::SOUTH:
+            return "D"sv;
+        default:
+            return "Unknown"sv;
+    }
+}
+
+int32_t ToFixed(double value) {
+    const double scaled = std::round(value * POSITION_SCALE);
+    return static_cast<int32_t>(std::clamp(scaled, static_cast<double>(std::numeric_limits<int32_t>::min()),
+                                           static_cast<double>(std::numeric_limits<int32_t>::max())));
+}
+
+double FromFixed(int32_t value) {
+    return static_cast<double>(value) / POSITION_SCALE;
+}
+
+class Writer {
+public:
+    explicit Writer(size_t reserve) {
+        data_.reserve(reserve);
+    }
+
+    void PutU8(uint8_t value) {
+        data_.push_back(static_cast<char>(value));
+    }
+
+    void PutI32(int32_t value) {
+        const auto bits = static_cast<uint32_t>(value);
+        const char bytes[] = {static_cast<char>(bits), static_cast<char>(bits >> 8),
+                              static_cast<char>(bits >> 16), static_cast<char>(bits >> 24)};
+        data_.append(bytes, sizeof(bytes));
+    }
+
+    // LEB128: по 7 бит на байт, старший бит означает продолжение
+    void PutVarint(uint64_t value) {
+        char bytes[10];
+        size_t size = 0;
+        while (value >= 0x80) {
+            bytes[size++] = static_cast<char>(value | 0x80);
+            value >>= 7;
+        }
+        bytes[size++] = static_cast<char>(value);
+        data_.append(bytes, size);
+    }
+
+    std::string Release() {
+        return std::move(data_);
+    }
+
+private:
+    std::string data_;
+};
+
+class Reader {
+public:
+    explicit Reader(std::string_view data)
+        : data_{data} {
+    }
+
+    uint8_t GetU8() {
+        if (pos_ >= data_.size()) {
+            throw std::invalid_argument("Unexpected end of game state"s);
+        }
+        return static_cast<uint8_t>(data_[pos_++]);
+    }
+
+    int32_t GetI32() {
+        uint32_t bits = 0;
+        for (unsigned shift = 0; shift < 32; shift += 8) {
+            bits |= static_cast<uint32_t>(GetU8()) << shift;
+        }
+        return static_cast<int32_t>(bits);
+    }
+
+    uint64_t GetVarint() {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            const uint8_t byte = GetU8();
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::invalid_argument("Varint is too long"s);
+    }
+
+    // Число элементов не может превышать число оставшихся байтов: так повреждённые
+    // данные не приводят к огромному резервированию памяти
+    size_t GetCount() {
+        const uint64_t count = GetVarint();
+        if (count > data_.size() - pos_) {
+            throw std::invalid_argument("Invalid element count in game state"s);
+        }
+        return static_cast<size_t>(count);
+    }
+
+    bool AtEnd() const noexcept {
+        return pos_ == data_.size();
+    }
+
+private:
+    std::string_view data_;
+    size_t pos_ = 0;
+};
+
+void AppendDog(StateFrame& frame, const model::Dog& dog) {
+    DogState dog_state;
+    dog_state.id = dog.GetId();
+    dog_state.x = dog.GetCoordinate().x;
+    dog_state.y = dog.GetCoordinate().y;
+    dog_state.vx = dog.GetSpeed().first;
+    dog_state.vy = dog.GetSpeed().second;
+    dog_state.direction = dog.GetDirection();
+    dog_state.score = dog.GetScore();
+    for (const auto& item : dog.GetBag()) {
+        dog_state.bag.push_back({item->GetId(), item->GetType()});
+    }
+    frame.players.push_back(std::move(dog_state));
+}
+
+void AppendLostObject(StateFrame& frame, const model::LostObject& lost_object) {
+    frame.lost_objects.push_back({lost_object.GetId(), lost_object.GetType(),
+                                  lost_object.GetCoordinate().x, lost_object.GetCoordinate().y});
+}
+
+}  // namespace
+
+void AppendSession(StateFrame& frame, model::GameSession& session) {
+    for (const std::shared_ptr<model::Dog>& dog : session.GetDogs()) {
+        AppendDog(frame, *dog);
+    }
+    for (const std::shared_ptr<model::LostObject>& lost_object : session.GetLostObjects()) {
+        AppendLostObject(frame, *lost_object);
+    }
+}
+
+void AppendSessionView(StateFrame& frame, const model::GameSession& session, const model::Dog& viewer, double radius) {
+    const geom::Point2D center = viewer.GetCoordinate();
+    // Собака игрока со своим рюкзаком и очками попадает в кадр всегда
+    AppendDog(frame, viewer);
+    session.ForEachDogInRadius(center, radius, [&frame, &viewer](const std::shared_ptr<model::Dog>& dog) {
+        if (dog.get() != &viewer) {
+            AppendDog(frame, *dog);
+        }
+    });
+    session.ForEachLostObjectInRadius(center, radius, [&frame](const std::shared_ptr<model::LostObject>& lost_object) {
+        AppendLostObject(frame, *lost_object);
+    });
+}
+
+JsonProducer StateJson(std::shared_ptr<const StateFrame> frame) {
+    return JsonSequence{}
+        .Then([](JsonWriter& writer) {
+            writer.StartObject();
+            writer.Key("players"sv);
+            writer.StartObject();
+        })
+        .ForEach(frame->players.size(), [frame](size_t index, JsonWriter& writer) {
+            const DogState& dog = frame->players[index];
+            writer.Key(std::to_string(dog.id));
+            writer.StartObject();
+            writer.Key("pos"sv);
+            writer.Pair(dog.x, dog.y);
+            writer.Key("speed"sv);
+            writer.Pair(dog.vx, dog.vy);
+            writer.Key("dir"sv);
+            writer.String(DirectionToString(dog.direction));
+            writer.Key("bag"sv);
+            writer.StartArray();
+            for (const BagItemState& item : dog.bag) {
+                writer.StartObject();
+                writer.Key("id"sv);
+                writer.Uint(item.id);
+                writer.Key("type"sv);
+                writer.Uint(item.type);
+                writer.EndObject();
+            }
+            writer.EndArray();
+            writer.Key("score"sv);
+            writer.Uint(dog.score);
+            writer.EndObject();
+        })
+        .Then([](JsonWriter& writer) {
+            writer.EndObject();
+            writer.Key("lostObjects"sv);
+            writer.StartObject();
+        })
+        .ForEach(frame->lost_objects.size(), [frame](size_t index, JsonWriter& writer) {
+            const LootState& loot = frame->lost_objects[index];
+            writer.Key(std::to_string(loot.id));
+            writer.StartObject();
+            writer.Key("type"sv);
+            writer.Uint(loot.type);
+            writer.Key("pos"sv);
+            writer.Pair(loot.x, loot.y);
+            writer.EndObject();
+        })
+        .Then([](JsonWriter& writer) {
+            writer.EndObject();
+            writer.EndObject();
+        })
+        .Build();
+}
+
+std::string EncodeBinary(const StateFrame& frame) {
+    // Оценка сверху для типичного кадра, чтобы строка не перераспределялась
+    Writer writer{4 + 10 + frame.players.size() * 40 + frame.lost_objects.size() * 20};
+    writer.PutU8(static_cast<uint8_t>(MAGIC[0]));
+    writer.PutU8(static_cast<uint8_t>(MAGIC[1]));
+    writer.PutU8(BINARY_VERSION);
+    writer.PutU8(0);
+
+    writer.PutVarint(frame.players.size());
+    for (const DogState& dog : frame.players) {
+        writer.PutVarint(dog.id);
+        writer.PutI32(ToFixed(dog.x));
+        writer.PutI32(ToFixed(dog.y));
+        writer.PutI32(ToFixed(dog.vx));
+        writer.PutI32(ToFixed(dog.vy));
+        writer.PutU8(DirectionToCode(dog.direction));
+        writer.PutVarint(dog.score);
+        writer.PutVarint(dog.bag.size());
+        for (const BagItemState& item : dog.bag) {
+            writer.PutVarint(item.id);
+            writer.PutVarint(item.type);
+        }
+    }
+
+    writer.PutVarint(frame.lost_objects.size());
+    for (const LootState& loot : frame.lost_objects) {
+        writer.PutVarint(loot.id);
+        writer.PutVarint(loot.type);
+        writer.PutI32(ToFixed(loot.x));
+        writer.PutI32(ToFixed(loot.y));
+    }
+    return writer.Release();
+}
+
+StateFrame DecodeBinary(std::string_view data) {
+    Reader reader{data};
+    if (reader.GetU8() != static_cast<uint8_t>(MAGIC[0]) || reader.GetU8() != static_cast<uint8_t>(MAGIC[1])) {
+        throw std::invalid_argument("Not a game state"s);
+    }
+    if (const uint8_t version = reader.GetU8(); version != BINARY_VERSION) {
+        throw std::invalid_argument("Unsupported game state version "s + std::to_string(version));
+    }
+    reader.GetU8();
+
+    StateFrame frame;
+    frame.players.resize(reader.GetCount());
+    for (DogState& dog : frame.players) {
+        dog.id = reader.GetVarint();
+        dog.x = FromFixed(reader.GetI32());
+        dog.y = FromFixed(reader.GetI32());
+        dog.vx = FromFixed(reader.GetI32());
+        dog.vy = FromFixed(reader.GetI32());
+        dog.direction = CodeToDirection(reader.GetU8());
+        dog.score = reader.GetVarint();
+        dog.bag.resize(reader.GetCount());
+        for (BagItemState& item : dog.bag) {
+            item.id = reader.GetVarint();
+            item.type = reader.GetVarint();
+        }
+    }
+
+    frame.lost_objects.resize(reader.GetCount());
+    for (LootState& loot : frame.lost_objects) {
+        loot.id = reader.GetVarint();
+        loot.type = reader.GetVarint();
+        loot.x = FromFixed(reader.GetI32());
+        loot.y = FromFixed(reader.GetI32());
+    }
+
+    if (!reader.AtEnd()) {
+        throw std::invalid_argument("Trailing data after game state"s);
+    }
+    return frame;
+}
+
+bool AcceptsContentType(std::string_view accept, std::string_view content_type) {
+    for (const HeaderListItem& item : ParseHeaderList(accept)) {
+        if (EqualsIgnoreCase(item.value, content_type)) {
+            return item.quality > 0.0;
+        }
+    }
+    return false;
+}
+
+}  // namespace wire
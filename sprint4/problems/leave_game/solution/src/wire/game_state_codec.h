@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "json_writer.h"
+#include "../constants.h"
+
+namespace model {
+class Dog;
+class GameSession;
+}  // namespace model
+
+namespace wire {
+
+// Тип содержимого, которое клиент указывает в заголовке Accept, чтобы получить состояние в двоичном виде
+inline constexpr std::string_view GAME_STATE_CONTENT_TYPE = "application/x-game-state";
+
+/*
+ *  Состояние игры в том виде, в каком оно отправляется клиенту. Заполняется из сессий
+ *  и кодируется в JSON или в компактный двоичный формат.
+ *
+ *  Двоичный формат, все числа little-endian:
+ *      "GS" | версия: u8 | флаги: u8
+ *      число собак: varint, для каждой:
+ *          id: varint | x, y, vx, vy: i32 | направление: u8 | очки: varint
+ *          число трофеев в рюкзаке: varint, для каждого: id: varint | тип: varint
+ *      число потерянных вещей: varint, для каждой:
+ *          id: varint | тип: varint | x, y: i32
+ *  Координаты и скорости передаются в фиксированной точке: значение, умноженное на POSITION_SCALE.
+ *  Направление: 0 - U, 1 - D, 2 - L, 3 - R, 4 - собака стоит.
+ */
+struct BagItemState {
+    uint64_t id = 0;
+    uint64_t type = 0;
+};
+
+struct DogState {
+    uint64_t id = 0;
+    double x = 0;
+    double y = 0;
+    double vx = 0;
+    double vy = 0;
+    constants::Direction direction = constants::Direction::NORTH;
+    uint64_t score = 0;
+    std::vector<BagItemState> bag;
+};
+
+struct LootState {
+    uint64_t id = 0;
+    uint64_t type = 0;
+    double x = 0;
+    double y = 0;
+};
+
+struct StateFrame {
+    std::vector<DogState> players;
+    std::vector<LootState> lost_objects;
+};
+
+constexpr uint8_t BINARY_VERSION = 1;
+// 1/256 клетки: погрешность заметно меньше размера собаки и трофея
+constexpr double POSITION_SCALE = 256.0;
+
+// Добавляет в кадр собак и потерянные вещи сессии. Вызывается в strand сессии
+void AppendSession(StateFrame& frame, model::GameSession& session);
+// Добавляет в кадр собаку viewer и собак и вещи её сессии не дальше radius от неё.
+// Объём кадра зависит от плотности объектов вокруг игрока, а не от их числа на карте
+void AppendSessionView(StateFrame& frame, const model::GameSession& session, const model::Dog& viewer, double radius);
+
+// JSON в формате /api/v1/game/state, по одной собаке или вещи за вызов
+JsonProducer StateJson(std::shared_ptr<const StateFrame> frame);
+std::string EncodeBinary(const StateFrame& frame);
+// Бросает std::invalid_argument, если данные повреждены или имеют неизвестную версию
+StateFrame DecodeBinary(std::string_view data);
+
+// Проверяет, перечислен ли тип content_type в значении заголовка Accept
+bool AcceptsContentType(std::string_view accept, std::string_view content_type);
+
+}  // namespace wire
@@ -0,0 +1,53 @@
+#include "header_list.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <string>
+
+namespace wire {
+
+using namespace std::literals;
+
+std::vector<HeaderListItem> ParseHeaderList(std::string_view header) {
+    std::vector<HeaderListItem> result;
+    while (!header.empty()) {
+        const auto comma = header.find(',');
+        std::string_view entry = header.substr(0, comma);
+        header = comma == std::string_view::npos ? std::string_view{} : header.substr(comma + 1);
+
+        const auto semicolon = entry.find(';');
+        HeaderListItem item{Trim(entry.substr(0, semicolon))};
+        if (item.value.empty()) {
+            continue;
+        }
+        std::string_view params = semicolon == std::string_view::npos ? std::string_view{} : entry.substr(semicolon + 1);
+        while (!params.empty()) {
+            const auto next = params.find(';');
+            const std::string_view param = Trim(params.substr(0, next));
+            params = next == std::string_view::npos ? std::string_view{} : params.substr(next + 1);
+            if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+                item.quality = std::strtod(std::string{param.substr(2)}.c_str(), nullptr);
+            }
+        }
+        result.push_back(item);
+    }
+    return result;
+}
+
+std::string_view Trim(std::string_view str) noexcept {
+    const auto begin = str.find_first_not_of(" \t"sv);
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    const auto end = str.find_last_not_of(" \t"sv);
+    return str.substr(begin, end - begin + 1);
+}
+
+bool EqualsIgnoreCase(std::string_view lhs, std::string_view rhs) noexcept {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](char l, char r) {
+        return std::tolower(static_cast<unsigned char>(l)) == std::tolower(static_cast<unsigned char>(r));
+    });
+}
+
+}  // namespace wire
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+namespace wire {
+
+// Элемент списка из заголовков вида Accept и Accept-Encoding: "gzip;q=0.8, br"
+struct HeaderListItem {
+    std::string_view value;
+    // Вес q из параметров элемента, по умолчанию 1. Элемент с q=0 клиент явно не принимает
+    double quality = 1.0;
+};
+
+std::vector<HeaderListItem> ParseHeaderList(std::string_view header);
+
+std::string_view Trim(std::string_view str) noexcept;
+bool EqualsIgnoreCase(std::string_view lhs, std::string_view rhs) noexcept;
+
+}  // namespace wire
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <boost/asio/buffer.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/optional.hpp>
+#include <optional>
+
+#include "compression.h"
+#include "json_writer.h"
+
+namespace wire {
+
+/*
+ *  Тело HTTP-ответа, которое формируется во время отправки. Сериализатор Beast забирает
+ *  у писателя очередное окно не больше WINDOW_SIZE байт (плюс последняя сущность), после
+ *  чего оно очищается и заполняется заново. В памяти находится только одно окно, а не весь
+ *  ответ. Длина заранее неизвестна, поэтому ответ с таким телом отправляется chunked.
+ *  Если задан Compressor, каждое окно сжимается перед отправкой.
+ */
+struct JsonStreamBody {
+    static constexpr size_t WINDOW_SIZE = 16 * 1024;
+
+    class value_type {
+    public:
+        value_type() = default;
+        value_type(JsonWriter writer, JsonProducer producer)
+            : writer_{std::move(writer)}
+            , producer_{std::move(producer)} {
+        }
+
+        void SetCompressor(Compressor compressor) {
+            compressor_.emplace(std::move(compressor));
+        }
+
+    private:
+        friend struct JsonStreamBody;
+
+        // Сериализатор получает тело по константной ссылке, а окно заполняется при отправке
+        mutable JsonWriter writer_;
+        mutable JsonProducer producer_;
+        mutable std::string window_;
+        mutable std::optional<Compressor> compressor_;
+    };
+
+    class writer {
+    public:
+        using const_buffers_type = boost::asio::const_buffer;
+
+        template <bool isRequest, class Fields>
+        writer(const boost::beast::http::header<isRequest, Fields>&, const value_type& body)
+            : body_{body} {
+        }
+
+        void init(boost::system::error_code& ec) {
+            ec = {};
+        }
+
+        boost::optional<std::pair<const_buffers_type, bool>> get(boost::system::error_code& ec) {
+            ec = {};
+            // В окне может остаться текст, накопленный до начала отправки
+            bool more = static_cast<bool>(body_.producer_);
+            while (more && body_.writer_.Size() < WINDOW_SIZE) {
+                more = body_.producer_(body_.writer_);
+            }
+            if (!more) {
+                body_.producer_ = nullptr;
+            }
+            if (body_.compressor_) {
+                // Окно сжимается целиком, чтобы клиент мог распаковать его сразу по получении
+                body_.window_.clear();
+                if (more) {
+                    body_.compressor_->Write(body_.writer_.GetBuffer(), body_.window_);
+                } else {
+                    body_.compressor_->Finish(body_.writer_.GetBuffer(), body_.window_);
+                    body_.compressor_.reset();
+                }
+            } else {
+                // Буферы меняются местами, чтобы не выделять память под каждое окно: предыдущее
+                // окно Beast уже отправил к моменту следующего вызова get
+                body_.window_.swap(body_.writer_.GetBuffer());
+            }
+            body_.writer_.GetBuffer().clear();
+            if (body_.window_.empty()) {
+                return boost::none;
+            }
+            return {{boost::asio::const_buffer{body_.window_.data(), body_.window_.size()}, more}};
+        }
+
+    private:
+        const value_type& body_;
+    };
+};
+
+}  // namespace wire
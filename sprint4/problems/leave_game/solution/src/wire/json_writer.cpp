@@ -0,0 +1,186 @@
+#include "json_writer.h"
+
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <memory>
+
+namespace wire {
+
+using namespace std::literals;
+
+void JsonWriter::StartObject() {
+    BeforeValue();
+    buffer_.push_back('{');
+    has_items_.push_back(false);
+}
+
+void JsonWriter::EndObject() {
+    assert(!has_items_.empty() && !after_key_);
+    has_items_.pop_back();
+    buffer_.push_back('}');
+}
+
+void JsonWriter::StartArray() {
+    BeforeValue();
+    buffer_.push_back('[');
+    has_items_.push_back(false);
+}
+
+void JsonWriter::EndArray() {
+    assert(!has_items_.empty());
+    has_items_.pop_back();
+    buffer_.push_back(']');
+}
+
+void JsonWriter::Key(std::string_view key) {
+    BeforeValue();
+    WriteEscaped(key);
+    buffer_.push_back(':');
+    after_key_ = true;
+}
+
+void JsonWriter::String(std::string_view value) {
+    BeforeValue();
+    WriteEscaped(value);
+}
+
+void JsonWriter::Int(int64_t value) {
+    BeforeValue();
+    char chars[24];
+    auto result = std::to_chars(std::begin(chars), std::end(chars), value);
+    buffer_.append(chars, result.ptr);
+}
+
+void JsonWriter::Uint(uint64_t value) {
+    BeforeValue();
+    char chars[24];
+    auto result = std::to_chars(std::begin(chars), std::end(chars), value);
+    buffer_.append(chars, result.ptr);
+}
+
+void JsonWriter::Double(double value) {
+    BeforeValue();
+    // В JSON нет бесконечности и NaN
+    if (!std::isfinite(value)) {
+        buffer_.append("null"sv);
+        return;
+    }
+    // Кратчайшая запись, из которой число восстанавливается без потерь
+    char chars[32];
+    auto result = std::to_chars(std::begin(chars), std::end(chars), value);
+    buffer_.append(chars, result.ptr);
+}
+
+void JsonWriter::Bool(bool value) {
+    BeforeValue();
+    buffer_.append(value ? "true"sv : "false"sv);
+}
+
+void JsonWriter::Null() {
+    BeforeValue();
+    buffer_.append("null"sv);
+}
+
+void JsonWriter::Pair(double x, double y) {
+    StartArray();
+    Double(x);
+    Double(y);
+    EndArray();
+}
+
+std::string& JsonWriter::GetBuffer() noexcept {
+    return buffer_;
+}
+
+size_t JsonWriter::Size() const noexcept {
+    return buffer_.size();
+}
+
+std::string JsonWriter::TakeBuffer() {
+    std::string result = std::move(buffer_);
+    buffer_.clear();
+    return result;
+}
+
+void JsonWriter::BeforeValue() {
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (!has_items_.empty()) {
+        if (has_items_.back()) {
+            buffer_.push_back(',');
+        }
+        has_items_.back() = true;
+    }
+}
+
+void JsonWriter::WriteEscaped(std::string_view str) {
+    constexpr char HEX[] = "0123456789abcdef";
+    buffer_.push_back('"');
+    size_t plain_begin = 0;
+    for (size_t i = 0; i < str.size(); ++i) {
+        const auto c = static_cast<unsigned char>(str[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        buffer_.append(str.substr(plain_begin, i - plain_begin));
+        plain_begin = i + 1;
+        switch (c) {
+            case '"':
+                buffer_.append("\\\""sv);
+                break;
+            case '\\':
+                buffer_.append("\\\\"sv);
+                break;
+            case '\n':
+                buffer_.append("\\n"sv);
+                break;
+            case '\r':
+                buffer_.append("\\r"sv);
+                break;
+            case '\t':
+                buffer_.append("\\t"sv);
+                break;
+            default:
+                buffer_.append("\\u00"sv);
+                buffer_.push_back(HEX[c >> 4]);
+                buffer_.push_back(HEX[c & 0xF]);
+                break;
+        }
+    }
+    buffer_.append(str.substr(plain_begin));
+    buffer_.push_back('"');
+}
+
+JsonSequence& JsonSequence::Then(std::function<void(JsonWriter& writer)> write) {
+    steps_.push_back([write = std::move(write)](JsonWriter& writer) {
+        write(writer);
+        return true;
+    });
+    return *this;
+}
+
+JsonSequence& JsonSequence::ForEach(size_t count, std::function<void(size_t index, JsonWriter& writer)> write) {
+    steps_.push_back([count, write = std::move(write), index = size_t{0}](JsonWriter& writer) mutable {
+        if (index < count) {
+            write(index++, writer);
+        }
+        return index >= count;
+    });
+    return *this;
+}
+
+JsonProducer JsonSequence::Build() {
+    // std::function требует копируемости, поэтому состояние шагов разделяется через shared_ptr
+    auto steps = std::make_shared<std::vector<Step>>(std::move(steps_));
+    return [steps, current = size_t{0}](JsonWriter& writer) mutable {
+        if (current < steps->size() && (*steps)[current](writer)) {
+            ++current;
+        }
+        return current < steps->size();
+    };
+}
+
+}  // namespace wire
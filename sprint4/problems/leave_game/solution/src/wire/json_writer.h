@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace wire {
+
+/*
+ *  Потоковая запись JSON без построения дерева boost::json. Текст дописывается в буфер,
+ *  который владелец может забрать и очистить в любой момент: запятые и вложенность
+ *  отслеживаются самим писателем, поэтому документ можно выдавать частями.
+ */
+class JsonWriter {
+public:
+    void StartObject();
+    void EndObject();
+    void StartArray();
+    void EndArray();
+    void Key(std::string_view key);
+
+    void String(std::string_view value);
+    void Int(int64_t value);
+    void Uint(uint64_t value);
+    void Double(double value);
+    void Bool(bool value);
+    void Null();
+
+    // Пара [x, y], в таком виде передаются координаты и скорости
+    void Pair(double x, double y);
+
+    std::string& GetBuffer() noexcept;
+    size_t Size() const noexcept;
+    // Забирает накопленный текст, состояние вложенности сохраняется
+    std::string TakeBuffer();
+
+private:
+    void BeforeValue();
+    void WriteEscaped(std::string_view str);
+
+    std::string buffer_;
+    // Для каждого открытого объекта или массива: был ли в нём уже элемент
+    std::vector<bool> has_items_;
+    bool after_key_ = false;
+};
+
+/*
+ *  Выдаёт документ по частям: каждый вызов дописывает в писатель следующую порцию
+ *  и возвращает false, когда документ закончен.
+ */
+using JsonProducer = std::function<bool(JsonWriter& writer)>;
+
+/*
+ *  Составляет JsonProducer из последовательных шагов. Шаг вызывается, пока не вернёт true.
+ */
+class JsonSequence {
+public:
+    using Step = std::function<bool(JsonWriter& writer)>;
+
+    // Шаг, который выполняется один раз
+    JsonSequence& Then(std::function<void(JsonWriter& writer)> write);
+    // Шаг, который пишет по одному элементу за вызов: write(i, writer) для i из [0, count)
+    JsonSequence& ForEach(size_t count, std::function<void(size_t index, JsonWriter& writer)> write);
+
+    // Шаги переносятся в результат, после вызова последовательность пуста
+    JsonProducer Build();
+
+private:
+    std::vector<Step> steps_;
+};
+
+}  // namespace wire
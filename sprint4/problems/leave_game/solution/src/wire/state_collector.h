@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/post.hpp>
+
+#include "../model/game_session.h"
+#include "game_state_codec.h"
+
+namespace wire {
+
+/*
+ *  Собирает кадр состояния из нескольких сессий. fill(frame, session) выполняется в strand-е
+ *  каждой сессии, а done(frame) вызывает тот обработчик, который завершился последним.
+ *  Поэтому в кадр попадают все сессии, даже если чей-то strand был занят тиком: ответ просто
+ *  уходит позже. Части кадра склеиваются в порядке sessions.
+ */
+template <typename Fill, typename Done>
+void CollectStateFrame(std::vector<std::shared_ptr<model::GameSession>> sessions, Fill fill, Done done) {
+    if (sessions.empty()) {
+        done(std::make_shared<const StateFrame>());
+        return;
+    }
+
+    struct Collector {
+        Collector(size_t sessions_count, Fill&& fill, Done&& done)
+            : parts(sessions_count)
+            , pending(sessions_count)
+            , fill(std::move(fill))
+            , done(std::move(done)) {
+        }
+
+        // Каждая сессия пишет только в свою часть, поэтому мьютекс не нужен.
+        // acq_rel на счётчике делает все части видимыми последнему обработчику
+        std::vector<StateFrame> parts;
+        std::atomic<size_t> pending;
+        Fill fill;
+        Done done;
+
+        void Finish() {
+            StateFrame frame = std::move(parts.front());
+            for (size_t i = 1; i < parts.size(); ++i) {
+                auto& part = parts[i];
+                frame.players.insert(frame.players.end(), std::make_move_iterator(part.players.begin()),
+                                     std::make_move_iterator(part.players.end()));
+                frame.lost_objects.insert(frame.lost_objects.end(), part.lost_objects.begin(), part.lost_objects.end());
+            }
+            done(std::make_shared<const StateFrame>(std::move(frame)));
+        }
+    };
+
+    auto collector = std::make_shared<Collector>(sessions.size(), std::move(fill), std::move(done));
+    for (size_t i = 0; i < sessions.size(); ++i) {
+        auto strand = sessions[i]->GetSessionStrand();
+        boost::asio::post(*strand, [collector, session = std::move(sessions[i]), i] {
+            collector->fill(collector->parts[i], *session);
+            if (collector->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                collector->Finish();
+            }
+        });
+    }
+}
+
+}  // namespace wire
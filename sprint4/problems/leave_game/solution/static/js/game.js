@@ -411,6 +411,14 @@ class GameState {
 
   _updateState(then) {
     let self = this;
+    if (gameStateBinarySupported()) {
+      fetchGameState(Cookies.get('authToken')).then(function(x){
+        self.desiredState = x;
+        self.stateTime = performance.now();
+        then();
+      });
+      return;
+    }
     $.get({
       url: '/api/v1/game/state',
       dataType: 'json',
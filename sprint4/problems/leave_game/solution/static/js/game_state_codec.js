@@ -0,0 +1,101 @@
+// Декодер двоичного состояния игры (application/x-game-state), формат описан в src/wire/game_state_codec.h.
+// Возвращает объект того же вида, что и JSON-ответ /api/v1/game/state
+const GAME_STATE_CONTENT_TYPE = 'application/x-game-state';
+const GAME_STATE_POSITION_SCALE = 256;
+const GAME_STATE_DIRECTIONS = ['U', 'D', 'L', 'R', 'Unknown'];
+
+function gameStateBinarySupported() {
+  return typeof fetch === 'function' && typeof DataView === 'function';
+}
+
+function decodeGameState(buffer) {
+  const view = new DataView(buffer);
+  let offset = 0;
+
+  function u8() {
+    if (offset >= view.byteLength) {
+      throw new Error('Unexpected end of game state');
+    }
+    return view.getUint8(offset++);
+  }
+
+  function i32() {
+    if (offset + 4 > view.byteLength) {
+      throw new Error('Unexpected end of game state');
+    }
+    const value = view.getInt32(offset, true);
+    offset += 4;
+    return value;
+  }
+
+  function fixed() {
+    return i32() / GAME_STATE_POSITION_SCALE;
+  }
+
+  function varint() {
+    let value = 0;
+    let multiplier = 1;
+    for (;;) {
+      const byte = u8();
+      value += (byte & 0x7f) * multiplier;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+      multiplier *= 128;
+    }
+  }
+
+  if (u8() != 0x47 || u8() != 0x53) {
+    throw new Error('Not a game state');
+  }
+  const version = u8();
+  if (version != 1) {
+    throw new Error('Unsupported game state version ' + version);
+  }
+  u8();
+
+  const players = {};
+  const playersCount = varint();
+  for (let i = 0; i < playersCount; ++i) {
+    const id = varint();
+    const pos = [fixed(), fixed()];
+    const speed = [fixed(), fixed()];
+    const dir = GAME_STATE_DIRECTIONS[u8()];
+    const score = varint();
+    const bag = [];
+    const bagSize = varint();
+    for (let j = 0; j < bagSize; ++j) {
+      bag.push({id: varint(), type: varint()});
+    }
+    players[id] = {pos: pos, speed: speed, dir: dir, bag: bag, score: score};
+  }
+
+  const lostObjects = {};
+  const lostObjectsCount = varint();
+  for (let i = 0; i < lostObjectsCount; ++i) {
+    const id = varint();
+    const type = varint();
+    lostObjects[id] = {type: type, pos: [fixed(), fixed()]};
+  }
+
+  return {players: players, lostObjects: lostObjects};
+}
+
+// Запрашивает состояние в двоичном виде. Если сервер ответил JSON, разбирает его
+function fetchGameState(authToken) {
+  return fetch('/api/v1/game/state', {
+    headers: {
+      'Authorization': 'Bearer ' + authToken,
+      'Accept': GAME_STATE_CONTENT_TYPE + ', application/json;q=0.5'
+    }
+  }).then(function(response) {
+    if (!response.ok) {
+      throw new Error('Game state request failed: ' + response.status);
+    }
+    const contentType = response.headers.get('Content-Type') || '';
+    if (contentType.startsWith(GAME_STATE_CONTENT_TYPE)) {
+      return response.arrayBuffer().then(decodeGameState);
+    }
+    return response.json();
+  });
+}
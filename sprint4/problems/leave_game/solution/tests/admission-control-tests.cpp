@@ -0,0 +1,146 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+#include "../src/http_server/admission_control.h"
+#include "../src/http_server/rate_limiter.h"
+
+using namespace std::literals;
+using http_server::AdmissionControl;
+using http_server::TokenBucketRateLimiter;
+
+SCENARIO("Connection admission") {
+    GIVEN("a limit of 3 connections and 2 per address") {
+        auto admission = std::make_shared<AdmissionControl>(3, 2);
+
+        WHEN("one address opens connections") {
+            auto first = admission->TryAdmit("10.0.0.1"s);
+            auto second = admission->TryAdmit("10.0.0.1"s);
+            auto third = admission->TryAdmit("10.0.0.1"s);
+
+            THEN("connections above the per-address limit are rejected") {
+                CHECK(first);
+                CHECK(second);
+                CHECK_FALSE(third);
+                CHECK(admission->ActiveConnections("10.0.0.1"s) == 2);
+            }
+
+            AND_WHEN("other addresses connect") {
+                auto other = admission->TryAdmit("10.0.0.2"s);
+                auto over_limit = admission->TryAdmit("10.0.0.3"s);
+
+                THEN("the total limit is applied to all addresses") {
+                    CHECK(other);
+                    CHECK_FALSE(over_limit);
+                    CHECK(admission->ActiveConnections() == 3);
+                }
+            }
+
+            AND_WHEN("a connection is closed") {
+                first = {};
+
+                THEN("its slot is returned") {
+                    CHECK(admission->ActiveConnections() == 1);
+                    CHECK(admission->TryAdmit("10.0.0.1"s));
+                }
+            }
+        }
+
+        WHEN("slots are moved") {
+            std::vector<AdmissionControl::Slot> slots;
+            slots.push_back(admission->TryAdmit("10.0.0.1"s));
+            slots.push_back(admission->TryAdmit("10.0.0.2"s));
+            slots.push_back(admission->TryAdmit("10.0.0.3"s));
+
+            THEN("each connection is released exactly once") {
+                CHECK(admission->ActiveConnections() == 3);
+                slots.clear();
+                CHECK(admission->ActiveConnections() == 0);
+                CHECK(admission->ActiveConnections("10.0.0.1"s) == 0);
+            }
+        }
+    }
+
+    GIVEN("no limits") {
+        auto admission = std::make_shared<AdmissionControl>(0, 0);
+
+        THEN("every connection is admitted") {
+            std::vector<AdmissionControl::Slot> slots;
+            for (int i = 0; i < 1000; ++i) {
+                slots.push_back(admission->TryAdmit("10.0.0.1"s));
+                REQUIRE(slots.back());
+            }
+        }
+    }
+}
+
+SCENARIO("Token bucket rate limiter") {
+    using Clock = TokenBucketRateLimiter::Clock;
+    const Clock::time_point start = Clock::now();
+
+    GIVEN("a limiter of 10 requests per second with a burst of 3") {
+        TokenBucketRateLimiter limiter{10, 3};
+
+        WHEN("a key sends a burst") {
+            THEN("requests above the burst are rejected") {
+                CHECK(limiter.TryAcquire("token"sv, start));
+                CHECK(limiter.TryAcquire("token"sv, start));
+                CHECK(limiter.TryAcquire("token"sv, start));
+                CHECK_FALSE(limiter.TryAcquire("token"sv, start));
+            }
+
+            THEN("other keys have their own buckets") {
+                for (int i = 0; i < 3; ++i) {
+                    REQUIRE(limiter.TryAcquire("token"sv, start));
+                }
+                CHECK(limiter.TryAcquire("other"sv, start));
+            }
+        }
+
+        WHEN("the bucket is empty") {
+            for (int i = 0; i < 3; ++i) {
+                REQUIRE(limiter.TryAcquire("token"sv, start));
+            }
+
+            THEN("tokens are refilled at the configured rate") {
+                CHECK_FALSE(limiter.TryAcquire("token"sv, start + 50ms));
+                CHECK(limiter.TryAcquire("token"sv, start + 100ms));
+                CHECK_FALSE(limiter.TryAcquire("token"sv, start + 100ms));
+            }
+
+            THEN("the refill does not exceed the burst") {
+                const auto later = start + 10s;
+                for (int i = 0; i < 3; ++i) {
+                    CHECK(limiter.TryAcquire("token"sv, later));
+                }
+                CHECK_FALSE(limiter.TryAcquire("token"sv, later));
+            }
+        }
+
+        WHEN("many keys stop sending requests and new keys arrive") {
+            constexpr int KEYS = 20000;
+            for (int i = 0; i < KEYS; ++i) {
+                limiter.TryAcquire("old-"s + std::to_string(i), start);
+            }
+            for (int i = 0; i < KEYS; ++i) {
+                limiter.TryAcquire("new-"s + std::to_string(i), start + 10s);
+            }
+
+            THEN("full buckets of the old keys are dropped") {
+                CHECK(limiter.Size() < KEYS * 3 / 2);
+            }
+        }
+    }
+
+    GIVEN("a zero rate") {
+        TokenBucketRateLimiter limiter{0, 1};
+
+        THEN("the limiter is disabled") {
+            CHECK_FALSE(limiter.Enabled());
+            for (int i = 0; i < 100; ++i) {
+                REQUIRE(limiter.TryAcquire("token"sv, start));
+            }
+            CHECK(limiter.Size() == 0);
+        }
+    }
+}
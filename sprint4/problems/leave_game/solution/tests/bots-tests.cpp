@@ -0,0 +1,147 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/model/game_session.h"
+
+using namespace std::literals;
+using constants::Direction;
+
+namespace {
+
+// Дороги буквой П: (0, 0) - (10, 0) - (10, 10) - (0, 10), база в конце последней дороги
+struct Fixture {
+    Fixture() {
+        map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, 0}, 10));
+        map.AddRoad(model::Road(model::Road::VERTICAL, {10, 0}, 10));
+        map.AddRoad(model::Road(model::Road::HORIZONTAL, {10, 10}, 0));
+        map.AddOffice(model::Office{model::Office::Id{"office"s}, {0, 10}, {0, 0}});
+        map.AddLootType({});
+        map.SetDogSpeed(3.0);
+        map.SetBagCapaccity(3);
+        navigation = std::make_shared<const model::RoadNavigation>(map);
+    }
+
+    std::shared_ptr<model::GameSession> MakeSession() {
+        // Предметы не появляются сами, их раскладывает тест
+        return std::make_shared<model::GameSession>(&map, 0ms, model::LootGeneratorConfig{1.0, 0.0}, ioc, 42);
+    }
+
+    std::shared_ptr<model::Dog> AddBot(model::GameSession& session, model::BotPolicyType policy) {
+        std::string name = "bot"s;
+        auto dog = std::make_shared<model::Dog>(name);
+        session.AddBot(dog, model::MakeBotPolicy(policy), navigation, false);
+        return dog;
+    }
+
+    model::Map map{model::Map::Id{"map"s}, "map"s};
+    std::shared_ptr<const model::RoadNavigation> navigation;
+    net::io_context ioc;
+};
+
+std::shared_ptr<model::LostObject> AddLoot(model::GameSession& session, model::Point point, size_t type) {
+    auto lost_object = std::make_shared<model::LostObject>();
+    lost_object->SetCoordinateByPoint(point);
+    lost_object->SetType(type);
+    session.AddLostObject(lost_object);
+    return lost_object;
+}
+
+}  // namespace
+
+SCENARIO_METHOD(Fixture, "Road graph") {
+    const model::RoadGraph& graph = navigation->graph;
+
+    THEN("every integer point of the roads is a node") {
+        CHECK(graph.GetNodesCount() == 31);
+        CHECK(graph.FindNode({5, 0}));
+        CHECK(graph.FindNode({0, 10}));
+        CHECK_FALSE(graph.FindNode({5, 5}));
+        CHECK_FALSE(graph.FindNode({-1, 0}));
+        CHECK_FALSE(graph.FindNode({11, 11}));
+    }
+
+    THEN("nodes are linked along the roads") {
+        const auto corner = *graph.FindNode({10, 0});
+        CHECK(graph.GetNeighbor(corner, Direction::WEST) == *graph.FindNode({9, 0}));
+        CHECK(graph.GetNeighbor(corner, Direction::SOUTH) == *graph.FindNode({10, 1}));
+        CHECK(graph.GetNeighbor(corner, Direction::EAST) == model::RoadGraph::NO_NODE);
+        CHECK(graph.GetNeighbor(corner, Direction::NORTH) == model::RoadGraph::NO_NODE);
+        CHECK(graph.GetNeighbor(corner, Direction::STOP) == model::RoadGraph::NO_NODE);
+    }
+
+    THEN("distances to offices are measured along the roads") {
+        CHECK(navigation->office_distances[*graph.FindNode({0, 10})] == 0);
+        CHECK(navigation->office_distances[*graph.FindNode({10, 5})] == 15);
+        CHECK(navigation->office_distances[*graph.FindNode({0, 0})] == 30);
+    }
+
+    THEN("a graph is not built for a map with a too large bounding box") {
+        CHECK(model::RoadGraph::CanBuild(map));
+        model::Map huge{model::Map::Id{"huge"s}, "huge"s};
+        huge.AddRoad(model::Road(model::Road::HORIZONTAL, {0, 0}, 100'000));
+        huge.AddRoad(model::Road(model::Road::VERTICAL, {0, 0}, 100'000));
+        CHECK_FALSE(model::RoadGraph::CanBuild(huge));
+        CHECK_THROWS_AS(model::RoadGraph{huge}, std::invalid_argument);
+    }
+
+    THEN("distances to several sources are measured to the nearest one") {
+        model::RoadGraph::Distances distances;
+        graph.FindDistances({*graph.FindNode({0, 0}), *graph.FindNode({0, 10})}, distances);
+        CHECK(distances[*graph.FindNode({10, 0})] == 10);
+        CHECK(distances[*graph.FindNode({10, 4})] == 14);
+        CHECK(distances[*graph.FindNode({10, 6})] == 14);
+    }
+}
+
+SCENARIO_METHOD(Fixture, "Server-side bots") {
+    CHECK(model::ParseBotPolicy("randomWalk"sv) == model::BotPolicyType::RANDOM_WALK);
+    CHECK(model::ParseBotPolicy("lootSeeker"sv) == model::BotPolicyType::LOOT_SEEKER);
+    CHECK_FALSE(model::ParseBotPolicy("teleport"sv));
+
+    GIVEN("a loot seeker and a lost object on the far road") {
+        auto session = MakeSession();
+        auto dog = AddBot(*session, model::BotPolicyType::LOOT_SEEKER);
+        AddLoot(*session, {10, 5}, 2);
+
+        CHECK(session->IsBot(dog->GetId()));
+        CHECK(session->GetBotsCount() == 1);
+
+        WHEN("the session is updated for a while") {
+            bool picked_up = false;
+            for (int tick = 0; tick < 300; ++tick) {
+                session->UpdateSessionByTime(50ms);
+                picked_up = picked_up || dog->GetSizeBag() == 1;
+            }
+
+            THEN("the bot picks the object up and brings it to the office") {
+                CHECK(picked_up);
+                CHECK(session->GetLostObjects().empty());
+                CHECK(dog->GetSizeBag() == 0);
+                CHECK(dog->GetScore() == 2);
+            }
+        }
+    }
+
+    GIVEN("a random walker") {
+        auto session = MakeSession();
+        auto dog = AddBot(*session, model::BotPolicyType::RANDOM_WALK);
+
+        WHEN("the session is updated for a while") {
+            THEN("the bot keeps moving along the roads") {
+                const model::RoadGraph& graph = navigation->graph;
+                double max_x = 0;
+                double max_y = 0;
+                for (int tick = 0; tick < 2000; ++tick) {
+                    session->UpdateSessionByTime(50ms);
+                    const geom::Point2D coord = dog->GetCoordinate();
+                    REQUIRE(graph.FindNode({static_cast<model::Coord>(std::round(coord.x)),
+                                            static_cast<model::Coord>(std::round(coord.y))}));
+                    REQUIRE(dog->GetSpeed() != std::pair{0.0, 0.0});
+                    max_x = std::max(max_x, coord.x);
+                    max_y = std::max(max_y, coord.y);
+                }
+                CHECK(max_x > 9.5);
+                CHECK(max_y > 9.5);
+            }
+        }
+    }
+}
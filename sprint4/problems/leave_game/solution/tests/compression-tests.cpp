@@ -0,0 +1,210 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <fstream>
+#include <thread>
+#include <zlib.h>
+
+#include "../src/files.h"
+#include "../src/wire/compression.h"
+#include "../src/wire/json_stream_body.h"
+
+using namespace std::literals;
+using wire::ContentEncoding;
+
+namespace {
+
+// Распаковывает gzip и deflate (zlib): 15 + 32 включает автоопределение заголовка
+std::string Decompress(std::string_view data) {
+    z_stream stream{};
+    REQUIRE(inflateInit2(&stream, 15 + 32) == Z_OK);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    std::string result;
+    int status = Z_OK;
+    while (status == Z_OK) {
+        char buffer[4096];
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = sizeof(buffer);
+        status = inflate(&stream, Z_NO_FLUSH);
+        result.append(buffer, sizeof(buffer) - stream.avail_out);
+    }
+    inflateEnd(&stream);
+    REQUIRE(status == Z_STREAM_END);
+    return result;
+}
+
+std::string MakeText(size_t lines) {
+    std::string text;
+    for (size_t i = 0; i < lines; ++i) {
+        text += "{\"id\":" + std::to_string(i) + ",\"pos\":[1.5,2.25],\"dir\":\"U\"}\n";
+    }
+    return text;
+}
+
+void WriteFile(const fs::path& path, std::string_view data) {
+    std::ofstream output{path, std::ios::binary | std::ios::trunc};
+    output.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+}  // namespace
+
+SCENARIO("Content-Encoding negotiation") {
+    const auto gzip_or_deflate = {ContentEncoding::GZIP, ContentEncoding::DEFLATE};
+
+    CHECK(wire::ChooseEncoding("gzip, deflate, br"sv, gzip_or_deflate) == ContentEncoding::GZIP);
+    CHECK(wire::ChooseEncoding("deflate"sv, gzip_or_deflate) == ContentEncoding::DEFLATE);
+    CHECK(wire::ChooseEncoding("GZIP;q=0.5"sv, gzip_or_deflate) == ContentEncoding::GZIP);
+    CHECK(wire::ChooseEncoding("gzip;q=0, deflate"sv, gzip_or_deflate) == ContentEncoding::DEFLATE);
+    CHECK(wire::ChooseEncoding("*"sv, gzip_or_deflate) == ContentEncoding::GZIP);
+    CHECK(wire::ChooseEncoding("*, gzip;q=0"sv, gzip_or_deflate) == ContentEncoding::DEFLATE);
+    CHECK(wire::ChooseEncoding("br"sv, gzip_or_deflate) == ContentEncoding::IDENTITY);
+    CHECK(wire::ChooseEncoding(""sv, gzip_or_deflate) == ContentEncoding::IDENTITY);
+
+    CHECK(wire::IsCompressible("application/json"sv));
+    CHECK(wire::IsCompressible("text/html; charset=utf-8"sv));
+    CHECK_FALSE(wire::IsCompressible("image/png"sv));
+    CHECK_FALSE(wire::IsCompressible("application/x-game-state"sv));
+}
+
+SCENARIO("Streaming compression") {
+    GIVEN("a large text") {
+        const std::string text = MakeText(2000);
+
+        WHEN("it is compressed at once") {
+            THEN("it becomes smaller and is restored exactly") {
+                for (ContentEncoding encoding : {ContentEncoding::GZIP, ContentEncoding::DEFLATE}) {
+                    const std::string compressed = wire::Compress(text, encoding, 6);
+                    CHECK(compressed.size() < text.size() / 4);
+                    CHECK(Decompress(compressed) == text);
+                }
+            }
+        }
+
+        WHEN("it is compressed in parts") {
+            wire::Compressor compressor{ContentEncoding::GZIP, 1};
+            std::string compressed;
+            std::string flushed;
+            for (size_t pos = 0; pos < text.size(); pos += 1000) {
+                compressor.Write(std::string_view{text}.substr(pos, 1000), compressed);
+                flushed = compressed;
+            }
+            compressor.Finish({}, compressed);
+
+            THEN("every part is flushed and the whole stream is restored") {
+                CHECK(!flushed.empty());
+                CHECK(Decompress(compressed) == text);
+            }
+        }
+
+        WHEN("the encoding can not be produced on the fly") {
+            THEN("the compressor refuses it") {
+                CHECK_THROWS_AS((wire::Compressor{ContentEncoding::BROTLI, 6}), std::invalid_argument);
+            }
+        }
+    }
+
+    GIVEN("a JSON stream body with a compressor") {
+        constexpr size_t COUNT = 5000;
+        auto make_producer = [] {
+            return wire::JsonSequence{}
+                .Then([](wire::JsonWriter& writer) {
+                    writer.StartArray();
+                })
+                .ForEach(COUNT, [](size_t index, wire::JsonWriter& writer) {
+                    writer.Uint(index);
+                })
+                .Then([](wire::JsonWriter& writer) {
+                    writer.EndArray();
+                })
+                .Build();
+        };
+        namespace http = boost::beast::http;
+        http::response<wire::JsonStreamBody> response;
+        response.body() = wire::JsonStreamBody::value_type{wire::JsonWriter{}, make_producer()};
+        response.body().SetCompressor(wire::Compressor{ContentEncoding::GZIP, 6});
+
+        WHEN("it is sent") {
+            wire::JsonStreamBody::writer body_writer{response.base(), response.body()};
+            boost::system::error_code ec;
+            body_writer.init(ec);
+            std::string compressed;
+            while (auto chunk = body_writer.get(ec)) {
+                compressed.append(static_cast<const char*>(chunk->first.data()), chunk->first.size());
+                if (!chunk->second) {
+                    break;
+                }
+            }
+
+            THEN("the joined windows form one gzip stream of the document") {
+                wire::JsonWriter writer;
+                auto producer = make_producer();
+                while (producer(writer)) {
+                }
+                CHECK(Decompress(compressed) == writer.TakeBuffer());
+            }
+        }
+    }
+}
+
+SCENARIO("Precompressed static files") {
+    const fs::path root = fs::temp_directory_path() / ("precompress-test-"s + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+    fs::remove_all(root);
+    fs::create_directories(root / "js");
+    WriteFile(root / "index.html", MakeText(200));
+    WriteFile(root / "js" / "game.js", MakeText(300));
+    WriteFile(root / "tiny.txt", "x"sv);
+    WriteFile(root / "image.png", MakeText(200));
+
+    GIVEN("a static directory") {
+        WHEN("it is precompressed") {
+            const files_path::PrecompressStats stats = files_path::PrecompressFiles(root, 9);
+
+            THEN("compressible files get .gz copies") {
+                CHECK(stats.files == 2);
+                CHECK(stats.failed == 0);
+                CHECK(stats.compressed_bytes < stats.original_bytes);
+                CHECK(fs::exists(root / "index.html.gz"));
+                CHECK(fs::exists(root / "js" / "game.js.gz"));
+                // Копия из одного байта больше оригинала, а PNG уже сжат
+                CHECK_FALSE(fs::exists(root / "tiny.txt.gz"));
+                CHECK_FALSE(fs::exists(root / "image.png.gz"));
+            }
+
+            THEN("fresh copies are not compressed again") {
+                CHECK(files_path::PrecompressFiles(root, 9).files == 0);
+            }
+
+            THEN("a copy is chosen only for clients that accept it") {
+                const auto gzip = files_path::ChoosePrecompressed(root / "index.html", "gzip, deflate"sv);
+                CHECK(gzip.encoding == ContentEncoding::GZIP);
+                CHECK(gzip.path == root / "index.html.gz");
+                CHECK(gzip.has_variants);
+
+                const auto identity = files_path::ChoosePrecompressed(root / "index.html", "identity"sv);
+                CHECK(identity.encoding == ContentEncoding::IDENTITY);
+                CHECK(identity.path == root / "index.html");
+                CHECK(identity.has_variants);
+
+                CHECK_FALSE(files_path::ChoosePrecompressed(root / "tiny.txt", "gzip"sv).has_variants);
+            }
+
+            AND_WHEN("a brotli copy is added") {
+                WriteFile(root / "index.html.br", "brotli"sv);
+
+                THEN("it is preferred by clients that accept br") {
+                    CHECK(files_path::ChoosePrecompressed(root / "index.html", "gzip, br"sv).encoding == ContentEncoding::BROTLI);
+                    CHECK(files_path::ChoosePrecompressed(root / "index.html", "gzip"sv).encoding == ContentEncoding::GZIP);
+                }
+            }
+
+            AND_WHEN("the original file is changed") {
+                fs::last_write_time(root / "index.html", fs::last_write_time(root / "index.html.gz") + 1s);
+
+                THEN("the outdated copy is not served") {
+                    CHECK(files_path::ChoosePrecompressed(root / "index.html", "gzip"sv).encoding == ContentEncoding::IDENTITY);
+                }
+            }
+        }
+    }
+    fs::remove_all(root);
+}
@@ -0,0 +1,311 @@
+// Нагрузочные тесты общего состояния приложения. Предназначены для сборки с -fsanitize=thread:
+// проверки в тестах ловят несогласованные снимки, а гонки данных находит ThreadSanitizer
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "../src/shared_snapshot.h"
+#include "../src/app/player_tokens.h"
+#include "../src/model/game.h"
+#include "../src/model/session_manager.h"
+
+using namespace std::literals;
+
+namespace {
+
+constexpr int READERS_COUNT = 4;
+constexpr int WRITES_COUNT = 2000;
+
+// Запускает count читателей, пока writer не завершится
+template <typename Reader, typename Writer>
+void RunConcurrently(int count, Reader reader, Writer writer) {
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < count; ++i) {
+        readers.emplace_back([&done, &reader] {
+            while (!done.load(std::memory_order_acquire)) {
+                reader();
+            }
+        });
+    }
+    writer();
+    done.store(true, std::memory_order_release);
+    for (auto& thread : readers) {
+        thread.join();
+    }
+}
+
+}  // namespace
+
+SCENARIO("Shared snapshot under concurrent updates") {
+    GIVEN("a snapshot of a vector whose elements are all equal") {
+        util::SharedSnapshot<std::vector<int>> snapshot{std::vector<int>(16, 0)};
+
+        WHEN("a writer updates it while readers load it") {
+            std::atomic<int> inconsistent{0};
+            RunConcurrently(READERS_COUNT, [&] {
+                const auto values = snapshot.Load();
+                for (int value : *values) {
+                    if (value != values->front()) {
+                        inconsistent.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }, [&] {
+                for (int i = 1; i <= WRITES_COUNT; ++i) {
+                    snapshot.Update([i](std::vector<int>& values) {
+                        for (int& value : values) {
+                            value = i;
+                        }
+                    });
+                }
+            });
+
+            THEN("readers never observe a partially updated snapshot") {
+                CHECK(inconsistent == 0);
+                CHECK(snapshot.Load()->front() == WRITES_COUNT);
+            }
+        }
+    }
+}
+
+SCENARIO("Shared snapshot readers against a join-heavy writer") {
+    GIVEN("a snapshot that only grows, like a list of joined players") {
+        util::SharedSnapshot<std::vector<int>> snapshot;
+
+        WHEN("a writer appends an element per update while readers load it") {
+            std::atomic<int> inconsistent{0};
+            std::atomic<int> went_back{0};
+            RunConcurrently(READERS_COUNT, [&] {
+                thread_local size_t last_size = 0;
+                const auto values = snapshot.Load();
+                if (values->size() < last_size) {
+                    went_back.fetch_add(1, std::memory_order_relaxed);
+                }
+                last_size = values->size();
+                for (size_t i = 0; i < values->size(); ++i) {
+                    if ((*values)[i] != static_cast<int>(i)) {
+                        inconsistent.fetch_add(1, std::memory_order_relaxed);
+                        break;
+                    }
+                }
+            }, [&] {
+                for (int i = 0; i < WRITES_COUNT; ++i) {
+                    snapshot.Update([i](std::vector<int>& values) {
+                        values.push_back(i);
+                    });
+                }
+            });
+
+            THEN("every reader sees complete snapshots that never go back in time") {
+                CHECK(inconsistent == 0);
+                CHECK(went_back == 0);
+                CHECK(snapshot.Load()->size() == WRITES_COUNT);
+            }
+        }
+    }
+}
+
+SCENARIO("Player tokens under concurrent joins and retirements") {
+    GIVEN("player tokens shared between request handlers and session strands") {
+        app::PlayerTokens tokens;
+        std::vector<std::shared_ptr<model::Dog>> dogs;
+        std::vector<std::shared_ptr<app::Player>> players;
+        for (int i = 0; i < WRITES_COUNT; ++i) {
+            std::string name = "dog"s + std::to_string(i);
+            dogs.push_back(std::make_shared<model::Dog>(name));
+            players.push_back(std::make_shared<app::Player>(dogs.back(), std::weak_ptr<model::GameSession>{}));
+        }
+        std::vector<app::Token> known_tokens(WRITES_COUNT, app::Token{""s});
+        std::atomic<int> published{0};
+
+        WHEN("players join and retire while tokens are looked up") {
+            std::atomic<int> wrong_player{0};
+            RunConcurrently(READERS_COUNT, [&] {
+                const int count = published.load(std::memory_order_acquire);
+                for (int i = std::max(0, count - 8); i < count; ++i) {
+                    auto player = tokens.FindPlayerByToken(known_tokens[i]);
+                    if (player && player != players[i]) {
+                        wrong_player.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }, [&] {
+                // Второй писатель отправляет на покой каждого второго игрока
+                std::thread retirer{[&] {
+                    for (int i = 0; i < WRITES_COUNT; i += 2) {
+                        while (published.load(std::memory_order_acquire) <= i) {
+                            std::this_thread::yield();
+                        }
+                        tokens.RemovePlayerById(players[i]->GetPlayerId());
+                    }
+                }};
+                for (int i = 0; i < WRITES_COUNT; ++i) {
+                    known_tokens[i] = tokens.AddPlayer(players[i]);
+                    published.store(i + 1, std::memory_order_release);
+                }
+                retirer.join();
+            });
+
+            THEN("lookups find only their own players and retired players are removed") {
+                CHECK(wrong_player == 0);
+                CHECK(tokens.GetPlayerToken().size() == WRITES_COUNT / 2);
+                CHECK(tokens.FindPlayerByToken(known_tokens[0]) == nullptr);
+                CHECK(tokens.FindPlayerByToken(known_tokens[1]) == players[1]);
+            }
+        }
+    }
+}
+
+SCENARIO("Session manager under concurrent joins") {
+    GIVEN("a session manager shared between request handlers") {
+        model::Map map{model::Map::Id{"map"s}, "map"s};
+        map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, 0}, 10));
+        map.AddLootType({});
+        net::io_context ioc;
+        auto manager = std::make_shared<model::SessionManager>(map.GetId(), 4);
+        std::atomic<int> created{0};
+        auto factory = [&] {
+            created.fetch_add(1, std::memory_order_relaxed);
+            return std::make_shared<model::GameSession>(&map, 0ms, model::LootGeneratorConfig{1.0, 0.5}, ioc, 42);
+        };
+
+        WHEN("several threads acquire and release slots while sessions are listed") {
+            constexpr int JOINERS_COUNT = 4;
+            constexpr int JOINS_COUNT = 500;
+            std::atomic<size_t> listed{0};
+            RunConcurrently(READERS_COUNT, [&] {
+                listed.fetch_add(manager->GetSessions()->size(), std::memory_order_relaxed);
+            }, [&] {
+                std::vector<std::thread> joiners;
+                for (int i = 0; i < JOINERS_COUNT; ++i) {
+                    joiners.emplace_back([&] {
+                        for (int j = 0; j < JOINS_COUNT; ++j) {
+                            auto session = manager->Acquire(factory);
+                            if (j % 2 == 0) {
+                                manager->Release(session.get(), 1);
+                            }
+                        }
+                    });
+                }
+                for (auto& thread : joiners) {
+                    thread.join();
+                }
+            });
+
+            THEN("the listed sessions hold all remaining players") {
+                const size_t players = JOINERS_COUNT * JOINS_COUNT / 2;
+                const auto sessions = manager->GetSessions();
+                CHECK(sessions->size() * 4 >= players);
+                CHECK(sessions->size() <= players);
+                CHECK(created >= static_cast<int>(sessions->size()));
+            }
+        }
+    }
+}
+
+SCENARIO("Players join sessions that are ticking") {
+    GIVEN("a game with the interest index and sessions ticking on io_context threads") {
+        // io_context переживает игру: колесо таймеров и strand-ы сессий живут в нём
+        net::io_context ioc;
+        model::Map map{model::Map::Id{"map"s}, "map"s};
+        for (int i = 0; i <= 40; i += 10) {
+            map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, i}, 40));
+            map.AddRoad(model::Road(model::Road::VERTICAL, {i, 0}, 40));
+        }
+        map.AddLootType({});
+        map.SetDogSpeed(4.0);
+        map.SetBagCapaccity(3);
+        model::Game game;
+        game.AddMap(std::move(map));
+        const model::Map* game_map = &game.GetMaps().front();
+        game.SetViewRadius(5.0);
+        auto navigation = std::make_shared<const model::RoadNavigation>(*game_map);
+
+        auto timer_wheel = std::make_shared<time_tiker::TimerWheel>(ioc, 1ms, false);
+        timer_wheel->Start();
+        game.SetTimerWheel(timer_wheel);
+        auto work = net::make_work_guard(ioc);
+        std::vector<std::thread> runners;
+        for (int i = 0; i < 2; ++i) {
+            runners.emplace_back([&ioc] {
+                ioc.run();
+            });
+        }
+
+        WHEN("several threads join players and bots while the sessions tick") {
+            constexpr int JOINERS_COUNT = 4;
+            constexpr int JOINS_COUNT = 100;
+            std::atomic<int> created{0};
+            // Собаки создаются заранее: в приложении их id выдаются под мьютексом игроков
+            std::vector<std::vector<std::shared_ptr<model::Dog>>> dogs(JOINERS_COUNT);
+            for (auto& joiner_dogs : dogs) {
+                for (int j = 0; j < JOINS_COUNT; ++j) {
+                    std::string name = "dog"s;
+                    joiner_dogs.push_back(std::make_shared<model::Dog>(name));
+                }
+            }
+            std::vector<std::vector<std::pair<std::shared_ptr<model::GameSession>, std::shared_ptr<model::Dog>>>> joined(JOINERS_COUNT);
+            std::vector<std::thread> joiners;
+            for (int i = 0; i < JOINERS_COUNT; ++i) {
+                joiners.emplace_back([&, i] {
+                    for (int j = 0; j < JOINS_COUNT; ++j) {
+                        auto session = game.FindValidSession(game_map, 5ms, ioc, [&created](const auto&) {
+                            created.fetch_add(1, std::memory_order_relaxed);
+                        });
+                        const auto& dog = dogs[i][j];
+                        if (j % 2 == 0) {
+                            session->PostAddDog(dog, true);
+                        } else {
+                            session->PostAddBot(dog, model::MakeBotPolicy(model::BotPolicyType::RANDOM_WALK),
+                                                navigation, true);
+                        }
+                        joined[i].emplace_back(std::move(session), dog);
+                    }
+                });
+            }
+            for (auto& thread : joiners) {
+                thread.join();
+            }
+
+            THEN("every dog is in its session and in the interest index around itself") {
+                const auto sessions = game.GetAllSession();
+                CHECK(created == static_cast<int>(sessions.size()));
+                size_t dogs_count = 0;
+                for (const auto& session : sessions) {
+                    std::promise<size_t> count;
+                    net::post(*session->GetSessionStrand(), [&count, &session] {
+                        count.set_value(session->GetDogs().size());
+                    });
+                    dogs_count += count.get_future().get();
+                }
+                CHECK(dogs_count == JOINERS_COUNT * JOINS_COUNT);
+
+                for (const auto& joiner_dogs : joined) {
+                    for (const auto& [session, dog] : joiner_dogs) {
+                        std::promise<bool> found;
+                        net::post(*session->GetSessionStrand(), [&found, &session, &dog] {
+                            bool in_index = false;
+                            session->ForEachDogInRadius(dog->GetCoordinate(), 0.1, [&in_index, &dog](const auto& other) {
+                                in_index = in_index || other == dog;
+                            });
+                            found.set_value(in_index);
+                        });
+                        CHECK(found.get_future().get());
+                    }
+                }
+            }
+        }
+
+        timer_wheel->Stop();
+        work.reset();
+        ioc.stop();
+        for (auto& thread : runners) {
+            thread.join();
+        }
+        for (const auto& session : game.GetAllSession()) {
+            session->Stop();
+        }
+    }
+}
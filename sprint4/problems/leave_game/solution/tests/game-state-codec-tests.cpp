@@ -0,0 +1,312 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <thread>
+#include <boost/beast/http.hpp>
+#include <boost/json.hpp>
+
+#include "../src/model/game_session.h"
+#include "../src/wire/game_state_codec.h"
+#include "../src/wire/json_stream_body.h"
+#include "../src/wire/state_collector.h"
+
+namespace json = boost::json;
+using namespace std::literals;
+
+namespace {
+
+std::string Drain(wire::JsonProducer producer) {
+    wire::JsonWriter writer;
+    while (producer(writer)) {
+    }
+    return writer.TakeBuffer();
+}
+
+std::string StateJsonText(const wire::StateFrame& frame) {
+    return Drain(wire::StateJson(std::make_shared<const wire::StateFrame>(frame)));
+}
+
+wire::StateFrame MakeFrame() {
+    wire::StateFrame frame;
+    frame.players.push_back({300, 1.5, -2.25, 0.0, 3.0, constants::Direction::WEST, 1000, {{5, 1}, {70000, 2}}});
+    frame.players.push_back({1, 0.4, 7.0, -1.0, 0.0, constants::Direction::STOP, 0, {}});
+    frame.lost_objects.push_back({12, 3, 10.0, 20.5});
+    return frame;
+}
+
+}  // namespace
+
+SCENARIO("Binary game state encoding") {
+    GIVEN("a state frame") {
+        const wire::StateFrame frame = MakeFrame();
+
+        WHEN("it is encoded and decoded") {
+            const std::string data = wire::EncodeBinary(frame);
+            const wire::StateFrame decoded = wire::DecodeBinary(data);
+
+            THEN("ids, directions, scores and bags are restored exactly") {
+                REQUIRE(decoded.players.size() == 2);
+                CHECK(decoded.players[0].id == 300);
+                CHECK(decoded.players[0].direction == constants::Direction::WEST);
+                CHECK(decoded.players[0].score == 1000);
+                REQUIRE(decoded.players[0].bag.size() == 2);
+                CHECK(decoded.players[0].bag[1].id == 70000);
+                CHECK(decoded.players[0].bag[1].type == 2);
+                CHECK(decoded.players[1].direction == constants::Direction::STOP);
+                REQUIRE(decoded.lost_objects.size() == 1);
+                CHECK(decoded.lost_objects[0].id == 12);
+                CHECK(decoded.lost_objects[0].type == 3);
+            }
+
+            THEN("positions and speeds are quantized to the fixed point step") {
+                const double step = 1.0 / wire::POSITION_SCALE;
+                CHECK(std::abs(decoded.players[0].y - frame.players[0].y) <= step / 2);
+                CHECK(std::abs(decoded.players[0].vy - frame.players[0].vy) <= step / 2);
+                CHECK(std::abs(decoded.players[1].x - frame.players[1].x) <= step / 2);
+                CHECK(std::abs(decoded.lost_objects[0].y - frame.lost_objects[0].y) <= step / 2);
+            }
+
+            THEN("the frame is much smaller than its JSON form") {
+                CHECK(data.size() < StateJsonText(frame).size() / 3);
+            }
+        }
+
+        WHEN("the encoded data is truncated or has a wrong header") {
+            std::string data = wire::EncodeBinary(frame);
+
+            THEN("decoding fails") {
+                CHECK_THROWS_AS(wire::DecodeBinary(std::string_view{data}.substr(0, data.size() - 1)), std::invalid_argument);
+                data[2] = 2;
+                CHECK_THROWS_AS(wire::DecodeBinary(data), std::invalid_argument);
+            }
+        }
+    }
+}
+
+SCENARIO("Area of interest") {
+    GIVEN("a session with objects near and far from the player") {
+        model::Map map{model::Map::Id{"map"s}, "map"s};
+        map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, 0}, 100));
+        map.AddLootType({});
+        net::io_context ioc;
+        auto session = std::make_shared<model::GameSession>(&map, 0ms, model::LootGeneratorConfig{1.0, 0.0}, ioc, 1);
+        session->EnableInterestIndex(10.0);
+
+        auto add_dog = [&session](double x) {
+            std::string name = "dog"s;
+            auto dog = std::make_shared<model::Dog>(name);
+            dog->SetCoordinate({x, 0.0});
+            session->AddDog(dog);
+            return dog;
+        };
+        auto add_loot = [&session](double x) {
+            auto lost_object = std::make_shared<model::LostObject>();
+            lost_object->SetCoordinate({x, 0.0});
+            session->AddLostObject(lost_object);
+            return lost_object;
+        };
+        const auto viewer = add_dog(50.0);
+        const auto near_dog = add_dog(55.0);
+        add_dog(90.0);
+        const auto near_loot = add_loot(41.0);
+        add_loot(5.0);
+
+        WHEN("the player's view is collected") {
+            wire::StateFrame frame;
+            wire::AppendSessionView(frame, *session, *viewer, 10.0);
+
+            THEN("it has the player's dog and only the nearby objects") {
+                REQUIRE(frame.players.size() == 2);
+                CHECK(frame.players[0].id == viewer->GetId());
+                CHECK(frame.players[1].id == near_dog->GetId());
+                REQUIRE(frame.lost_objects.size() == 1);
+                CHECK(frame.lost_objects[0].id == near_loot->GetId());
+            }
+        }
+    }
+}
+
+SCENARIO("Collecting the state of several sessions") {
+    GIVEN("sessions with one dog each, one of them with a busy strand") {
+        model::Map map{model::Map::Id{"map"s}, "map"s};
+        map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, 0}, 100));
+        map.AddLootType({});
+        net::io_context ioc;
+        std::vector<std::shared_ptr<model::GameSession>> sessions;
+        std::vector<uint64_t> dog_ids;
+        for (int i = 0; i < 3; ++i) {
+            sessions.push_back(std::make_shared<model::GameSession>(&map, 0ms, model::LootGeneratorConfig{1.0, 0.0}, ioc, i));
+            std::string name = "dog"s + std::to_string(i);
+            auto dog = std::make_shared<model::Dog>(name);
+            sessions.back()->AddDog(dog);
+            dog_ids.push_back(dog->GetId());
+        }
+
+        // Работа, поставленная в strand раньше сбора, например тик
+        std::atomic<bool> busy{false};
+        std::atomic<bool> release{false};
+        net::post(*sessions[1]->GetSessionStrand(), [&busy, &release] {
+            busy = true;
+            while (!release) {
+                std::this_thread::yield();
+            }
+        });
+
+        WHEN("the state is collected while that strand is busy") {
+            std::promise<std::shared_ptr<const wire::StateFrame>> result;
+            auto collected = result.get_future();
+            wire::CollectStateFrame(sessions, [](wire::StateFrame& frame, model::GameSession& session) {
+                wire::AppendSession(frame, session);
+            }, [&result](std::shared_ptr<const wire::StateFrame> frame) {
+                result.set_value(std::move(frame));
+            });
+
+            std::vector<std::jthread> runners;
+            for (int i = 0; i < 2; ++i) {
+                runners.emplace_back([&ioc] {
+                    ioc.run();
+                });
+            }
+            // Отпускает strand до join потоков, даже если проверка ниже прервёт сценарий
+            struct ReleaseGuard {
+                std::atomic<bool>& release;
+                ~ReleaseGuard() {
+                    release = true;
+                }
+            } release_guard{release};
+            while (!busy) {
+                std::this_thread::yield();
+            }
+
+            THEN("the response waits for the busy session and includes every session") {
+                CHECK(collected.wait_for(50ms) == std::future_status::timeout);
+                release = true;
+                const auto frame = collected.get();
+                REQUIRE(frame->players.size() == 3);
+                for (size_t i = 0; i < dog_ids.size(); ++i) {
+                    CHECK(frame->players[i].id == dog_ids[i]);
+                }
+            }
+        }
+    }
+
+    GIVEN("no sessions") {
+        THEN("an empty frame is returned at once") {
+            std::shared_ptr<const wire::StateFrame> result;
+            wire::CollectStateFrame({}, [](wire::StateFrame&, model::GameSession&) {}, [&result](std::shared_ptr<const wire::StateFrame> frame) {
+                result = std::move(frame);
+            });
+            REQUIRE(result);
+            CHECK(result->players.empty());
+        }
+    }
+}
+
+SCENARIO("Game state JSON encoding") {
+    GIVEN("a state frame") {
+        const json::object state = json::parse(StateJsonText(MakeFrame())).as_object();
+
+        THEN("it has the format of /api/v1/game/state") {
+            const auto& dog = state.at("players").at("300").as_object();
+            CHECK(dog.at("pos").as_array() == json::array{1.5, -2.25});
+            CHECK(dog.at("dir").as_string() == "L");
+            CHECK(dog.at("bag").as_array().size() == 2);
+            CHECK(state.at("players").at("1").at("dir").as_string() == "Unknown");
+            CHECK(state.at("lostObjects").at("12").at("type").to_number<int>() == 3);
+        }
+    }
+}
+
+SCENARIO("Accept header negotiation") {
+    using wire::AcceptsContentType;
+    using wire::GAME_STATE_CONTENT_TYPE;
+
+    CHECK(AcceptsContentType("application/x-game-state"sv, GAME_STATE_CONTENT_TYPE));
+    CHECK(AcceptsContentType("text/html, Application/X-Game-State;q=0.9"sv, GAME_STATE_CONTENT_TYPE));
+    CHECK_FALSE(AcceptsContentType("application/json"sv, GAME_STATE_CONTENT_TYPE));
+    CHECK_FALSE(AcceptsContentType("application/x-game-state; q=0"sv, GAME_STATE_CONTENT_TYPE));
+    CHECK_FALSE(AcceptsContentType(""sv, GAME_STATE_CONTENT_TYPE));
+}
+
+SCENARIO("Streaming JSON writer") {
+    GIVEN("a writer") {
+        wire::JsonWriter writer;
+
+        WHEN("nested values are written") {
+            writer.StartObject();
+            writer.Key("name"sv);
+            writer.String("a \"quoted\"\n\x01 name"sv);
+            writer.Key("list"sv);
+            writer.StartArray();
+            writer.Int(-1);
+            writer.Double(0.1);
+            writer.Bool(true);
+            writer.Null();
+            writer.StartObject();
+            writer.EndObject();
+            writer.EndArray();
+            writer.Key("pos"sv);
+            writer.Pair(1.5, 2);
+            writer.EndObject();
+
+            THEN("commas and escapes make valid JSON that keeps the values") {
+                const std::string text = writer.TakeBuffer();
+                CHECK(text == R"({"name":"a \"quoted\"\n\u0001 name","list":[-1,0.1,true,null,{}],"pos":[1.5,2]})");
+                const json::value parsed = json::parse(text);
+                CHECK(parsed.at("name").as_string() == "a \"quoted\"\n\x01 name");
+                CHECK(parsed.at("list").at(1).as_double() == 0.1);
+            }
+        }
+    }
+
+    GIVEN("a producer of many entities") {
+        constexpr size_t COUNT = 5000;
+        auto make_producer = [] {
+            return wire::JsonSequence{}
+                .Then([](wire::JsonWriter& writer) {
+                    writer.StartArray();
+                })
+                .ForEach(COUNT, [](size_t index, wire::JsonWriter& writer) {
+                    writer.StartObject();
+                    writer.Key("id"sv);
+                    writer.Uint(index);
+                    writer.EndObject();
+                })
+                .Then([](wire::JsonWriter& writer) {
+                    writer.EndArray();
+                })
+                .Build();
+        };
+
+        WHEN("it is sent as a stream body") {
+            namespace http = boost::beast::http;
+            http::response<wire::JsonStreamBody> response;
+            response.body() = wire::JsonStreamBody::value_type{wire::JsonWriter{}, make_producer()};
+            wire::JsonStreamBody::writer body_writer{response.base(), response.body()};
+            boost::system::error_code ec;
+            body_writer.init(ec);
+
+            std::string text;
+            size_t windows = 0;
+            size_t max_window = 0;
+            while (auto chunk = body_writer.get(ec)) {
+                ++windows;
+                max_window = std::max(max_window, chunk->first.size());
+                text.append(static_cast<const char*>(chunk->first.data()), chunk->first.size());
+                if (!chunk->second) {
+                    break;
+                }
+            }
+
+            THEN("it is split into bounded windows that join into the whole document") {
+                CHECK(!ec);
+                CHECK(windows > 1);
+                CHECK(max_window < wire::JsonStreamBody::WINDOW_SIZE + 64);
+                CHECK(text == Drain(make_producer()));
+                CHECK(json::parse(text).as_array().size() == COUNT);
+            }
+        }
+    }
+}
@@ -1,7 +1,11 @@
 #include <cmath>
+#include <set>
+#include <thread>
+#include <vector>
 #include <catch2/catch_test_macros.hpp>
 
 #include "../src/model/loot_generator.h"
+#include "../src/model/random.h"
 
 using namespace std::literals;
 
@@ -72,3 +76,112 @@ SCENARIO("Loot generation") {
         }
     }
 }
+
+SCENARIO("Session random engine") {
+    using model::random::Engine;
+
+    GIVEN("two engines with the same seed") {
+        Engine lhs{42};
+        Engine rhs{42};
+
+        THEN("they produce the same sequence") {
+            bool equal = true;
+            for (int i = 0; i < 1000; ++i) {
+                equal = equal && lhs() == rhs();
+            }
+            CHECK(equal);
+        }
+
+        WHEN("the state of one engine is copied to another") {
+            lhs();
+            Engine restored{7};
+            restored.SetState(lhs.GetState());
+
+            THEN("the sequence continues from the same point") {
+                CHECK(restored() == lhs());
+                CHECK(restored.UniformInt(0, 100) == lhs.UniformInt(0, 100));
+            }
+        }
+    }
+
+    GIVEN("engines with different seeds") {
+        THEN("their sequences differ") {
+            Engine lhs{1};
+            Engine rhs{2};
+            CHECK(lhs() != rhs());
+        }
+    }
+
+    GIVEN("an engine") {
+        Engine engine{123};
+
+        THEN("uniform values stay in range") {
+            bool in_range = true;
+            for (int i = 0; i < 10'000; ++i) {
+                const double real = engine.UniformReal();
+                const int64_t integer = engine.UniformInt(-3, 5);
+                in_range = in_range && real >= 0.0 && real < 1.0 && integer >= -3 && integer <= 5;
+            }
+            CHECK(in_range);
+            CHECK(engine.UniformInt(4, 4) == 4);
+        }
+
+        THEN("it can drive a loot generator") {
+            loot_gen::LootGenerator gen{1s, 1.0, [&engine] {
+                                            return engine.UniformReal();
+                                        }};
+            CHECK(gen.Generate(1s, 0, 4) <= 4);
+        }
+    }
+}
+
+SCENARIO("Session seed sequence") {
+    using model::random::SeedSequence;
+
+    GIVEN("a seed sequence and a plain SplitMix64 state with the same master seed") {
+        SeedSequence seeds{42};
+        uint64_t state = 42;
+
+        THEN("they produce the same seeds") {
+            bool equal = true;
+            for (int i = 0; i < 100; ++i) {
+                equal = equal && seeds.Next() == model::random::SplitMix64(state);
+            }
+            CHECK(equal);
+        }
+    }
+
+    GIVEN("a seed sequence shared between threads") {
+        SeedSequence seeds{7};
+        constexpr int THREADS_COUNT = 4;
+        constexpr int SEEDS_PER_THREAD = 1000;
+        std::vector<std::vector<uint64_t>> drawn(THREADS_COUNT);
+
+        WHEN("every thread draws seeds") {
+            std::vector<std::thread> threads;
+            for (auto& thread_seeds : drawn) {
+                threads.emplace_back([&seeds, &thread_seeds] {
+                    for (int i = 0; i < SEEDS_PER_THREAD; ++i) {
+                        thread_seeds.push_back(seeds.Next());
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            THEN("no seed is handed out twice and together they are the sequential seeds") {
+                std::set<uint64_t> unique;
+                for (const auto& thread_seeds : drawn) {
+                    unique.insert(thread_seeds.begin(), thread_seeds.end());
+                }
+                SeedSequence sequential{7};
+                std::set<uint64_t> expected;
+                for (int i = 0; i < THREADS_COUNT * SEEDS_PER_THREAD; ++i) {
+                    expected.insert(sequential.Next());
+                }
+                CHECK(unique == expected);
+            }
+        }
+    }
+}
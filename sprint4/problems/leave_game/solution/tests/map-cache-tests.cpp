@@ -0,0 +1,205 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+#include "../src/json_loader/map_cache.h"
+#include "../src/json_loader/parallel_maps.h"
+#include "../src/model/bots.h"
+
+using namespace std::literals;
+namespace fs = std::filesystem;
+
+namespace {
+
+void WriteFile(const fs::path& path, std::string_view content) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << content;
+}
+
+model::Game MakeGame() {
+    model::Game game;
+    game.SetDefaultDogSpeed(2.5);
+    game.SetDefaultBagCapacity(4);
+    model::LootGeneratorConfig loot_gen_config{5.0, 0.25};
+    game.SetLootGeneratorConfig(loot_gen_config);
+
+    model::Map map{model::Map::Id{"town"s}, "Town"s};
+    map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, 0}, 20));
+    map.AddRoad(model::Road(model::Road::VERTICAL, {20, 0}, 10));
+    map.AddRoad(model::Road(model::Road::VERTICAL, {5, 0}, 8));
+    map.AddBuilding(model::Building({{2, 2}, {3, 4}}));
+    map.AddOffice(model::Office{model::Office::Id{"o1"s}, {20, 10}, {1, -1}});
+    model::LootType loot_type;
+    loot_type.name = "key"s;
+    loot_type.file = "assets/key.obj"s;
+    loot_type.value = 10;
+    map.AddLootType(loot_type);
+    map.SetDogSpeed(3.0);
+    map.SetBagCapaccity(2);
+    map.SetBotsConfig({5, model::BotPolicyType::RANDOM_WALK});
+    map.SetNavigation(std::make_shared<const model::RoadNavigation>(map));
+    game.AddMap(std::move(map));
+
+    game.AddMap(model::Map{model::Map::Id{"empty"s}, "Empty"s});
+    return game;
+}
+
+}  // namespace
+
+SCENARIO("Map cache") {
+    const fs::path dir = fs::temp_directory_path() / "map-cache-tests"s;
+    fs::create_directories(dir);
+    const fs::path config_path = dir / "config.json"s;
+    const fs::path cache_path = dir / "config.cache"s;
+    fs::remove(cache_path);
+    WriteFile(config_path, R"({"maps": []})"sv);
+
+    GIVEN("no cache file") {
+        THEN("nothing is loaded") {
+            CHECK_FALSE(json_loader::LoadGameFromCache(config_path, cache_path));
+        }
+    }
+
+    GIVEN("a cache saved for the config") {
+        const model::Game game = MakeGame();
+        json_loader::SaveGameCache(game, config_path, cache_path);
+
+        THEN("the game is restored from it") {
+            auto restored = json_loader::LoadGameFromCache(config_path, cache_path);
+            REQUIRE(restored);
+            CHECK(restored->GetDefaultDogSpeed() == 2.5);
+            CHECK(restored->GetDefaultBagCapacity() == 4);
+            CHECK(restored->GetLootGeneratorConfig().probability == 0.25);
+            REQUIRE(restored->GetMaps().size() == 2);
+
+            const model::Map& map = restored->GetMaps().front();
+            const model::Map& original = game.GetMaps().front();
+            CHECK(*map.GetId() == "town"s);
+            CHECK(map.GetName() == "Town"s);
+            CHECK(map.GetDogSpeed() == 3.0);
+            CHECK(map.GetBagCapacity() == 2);
+            CHECK(map.GetBotsConfig().count == 5);
+            CHECK(map.GetBotsConfig().policy == model::BotPolicyType::RANDOM_WALK);
+            REQUIRE(map.GetRoads().size() == original.GetRoads().size());
+            for (size_t i = 0; i < map.GetRoads().size(); ++i) {
+                CHECK(map.GetRoads()[i].IsHorizontal() == original.GetRoads()[i].IsHorizontal());
+                CHECK(map.GetRoads()[i].GetStart().x == original.GetRoads()[i].GetStart().x);
+                CHECK(map.GetRoads()[i].GetStart().y == original.GetRoads()[i].GetStart().y);
+                CHECK(map.GetRoads()[i].GetEnd().x == original.GetRoads()[i].GetEnd().x);
+                CHECK(map.GetRoads()[i].GetEnd().y == original.GetRoads()[i].GetEnd().y);
+            }
+            CHECK(map.GetVerRoad(5, 7));
+            REQUIRE(map.GetBuildings().size() == 1);
+            CHECK(map.GetBuildings().front().GetBounds().size.height == 4);
+            REQUIRE(map.GetOffices().size() == 1);
+            CHECK(*map.GetOffices().front().GetId() == "o1"s);
+            CHECK(map.GetOffices().front().GetOffset().dy == -1);
+            REQUIRE(map.GetLootTypes().size() == 1);
+            CHECK(map.GetLootTypes().front().file == "assets/key.obj"s);
+            CHECK(map.GetLootTypes().front().value == 10);
+
+            REQUIRE(map.GetNavigation());
+            const model::RoadGraph& graph = map.GetNavigation()->graph;
+            CHECK(graph.GetNodesCount() == original.GetNavigation()->graph.GetNodesCount());
+            CHECK(map.GetNavigation()->office_distances == original.GetNavigation()->office_distances);
+            const auto corner = graph.FindNode({20, 0});
+            REQUIRE(corner);
+            CHECK(graph.GetNeighbor(*corner, constants::Direction::SOUTH) == *graph.FindNode({20, 1}));
+
+            CHECK_FALSE(restored->GetMaps().back().GetNavigation());
+        }
+
+        WHEN("the config is changed") {
+            // Тот же размер, другое содержимое
+            WriteFile(config_path, R"({"maps":[ ]})"sv);
+            fs::last_write_time(config_path, fs::last_write_time(config_path) + 1s);
+
+            THEN("the cache is ignored") {
+                CHECK_FALSE(json_loader::LoadGameFromCache(config_path, cache_path));
+            }
+        }
+
+        WHEN("the config is replaced keeping its size and modification time") {
+            const auto mtime = fs::last_write_time(config_path);
+            WriteFile(config_path, R"({"maps":[ ]})"sv);
+            fs::last_write_time(config_path, mtime);
+
+            THEN("the cache is ignored") {
+                CHECK_FALSE(json_loader::LoadGameFromCache(config_path, cache_path));
+            }
+        }
+
+        WHEN("only the modification time of the config is changed") {
+            fs::last_write_time(config_path, fs::last_write_time(config_path) + 1s);
+
+            THEN("the cache is still used") {
+                CHECK(json_loader::LoadGameFromCache(config_path, cache_path));
+            }
+        }
+
+        WHEN("the cache file is truncated") {
+            fs::resize_file(cache_path, fs::file_size(cache_path) / 2);
+
+            THEN("loading fails") {
+                CHECK_THROWS_AS(json_loader::LoadGameFromCache(config_path, cache_path), std::runtime_error);
+            }
+        }
+    }
+
+    fs::remove_all(dir);
+}
+
+SCENARIO("Building maps in parallel") {
+    constexpr size_t maps_count = 8;
+    // Первые карты строятся дольше, поэтому потоки завершают их позже остальных
+    auto make_map = [](size_t index) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{(maps_count - index) * 5});
+        const std::string id = "map"s + std::to_string(index);
+        return model::Map{model::Map::Id{id}, id};
+    };
+
+    GIVEN("maps that all build") {
+        for (unsigned threads : {1u, 3u, 16u}) {
+            WHEN("they are built in " + std::to_string(threads) + " threads") {
+                const auto maps = json_loader::BuildMapsInParallel(maps_count, threads, make_map);
+
+                THEN("they come back in config order") {
+                    REQUIRE(maps.size() == maps_count);
+                    for (size_t i = 0; i < maps_count; ++i) {
+                        CHECK(*maps[i].GetId() == "map"s + std::to_string(i));
+                    }
+                }
+            }
+        }
+    }
+
+    GIVEN("an earlier and a later map that fail") {
+        // Поздняя карта падает сразу, ранняя - только после долгой сборки
+        auto make_map_with_errors = [&make_map](size_t index) {
+            if (index == 6) {
+                throw std::runtime_error("map 6 is broken");
+            }
+            auto map = make_map(index);
+            if (index == 2) {
+                throw std::runtime_error("map 2 is broken");
+            }
+            return map;
+        };
+
+        for (unsigned threads : {1u, 4u}) {
+            WHEN("they are built in " + std::to_string(threads) + " threads") {
+                THEN("the error of the first failing map in config order is rethrown") {
+                    try {
+                        json_loader::BuildMapsInParallel(maps_count, threads, make_map_with_errors);
+                        FAIL("no error was thrown");
+                    } catch (const std::runtime_error& e) {
+                        CHECK(e.what() == "map 2 is broken"s);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <thread>
+#include <vector>
+
+#include "../src/metrics/metrics.h"
+
+using namespace std::literals;
+using metrics::Histogram;
+
+SCENARIO("Histogram buckets") {
+    GIVEN("small values") {
+        THEN("they are stored exactly") {
+            for (uint64_t value = 0; value < Histogram::SUB_BUCKETS; ++value) {
+                CHECK(Histogram::BucketUpperBound(Histogram::BucketIndex(value)) == value);
+            }
+        }
+    }
+
+    GIVEN("large values") {
+        THEN("bucket bounds contain the value with bounded relative error") {
+            for (uint64_t value = Histogram::SUB_BUCKETS; value < (uint64_t{1} << 30); value = value * 3 / 2 + 1) {
+                INFO("value: " << value);
+                const uint64_t upper = Histogram::BucketUpperBound(Histogram::BucketIndex(value));
+                CHECK(upper >= value);
+                CHECK(upper - value <= value / Histogram::SUB_BUCKETS_HALF);
+            }
+        }
+
+        THEN("bucket index grows monotonically and fits the table") {
+            size_t prev_index = 0;
+            bool monotonic = true;
+            for (uint64_t value = 0; value < (uint64_t{1} << 20); ++value) {
+                const size_t index = Histogram::BucketIndex(value);
+                monotonic = monotonic && index >= prev_index;
+                prev_index = index;
+            }
+            CHECK(monotonic);
+            CHECK(Histogram::BucketIndex(~uint64_t{0}) == Histogram::BUCKETS_COUNT - 1);
+        }
+    }
+}
+
+SCENARIO("Histogram percentiles") {
+    GIVEN("a histogram with uniformly distributed values") {
+        Histogram histogram;
+        for (uint64_t value = 1; value <= 10'000; ++value) {
+            histogram.Record(value);
+        }
+        const auto snapshot = histogram.TakeSnapshot();
+
+        THEN("count and sum are exact") {
+            CHECK(snapshot.Count() == 10'000);
+            CHECK(snapshot.Sum() == 10'000 * 10'001 / 2);
+        }
+
+        THEN("percentiles are close to the exact ones") {
+            CHECK(snapshot.Percentile(0.5) >= 5'000);
+            CHECK(snapshot.Percentile(0.5) <= 5'000 + 5'000 / Histogram::SUB_BUCKETS_HALF);
+            CHECK(snapshot.Percentile(0.99) >= 9'900);
+            CHECK(snapshot.Percentile(0.99) <= 9'900 + 9'900 / Histogram::SUB_BUCKETS_HALF);
+            CHECK(snapshot.Percentile(1.0) >= 10'000);
+        }
+    }
+}
+
+SCENARIO("Sharded counter") {
+    GIVEN("a counter updated from several threads") {
+        metrics::Counter counter;
+        constexpr int THREADS = 8;
+        constexpr int ITERATIONS = 10'000;
+        {
+            std::vector<std::jthread> threads;
+            for (int i = 0; i < THREADS; ++i) {
+                threads.emplace_back([&counter] {
+                    for (int j = 0; j < ITERATIONS; ++j) {
+                        counter.Add();
+                    }
+                });
+            }
+        }
+
+        THEN("the aggregated value counts every increment") {
+            CHECK(counter.Value() == THREADS * ITERATIONS);
+        }
+    }
+}
+
+SCENARIO("Prometheus exposition") {
+    GIVEN("a registry with metrics") {
+        auto& registry = metrics::Registry::Instance();
+        registry.GetCounter("test_requests_total", "Test counter", {{"route", "/a"}}).Add(3);
+        registry.GetHistogram("test_latency_seconds", "Test histogram").Record(1'000);
+
+        WHEN("metrics are rendered") {
+            const std::string text = registry.Render();
+
+            THEN("families and series are present") {
+                CHECK(text.find("# TYPE test_requests_total counter") != std::string::npos);
+                CHECK(text.find("test_requests_total{route=\"/a\"} 3") != std::string::npos);
+                CHECK(text.find("# TYPE test_latency_seconds histogram") != std::string::npos);
+                CHECK(text.find("test_latency_seconds_bucket{le=\"+Inf\"} 1") != std::string::npos);
+                CHECK(text.find("test_latency_seconds_count 1") != std::string::npos);
+            }
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <thread>
+
+#include "../src/profiler/sampling_profiler.h"
+
+using namespace std::literals;
+using profiler::SamplingProfiler;
+
+namespace {
+
+std::atomic<bool> keep_spinning{false};
+
+// Имя функции должно попасть в профиль, поэтому она экспортируется и не встраивается
+extern "C" __attribute__((noinline)) double ProfilerTestSpin() {
+    double value = 0;
+    while (keep_spinning.load(std::memory_order_relaxed)) {
+        for (int i = 1; i < 1000; ++i) {
+            value += std::sqrt(static_cast<double>(i));
+        }
+    }
+    return value;
+}
+
+}  // namespace
+
+SCENARIO("Sampling profiler") {
+    auto& profiler = SamplingProfiler::Instance();
+
+    GIVEN("a registered thread busy with computation") {
+        keep_spinning = true;
+        std::atomic<double> result{0};
+        std::thread worker{[&result] {
+            profiler::ThreadRegistration registration;
+            result = ProfilerTestSpin();
+        }};
+
+        WHEN("a session runs while the thread works") {
+            REQUIRE(profiler.Start(1000));
+            THEN("a second session is refused") {
+                CHECK_FALSE(profiler.Start(1000));
+            }
+            std::this_thread::sleep_for(300ms);
+            auto profile = profiler.Stop();
+            keep_spinning = false;
+            worker.join();
+
+            THEN("its stacks are folded with the root first and the hot function on top") {
+                CHECK(profile.samples > 0);
+                CHECK(profile.dropped == 0);
+                CHECK_FALSE(profiler.IsActive());
+
+                std::istringstream lines{profile.folded};
+                std::string line;
+                uint64_t total = 0;
+                uint64_t spinning = 0;
+                while (std::getline(lines, line)) {
+                    const auto space = line.rfind(' ');
+                    REQUIRE(space != std::string::npos);
+                    const uint64_t count = std::stoull(line.substr(space + 1));
+                    const std::string stack = line.substr(0, space);
+                    total += count;
+                    if (stack.find("ProfilerTestSpin") != std::string::npos) {
+                        spinning += count;
+                    }
+                    // Кадры обработчика сигнала отрезаны
+                    CHECK(stack.find("OnSignal") == std::string::npos);
+                }
+                CHECK(total == profile.samples);
+                CHECK(spinning * 2 > total);
+            }
+        }
+    }
+
+    GIVEN("no session") {
+        THEN("stopping returns an empty profile") {
+            auto profile = profiler.Stop();
+            CHECK(profile.samples == 0);
+            CHECK(profile.folded.empty());
+        }
+
+        THEN("frequency out of range is rejected") {
+            CHECK_THROWS_AS(profiler.Start(0), std::invalid_argument);
+            CHECK_THROWS_AS(profiler.Start(SamplingProfiler::MAX_FREQUENCY + 1), std::invalid_argument);
+        }
+    }
+}
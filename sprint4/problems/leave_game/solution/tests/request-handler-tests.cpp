@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <future>
+#include <thread>
+
+#include "../src/request_handler/api_request_handler.h"
+#include "../src/request_handler/compression_request_handler.h"
+#include "../src/request_handler/logging_request_handler.h"
+
+using namespace std::literals;
+
+namespace {
+
+struct Reply {
+    http::status status;
+    std::string vary;
+    std::string body;
+};
+
+using StateHandler = http_handler::LoggingRequestHandler<http_handler::CompressionRequestHandler<http_handler::ApiRequestHandler>>;
+
+// Адрес клиента и функция отправки - временные объекты, которые живут только до возврата из обработчика
+void RequestState(StateHandler& handler, const app::Token& token, std::promise<Reply>& reply) {
+    http_handler::StringRequest req{http::verb::get, "/api/v1/game/state", 11};
+    req.set(http::field::authorization, "Bearer " + *token);
+    req.set(http::field::accept_encoding, "gzip");
+    handler(std::move(req), "127.0.0.1"s, [&reply](auto&& response) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(response)>, http_handler::StringResponse>) {
+            reply.set_value({response.result(), response[http::field::vary].to_string(), response.body()});
+        } else {
+            reply.set_value({response.result(), response[http::field::vary].to_string(), {}});
+        }
+    });
+}
+
+}  // namespace
+
+SCENARIO("Game state through the logging and compression decorators") {
+    // Application работает с базой данных, адрес которой передаётся так же, как серверу
+    const char* db_url = std::getenv("GAME_DB_URL");
+    if (!db_url) {
+        WARN("GAME_DB_URL is not set");
+        return;
+    }
+
+    GIVEN("a player whose session strand runs on another thread") {
+        net::io_context ioc;
+        model::Game game;
+        model::Map map{model::Map::Id{"map"s}, "map"s};
+        map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, 0}, 100));
+        map.AddLootType({});
+        game.AddMap(std::move(map));
+        const model::Map* game_map = game.FindMap(model::Map::Id{"map"s});
+
+        app::Application application{game, ioc, 0, false, false, db_app::DBSettings{1, db_url}};
+        const auto joined = application.JoinGame("dog"s, game_map);
+        REQUIRE(joined);
+        const auto session = application.GetPlayerTokens().FindPlayerByToken(joined->first)->GetSession().lock();
+
+        auto api_handler = std::make_shared<http_handler::ApiRequestHandler>(application, fs::path{});
+        http_handler::CompressionRequestHandler<http_handler::ApiRequestHandler> compression_handler{*api_handler, {}};
+        StateHandler logging_handler{compression_handler};
+
+        // Strand сессии занят, пока обработчик не вернёт управление
+        std::atomic<bool> busy{false};
+        std::atomic<bool> release{false};
+        net::post(*session->GetSessionStrand(), [&busy, &release] {
+            busy = true;
+            while (!release) {
+                std::this_thread::yield();
+            }
+        });
+        auto work = net::make_work_guard(ioc);
+        std::jthread runner{[&ioc] {
+            ioc.run();
+        }};
+        struct Stop {
+            std::atomic<bool>& release;
+            decltype(work)& work;
+            ~Stop() {
+                release = true;
+                work.reset();
+            }
+        } stop{release, work};
+        while (!busy) {
+            std::this_thread::yield();
+        }
+
+        WHEN("the state is requested") {
+            std::promise<Reply> reply;
+            auto replied = reply.get_future();
+            RequestState(logging_handler, joined->first, reply);
+
+            THEN("the reply is sent from the session strand after the handler has returned") {
+                CHECK(replied.wait_for(50ms) == std::future_status::timeout);
+                release = true;
+                REQUIRE(replied.wait_for(5s) == std::future_status::ready);
+                const Reply result = replied.get();
+                CHECK(result.status == http::status::ok);
+                CHECK(result.vary.find("Accept-Encoding") != std::string::npos);
+                CHECK(result.body.find("\"players\"") != std::string::npos);
+            }
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/model/session_manager.h"
+
+using namespace std::literals;
+
+namespace {
+
+struct Fixture {
+    Fixture() {
+        map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, 0}, 10));
+        map.AddLootType({});
+    }
+
+    std::shared_ptr<model::GameSession> MakeSession() {
+        ++created;
+        return std::make_shared<model::GameSession>(&map, 0ms, model::LootGeneratorConfig{1.0, 0.5}, ioc, 42);
+    }
+
+    model::Map map{model::Map::Id{"map"s}, "map"s};
+    net::io_context ioc;
+    int created = 0;
+};
+
+}  // namespace
+
+SCENARIO_METHOD(Fixture, "Session manager") {
+    GIVEN("a session manager with two slots per session") {
+        auto manager = std::make_shared<model::SessionManager>(map.GetId(), 2);
+        auto factory = [this] {
+            return MakeSession();
+        };
+
+        WHEN("players join") {
+            auto first = manager->Acquire(factory);
+            auto second = manager->Acquire(factory);
+            auto third = manager->Acquire(factory);
+
+            THEN("a new session is created only when the previous one is full") {
+                CHECK(first == second);
+                CHECK(first != third);
+                CHECK(created == 2);
+                CHECK(manager->GetSessions()->size() == 2);
+            }
+
+            AND_WHEN("a player leaves a full session") {
+                manager->Release(first.get(), 1);
+
+                THEN("its free slot is reused") {
+                    CHECK(manager->Acquire(factory) == third);
+                    CHECK(manager->Acquire(factory) == first);
+                    CHECK(created == 2);
+                }
+            }
+
+            AND_WHEN("all players leave a session") {
+                manager->Release(first.get(), 2);
+
+                THEN("the session is removed") {
+                    const auto sessions = manager->GetSessions();
+                    REQUIRE(sessions->size() == 1);
+                    CHECK(sessions->front() == third);
+                }
+            }
+        }
+
+        WHEN("a restored session is added") {
+            auto restored = MakeSession();
+            manager->Add(restored, 1);
+
+            THEN("its free slot is used before creating new sessions") {
+                CHECK(manager->Acquire(factory) == restored);
+                CHECK(created == 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,132 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+
+#include "../src/model/game_session.h"
+
+using namespace std::literals;
+
+namespace {
+
+template <typename T>
+std::vector<uint32_t> IdsInRadius(const model::SpatialGrid<T>& grid, geom::Point2D center, double radius) {
+    std::vector<uint32_t> ids;
+    grid.ForEachInRadius(center, radius, [&ids](const std::shared_ptr<T>& object) {
+        ids.push_back(object->GetId());
+    });
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+template <typename T>
+std::vector<uint32_t> IdsInRadius(const std::vector<std::shared_ptr<T>>& objects, geom::Point2D center, double radius) {
+    std::vector<uint32_t> ids;
+    for (const auto& object : objects) {
+        const double dx = object->GetCoordinate().x - center.x;
+        const double dy = object->GetCoordinate().y - center.y;
+        if (dx * dx + dy * dy <= radius * radius) {
+            ids.push_back(object->GetId());
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+}  // namespace
+
+SCENARIO("Spatial grid") {
+    GIVEN("objects scattered over a large area") {
+        model::random::Engine random{7};
+        model::SpatialGrid<model::LostObject> grid{10.0};
+        std::vector<std::shared_ptr<model::LostObject>> objects;
+        for (uint32_t id = 0; id < 1000; ++id) {
+            auto object = std::make_shared<model::LostObject>(id);
+            object->SetCoordinate({random.UniformReal() * 400.0 - 200.0, random.UniformReal() * 400.0 - 200.0});
+            grid.Insert(object);
+            objects.push_back(object);
+        }
+
+        THEN("a query returns exactly the objects within the radius") {
+            CHECK(grid.Size() == 1000);
+            for (const geom::Point2D center : {geom::Point2D{0, 0}, geom::Point2D{-150.5, 99.9}, geom::Point2D{200, -200}}) {
+                for (const double radius : {0.0, 5.0, 17.5, 1000.0}) {
+                    CHECK(IdsInRadius(grid, center, radius) == IdsInRadius(objects, center, radius));
+                }
+            }
+        }
+
+        WHEN("objects move and some are removed") {
+            for (size_t i = 0; i < objects.size(); ++i) {
+                if (i % 3 == 0) {
+                    grid.Erase(objects[i].get());
+                } else {
+                    objects[i]->SetCoordinate({objects[i]->GetCoordinate().x + 12.5, objects[i]->GetCoordinate().y - 3.0});
+                    grid.Update(objects[i]);
+                }
+            }
+            std::erase_if(objects, [](const auto& object) {
+                return object->GetId() % 3 == 0;
+            });
+
+            THEN("queries see their new positions") {
+                CHECK(grid.Size() == objects.size());
+                for (const double radius : {8.0, 30.0}) {
+                    CHECK(IdsInRadius(grid, {12.5, -3.0}, radius) == IdsInRadius(objects, {12.5, -3.0}, radius));
+                    CHECK(IdsInRadius(grid, {-90.0, 40.0}, radius) == IdsInRadius(objects, {-90.0, 40.0}, radius));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Game session interest index") {
+    model::Map map{model::Map::Id{"map"s}, "map"s};
+    for (int i = 0; i <= 60; i += 10) {
+        map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, i}, 60));
+        map.AddRoad(model::Road(model::Road::VERTICAL, {i, 0}, 60));
+    }
+    map.AddOffice(model::Office{model::Office::Id{"office"s}, {30, 30}, {0, 0}});
+    map.AddLootType({});
+    map.SetDogSpeed(4.0);
+    map.SetBagCapaccity(3);
+    net::io_context ioc;
+
+    GIVEN("a session with the index and wandering dogs") {
+        auto session = std::make_shared<model::GameSession>(&map, 0ms, model::LootGeneratorConfig{0.5, 0.5}, ioc, 42);
+        session->EnableInterestIndex(8.0);
+        auto navigation = std::make_shared<const model::RoadNavigation>(map);
+        for (int i = 0; i < 20; ++i) {
+            std::string name = "dog"s;
+            session->AddBot(std::make_shared<model::Dog>(name), model::MakeBotPolicy(model::BotPolicyType::RANDOM_WALK),
+                            navigation, true);
+        }
+
+        WHEN("the session is updated") {
+            for (int tick = 0; tick < 200; ++tick) {
+                session->UpdateSessionByTime(100ms);
+            }
+
+            THEN("the index matches a full scan of dogs and lost objects") {
+                const std::vector<std::shared_ptr<model::Dog>> dogs{session->GetDogs().begin(), session->GetDogs().end()};
+                const std::vector<std::shared_ptr<model::LostObject>> lost_objects{
+                    session->GetLostObjects().begin(), session->GetLostObjects().end()};
+                CHECK(!lost_objects.empty());
+                for (const auto& viewer : dogs) {
+                    std::vector<uint32_t> dog_ids;
+                    session->ForEachDogInRadius(viewer->GetCoordinate(), 12.0, [&dog_ids](const auto& dog) {
+                        dog_ids.push_back(dog->GetId());
+                    });
+                    std::sort(dog_ids.begin(), dog_ids.end());
+                    CHECK(dog_ids == IdsInRadius(dogs, viewer->GetCoordinate(), 12.0));
+
+                    std::vector<uint32_t> loot_ids;
+                    session->ForEachLostObjectInRadius(viewer->GetCoordinate(), 12.0, [&loot_ids](const auto& lost_object) {
+                        loot_ids.push_back(lost_object->GetId());
+                    });
+                    std::sort(loot_ids.begin(), loot_ids.end());
+                    CHECK(loot_ids == IdsInRadius(lost_objects, viewer->GetCoordinate(), 12.0));
+                }
+            }
+        }
+    }
+}
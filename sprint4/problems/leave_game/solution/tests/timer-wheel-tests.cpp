@@ -0,0 +1,232 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../src/time/timer_wheel.h"
+
+using namespace std::literals;
+namespace net = boost::asio;
+using time_tiker::TimerWheel;
+
+namespace {
+
+struct Event {
+    std::string name;
+    uint64_t tick;
+    std::chrono::milliseconds delta;
+};
+
+// Колесо со слотами по 1 мс, время которого сдвигается только тестом.
+// Обработчики выполняются в том же потоке сразу после сдвига
+class ManualWheel {
+public:
+    explicit ManualWheel(bool align_phases = false)
+        : wheel_{std::make_shared<TimerWheel>(ioc_, 1ms, align_phases, true)} {
+        wheel_->Start();
+        Poll();
+    }
+
+    TimerWheel::Id Add(const std::string& name, std::chrono::milliseconds period,
+                       std::function<void()> on_fire = {}) {
+        const auto id = wheel_->Add(strand_, period, [this, name, on_fire](std::chrono::milliseconds delta) {
+            events_.push_back({name, tick_, delta});
+            if (on_fire) {
+                on_fire();
+            }
+        });
+        Poll();
+        return id;
+    }
+
+    void Remove(TimerWheel::Id id) {
+        wheel_->Remove(id);
+    }
+
+    // Сдвигает время по одному слоту, как если бы колесо просыпалось вовремя
+    void AdvanceTo(uint64_t tick) {
+        while (tick_ < tick) {
+            Advance(1);
+        }
+    }
+
+    // Сдвигает время сразу на ticks слотов, как если бы пробуждение опоздало
+    void Advance(uint64_t ticks) {
+        tick_ += ticks;
+        wheel_->Advance(ticks);
+        Poll();
+    }
+
+    std::vector<uint64_t> FireTicks(const std::string& name) const {
+        std::vector<uint64_t> ticks;
+        for (const Event& event : events_) {
+            if (event.name == name) {
+                ticks.push_back(event.tick);
+            }
+        }
+        return ticks;
+    }
+
+    const std::vector<Event>& GetEvents() const noexcept {
+        return events_;
+    }
+
+private:
+    void Poll() {
+        ioc_.restart();
+        ioc_.poll();
+    }
+
+    net::io_context ioc_;
+    TimerWheel::Strand strand_ = net::make_strand(ioc_);
+    std::shared_ptr<TimerWheel> wheel_;
+    uint64_t tick_ = 0;
+    std::vector<Event> events_;
+};
+
+std::vector<uint64_t> Multiples(uint64_t period, uint64_t last_tick) {
+    std::vector<uint64_t> ticks;
+    for (uint64_t tick = period; tick <= last_tick; tick += period) {
+        ticks.push_back(tick);
+    }
+    return ticks;
+}
+
+}  // namespace
+
+SCENARIO("Timer wheel cascades") {
+    static_assert(TimerWheel::SLOTS == 64 && TimerWheel::LEVELS == 3);
+
+    GIVEN("a manual wheel with 1 ms slots") {
+        ManualWheel wheel;
+
+        WHEN("subscriptions start on levels 0, 1 and 2") {
+            wheel.Add("level 0", 40ms);
+            // 100 слотов не помещаются в уровень 0 и спускаются с уровня 1 на каскаде 1 -> 0
+            wheel.Add("level 1", 100ms);
+            // 5000 слотов лежат на уровне 2 и проходят каскады 2 -> 1 и 1 -> 0
+            wheel.Add("level 2", 5000ms);
+            wheel.AdvanceTo(10'000);
+
+            THEN("each fires exactly on its period, in tick order") {
+                CHECK(wheel.FireTicks("level 0") == Multiples(40, 10'000));
+                CHECK(wheel.FireTicks("level 1") == Multiples(100, 10'000));
+                CHECK(wheel.FireTicks("level 2") == Multiples(5000, 10'000));
+                CHECK(std::is_sorted(wheel.GetEvents().begin(), wheel.GetEvents().end(), [](const Event& lhs, const Event& rhs) {
+                    return lhs.tick < rhs.tick;
+                }));
+            }
+            THEN("every handler receives its period as the elapsed time") {
+                for (const Event& event : wheel.GetEvents()) {
+                    const auto period = event.name == "level 0" ? 40ms : event.name == "level 1" ? 100ms : 5000ms;
+                    CHECK(event.delta == period);
+                }
+            }
+        }
+
+        WHEN("a period is longer than the whole wheel") {
+            constexpr uint64_t wheel_span = uint64_t{1} << (TimerWheel::SLOT_BITS * TimerWheel::LEVELS);
+            wheel.Add("long", std::chrono::milliseconds{wheel_span + 37'856});
+            wheel.AdvanceTo(wheel_span + 37'856);
+
+            THEN("it is parked in the top level and fires once, on time") {
+                CHECK(wheel.FireTicks("long") == std::vector<uint64_t>{wheel_span + 37'856});
+            }
+        }
+    }
+}
+
+SCENARIO("Removing timer wheel subscriptions from a handler") {
+    GIVEN("a manual wheel") {
+        ManualWheel wheel;
+
+        WHEN("a handler removes its own subscription on the second call") {
+            TimerWheel::Id self_id = 0;
+            int calls = 0;
+            self_id = wheel.Add("self", 10ms, [&] {
+                if (++calls == 2) {
+                    wheel.Remove(self_id);
+                }
+            });
+            wheel.AdvanceTo(100);
+
+            THEN("it is not called again") {
+                CHECK(wheel.FireTicks("self") == std::vector<uint64_t>{10, 20});
+            }
+        }
+
+        WHEN("a handler removes another subscription before it is due") {
+            TimerWheel::Id other_id = 0;
+            wheel.Add("remover", 10ms, [&] {
+                wheel.Remove(other_id);
+            });
+            // Срок 100 слотов лежит на уровне 1, идентификатор остаётся там и после удаления
+            other_id = wheel.Add("other", 100ms);
+            wheel.AdvanceTo(300);
+
+            THEN("the removed one never fires and the remover keeps firing") {
+                CHECK(wheel.FireTicks("other").empty());
+                CHECK(wheel.FireTicks("remover") == Multiples(10, 300));
+            }
+        }
+    }
+}
+
+SCENARIO("Timer wheel wakeups") {
+    GIVEN("a manual wheel with a subscription every 10 ms") {
+        ManualWheel wheel;
+        wheel.Add("ticker", 10ms);
+
+        WHEN("a wakeup is late by more than a period") {
+            wheel.Advance(25);
+            wheel.AdvanceTo(40);
+
+            THEN("the missed call is skipped and later calls stay on the epoch grid") {
+                // delta - фактическое время между вызовами, а не период
+                const auto& events = wheel.GetEvents();
+                REQUIRE(events.size() == 3);
+                CHECK(events[0].tick == 25);
+                CHECK(events[0].delta == 25ms);
+                CHECK(events[1].tick == 30);
+                CHECK(events[1].delta == 5ms);
+                CHECK(events[2].tick == 40);
+                CHECK(events[2].delta == 10ms);
+            }
+        }
+    }
+
+    GIVEN("a manual wheel sleeping until a distant slot") {
+        ManualWheel wheel;
+        wheel.Add("distant", 100ms);
+        wheel.AdvanceTo(3);
+
+        WHEN("a subscription due earlier is added") {
+            wheel.Add("near", 5ms);
+            wheel.AdvanceTo(20);
+
+            THEN("the wheel wakes for it, counting from the current time") {
+                CHECK(wheel.FireTicks("near") == std::vector<uint64_t>{8, 13, 18});
+                CHECK(wheel.FireTicks("distant").empty());
+            }
+        }
+    }
+
+    GIVEN("a manual wheel with aligned phases") {
+        ManualWheel wheel{true};
+        wheel.AdvanceTo(3);
+
+        WHEN("subscriptions with the same period are added at different times") {
+            wheel.Add("first", 10ms);
+            wheel.AdvanceTo(7);
+            wheel.Add("second", 10ms);
+            wheel.AdvanceTo(30);
+
+            THEN("both fire on multiples of the period") {
+                CHECK(wheel.FireTicks("first") == Multiples(10, 30));
+                CHECK(wheel.FireTicks("second") == Multiples(10, 30));
+            }
+        }
+    }
+}